@@ -4,6 +4,9 @@
 
 #include "ShaderCore.h"
 #include "Interfaces/IPluginManager.h"
+#include "Misc/CoreDelegates.h"
+#include "SpoutSharedTexturePool.h"
+#include "SpoutTransferWorker.h"
 
 #define LOCTEXT_NAMESPACE "FSpout2Module"
 
@@ -12,13 +15,19 @@ void FSpout2Module::StartupModule()
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
 	FString PluginShaderDir = FPaths::Combine(IPluginManager::Get().FindPlugin(TEXT("Spout2"))->GetBaseDir(), TEXT("Shaders"));
 	AddShaderSourceDirectoryMapping(TEXT("/Plugin/Spout2"), PluginShaderDir);
+
+	// the RHI is not up yet in this loading phase
+	FCoreDelegates::OnPostEngineInit.AddLambda([]() {
+		FSpoutSharedTexturePool::Get().PrewarmFromConfig();
+	});
 }
 
 void FSpout2Module::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
-	
+	FSpoutTransferWorker::Shutdown();
+	FSpoutSharedTexturePool::Get().Shutdown();
 }
 
 #undef LOCTEXT_NAMESPACE
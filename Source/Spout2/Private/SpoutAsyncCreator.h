@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Async.h"
+#include "Misc/Optional.h"
+
+enum class ESpoutCreationState : uint8
+{
+	Idle,
+	Pending,
+	Ready,
+	Failed,
+};
+
+/**
+ * Builds a resource for a key on the thread pool and hands it over once it is ready.
+ *
+ * Update() is polled from one owning thread with the key the owner currently wants. It
+ * returns the resource only when it was built for that exact key, and null while a build
+ * is in flight. A build that finishes for a key that is no longer wanted is discarded on the
+ * owning thread, then the current key is built. A failed key is retried after RetryDelay.
+ *
+ * The factory runs off the owning thread and must only use what the key carries.
+ */
+template<typename KeyType, typename ResourceType>
+class TSpoutAsyncCreator
+{
+public:
+
+	typedef TSharedPtr<ResourceType, ESPMode::ThreadSafe> FResourcePtr;
+	typedef TFunction<FResourcePtr(const KeyType&)> FFactory;
+
+	explicit TSpoutAsyncCreator(FFactory InFactory, double InRetryDelay = 1.0)
+		: Factory(MoveTemp(InFactory))
+		, RetryDelay(InRetryDelay)
+	{
+	}
+
+	~TSpoutAsyncCreator()
+	{
+		// the build cannot be cancelled, its result is released here rather than on the pool thread
+		if (Pending.IsValid())
+			Pending.Wait();
+	}
+
+	TSpoutAsyncCreator(const TSpoutAsyncCreator&) = delete;
+	TSpoutAsyncCreator& operator=(const TSpoutAsyncCreator&) = delete;
+
+	FResourcePtr Update(const KeyType& Key, double Time)
+	{
+		if (Pending.IsValid() && Pending.IsReady())
+		{
+			FResourcePtr Result = Pending.Get();
+			Pending = TFuture<FResourcePtr>();
+
+			if (PendingKey.IsSet() && PendingKey.GetValue() == Key)
+			{
+				RequestedKey = Key;
+				Resource = Result;
+				State = Result ? ESpoutCreationState::Ready : ESpoutCreationState::Failed;
+				LastAttemptTime = Time;
+			}
+			else
+			{
+				State = ESpoutCreationState::Idle;
+			}
+
+			PendingKey.Reset();
+		}
+
+		if (RequestedKey.IsSet() && RequestedKey.GetValue() == Key)
+		{
+			if (State == ESpoutCreationState::Ready)
+				return Resource;
+
+			if (State == ESpoutCreationState::Pending
+				|| (State == ESpoutCreationState::Failed && Time < LastAttemptTime + RetryDelay))
+				return nullptr;
+		}
+
+		// the previous resource stops being handed out as soon as the key changes
+		Resource.Reset();
+		RequestedKey = Key;
+
+		// an outdated build still in flight, it is harvested and dropped on a later update
+		if (Pending.IsValid())
+		{
+			State = ESpoutCreationState::Idle;
+			return nullptr;
+		}
+
+		State = ESpoutCreationState::Pending;
+		PendingKey = Key;
+		LastAttemptTime = Time;
+
+		Pending = Async(EAsyncExecution::ThreadPool, [Factory = Factory, Key]() {
+			return Factory(Key);
+		});
+
+		return nullptr;
+	}
+
+	/** Drops the resource; an in-flight build finishes and is discarded, even when its key is wanted again. */
+	void Reset()
+	{
+		Resource.Reset();
+		RequestedKey.Reset();
+		PendingKey.Reset();
+		State = ESpoutCreationState::Idle;
+	}
+
+	ESpoutCreationState GetState() const { return State; }
+
+private:
+
+	FFactory Factory;
+	double RetryDelay;
+
+	TOptional<KeyType> RequestedKey;
+	TOptional<KeyType> PendingKey;
+	TFuture<FResourcePtr> Pending;
+	FResourcePtr Resource;
+
+	ESpoutCreationState State = ESpoutCreationState::Idle;
+	double LastAttemptTime = 0.0;
+};
@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutAtlasLayout.h"
+
+#include "HAL/PlatformAtomics.h"
+#include "HAL/PlatformMisc.h"
+
+namespace SpoutAtlas
+{
+	static const TCHAR* DescriptionPrefix = TEXT("SpoutAtlas:");
+
+	static FString MakeRegionName(const FString& AtlasName)
+	{
+		return FSpoutSharedRegion::MakeName(AtlasName, TEXT("SpoutAtlas"));
+	}
+
+	FString MakeDescription(const FString& AtlasName)
+	{
+		return DescriptionPrefix + AtlasName;
+	}
+
+	bool ParseDescription(const TCHAR* Description, FString& OutAtlasName)
+	{
+		const FString Text(Description);
+		if (!Text.StartsWith(DescriptionPrefix, ESearchCase::CaseSensitive))
+			return false;
+
+		OutAtlasName = Text.RightChop(FCString::Strlen(DescriptionPrefix));
+		return !OutAtlasName.IsEmpty();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+FSpoutAtlasTableWriter::FSpoutAtlasTableWriter(const FString& AtlasName)
+	: AtlasName(AtlasName)
+{
+}
+
+bool FSpoutAtlasTableWriter::Publish(FIntPoint AtlasSize, const TArray<FSpoutAtlasEntry>& Entries)
+{
+	if (Entries.Num() > FSpoutAtlasTable::MaxEntries)
+		return false;
+
+	if (!Region.IsValid()
+		&& !Region.Create(SpoutAtlas::MakeRegionName(AtlasName), sizeof(FSpoutAtlasTable)))
+		return false;
+
+	FSpoutAtlasTable* Table = Region.As<FSpoutAtlasTable>();
+
+	// odd sequence: readers retry until the table is complete
+	FPlatformAtomics::InterlockedIncrement(&Table->Sequence);
+	FPlatformMisc::MemoryBarrier();
+
+	Table->Magic = FSpoutAtlasTable::MagicValue;
+	Table->Version = FSpoutAtlasTable::CurrentVersion;
+	Table->AtlasWidth = AtlasSize.X;
+	Table->AtlasHeight = AtlasSize.Y;
+	Table->NumEntries = Entries.Num();
+
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
+	{
+		FSpoutAtlasTable::FEntry& Entry = Table->Entries[Index];
+
+		FCStringAnsi::Strncpy(Entry.Name, TCHAR_TO_ANSI(*Entries[Index].Name), FSpoutAtlasTable::MaxNameLength);
+		Entry.X = Entries[Index].Rect.Min.X;
+		Entry.Y = Entries[Index].Rect.Min.Y;
+		Entry.Width = Entries[Index].Rect.Width();
+		Entry.Height = Entries[Index].Rect.Height();
+	}
+
+	FPlatformMisc::MemoryBarrier();
+	FPlatformAtomics::InterlockedIncrement(&Table->Sequence);
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+FSpoutAtlasTableReader::FSpoutAtlasTableReader(const FString& AtlasName)
+	: AtlasName(AtlasName)
+{
+}
+
+bool FSpoutAtlasTableReader::Find(const FString& SenderName, FIntRect& OutRect)
+{
+	if (!Region.IsValid()
+		&& !Region.Open(SpoutAtlas::MakeRegionName(AtlasName), sizeof(FSpoutAtlasTable)))
+		return false;
+
+	const FSpoutAtlasTable* Table = Region.As<FSpoutAtlasTable>();
+
+	const int64 SequenceBefore = FPlatformAtomics::AtomicRead(&Table->Sequence);
+	if (SequenceBefore & 1)
+		return false;
+
+	FPlatformMisc::MemoryBarrier();
+
+	if (Table->Magic != FSpoutAtlasTable::MagicValue
+		|| Table->Version != FSpoutAtlasTable::CurrentVersion)
+		return false;
+
+	const auto Name = StringCast<ANSICHAR>(*SenderName);
+	const int32 NumEntries = FMath::Clamp(Table->NumEntries, 0, FSpoutAtlasTable::MaxEntries);
+
+	bool bFound = false;
+
+	for (int32 Index = 0; Index < NumEntries && !bFound; ++Index)
+	{
+		const FSpoutAtlasTable::FEntry& Entry = Table->Entries[Index];
+
+		if (FCStringAnsi::Strncmp(Entry.Name, Name.Get(), FSpoutAtlasTable::MaxNameLength) != 0)
+			continue;
+
+		OutRect = FIntRect(Entry.X, Entry.Y, Entry.X + Entry.Width, Entry.Y + Entry.Height);
+		bFound = true;
+	}
+
+	// the atlas was repacked while we read, the rectangle may belong to the old layout
+	FPlatformMisc::MemoryBarrier();
+	if (FPlatformAtomics::AtomicRead(&Table->Sequence) != SequenceBefore)
+		return false;
+
+	return bFound && OutRect.Width() > 0 && OutRect.Height() > 0;
+}
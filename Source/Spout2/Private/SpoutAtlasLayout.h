@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SpoutSharedRegion.h"
+
+/**
+ * Where each logical sender of an atlas lives, in a region "<Atlas>_SpoutAtlas".
+ *
+ * Logical senders are registered with Spout under their own name but share the atlas'
+ * texture handle; their SharedTextureInfo description names the atlas, see
+ * SpoutAtlas::MakeDescription. The table is rewritten only when the atlas is repacked,
+ * under a sequence counter that is odd while it changes.
+ */
+struct FSpoutAtlasTable
+{
+	static constexpr uint32 MagicValue = 0x54415053; // "SPAT"
+	static constexpr uint32 CurrentVersion = 1;
+	static constexpr int32 MaxEntries = 64;
+	// SpoutMaxSenderNameLen
+	static constexpr int32 MaxNameLength = 256;
+
+	struct FEntry
+	{
+		ANSICHAR Name[MaxNameLength];
+		int32 X;
+		int32 Y;
+		int32 Width;
+		int32 Height;
+	};
+
+	uint32 Magic;
+	uint32 Version;
+	volatile int64 Sequence;
+	int32 AtlasWidth;
+	int32 AtlasHeight;
+	int32 NumEntries;
+	uint32 Reserved;
+
+	FEntry Entries[MaxEntries];
+};
+
+struct FSpoutAtlasEntry
+{
+	FString Name;
+	FIntRect Rect;
+};
+
+class FSpoutAtlasTableWriter
+{
+public:
+
+	explicit FSpoutAtlasTableWriter(const FString& AtlasName);
+
+	/** Replaces the table. False when the region is unusable or there are more than MaxEntries. */
+	bool Publish(FIntPoint AtlasSize, const TArray<FSpoutAtlasEntry>& Entries);
+
+private:
+
+	FString AtlasName;
+	FSpoutSharedRegion Region;
+};
+
+class FSpoutAtlasTableReader
+{
+public:
+
+	explicit FSpoutAtlasTableReader(const FString& AtlasName);
+
+	/** Rectangle of a logical sender in the atlas. False while the table is rewritten or the sender is not in it. */
+	bool Find(const FString& SenderName, FIntRect& OutRect);
+
+	const FString& GetAtlasName() const { return AtlasName; }
+
+private:
+
+	FString AtlasName;
+	FSpoutSharedRegion Region;
+};
+
+namespace SpoutAtlas
+{
+	/** SharedTextureInfo::description of a logical sender, "SpoutAtlas:<Atlas>". */
+	FString MakeDescription(const FString& AtlasName);
+
+	/** Atlas a description names, false for a plain sender. */
+	bool ParseDescription(const TCHAR* Description, FString& OutAtlasName);
+}
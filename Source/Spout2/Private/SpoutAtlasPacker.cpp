@@ -0,0 +1,182 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutAtlasPacker.h"
+
+FSpoutSkylinePacker::FSpoutSkylinePacker(int32 InWidth, int32 InHeight, int32 InPadding)
+	: Padding(InPadding)
+{
+	Reset(InWidth, InHeight);
+}
+
+void FSpoutSkylinePacker::Reset(int32 InWidth, int32 InHeight)
+{
+	Width = InWidth;
+	Height = InHeight;
+	UsedArea = 0;
+
+	Skyline.Reset();
+	Skyline.Add({ 0, 0, Width });
+}
+
+TOptional<int32> FSpoutSkylinePacker::Fit(int32 Index, int32 RectWidth, int32 RectHeight) const
+{
+	const int32 X = Skyline[Index].X;
+	if (X + RectWidth > Width)
+		return {};
+
+	int32 Y = 0;
+	int32 WidthLeft = RectWidth;
+
+	// rests on the highest segment it spans
+	for (int32 i = Index; WidthLeft > 0; ++i)
+	{
+		if (i == Skyline.Num())
+			return {};
+
+		Y = FMath::Max(Y, Skyline[i].Y);
+		if (Y + RectHeight > Height)
+			return {};
+
+		WidthLeft -= Skyline[i].Width;
+	}
+
+	return Y;
+}
+
+TOptional<FIntRect> FSpoutSkylinePacker::Insert(FIntPoint Size)
+{
+	if (Size.X <= 0 || Size.Y <= 0 || Size.X > Width || Size.Y > Height)
+		return {};
+
+	const int32 PaddedWidth = FMath::Min(Size.X + Padding, Width);
+	const int32 PaddedHeight = FMath::Min(Size.Y + Padding, Height);
+
+	int32 BestIndex = INDEX_NONE;
+	int32 BestTop = MAX_int32;
+	int32 BestSegmentWidth = MAX_int32;
+	int32 BestY = 0;
+
+	for (int32 Index = 0; Index < Skyline.Num(); ++Index)
+	{
+		const TOptional<int32> Y = Fit(Index, PaddedWidth, PaddedHeight);
+		if (!Y.IsSet())
+			continue;
+
+		const int32 Top = Y.GetValue() + PaddedHeight;
+
+		if (Top < BestTop || (Top == BestTop && Skyline[Index].Width < BestSegmentWidth))
+		{
+			BestIndex = Index;
+			BestTop = Top;
+			BestSegmentWidth = Skyline[Index].Width;
+			BestY = Y.GetValue();
+		}
+	}
+
+	if (BestIndex == INDEX_NONE)
+		return {};
+
+	const int32 X = Skyline[BestIndex].X;
+	Place(BestIndex, FIntRect(X, BestY, X + PaddedWidth, BestY + PaddedHeight));
+
+	UsedArea += (int64)Size.X * Size.Y;
+	return FIntRect(X, BestY, X + Size.X, BestY + Size.Y);
+}
+
+void FSpoutSkylinePacker::Place(int32 Index, const FIntRect& Rect)
+{
+	Skyline.Insert({ Rect.Min.X, Rect.Max.Y, Rect.Width() }, Index);
+
+	// cut away what the new segment covers of the ones to its right
+	for (int32 i = Index + 1; i < Skyline.Num();)
+	{
+		const int32 PreviousEnd = Skyline[i - 1].X + Skyline[i - 1].Width;
+		if (Skyline[i].X >= PreviousEnd)
+			break;
+
+		const int32 Shrink = PreviousEnd - Skyline[i].X;
+		Skyline[i].X += Shrink;
+		Skyline[i].Width -= Shrink;
+
+		if (Skyline[i].Width > 0)
+			break;
+
+		Skyline.RemoveAt(i);
+	}
+
+	for (int32 i = 0; i + 1 < Skyline.Num();)
+	{
+		if (Skyline[i].Y == Skyline[i + 1].Y)
+		{
+			Skyline[i].Width += Skyline[i + 1].Width;
+			Skyline.RemoveAt(i + 1);
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+
+float FSpoutSkylinePacker::GetOccupancy() const
+{
+	const int64 Area = (int64)Width * Height;
+	return Area > 0 ? (float)((double)UsedArea / Area) : 0.f;
+}
+
+bool FSpoutSkylinePacker::PackAll(const TArray<FIntPoint>& Sizes, FIntPoint AtlasSize, int32 Padding, TArray<FIntRect>& OutRects)
+{
+	TArray<int32> Order;
+	for (int32 Index = 0; Index < Sizes.Num(); ++Index)
+		Order.Add(Index);
+
+	Order.Sort([&Sizes](int32 A, int32 B) {
+		return Sizes[A].Y != Sizes[B].Y ? Sizes[A].Y > Sizes[B].Y : Sizes[A].X > Sizes[B].X;
+	});
+
+	FSpoutSkylinePacker Packer(AtlasSize.X, AtlasSize.Y, Padding);
+
+	OutRects.SetNum(Sizes.Num());
+
+	for (int32 Index : Order)
+	{
+		const TOptional<FIntRect> Rect = Packer.Insert(Sizes[Index]);
+		if (!Rect.IsSet())
+			return false;
+
+		OutRects[Index] = Rect.GetValue();
+	}
+
+	return true;
+}
+
+TOptional<FIntPoint> FSpoutSkylinePacker::PackSmallest(const TArray<FIntPoint>& Sizes, int32 Padding, int32 MaxSize, TArray<FIntRect>& OutRects)
+{
+	int64 Area = 0;
+	FIntPoint Largest = FIntPoint::ZeroValue;
+
+	for (const FIntPoint& Size : Sizes)
+	{
+		// padding is dropped at the atlas edge, a sender as large as the atlas still fits
+		Area += (int64)(Size.X + Padding) * (Size.Y + Padding);
+		Largest = Largest.ComponentMax(Size);
+	}
+
+	if (Sizes.Num() == 0)
+		return {};
+
+	// the square that holds the area, halved since the wide atlas is tried first
+	int32 Side = (int32)FMath::RoundUpToPowerOfTwo((uint32)FMath::Max(Largest.X, Largest.Y));
+	Side = FMath::Max(Side, (int32)FMath::RoundUpToPowerOfTwo((uint32)FMath::CeilToInt(FMath::Sqrt((double)Area))) / 2);
+
+	for (; Side <= MaxSize; Side *= 2)
+	{
+		if (Side / 2 >= Largest.Y && PackAll(Sizes, FIntPoint(Side, Side / 2), Padding, OutRects))
+			return FIntPoint(Side, Side / 2);
+
+		if (PackAll(Sizes, FIntPoint(Side, Side), Padding, OutRects))
+			return FIntPoint(Side, Side);
+	}
+
+	return {};
+}
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Skyline bottom-left rectangle packer for atlases of small senders.
+ *
+ * The skyline is the upper edge of everything placed so far, kept as horizontal segments
+ * left to right. A rectangle goes where its top ends lowest, ties broken by the narrower
+ * segment, which wastes little space on the sizes UI widgets and thumbnails come in.
+ */
+class FSpoutSkylinePacker
+{
+public:
+
+	FSpoutSkylinePacker(int32 InWidth, int32 InHeight, int32 InPadding = 0);
+
+	void Reset(int32 InWidth, int32 InHeight);
+
+	/** Places one rectangle, unset when it no longer fits. Padding is kept to the right and below. */
+	TOptional<FIntRect> Insert(FIntPoint Size);
+
+	/** Area of the placed rectangles over the atlas area, padding excluded. */
+	float GetOccupancy() const;
+
+	/** Packs all of Sizes, tallest first, into an atlas of AtlasSize. OutRects follows the order of Sizes. */
+	static bool PackAll(const TArray<FIntPoint>& Sizes, FIntPoint AtlasSize, int32 Padding, TArray<FIntRect>& OutRects);
+
+	/** Smallest power of two atlas, up to MaxSize on each side, that PackAll succeeds in. */
+	static TOptional<FIntPoint> PackSmallest(const TArray<FIntPoint>& Sizes, int32 Padding, int32 MaxSize, TArray<FIntRect>& OutRects);
+
+private:
+
+	struct FSegment
+	{
+		int32 X;
+		int32 Y;
+		int32 Width;
+	};
+
+	/** Lowest top edge a Width x Height rectangle starting at segment Index would rest on, unset when it does not fit. */
+	TOptional<int32> Fit(int32 Index, int32 RectWidth, int32 RectHeight) const;
+
+	void Place(int32 Index, const FIntRect& Rect);
+
+	int32 Width;
+	int32 Height;
+	int32 Padding;
+	int64 UsedArea = 0;
+
+	TArray<FSegment> Skyline;
+};
@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/ScopeLock.h"
+#include "SpoutTypes.h"
+
+/**
+ * Picks the post-processing pass a view is captured after.
+ *
+ * Passes are offered in pipeline order with their enabled state, before any of them
+ * executes. Every enabled pass up to the requested stage is subscribed; once all offers
+ * are in, only the last of them is the selected one, so a disabled FXAA falls back to
+ * the tonemapper rather than capturing nothing.
+ */
+struct FSpoutStageSelection
+{
+	ESpoutCaptureStage Requested = ESpoutCaptureStage::AfterTonemap;
+	TOptional<ESpoutCaptureStage> Selected;
+
+	/** True when the pass needs a callback. */
+	bool Offer(ESpoutCaptureStage Stage, bool bEnabled)
+	{
+		if (!bEnabled || Stage > Requested)
+			return false;
+
+		Selected = Stage;
+		return true;
+	}
+
+	bool IsSelected(ESpoutCaptureStage Stage) const
+	{
+		return Selected.IsSet() && Selected.GetValue() == Stage;
+	}
+};
+
+/**
+ * Hands the slot a sender publishes from to the render thread, once per admitted frame.
+ *
+ * The game thread arms a frame with the current target; the first view of that frame or a
+ * later one claims it on the render thread if its size and format match the target.
+ * Every view reports what it looked like, so the game thread can (re)allocate the target
+ * when the viewport resizes or changes format.
+ */
+template<typename TargetType>
+class TSpoutCaptureHandoff
+{
+public:
+
+	typedef TSharedPtr<TargetType, ESPMode::ThreadSafe> FTargetPtr;
+
+	/** Game thread. Target size and format are what Claim compares against. */
+	void Arm(FTargetPtr InTarget, FIntPoint InTargetSize, int32 InTargetFormat, uint64 FrameNumber)
+	{
+		FScopeLock Lock(&Mutex);
+		Target = MoveTemp(InTarget);
+		TargetSize = InTargetSize;
+		TargetFormat = InTargetFormat;
+		ArmedFrame = FrameNumber;
+	}
+
+	/** Game thread. Drops the target, nothing is claimed until the next Arm. */
+	void Disarm()
+	{
+		FScopeLock Lock(&Mutex);
+		Target.Reset();
+		ArmedFrame = 0;
+	}
+
+	/** Render thread, once per candidate view. Null when this view must not be captured. */
+	FTargetPtr Claim(uint64 FrameNumber, FIntPoint ViewSize, int32 ViewFormat)
+	{
+		FScopeLock Lock(&Mutex);
+
+		ObservedSize = ViewSize;
+		ObservedFormat = ViewFormat;
+
+		if (!Target.IsValid()
+			|| ArmedFrame == 0
+			|| FrameNumber < ArmedFrame
+			|| FrameNumber == ClaimedFrame
+			|| ViewSize != TargetSize
+			|| ViewFormat != TargetFormat)
+			return nullptr;
+
+		ClaimedFrame = FrameNumber;
+		ArmedFrame = 0;
+		return Target;
+	}
+
+	/** Game thread. Size and format of the last candidate view, zero before the first one. */
+	void GetObserved(FIntPoint& OutSize, int32& OutFormat) const
+	{
+		FScopeLock Lock(&Mutex);
+		OutSize = ObservedSize;
+		OutFormat = ObservedFormat;
+	}
+
+	uint64 GetClaimedFrame() const
+	{
+		FScopeLock Lock(&Mutex);
+		return ClaimedFrame;
+	}
+
+private:
+
+	mutable FCriticalSection Mutex;
+
+	FTargetPtr Target;
+	FIntPoint TargetSize = FIntPoint::ZeroValue;
+	int32 TargetFormat = 0;
+
+	uint64 ArmedFrame = 0;
+	uint64 ClaimedFrame = 0;
+
+	FIntPoint ObservedSize = FIntPoint::ZeroValue;
+	int32 ObservedFormat = 0;
+};
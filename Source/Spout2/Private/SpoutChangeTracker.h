@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Remembers the last published state of something and bumps a version when it changes.
+ *
+ * HasChanged and MarkPublished are separate so a change the scheduler defers is not
+ * lost: only the publish that actually happened is recorded. The first value always
+ * counts as a change.
+ */
+template<typename T>
+class TSpoutChangeTracker
+{
+public:
+
+	bool HasChanged(const T& Value) const
+	{
+		return !Published.IsSet() || !(Published.GetValue() == Value);
+	}
+
+	void MarkPublished(const T& Value)
+	{
+		if (HasChanged(Value))
+			++Version;
+
+		Published = Value;
+	}
+
+	void Reset()
+	{
+		Published.Reset();
+	}
+
+	/** Number of distinct values published so far. */
+	uint64 GetVersion() const { return Version; }
+
+private:
+
+	TOptional<T> Published;
+	uint64 Version = 0;
+};
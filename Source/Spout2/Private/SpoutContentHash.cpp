@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutContentHash.h"
+
+#include "GlobalShader.h"
+#include "RHICommandList.h"
+#include "RHIGPUReadback.h"
+#include "ShaderParameterUtils.h"
+
+class FSpoutContentHashCS : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FSpoutContentHashCS, Global);
+public:
+
+	static constexpr int32 GroupSize = 8;
+
+#if (ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 25) || (ENGINE_MAJOR_VERSION == 5)
+	LAYOUT_FIELD(FShaderResourceParameter, SrcTexture);
+	LAYOUT_FIELD(FShaderResourceParameter, OutHash);
+	LAYOUT_FIELD(FShaderParameter, SourceSize);
+#else ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION <= 24
+	FShaderResourceParameter SrcTexture;
+	FShaderResourceParameter OutHash;
+	FShaderParameter SourceSize;
+
+	virtual bool Serialize(FArchive& Ar) override
+	{
+		bool bShaderHasOutdatedParams = FGlobalShader::Serialize(Ar);
+		Ar << SrcTexture;
+		Ar << OutHash;
+		Ar << SourceSize;
+		return bShaderHasOutdatedParams;
+	}
+#endif
+
+	FSpoutContentHashCS(const ShaderMetaType::CompiledShaderInitializerType& Initializer) :
+		FGlobalShader(Initializer)
+	{
+		SrcTexture.Bind(Initializer.ParameterMap, TEXT("SrcTexture"));
+		OutHash.Bind(Initializer.ParameterMap, TEXT("OutHash"));
+		SourceSize.Bind(Initializer.ParameterMap, TEXT("SourceSize"));
+	}
+	FSpoutContentHashCS() {}
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+};
+
+IMPLEMENT_SHADER_TYPE(, FSpoutContentHashCS, TEXT("/Plugin/Spout2/SpoutContentHash.usf"), TEXT("MainCS"), SF_Compute)
+
+//////////////////////////////////////////////////////////////////////////
+
+FSpoutContentHasher::FSpoutContentHasher()
+{
+}
+
+FSpoutContentHasher::~FSpoutContentHasher()
+{
+	for (FPendingHash& Hash : Pending)
+		Hash.Buffer.Release();
+}
+
+bool FSpoutContentHasher::Enqueue(FRHICommandListImmediate& RHICmdList, FRHITexture* Texture)
+{
+	check(IsInRenderingThread());
+
+	if (!Texture || NumInFlight == MaxInFlight)
+		return false;
+
+	FPendingHash& Hash = Pending[WriteIndex];
+
+	if (!Hash.Readback.IsValid())
+	{
+		Hash.Buffer.Initialize(TEXT("SpoutContentHash"), sizeof(uint32), 2, PF_R32_UINT, ERHIAccess::UAVCompute, BUF_SourceCopy);
+		Hash.Readback = MakeUnique<FRHIGPUBufferReadback>(TEXT("SpoutContentHashReadback"));
+	}
+
+	SCOPED_DRAW_EVENT(RHICmdList, HashSpoutContent);
+
+	const FIntVector Size = Texture->GetSizeXYZ();
+
+	RHICmdList.Transition(FRHITransitionInfo(Hash.Buffer.UAV, ERHIAccess::Unknown, ERHIAccess::UAVCompute));
+	RHICmdList.ClearUAVUint(Hash.Buffer.UAV, FUintVector4(0, 0, 0, 0));
+
+	TShaderMapRef<FSpoutContentHashCS> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+	FRHIComputeShader* ShaderRHI = ComputeShader.GetComputeShader();
+
+	SetComputePipelineState(RHICmdList, ShaderRHI);
+
+	FShaderResourceViewRHIRef SourceSRV = RHICreateShaderResourceView(Texture->GetTexture2D(), 0);
+	RHICmdList.SetShaderResourceViewParameter(ShaderRHI, ComputeShader->SrcTexture.GetBaseIndex(), SourceSRV);
+	RHICmdList.SetUAVParameter(ShaderRHI, ComputeShader->OutHash.GetBaseIndex(), Hash.Buffer.UAV);
+	SetShaderValue(RHICmdList, ShaderRHI, ComputeShader->SourceSize, FIntPoint(Size.X, Size.Y));
+
+	RHICmdList.DispatchComputeShader(
+		FMath::DivideAndRoundUp(Size.X, FSpoutContentHashCS::GroupSize),
+		FMath::DivideAndRoundUp(Size.Y, FSpoutContentHashCS::GroupSize), 1);
+
+	RHICmdList.SetUAVParameter(ShaderRHI, ComputeShader->OutHash.GetBaseIndex(), nullptr);
+	RHICmdList.Transition(FRHITransitionInfo(Hash.Buffer.UAV, ERHIAccess::UAVCompute, ERHIAccess::CopySrc));
+
+	Hash.Readback->EnqueueCopy(RHICmdList, Hash.Buffer.Buffer);
+
+	WriteIndex = (WriteIndex + 1) % MaxInFlight;
+	++NumInFlight;
+	return true;
+}
+
+TOptional<uint64> FSpoutContentHasher::Poll()
+{
+	check(IsInRenderingThread());
+
+	TOptional<uint64> Newest;
+
+	// readbacks complete in the order they were queued
+	while (NumInFlight > 0)
+	{
+		FPendingHash& Hash = Pending[(WriteIndex - NumInFlight + MaxInFlight) % MaxInFlight];
+		if (!Hash.Readback->IsReady())
+			break;
+
+		const uint32* Words = static_cast<const uint32*>(Hash.Readback->Lock(sizeof(uint32) * 2));
+		Newest = ((uint64)Words[0] << 32) | Words[1];
+		Hash.Readback->Unlock();
+
+		--NumInFlight;
+	}
+
+	return Newest;
+}
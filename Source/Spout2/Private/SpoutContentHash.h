@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RHIResources.h"
+#include "RHIUtilities.h"
+
+class FRHICommandListImmediate;
+class FRHIGPUBufferReadback;
+
+/**
+ * Fingerprints a texture on the GPU and reads the result back without stalling.
+ *
+ * A hash becomes available a few frames after it was queued, once its readback is ready,
+ * so a change detected this way is published with that much delay. Render thread only.
+ */
+class FSpoutContentHasher
+{
+public:
+
+	static constexpr int32 MaxInFlight = 3;
+
+	FSpoutContentHasher();
+	~FSpoutContentHasher();
+
+	FSpoutContentHasher(const FSpoutContentHasher&) = delete;
+	FSpoutContentHasher& operator=(const FSpoutContentHasher&) = delete;
+
+	/** Queues a hash of Texture. False when every readback is still in flight. */
+	bool Enqueue(FRHICommandListImmediate& RHICmdList, FRHITexture* Texture);
+
+	/** Newest hash completed since the last call. */
+	TOptional<uint64> Poll();
+
+private:
+
+	struct FPendingHash
+	{
+		FRWBuffer Buffer;
+		TUniquePtr<FRHIGPUBufferReadback> Readback;
+	};
+
+	FPendingHash Pending[MaxInFlight];
+	int32 WriteIndex = 0;
+	int32 NumInFlight = 0;
+};
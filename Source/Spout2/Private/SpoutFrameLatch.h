@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Decides when a receiver's copy runs within a frame.
+ *
+ * Everything happens on the render thread, in command order: the game thread's tick arms
+ * a request through a render command, the first view family rendered after it latches
+ * the request right before it draws, and the end of the frame latches whatever no view
+ * family took (a minimized window, a world nobody looks at), so a frame is never lost.
+ * A request armed again before it was latched replaces the older one, since each reads
+ * the newest sender frame when it runs.
+ */
+template<typename RequestType>
+class TSpoutFrameLatch
+{
+public:
+
+	struct FStats
+	{
+		uint32 BeforeRender = 0;
+		uint32 EndOfFrame = 0;
+		uint32 Replaced = 0;
+	};
+
+	void Arm(RequestType InRequest)
+	{
+		if (Request.IsSet())
+			++Stats.Replaced;
+
+		Request = MoveTemp(InRequest);
+	}
+
+	void Disarm()
+	{
+		Request.Reset();
+	}
+
+	bool IsArmed() const { return Request.IsSet(); }
+
+	/** Right before a view family renders. */
+	TOptional<RequestType> LatchBeforeRender()
+	{
+		return Take(Stats.BeforeRender);
+	}
+
+	/** After the frame's view families were submitted. */
+	TOptional<RequestType> LatchAtEndOfFrame()
+	{
+		return Take(Stats.EndOfFrame);
+	}
+
+	const FStats& GetStats() const { return Stats; }
+
+private:
+
+	TOptional<RequestType> Take(uint32& Counter)
+	{
+		if (!Request.IsSet())
+			return {};
+
+		++Counter;
+
+		TOptional<RequestType> Result = MoveTemp(Request);
+		Request.Reset();
+		return Result;
+	}
+
+	TOptional<RequestType> Request;
+	FStats Stats;
+};
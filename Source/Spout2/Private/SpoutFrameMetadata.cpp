@@ -0,0 +1,158 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutFrameMetadata.h"
+
+#include "HAL/PlatformAtomics.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformTime.h"
+
+namespace SpoutFrameMetadata
+{
+	// a ring nobody created yet is looked for again after this long
+	static constexpr double OpenRetryDelay = 1.0;
+
+	FSpoutMetadataRing* OpenRing(FSpoutSharedRegion& Region, const FString& SenderName, bool bCreate)
+	{
+		if (!Region.IsValid())
+		{
+			const FString RegionName = FSpoutSharedRegion::MakeName(SenderName, TEXT("SpoutMeta"));
+
+			if (bCreate ? !Region.Create(RegionName, sizeof(FSpoutMetadataRing)) : !Region.Open(RegionName, sizeof(FSpoutMetadataRing)))
+				return nullptr;
+		}
+
+		FSpoutMetadataRing* Ring = Region.As<FSpoutMetadataRing>();
+
+		// new mappings are zero filled, the first side to see one stamps it
+		if (FPlatformAtomics::InterlockedCompareExchange(&Ring->Magic, (int32)FSpoutMetadataRing::MagicValue, 0) == 0)
+			Ring->Version = FSpoutMetadataRing::CurrentVersion;
+
+		if ((uint32)Ring->Magic != FSpoutMetadataRing::MagicValue
+			|| Ring->Version != FSpoutMetadataRing::CurrentVersion)
+			return nullptr;
+
+		return Ring;
+	}
+
+	static void WriteSlot(FSpoutMetadataRing::FSlot& Slot, int64 FrameId, const uint8* Data, int32 Size)
+	{
+		// odd sequence: readers drop whatever they read meanwhile
+		FPlatformAtomics::InterlockedIncrement(&Slot.Sequence);
+		FPlatformMisc::MemoryBarrier();
+
+		Slot.FrameId = FrameId;
+		Slot.Size = Size;
+
+		if (Size > 0)
+			FMemory::Memcpy(Slot.Data, Data, Size);
+
+		FPlatformMisc::MemoryBarrier();
+		FPlatformAtomics::InterlockedIncrement(&Slot.Sequence);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+FSpoutMetadataWriter::FSpoutMetadataWriter(const FString& SenderName)
+	: SenderName(SenderName)
+{
+}
+
+FSpoutMetadataRing* FSpoutMetadataWriter::OpenRing()
+{
+	if (Region.IsValid())
+		return SpoutFrameMetadata::OpenRing(Region, SenderName, true);
+
+	FSpoutMetadataRing* Ring = SpoutFrameMetadata::OpenRing(Region, SenderName, true);
+	if (!Ring)
+		return nullptr;
+
+	// receivers kept the ring of a previous run of this sender alive, its slots belong to other frames
+	for (FSpoutMetadataRing::FSlot& Slot : Ring->Slots)
+		SpoutFrameMetadata::WriteSlot(Slot, 0, nullptr, 0);
+
+	return Ring;
+}
+
+bool FSpoutMetadataWriter::Write(int64 FrameId, const uint8* Data, int32 Size)
+{
+	if (FrameId <= 0)
+		return false;
+
+	FSpoutMetadataRing* Ring = OpenRing();
+	if (!Ring)
+		return false;
+
+	FSpoutMetadataRing::FSlot& Slot = Ring->Slots[FrameId % FSpoutMetadataRing::SlotCount];
+
+	// an oversized blob is dropped whole, the slot still moves to the frame so nothing older shows through
+	const bool bFits = Size >= 0 && Size <= FSpoutMetadataRing::MaxBlobSize;
+	SpoutFrameMetadata::WriteSlot(Slot, FrameId, Data, bFits ? Size : 0);
+
+	return bFits;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+FSpoutMetadataReader::FSpoutMetadataReader(const FString& SenderName)
+	: SenderName(SenderName)
+{
+}
+
+const FSpoutMetadataRing* FSpoutMetadataReader::OpenRing()
+{
+	if (!Region.IsValid())
+	{
+		// a failed open is a kernel call, senders without metadata would cost one every frame
+		const double Now = FPlatformTime::Seconds();
+		if (Now - LastOpenAttempt < SpoutFrameMetadata::OpenRetryDelay)
+			return nullptr;
+
+		LastOpenAttempt = Now;
+	}
+
+	return SpoutFrameMetadata::OpenRing(Region, SenderName, false);
+}
+
+ESpoutMetadataRead FSpoutMetadataReader::Read(int64 FrameId, TArray<uint8>& OutData)
+{
+	OutData.Reset();
+
+	const FSpoutMetadataRing* Ring = FrameId > 0 ? OpenRing() : nullptr;
+	if (!Ring)
+		return ESpoutMetadataRead::Unavailable;
+
+	const FSpoutMetadataRing::FSlot& Slot = Ring->Slots[FrameId % FSpoutMetadataRing::SlotCount];
+
+	const int64 SequenceBefore = FPlatformAtomics::AtomicRead(&Slot.Sequence);
+	if (SequenceBefore & 1)
+		return ESpoutMetadataRead::Overwritten;
+
+	FPlatformMisc::MemoryBarrier();
+
+	const int64 SlotFrameId = Slot.FrameId;
+	const int32 Size = FMath::Clamp(Slot.Size, 0, FSpoutMetadataRing::MaxBlobSize);
+
+	if (SlotFrameId == FrameId && Size > 0)
+	{
+		OutData.SetNumUninitialized(Size);
+		FMemory::Memcpy(OutData.GetData(), Slot.Data, Size);
+	}
+
+	// the sender lapped the ring while we read
+	FPlatformMisc::MemoryBarrier();
+	if (FPlatformAtomics::AtomicRead(&Slot.Sequence) != SequenceBefore)
+	{
+		OutData.Reset();
+		return ESpoutMetadataRead::Overwritten;
+	}
+
+	if (SlotFrameId > FrameId)
+		return ESpoutMetadataRead::Overwritten;
+
+	// an older frame still in the slot: the sender had not attached metadata yet when it published this one
+	if (SlotFrameId != FrameId || Size == 0)
+		return ESpoutMetadataRead::Missing;
+
+	return ESpoutMetadataRead::Found;
+}
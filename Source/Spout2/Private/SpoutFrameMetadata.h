@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SpoutSharedRegion.h"
+
+/**
+ * Per-frame metadata of a sender, such as timecode or camera and lens data, in a region
+ * "<Sender>_SpoutMeta" next to its control block.
+ *
+ * A ring of slots indexed by frame id (see FSpoutControlBlock::PublishedFrameId). The sender
+ * writes a frame's blob before it announces the frame, so a receiver that copied frame N
+ * finds N's blob in slot N % SlotCount with plain memory reads. Each slot is a seqlock, odd
+ * while written: a receiver more than SlotCount frames behind finds a newer frame in the slot,
+ * or catches it being written, and gets nothing rather than another frame's blob.
+ *
+ * Once a sender attached metadata it writes a slot for every frame it publishes, empty when
+ * the frame has none, so a slot never claims a frame it was not written for.
+ */
+struct FSpoutMetadataRing
+{
+	static constexpr uint32 MagicValue = 0x444d5053; // "SPMD"
+	static constexpr uint32 CurrentVersion = 1;
+	static constexpr int32 SlotCount = 32;
+	static constexpr int32 MaxBlobSize = 4096;
+
+	struct FSlot
+	{
+		volatile int64 Sequence;
+		int64 FrameId;
+		int32 Size;
+		uint32 Reserved;
+		uint8 Data[MaxBlobSize];
+	};
+
+	volatile int32 Magic;
+	uint32 Version;
+	FSlot Slots[SlotCount];
+};
+
+enum class ESpoutMetadataRead : uint8
+{
+	Found,
+	// the frame was published without metadata
+	Missing,
+	// a newer frame took the slot, the reader fell more than SlotCount frames behind
+	Overwritten,
+	// the sender never attached metadata, or its ring has another layout
+	Unavailable,
+};
+
+/** The sender's side, only ever used by the thread that publishes its frames. */
+class FSpoutMetadataWriter
+{
+public:
+
+	explicit FSpoutMetadataWriter(const FString& SenderName);
+
+	/**
+	 * Stores Size bytes as the metadata of FrameId, before the frame is announced; Size may be 0.
+	 * False when the blob is larger than MaxBlobSize, the frame then has none, or when the ring is unusable.
+	 */
+	bool Write(int64 FrameId, const uint8* Data, int32 Size);
+
+	const FString& GetSenderName() const { return SenderName; }
+
+private:
+
+	FSpoutMetadataRing* OpenRing();
+
+	FString SenderName;
+	FSpoutSharedRegion Region;
+};
+
+/** The receiver's side. Any one thread at a time. */
+class FSpoutMetadataReader
+{
+public:
+
+	explicit FSpoutMetadataReader(const FString& SenderName);
+
+	/** Metadata of FrameId, OutData is empty unless Found. Opening the ring is retried at most once a second. */
+	ESpoutMetadataRead Read(int64 FrameId, TArray<uint8>& OutData);
+
+	const FString& GetSenderName() const { return SenderName; }
+
+private:
+
+	const FSpoutMetadataRing* OpenRing();
+
+	FString SenderName;
+	FSpoutSharedRegion Region;
+	double LastOpenAttempt = -MAX_dbl;
+};
+
+namespace SpoutFrameMetadata
+{
+	/** Maps and initializes the ring, whichever side comes first. Null on a foreign layout, or when !bCreate and nobody created it. */
+	FSpoutMetadataRing* OpenRing(FSpoutSharedRegion& Region, const FString& SenderName, bool bCreate);
+}
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutFrameNotifier.h"
+
+#include "Misc/ScopeLock.h"
+
+void FSpoutFrameNotifier::Publish(const FSpoutReceivedFrame& Frame)
+{
+	TArray<TPromise<FSpoutReceivedFrame>> Fulfilled;
+	{
+		FScopeLock Lock(&Mutex);
+
+		if (Frame.FrameId == Newest.FrameId)
+			return;
+
+		Newest = Frame;
+		bUndispatched = true;
+		Fulfilled = MoveTemp(Waiters);
+	}
+
+	// outside the lock, continuations may acquire the next frame right away
+	for (TPromise<FSpoutReceivedFrame>& Promise : Fulfilled)
+		Promise.SetValue(Frame);
+}
+
+TFuture<FSpoutReceivedFrame> FSpoutFrameNotifier::AcquireNext()
+{
+	TPromise<FSpoutReceivedFrame> Promise;
+	TFuture<FSpoutReceivedFrame> Future = Promise.GetFuture();
+
+	FScopeLock Lock(&Mutex);
+	Waiters.Add(MoveTemp(Promise));
+	return Future;
+}
+
+bool FSpoutFrameNotifier::TakeUndispatched(FSpoutReceivedFrame& OutFrame)
+{
+	FScopeLock Lock(&Mutex);
+
+	if (!bUndispatched)
+		return false;
+
+	bUndispatched = false;
+	OutFrame = Newest;
+	return true;
+}
+
+void FSpoutFrameNotifier::Cancel()
+{
+	TArray<TPromise<FSpoutReceivedFrame>> Cancelled;
+	{
+		FScopeLock Lock(&Mutex);
+		Cancelled = MoveTemp(Waiters);
+	}
+
+	for (TPromise<FSpoutReceivedFrame>& Promise : Cancelled)
+		Promise.SetValue(FSpoutReceivedFrame());
+}
+
+FSpoutReceivedFrame FSpoutFrameNotifier::GetNewest() const
+{
+	FScopeLock Lock(&Mutex);
+	return Newest;
+}
+
+int32 FSpoutFrameNotifier::GetNumWaiters() const
+{
+	FScopeLock Lock(&Mutex);
+	return Waiters.Num();
+}
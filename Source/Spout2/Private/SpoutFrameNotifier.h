@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "SpoutTypes.h"
+
+/**
+ * Hands the frames a receiver draws to whoever waits for them, so nobody has to poll.
+ *
+ * The thread that drew a frame publishes it: waiting futures are fulfilled right there,
+ * and the frame is kept for the game thread, which takes it once per tick to broadcast
+ * events. Frames published between two takes coalesce, the newest wins. Nothing here
+ * touches the RHI or UObjects.
+ */
+class FSpoutFrameNotifier
+{
+public:
+
+	FSpoutFrameNotifier() {}
+	~FSpoutFrameNotifier() { Cancel(); }
+
+	FSpoutFrameNotifier(const FSpoutFrameNotifier&) = delete;
+	FSpoutFrameNotifier& operator=(const FSpoutFrameNotifier&) = delete;
+
+	/**
+	 * Publishes a drawn frame, from any thread. A frame with the id of the newest one is the same
+	 * frame drawn again and is ignored; any other id counts, so a restarted sender counting from 1 does too.
+	 */
+	void Publish(const FSpoutReceivedFrame& Frame);
+
+	/** Future of the first frame published after this call, fulfilled on the publishing thread. */
+	TFuture<FSpoutReceivedFrame> AcquireNext();
+
+	/** Newest frame published since the last take, false when there is none. */
+	bool TakeUndispatched(FSpoutReceivedFrame& OutFrame);
+
+	/** Fulfills every waiting future with an invalid frame, such as when the receiver goes away. */
+	void Cancel();
+
+	FSpoutReceivedFrame GetNewest() const;
+	int32 GetNumWaiters() const;
+
+private:
+
+	mutable FCriticalSection Mutex;
+	TArray<TPromise<FSpoutReceivedFrame>> Waiters;
+	FSpoutReceivedFrame Newest;
+	bool bUndispatched = false;
+};
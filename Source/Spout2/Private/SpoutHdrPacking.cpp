@@ -0,0 +1,305 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutHdrPacking.h"
+
+#include <limits>
+
+#include "SpoutPixelFormats.h"
+
+namespace SpoutHdrPacking
+{
+	// SMPTE ST 2084
+	static constexpr float PQ_M1 = 2610.f / 16384.f;
+	static constexpr float PQ_M2 = 2523.f / 4096.f * 128.f;
+	static constexpr float PQ_C1 = 3424.f / 4096.f;
+	static constexpr float PQ_C2 = 2413.f / 4096.f * 32.f;
+	static constexpr float PQ_C3 = 2392.f / 4096.f * 32.f;
+
+	static constexpr uint32 UsageTagPrefix = 0x53480000; // 'S' 'H'
+
+	uint32 GetUsageTag(ESpoutHdrTransport Transport)
+	{
+		return Transport == ESpoutHdrTransport::None ? 0 : UsageTagPrefix | (uint32)Transport;
+	}
+
+	ESpoutHdrTransport FromUsageTag(uint32 Usage)
+	{
+		if ((Usage & 0xffff0000) != UsageTagPrefix)
+			return ESpoutHdrTransport::None;
+
+		const uint32 Transport = Usage & 0xffff;
+		return Transport <= (uint32)ESpoutHdrTransport::Float11 ? (ESpoutHdrTransport)Transport : ESpoutHdrTransport::None;
+	}
+
+	uint32 GetSharedFormat(ESpoutHdrTransport Transport)
+	{
+		switch (Transport)
+		{
+		case ESpoutHdrTransport::PQ10:
+		case ESpoutHdrTransport::Log10:
+			return SpoutPixelFormats::DXGI_R10G10B10A2_UNorm;
+		case ESpoutHdrTransport::Float11:
+			return SpoutPixelFormats::DXGI_R11G11B10_Float;
+		default:
+			return SpoutPixelFormats::DXGI_Unknown;
+		}
+	}
+
+	float EncodePQ(float Linear)
+	{
+		const float Y = FMath::Clamp(Linear * PQReferenceNits / 10000.f, 0.f, 1.f);
+		const float YM1 = FMath::Pow(Y, PQ_M1);
+		return FMath::Pow((PQ_C1 + PQ_C2 * YM1) / (1.f + PQ_C3 * YM1), PQ_M2);
+	}
+
+	float DecodePQ(float Encoded)
+	{
+		const float EM2 = FMath::Pow(FMath::Clamp(Encoded, 0.f, 1.f), 1.f / PQ_M2);
+		const float Y = FMath::Pow(FMath::Max(EM2 - PQ_C1, 0.f) / (PQ_C2 - PQ_C3 * EM2), 1.f / PQ_M1);
+		return Y * 10000.f / PQReferenceNits;
+	}
+
+	float EncodeLog(float Linear)
+	{
+		if (Linear <= FMath::Exp2(LogMinExponent))
+			return 0.f;
+		return FMath::Clamp((FMath::Log2(Linear) - LogMinExponent) / (LogMaxExponent - LogMinExponent), 0.f, 1.f);
+	}
+
+	float DecodeLog(float Encoded)
+	{
+		if (Encoded <= 0.f)
+			return 0.f;
+		return FMath::Exp2(Encoded * (LogMaxExponent - LogMinExponent) + LogMinExponent);
+	}
+
+	uint32 FloatToUFloat(float Value, uint32 MantissaBits)
+	{
+		// unsigned float with a 5 bit exponent (bias 15), as in DXGI_FORMAT_R11G11B10_FLOAT
+		const uint32 MaxFinite = (30u << MantissaBits) | ((1u << MantissaBits) - 1);
+
+		uint32 Bits;
+		FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+
+		const uint32 Exponent32 = (Bits >> 23) & 0xff;
+		const uint32 Mantissa32 = Bits & 0x7fffff;
+
+		if (Exponent32 == 0xff)
+		{
+			if (Mantissa32)
+				return (31u << MantissaBits) | 1; // NaN
+			return (Bits & 0x80000000) ? 0 : (31u << MantissaBits); // +inf, -inf clamps to 0
+		}
+
+		if ((Bits & 0x80000000) || Exponent32 == 0)
+			return 0;
+
+		const int32 Exponent = (int32)Exponent32 - 127 + 15;
+		const uint32 Shift = 23 - MantissaBits;
+
+		if (Exponent <= 0)
+		{
+			// denormal result, round half up
+			const uint32 DenormShift = Shift + 1 - Exponent;
+			if (DenormShift > 24)
+				return 0;
+			const uint32 Mantissa = Mantissa32 | 0x800000;
+			return (Mantissa + (1u << (DenormShift - 1))) >> DenormShift;
+		}
+
+		if (Exponent >= 31)
+			return MaxFinite;
+
+		// round half up, a mantissa carry correctly bumps the exponent
+		uint32 Result = ((uint32)Exponent << MantissaBits) | (Mantissa32 >> Shift);
+		Result += (Mantissa32 >> (Shift - 1)) & 1;
+		return FMath::Min(Result, MaxFinite);
+	}
+
+	float UFloatToFloat(uint32 Bits, uint32 MantissaBits)
+	{
+		const uint32 Exponent = Bits >> MantissaBits;
+		const uint32 Mantissa = Bits & ((1u << MantissaBits) - 1);
+		const float MantissaScale = (float)(1u << MantissaBits);
+
+		if (Exponent == 31)
+			return Mantissa ? std::numeric_limits<float>::quiet_NaN() : std::numeric_limits<float>::infinity();
+
+		if (Exponent == 0)
+			return Mantissa / MantissaScale * FMath::Exp2(-14.f);
+
+		return (1.f + Mantissa / MantissaScale) * FMath::Exp2((float)Exponent - 15.f);
+	}
+
+	static FORCEINLINE uint32 QuantizeUNorm(float Value, uint32 MaxValue)
+	{
+		return (uint32)FMath::FloorToInt(FMath::Clamp(Value, 0.f, 1.f) * MaxValue + 0.5f);
+	}
+
+	uint32 PackTexel(const FLinearColor& Color, ESpoutHdrTransport Transport)
+	{
+		switch (Transport)
+		{
+		case ESpoutHdrTransport::PQ10:
+			return QuantizeUNorm(EncodePQ(Color.R), 1023)
+				| (QuantizeUNorm(EncodePQ(Color.G), 1023) << 10)
+				| (QuantizeUNorm(EncodePQ(Color.B), 1023) << 20)
+				| (QuantizeUNorm(Color.A, 3) << 30);
+		case ESpoutHdrTransport::Log10:
+			return QuantizeUNorm(EncodeLog(Color.R), 1023)
+				| (QuantizeUNorm(EncodeLog(Color.G), 1023) << 10)
+				| (QuantizeUNorm(EncodeLog(Color.B), 1023) << 20)
+				| (QuantizeUNorm(Color.A, 3) << 30);
+		case ESpoutHdrTransport::Float11:
+			return FloatToUFloat(Color.R, 6)
+				| (FloatToUFloat(Color.G, 6) << 11)
+				| (FloatToUFloat(Color.B, 5) << 22);
+		default:
+			return Color.ToFColor(false).DWColor();
+		}
+	}
+
+	FLinearColor UnpackTexel(uint32 Packed, ESpoutHdrTransport Transport)
+	{
+		switch (Transport)
+		{
+		case ESpoutHdrTransport::PQ10:
+			return FLinearColor(
+				DecodePQ((Packed & 1023) / 1023.f),
+				DecodePQ(((Packed >> 10) & 1023) / 1023.f),
+				DecodePQ(((Packed >> 20) & 1023) / 1023.f),
+				(Packed >> 30) / 3.f);
+		case ESpoutHdrTransport::Log10:
+			return FLinearColor(
+				DecodeLog((Packed & 1023) / 1023.f),
+				DecodeLog(((Packed >> 10) & 1023) / 1023.f),
+				DecodeLog(((Packed >> 20) & 1023) / 1023.f),
+				(Packed >> 30) / 3.f);
+		case ESpoutHdrTransport::Float11:
+			return FLinearColor(
+				UFloatToFloat(Packed & 0x7ff, 6),
+				UFloatToFloat((Packed >> 11) & 0x7ff, 6),
+				UFloatToFloat(Packed >> 22, 5),
+				1.f);
+		default:
+			return FColor(Packed).ReinterpretAsLinear();
+		}
+	}
+
+	void PackImage(const FLinearColor* Src, uint32* Dst, int32 NumPixels, ESpoutHdrTransport Transport)
+	{
+		if (Transport != ESpoutHdrTransport::PQ10)
+		{
+			for (int32 Index = 0; Index < NumPixels; ++Index)
+				Dst[Index] = PackTexel(Src[Index], Transport);
+			return;
+		}
+
+		// the PQ curve dominates the cost, evaluate it on all channels at once
+		const VectorRegister Scale = VectorSetFloat1(PQReferenceNits / 10000.f);
+		const VectorRegister M1 = VectorSetFloat1(PQ_M1);
+		const VectorRegister M2 = VectorSetFloat1(PQ_M2);
+		const VectorRegister C1 = VectorSetFloat1(PQ_C1);
+		const VectorRegister C2 = VectorSetFloat1(PQ_C2);
+		const VectorRegister C3 = VectorSetFloat1(PQ_C3);
+		const VectorRegister Max10 = VectorSetFloat1(1023.f);
+		const VectorRegister Half = VectorSetFloat1(0.5f);
+
+		for (int32 Index = 0; Index < NumPixels; ++Index)
+		{
+			VectorRegister Y = VectorMultiply(VectorLoad(&Src[Index].R), Scale);
+			Y = VectorMin(VectorMax(Y, VectorZero()), VectorOne());
+
+			const VectorRegister YM1 = VectorPow(Y, M1);
+			const VectorRegister Ratio = VectorDivide(VectorMultiplyAdd(C2, YM1, C1), VectorMultiplyAdd(C3, YM1, VectorOne()));
+			const VectorRegister Encoded = VectorMultiplyAdd(VectorPow(Ratio, M2), Max10, Half);
+
+			float Codes[4];
+			VectorStore(Encoded, Codes);
+
+			Dst[Index] = (uint32)FMath::FloorToInt(Codes[0])
+				| ((uint32)FMath::FloorToInt(Codes[1]) << 10)
+				| ((uint32)FMath::FloorToInt(Codes[2]) << 20)
+				| (QuantizeUNorm(Src[Index].A, 3) << 30);
+		}
+	}
+
+	// every 11 and 10 bit unsigned float decoded once, an exact lookup beats the bit twiddling
+	struct FUFloatTables
+	{
+		float Mantissa6[2048];
+		float Mantissa5[1024];
+
+		FUFloatTables()
+		{
+			for (uint32 Bits = 0; Bits < 2048; ++Bits)
+				Mantissa6[Bits] = UFloatToFloat(Bits, 6);
+			for (uint32 Bits = 0; Bits < 1024; ++Bits)
+				Mantissa5[Bits] = UFloatToFloat(Bits, 5);
+		}
+	};
+
+	static const FUFloatTables& GetUFloatTables()
+	{
+		static const FUFloatTables Tables;
+		return Tables;
+	}
+
+	void UnpackImage(const uint32* Src, FLinearColor* Dst, int32 NumPixels, ESpoutHdrTransport Transport)
+	{
+		if (Transport == ESpoutHdrTransport::Float11)
+		{
+			const FUFloatTables& Tables = GetUFloatTables();
+
+			for (int32 Index = 0; Index < NumPixels; ++Index)
+			{
+				const uint32 Packed = Src[Index];
+				Dst[Index] = FLinearColor(Tables.Mantissa6[Packed & 0x7ff], Tables.Mantissa6[(Packed >> 11) & 0x7ff], Tables.Mantissa5[Packed >> 22], 1.f);
+			}
+			return;
+		}
+
+		if (Transport != ESpoutHdrTransport::PQ10 && Transport != ESpoutHdrTransport::Log10)
+		{
+			for (int32 Index = 0; Index < NumPixels; ++Index)
+				Dst[Index] = UnpackTexel(Src[Index], Transport);
+			return;
+		}
+
+		// as in PackImage, the curve is evaluated on the three color channels at once
+		const VectorRegister InvMax10 = VectorSetFloat1(1.f / 1023.f);
+		const VectorRegister InvM1 = VectorSetFloat1(1.f / PQ_M1);
+		const VectorRegister InvM2 = VectorSetFloat1(1.f / PQ_M2);
+		const VectorRegister C1 = VectorSetFloat1(PQ_C1);
+		const VectorRegister C2 = VectorSetFloat1(PQ_C2);
+		const VectorRegister C3 = VectorSetFloat1(PQ_C3);
+		const VectorRegister Scale = VectorSetFloat1(10000.f / PQReferenceNits);
+		const VectorRegister Two = VectorSetFloat1(2.f);
+		const VectorRegister LogRange = VectorSetFloat1(LogMaxExponent - LogMinExponent);
+		const VectorRegister LogMin = VectorSetFloat1(LogMinExponent);
+
+		for (int32 Index = 0; Index < NumPixels; ++Index)
+		{
+			const uint32 Packed = Src[Index];
+			const VectorRegister Codes = MakeVectorRegister((float)(Packed & 1023), (float)((Packed >> 10) & 1023), (float)((Packed >> 20) & 1023), 0.f);
+			const VectorRegister Encoded = VectorMultiply(Codes, InvMax10);
+
+			VectorRegister Linear;
+			if (Transport == ESpoutHdrTransport::PQ10)
+			{
+				const VectorRegister EM2 = VectorPow(Encoded, InvM2);
+				const VectorRegister Ratio = VectorDivide(VectorMax(VectorSubtract(EM2, C1), VectorZero()), VectorSubtract(C2, VectorMultiply(C3, EM2)));
+				Linear = VectorMultiply(VectorPow(Ratio, InvM1), Scale);
+			}
+			else
+			{
+				// code 0 is below the range and decodes to 0, not to its lower end
+				Linear = VectorPow(Two, VectorMultiplyAdd(Encoded, LogRange, LogMin));
+				Linear = VectorBitwiseAnd(Linear, VectorCompareGT(Codes, VectorZero()));
+			}
+
+			VectorStore(Linear, &Dst[Index].R);
+			Dst[Index].A = (Packed >> 30) / 3.f;
+		}
+	}
+}
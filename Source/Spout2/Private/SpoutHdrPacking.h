@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SpoutTypes.h"
+
+/**
+ * Packed HDR transports, CPU side. The sender pack shader (SpoutSenderPackShader.usf)
+ * and the receiver decode in SpoutReceiverCopyShader.usf implement the same curves.
+ *
+ * Packed senders keep announcing a plain DXGI format, so legacy receivers see
+ * R10G10B10A2 or R11G11B10. The curve is tagged in SharedTextureInfo::usage.
+ *
+ * Worst relative round-trip error inside each encoding's range:
+ *   PQ10    1.0% from 0.01 (1 nit) to 100, 1.9% from 0.001 to 0.01
+ *   Log10   0.7% from 2^-11.99 to 2^8, values below decode to 0
+ *   Float11 0.8% for R and G, 1.6% for B, from 2^-14 to 64000
+ */
+namespace SpoutHdrPacking
+{
+	/** Nits represented by a linear scene value of 1.0 in PQ10. */
+	static constexpr float PQReferenceNits = 100.f;
+
+	static constexpr float LogMinExponent = -12.f;
+	static constexpr float LogMaxExponent = 8.f;
+
+	/** SharedTextureInfo::usage tags, "SH" followed by the transport. */
+	uint32 GetUsageTag(ESpoutHdrTransport Transport);
+	ESpoutHdrTransport FromUsageTag(uint32 Usage);
+
+	/** DXGI format of the shared texture for a transport, 0 for None. */
+	uint32 GetSharedFormat(ESpoutHdrTransport Transport);
+
+	float EncodePQ(float Linear);
+	float DecodePQ(float Encoded);
+	float EncodeLog(float Linear);
+	float DecodeLog(float Encoded);
+
+	uint32 FloatToUFloat(float Value, uint32 MantissaBits);
+	float UFloatToFloat(uint32 Bits, uint32 MantissaBits);
+
+	uint32 PackTexel(const FLinearColor& Color, ESpoutHdrTransport Transport);
+	FLinearColor UnpackTexel(uint32 Packed, ESpoutHdrTransport Transport);
+
+	void PackImage(const FLinearColor* Src, uint32* Dst, int32 NumPixels, ESpoutHdrTransport Transport);
+	void UnpackImage(const uint32* Src, FLinearColor* Dst, int32 NumPixels, ESpoutHdrTransport Transport);
+}
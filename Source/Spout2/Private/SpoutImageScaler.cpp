@@ -0,0 +1,233 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutImageScaler.h"
+
+namespace SpoutImageScaler
+{
+	static float Lanczos2(float X)
+	{
+		X = FMath::Abs(X);
+		if (X < 1e-5f)
+			return 1.f;
+		if (X >= 2.f)
+			return 0.f;
+
+		const float PX = PI * X;
+		return 2.f * FMath::Sin(PX) * FMath::Sin(PX * 0.5f) / (PX * PX);
+	}
+
+	/** Normalized, clamped taps of every destination pixel along one axis. */
+	struct FAxisTaps
+	{
+		// per destination pixel, no taps outside the source
+		TArray<int32> Offsets;
+		TArray<int32> Counts;
+
+		TArray<int32> Indices;
+		TArray<float> Weights;
+	};
+
+	static void ComputeAxisTaps(ESpoutScaleFilter Filter, int32 SrcSize, int32 DstSize, float UVScale, float UVBias, float FilterScale, FAxisTaps& Out)
+	{
+		float Scale, Radius;
+		GetKernelExtent(Filter, FilterScale, Scale, Radius);
+
+		Out.Offsets.SetNumUninitialized(DstSize);
+		Out.Counts.SetNumUninitialized(DstSize);
+		Out.Indices.Reset(DstSize * 4);
+		Out.Weights.Reset(DstSize * 4);
+
+		for (int32 d = 0; d < DstSize; ++d)
+		{
+			const float UV = ((d + 0.5f) / DstSize) * UVScale + UVBias;
+			const float Position = UV * SrcSize;
+
+			Out.Offsets[d] = Out.Indices.Num();
+			Out.Counts[d] = 0;
+
+			// outside the source in Fit mode
+			if (UV < 0.f || UV > 1.f)
+				continue;
+
+			if (Filter == ESpoutScaleFilter::Point)
+			{
+				Out.Indices.Add(FMath::Clamp(FMath::FloorToInt(Position), 0, SrcSize - 1));
+				Out.Weights.Add(1.f);
+				Out.Counts[d] = 1;
+				continue;
+			}
+
+			const int32 First = FMath::FloorToInt(Position - Radius);
+			const int32 Last = FMath::Min(FMath::CeilToInt(Position + Radius) - 1, First + MaxTaps - 1);
+
+			float TapWeights[MaxTaps];
+			float WeightSum = 0.f;
+			for (int32 Index = First; Index <= Last; ++Index)
+			{
+				TapWeights[Index - First] = AxisWeight(Filter, Index, Position, Scale);
+				WeightSum += TapWeights[Index - First];
+			}
+
+			// the shader draws black where the weights cancel out
+			if (WeightSum == 0.f)
+				continue;
+
+			for (int32 Index = First; Index <= Last; ++Index)
+			{
+				if (TapWeights[Index - First] == 0.f)
+					continue;
+
+				Out.Indices.Add(FMath::Clamp(Index, 0, SrcSize - 1));
+				Out.Weights.Add(TapWeights[Index - First] / WeightSum);
+			}
+
+			Out.Counts[d] = Out.Indices.Num() - Out.Offsets[d];
+		}
+	}
+
+	FVector4 ComputeUVScaleBias(int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, ESpoutScaleMode Mode)
+	{
+		if (Mode == ESpoutScaleMode::Stretch
+			|| SrcWidth <= 0 || SrcHeight <= 0 || DstWidth <= 0 || DstHeight <= 0)
+			return FVector4(1.f, 1.f, 0.f, 0.f);
+
+		const float SrcAspect = (float)SrcWidth / SrcHeight;
+		const float DstAspect = (float)DstWidth / DstHeight;
+
+		if (Mode == ESpoutScaleMode::Fit)
+		{
+			// the source occupies a centered fraction of the destination, the rest maps outside [0,1]
+			if (SrcAspect > DstAspect)
+			{
+				const float Fraction = DstAspect / SrcAspect;
+				return FVector4(1.f, 1.f / Fraction, 0.f, -(1.f - Fraction) / (2.f * Fraction));
+			}
+			const float Fraction = SrcAspect / DstAspect;
+			return FVector4(1.f / Fraction, 1.f, -(1.f - Fraction) / (2.f * Fraction), 0.f);
+		}
+
+		// Fill: a centered fraction of the source covers the whole destination
+		if (SrcAspect > DstAspect)
+		{
+			const float Fraction = DstAspect / SrcAspect;
+			return FVector4(Fraction, 1.f, (1.f - Fraction) * 0.5f, 0.f);
+		}
+		const float Fraction = SrcAspect / DstAspect;
+		return FVector4(1.f, Fraction, 0.f, (1.f - Fraction) * 0.5f);
+	}
+
+	FVector2D ComputeFilterScale(int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, const FVector4& UVScaleBias)
+	{
+		return FVector2D(
+			DstWidth > 0 ? SrcWidth * UVScaleBias.X / DstWidth : 1.f,
+			DstHeight > 0 ? SrcHeight * UVScaleBias.Y / DstHeight : 1.f);
+	}
+
+	float AxisWeight(ESpoutScaleFilter Filter, int32 Index, float Position, float Scale)
+	{
+		switch (Filter)
+		{
+		case ESpoutScaleFilter::Box:
+		{
+			const float Radius = 0.5f * Scale;
+			return FMath::Max(0.f, FMath::Min((float)Index + 1.f, Position + Radius) - FMath::Max((float)Index, Position - Radius));
+		}
+		case ESpoutScaleFilter::Lanczos:
+			return Lanczos2((Index + 0.5f - Position) / Scale);
+		case ESpoutScaleFilter::Bilinear:
+			return FMath::Max(0.f, 1.f - FMath::Abs(Index + 0.5f - Position));
+		default:
+			return Index == FMath::FloorToInt(Position) ? 1.f : 0.f;
+		}
+	}
+
+	void GetKernelExtent(ESpoutScaleFilter Filter, float FilterScale, float& OutScale, float& OutRadius)
+	{
+		switch (Filter)
+		{
+		case ESpoutScaleFilter::Box:
+			OutScale = FMath::Clamp(FilterScale, 1.f, (float)(MaxTaps - 1));
+			OutRadius = 0.5f * OutScale;
+			break;
+		case ESpoutScaleFilter::Lanczos:
+			OutScale = FMath::Clamp(FilterScale, 1.f, (float)(MaxTaps - 1) / 4.f);
+			OutRadius = 2.f * OutScale;
+			break;
+		case ESpoutScaleFilter::Bilinear:
+			OutScale = 1.f;
+			OutRadius = 1.f;
+			break;
+		default:
+			OutScale = 1.f;
+			OutRadius = 0.5f;
+			break;
+		}
+	}
+
+	void ScaleImage(
+		const FLinearColor* Src, int32 SrcWidth, int32 SrcHeight,
+		FLinearColor* Dst, int32 DstWidth, int32 DstHeight,
+		ESpoutScaleFilter Filter, ESpoutScaleMode Mode)
+	{
+		check(Src && Dst && Src != Dst);
+
+		if (SrcWidth <= 0 || SrcHeight <= 0 || DstWidth <= 0 || DstHeight <= 0)
+			return;
+
+		const FVector4 UVScaleBias = ComputeUVScaleBias(SrcWidth, SrcHeight, DstWidth, DstHeight, Mode);
+		const FVector2D FilterScale = ComputeFilterScale(SrcWidth, SrcHeight, DstWidth, DstHeight, UVScaleBias);
+
+		// the 2D kernel is the product of two axis kernels, so the image is filtered along rows, then columns
+		FAxisTaps Columns, Rows;
+		ComputeAxisTaps(Filter, SrcWidth, DstWidth, UVScaleBias.X, UVScaleBias.Z, FilterScale.X, Columns);
+		ComputeAxisTaps(Filter, SrcHeight, DstHeight, UVScaleBias.Y, UVScaleBias.W, FilterScale.Y, Rows);
+
+		// only the source rows some destination row reads
+		int32 FirstRow = SrcHeight, LastRow = -1;
+		for (int32 Index : Rows.Indices)
+		{
+			FirstRow = FMath::Min(FirstRow, Index);
+			LastRow = FMath::Max(LastRow, Index);
+		}
+
+		TArray<FLinearColor> Filtered;
+		if (LastRow >= FirstRow)
+			Filtered.SetNumUninitialized((LastRow - FirstRow + 1) * DstWidth);
+
+		for (int32 Row = FirstRow; Row <= LastRow; ++Row)
+		{
+			const FLinearColor* SrcLine = Src + (SIZE_T)Row * SrcWidth;
+			FLinearColor* FilteredLine = Filtered.GetData() + (SIZE_T)(Row - FirstRow) * DstWidth;
+
+			for (int32 x = 0; x < DstWidth; ++x)
+			{
+				const int32* Indices = Columns.Indices.GetData() + Columns.Offsets[x];
+				const float* Weights = Columns.Weights.GetData() + Columns.Offsets[x];
+
+				VectorRegister Sum = VectorZero();
+				for (int32 Tap = 0; Tap < Columns.Counts[x]; ++Tap)
+					Sum = VectorMultiplyAdd(VectorLoad(&SrcLine[Indices[Tap]].R), VectorSetFloat1(Weights[Tap]), Sum);
+
+				VectorStore(Sum, &FilteredLine[x].R);
+			}
+		}
+
+		for (int32 y = 0; y < DstHeight; ++y)
+		{
+			FLinearColor* DstLine = Dst + (SIZE_T)y * DstWidth;
+			FMemory::Memzero(DstLine, DstWidth * sizeof(FLinearColor));
+
+			const int32* Indices = Rows.Indices.GetData() + Rows.Offsets[y];
+			const float* Weights = Rows.Weights.GetData() + Rows.Offsets[y];
+
+			for (int32 Tap = 0; Tap < Rows.Counts[y]; ++Tap)
+			{
+				const FLinearColor* FilteredLine = Filtered.GetData() + (SIZE_T)(Indices[Tap] - FirstRow) * DstWidth;
+				const VectorRegister Weight = VectorSetFloat1(Weights[Tap]);
+
+				for (int32 x = 0; x < DstWidth; ++x)
+					VectorStore(VectorMultiplyAdd(VectorLoad(&FilteredLine[x].R), Weight, VectorLoad(&DstLine[x].R)), &DstLine[x].R);
+			}
+		}
+	}
+}
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SpoutTypes.h"
+
+/**
+ * CPU reference of the filtered scaling done by SpoutReceiverCopyShader.usf.
+ * Uses the same texel-space kernel math as the shader, with clamp addressing,
+ * and accumulates pixels with the engine's vector intrinsics.
+ */
+namespace SpoutImageScaler
+{
+	/** Taps per axis, mirrors SPOUT_MAX_TAPS in the shader. */
+	static constexpr int32 MaxTaps = 32;
+
+	/**
+	 * Maps destination UV to source UV (SrcUV = DstUV * XY + ZW) for the given fit mode.
+	 * Fit letterboxes, Fill crops the source to the destination aspect.
+	 */
+	FVector4 ComputeUVScaleBias(int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, ESpoutScaleMode Mode);
+
+	/** Source texels covered by one destination pixel, per axis. */
+	FVector2D ComputeFilterScale(int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, const FVector4& UVScaleBias);
+
+	/** Kernel weight of source texel Index for a sample at texel-space Position. */
+	float AxisWeight(ESpoutScaleFilter Filter, int32 Index, float Position, float Scale);
+
+	/** Clamped kernel scale and radius in source texels, with the shader's limits. */
+	void GetKernelExtent(ESpoutScaleFilter Filter, float FilterScale, float& OutScale, float& OutRadius);
+
+	/**
+	 * Scales decoded texels (see SpoutPixelConversion::DecodeTexel) as SampleSource does, one axis at a time.
+	 * Destination pixels outside the source in Fit mode are transparent black.
+	 */
+	void ScaleImage(
+		const FLinearColor* Src, int32 SrcWidth, int32 SrcHeight,
+		FLinearColor* Dst, int32 DstWidth, int32 DstHeight,
+		ESpoutScaleFilter Filter, ESpoutScaleMode Mode);
+}
@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutJitterBuffer.h"
+
+namespace SpoutJitterBuffer
+{
+	// weight of the newest interval, low enough that one late publish does not move the delay
+	static constexpr double IntervalSmoothing = 0.05;
+}
+
+void FSpoutJitterBuffer::Reset(int32 Capacity)
+{
+	Frames.Reset();
+	Frames.SetNum(FMath::Max(Capacity, 0));
+
+	NewestFrameId = 0;
+	NewestTime = 0.0;
+	SelectedFrameId = 0;
+	SelectedTime = 0.0;
+	FrameInterval = 0.0;
+	Latency = 0.0;
+}
+
+int32 FSpoutJitterBuffer::Push(int64 FrameId, double Time)
+{
+	if (Frames.Num() == 0 || FrameId <= NewestFrameId)
+		return INDEX_NONE;
+
+	// per frame id, the receiver only sees some of the sender's frames
+	if (NewestFrameId > 0 && Time > NewestTime)
+	{
+		const double Interval = (Time - NewestTime) / (FrameId - NewestFrameId);
+		FrameInterval = FrameInterval > 0.0 ? FMath::Lerp(FrameInterval, Interval, SpoutJitterBuffer::IntervalSmoothing) : Interval;
+	}
+
+	NewestFrameId = FrameId;
+	NewestTime = Time;
+
+	int32 Slot = INDEX_NONE;
+
+	for (int32 Index = 0; Index < Frames.Num(); ++Index)
+	{
+		const FFrame& Frame = Frames[Index];
+
+		if (Frame.FrameId == 0)
+		{
+			Slot = Index;
+			break;
+		}
+
+		if (Slot == INDEX_NONE || Frame.FrameId < Frames[Slot].FrameId)
+			Slot = Index;
+	}
+
+	Frames[Slot].FrameId = FrameId;
+	Frames[Slot].Time = Time;
+	return Slot;
+}
+
+int32 FSpoutJitterBuffer::Select(ESpoutJitterPolicy Policy, double Now)
+{
+	const double Target = Now - (Policy == ESpoutJitterPolicy::LowestLatency ? 0.0 : GetTargetDelay());
+
+	int32 Best = INDEX_NONE;
+	int32 Selected = INDEX_NONE;
+	int32 Next = INDEX_NONE;
+
+	for (int32 Index = 0; Index < Frames.Num(); ++Index)
+	{
+		const FFrame& Frame = Frames[Index];
+		if (Frame.FrameId == 0)
+			continue;
+
+		if (Frame.FrameId == SelectedFrameId)
+			Selected = Index;
+
+		if (Frame.FrameId > SelectedFrameId && (Next == INDEX_NONE || Frame.FrameId < Frames[Next].FrameId))
+			Next = Index;
+
+		switch (Policy)
+		{
+		case ESpoutJitterPolicy::LowestLatency:
+			if (Best == INDEX_NONE || Frame.FrameId > Frames[Best].FrameId)
+				Best = Index;
+			break;
+
+		case ESpoutJitterPolicy::SmoothCadence:
+			if (Frame.Time <= Target && (Best == INDEX_NONE || Frame.FrameId > Frames[Best].FrameId))
+				Best = Index;
+			break;
+
+		case ESpoutJitterPolicy::NearestTimestamp:
+		{
+			// ties go to the newer frame
+			const double Distance = FMath::Abs(Frame.Time - Target);
+			const double BestDistance = Best != INDEX_NONE ? FMath::Abs(Frames[Best].Time - Target) : 0.0;
+
+			if (Best == INDEX_NONE || Distance < BestDistance || (Distance == BestDistance && Frame.FrameId > Frames[Best].FrameId))
+				Best = Index;
+			break;
+		}
+		}
+	}
+
+	// nothing old enough, or only frames behind the screen: hold the selected frame, or step to the next one once it was replaced
+	if (Best == INDEX_NONE || Frames[Best].FrameId < SelectedFrameId)
+		Best = Selected != INDEX_NONE ? Selected : Next;
+
+	if (Best == INDEX_NONE)
+		return INDEX_NONE;
+
+	SelectedFrameId = Frames[Best].FrameId;
+	SelectedTime = Frames[Best].Time;
+	Latency = Now - Frames[Best].Time;
+	return Best;
+}
+
+int32 FSpoutJitterBuffer::GetOccupancy() const
+{
+	int32 Count = 0;
+	for (const FFrame& Frame : Frames)
+	{
+		if (Frame.FrameId > SelectedFrameId)
+			++Count;
+	}
+	return Count;
+}
+
+double FSpoutJitterBuffer::GetTargetDelay() const
+{
+	return FMath::Max(Frames.Num() - 1, 0) * FrameInterval;
+}
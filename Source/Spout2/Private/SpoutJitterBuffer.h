@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SpoutTypes.h"
+
+namespace SpoutJitterBuffer
+{
+	/** Most slots a receiver may ask for. */
+	static constexpr int32 MaxFrames = 8;
+}
+
+/**
+ * Frame selection of a receiver's jitter buffer, without any texture.
+ *
+ * Frames are identified by the sender's frame id and the time the sender published them
+ * (see FSpoutPublishedFrames), so the choice depends on the sender's cadence rather than on
+ * when the receiver happened to tick. The caller keeps one texture per slot: Push says which
+ * slot a new frame's pixels go to, Select which slot to show.
+ */
+class FSpoutJitterBuffer
+{
+public:
+
+	/** Empties the buffer and gives it Capacity slots. */
+	void Reset(int32 Capacity);
+
+	int32 GetCapacity() const { return Frames.Num(); }
+
+	/**
+	 * Buffers a frame published at Time, over the oldest one when full.
+	 * Returns the slot its pixels belong in, INDEX_NONE when it is not newer than every frame seen.
+	 */
+	int32 Push(int64 FrameId, double Time);
+
+	/** Slot to show at Now, INDEX_NONE while empty. Never goes back to a frame older than the last one selected. */
+	int32 Select(ESpoutJitterPolicy Policy, double Now);
+
+	/** Frame id of the last Select, 0 before. */
+	int64 GetSelectedFrameId() const { return SelectedFrameId; }
+
+	/** Publish time of the frame of the last Select. */
+	double GetSelectedTime() const { return SelectedTime; }
+
+	/** Buffered frames newer than the selected one. */
+	int32 GetOccupancy() const;
+
+	/** Now minus the publish time of the selected frame, as of the last Select. */
+	double GetLatency() const { return Latency; }
+
+	/** Smoothed interval between the sender's publishes, 0 until two frames were pushed. */
+	double GetFrameInterval() const { return FrameInterval; }
+
+	/** How long SmoothCadence and NearestTimestamp hold frames: one interval per slot but the newest. */
+	double GetTargetDelay() const;
+
+private:
+
+	struct FFrame
+	{
+		// zero while the slot is empty
+		int64 FrameId = 0;
+		double Time = 0.0;
+	};
+
+	TArray<FFrame> Frames;
+
+	int64 NewestFrameId = 0;
+	double NewestTime = 0.0;
+	int64 SelectedFrameId = 0;
+	double SelectedTime = 0.0;
+
+	double FrameInterval = 0.0;
+	double Latency = 0.0;
+};
@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutLateLatch.h"
+
+#include "Misc/CoreDelegates.h"
+#include "RenderGraphBuilder.h"
+#include "RenderingThread.h"
+#include "RHICommandList.h"
+#include "SpoutStats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Late Latched Copies"), STAT_SpoutLateLatched, STATGROUP_Spout2);
+DECLARE_DWORD_COUNTER_STAT(TEXT("End Of Frame Copies"), STAT_SpoutEndOfFrameLatched, STATGROUP_Spout2);
+
+FSpoutLateLatchExtension::FSpoutLateLatchExtension(const FAutoRegister& AutoRegister, FSpoutFrameLatchRef InLatch, FSceneInterface* InScene)
+	: FSceneViewExtensionBase(AutoRegister)
+	, Latch(InLatch)
+	, Scene(InScene)
+{
+}
+
+bool FSpoutLateLatchExtension::IsActiveThisFrame_Internal(const FSceneViewExtensionContext& Context) const
+{
+	return Context.Scene == Scene;
+}
+
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1
+void FSpoutLateLatchExtension::PreRenderViewFamily_RenderThread(FRDGBuilder& GraphBuilder, FSceneViewFamily& InViewFamily)
+{
+	TOptional<FSpoutLatchRequest> Request = Latch->LatchBeforeRender();
+	if (!Request.IsSet())
+		return;
+
+	INC_DWORD_STAT(STAT_SpoutLateLatched);
+
+	// the first pass of the family's graph, nothing of the scene has been drawn yet
+	AddPass(GraphBuilder, RDG_EVENT_NAME("SpoutLateLatch"), [Request = MoveTemp(Request.GetValue())](FRHICommandListImmediate& RHICmdList) {
+		Request(RHICmdList);
+	});
+}
+#else
+void FSpoutLateLatchExtension::PreRenderViewFamily_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneViewFamily& InViewFamily)
+{
+	TOptional<FSpoutLatchRequest> Request = Latch->LatchBeforeRender();
+	if (!Request.IsSet())
+		return;
+
+	INC_DWORD_STAT(STAT_SpoutLateLatched);
+	Request.GetValue()(RHICmdList);
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+
+FSpoutLateLatch::FSpoutLateLatch(FSceneInterface* InScene)
+	: Latch(MakeShared<FSpoutFrameLatch, ESPMode::ThreadSafe>())
+	, Scene(InScene)
+{
+	Extension = FSceneViewExtensions::NewExtension<FSpoutLateLatchExtension>(Latch, Scene);
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FSpoutLateLatch::OnEndFrame);
+}
+
+FSpoutLateLatch::~FSpoutLateLatch()
+{
+	check(IsInGameThread());
+
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+
+	ENQUEUE_RENDER_COMMAND(SpoutLateLatchDisarm)([Latch = Latch](FRHICommandListImmediate& RHICmdList) {
+		Latch->Disarm();
+	});
+
+	// armed requests reference the receiver, they must not outlive it
+	FlushRenderingCommands();
+}
+
+void FSpoutLateLatch::Arm(FSpoutLatchRequest Request)
+{
+	// through the command queue, so the request is armed in order with the frame it was ticked for
+	ENQUEUE_RENDER_COMMAND(SpoutLateLatchArm)([Latch = Latch, Request = MoveTemp(Request)](FRHICommandListImmediate& RHICmdList) mutable {
+		Latch->Arm(MoveTemp(Request));
+	});
+}
+
+void FSpoutLateLatch::OnEndFrame()
+{
+	// queued behind this frame's scene rendering
+	ENQUEUE_RENDER_COMMAND(SpoutLateLatchEndOfFrame)([Latch = Latch](FRHICommandListImmediate& RHICmdList) {
+		TOptional<FSpoutLatchRequest> Request = Latch->LatchAtEndOfFrame();
+		if (!Request.IsSet())
+			return;
+
+		INC_DWORD_STAT(STAT_SpoutEndOfFrameLatched);
+		Request.GetValue()(RHICmdList);
+	});
+}
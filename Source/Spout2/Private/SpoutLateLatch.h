@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SceneViewExtension.h"
+#include "SpoutFrameLatch.h"
+
+class FRHICommandListImmediate;
+class FSceneInterface;
+
+typedef TFunction<void(FRHICommandListImmediate&)> FSpoutLatchRequest;
+typedef TSpoutFrameLatch<FSpoutLatchRequest> FSpoutFrameLatch;
+typedef TSharedRef<FSpoutFrameLatch, ESPMode::ThreadSafe> FSpoutFrameLatchRef;
+
+/** Runs a receiver's latched copy right before a view family of its scene renders. */
+class FSpoutLateLatchExtension : public FSceneViewExtensionBase
+{
+public:
+
+	FSpoutLateLatchExtension(const FAutoRegister& AutoRegister, FSpoutFrameLatchRef InLatch, FSceneInterface* InScene);
+
+	// ISceneViewExtension
+	virtual void SetupViewFamily(FSceneViewFamily& InViewFamily) override {}
+	virtual void SetupView(FSceneViewFamily& InViewFamily, FSceneView& InView) override {}
+	virtual void BeginRenderViewFamily(FSceneViewFamily& InViewFamily) override {}
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1
+	virtual void PreRenderViewFamily_RenderThread(FRDGBuilder& GraphBuilder, FSceneViewFamily& InViewFamily) override;
+#else
+	virtual void PreRenderViewFamily_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneViewFamily& InViewFamily) override;
+	virtual void PreRenderView_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneView& InView) override {}
+#endif
+
+protected:
+
+	virtual bool IsActiveThisFrame_Internal(const FSceneViewExtensionContext& Context) const override;
+
+private:
+
+	FSpoutFrameLatchRef Latch;
+	FSceneInterface* Scene;
+};
+
+/**
+ * Game thread owner of a receiver's latch: arms it once per admitted tick, registers
+ * the view extension and the end of frame fallback, and tears both down safely.
+ */
+class FSpoutLateLatch
+{
+public:
+
+	explicit FSpoutLateLatch(FSceneInterface* InScene);
+	~FSpoutLateLatch();
+
+	FSpoutLateLatch(const FSpoutLateLatch&) = delete;
+	FSpoutLateLatch& operator=(const FSpoutLateLatch&) = delete;
+
+	/** Game thread. The request runs on the render thread before this frame's scene renders. */
+	void Arm(FSpoutLatchRequest Request);
+
+	FSceneInterface* GetScene() const { return Scene; }
+
+private:
+
+	void OnEndFrame();
+
+	FSpoutFrameLatchRef Latch;
+	FSceneInterface* Scene;
+
+	TSharedPtr<FSpoutLateLatchExtension, ESPMode::ThreadSafe> Extension;
+	FDelegateHandle EndFrameHandle;
+};
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutLocalSenders.h"
+
+#include "Misc/ScopeLock.h"
+
+FSpoutLocalSenders& FSpoutLocalSenders::Get()
+{
+	static FSpoutLocalSenders Instance;
+	return Instance;
+}
+
+void FSpoutLocalSenders::Register(const FString& SenderName, void* ShareHandle, FRHITexture2D* Texture)
+{
+	if (!ShareHandle || !Texture)
+		return;
+
+	FScopeLock Lock(&Mutex);
+
+	FEntry& Entry = Entries.FindOrAdd(SenderName);
+	Entry.ShareHandle = ShareHandle;
+	Entry.Texture = Texture;
+}
+
+void FSpoutLocalSenders::Unregister(const FString& SenderName, void* ShareHandle)
+{
+	FScopeLock Lock(&Mutex);
+
+	const FEntry* Entry = Entries.Find(SenderName);
+	if (Entry && Entry->ShareHandle == ShareHandle)
+		Entries.Remove(SenderName);
+}
+
+FTexture2DRHIRef FSpoutLocalSenders::Find(const FString& SenderName, void* ShareHandle) const
+{
+	if (!ShareHandle)
+		return nullptr;
+
+	FScopeLock Lock(&Mutex);
+
+	const FEntry* Entry = Entries.Find(SenderName);
+	return Entry && Entry->ShareHandle == ShareHandle ? Entry->Texture : nullptr;
+}
+
+int32 FSpoutLocalSenders::Num() const
+{
+	FScopeLock Lock(&Mutex);
+	return Entries.Num();
+}
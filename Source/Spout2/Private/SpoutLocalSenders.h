@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RHI.h"
+
+/**
+ * Senders published by this process, so a receiver in the same process can draw the
+ * sender's texture instead of opening the share handle and copying it through D3D11/11On12.
+ *
+ * Receivers still find the sender in Spout's registry. The share handle found there
+ * selects the entry, so a sender of the same name in another process never matches.
+ */
+class FSpoutLocalSenders
+{
+public:
+
+	static FSpoutLocalSenders& Get();
+
+	void Register(const FString& SenderName, void* ShareHandle, FRHITexture2D* Texture);
+
+	/** Only removes the entry while it still belongs to ShareHandle. */
+	void Unregister(const FString& SenderName, void* ShareHandle);
+
+	/** The texture behind ShareHandle when this process publishes it as SenderName, null otherwise. */
+	FTexture2DRHIRef Find(const FString& SenderName, void* ShareHandle) const;
+
+	int32 Num() const;
+
+private:
+
+	struct FEntry
+	{
+		void* ShareHandle = nullptr;
+		FTexture2DRHIRef Texture;
+	};
+
+	mutable FCriticalSection Mutex;
+	TMap<FString, FEntry> Entries;
+};
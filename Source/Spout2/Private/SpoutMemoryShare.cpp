@@ -0,0 +1,209 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutMemoryShare.h"
+
+#include "HAL/PlatformAtomics.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformTime.h"
+#include "SpoutSourceRegion.h"
+#include "SpoutYuvConversion.h"
+
+namespace SpoutMemoryShare
+{
+	FString MakePayloadName(const FString& SenderName, int32 Width, int32 Height, ESpoutMemoryShareFormat Format)
+	{
+		return FSpoutSharedRegion::MakeName(SenderName,
+			*FString::Printf(TEXT("SpoutMem_%dx%d_%d"), Width, Height, (int32)Format));
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+FSpoutMemorySender::FSpoutMemorySender(const FString& SenderName)
+	: SenderName(SenderName)
+{
+}
+
+bool FSpoutMemorySender::Publish(const FColor* Pixels, int32 Width, int32 Height, ESpoutMemoryShareFormat Format, ESpoutYuvMatrix Matrix)
+{
+	if (!Pixels)
+		return false;
+
+	return Write(Width, Height, Format, Matrix, [&](uint8* Payload) {
+		SpoutYuvConversion::Encode(Format, Pixels, Width, Height, Payload, Matrix);
+	});
+}
+
+bool FSpoutMemorySender::PublishEncoded(const uint8* Payload, SIZE_T PayloadSize, const FSpoutMemoryFrameInfo& Info)
+{
+	if (!Payload || PayloadSize != SpoutYuvConversion::GetFrameSize(Info.Format, Info.Width, Info.Height))
+		return false;
+
+	return Write(Info.Width, Info.Height, Info.Format, Info.Matrix, [&](uint8* Destination) {
+		FMemory::Memcpy(Destination, Payload, PayloadSize);
+	});
+}
+
+bool FSpoutMemorySender::Write(int32 Width, int32 Height, ESpoutMemoryShareFormat Format, ESpoutYuvMatrix Matrix, TFunctionRef<void(uint8*)> WritePayload)
+{
+	const SIZE_T FrameSize = SpoutYuvConversion::GetFrameSize(Format, Width, Height);
+	if (FrameSize == 0)
+		return false;
+
+	if (!InfoRegion.IsValid())
+	{
+		if (!InfoRegion.Create(FSpoutSharedRegion::MakeName(SenderName, TEXT("SpoutMem")), sizeof(FSpoutMemoryFrameHeader)))
+			return false;
+
+		FSpoutMemoryFrameHeader* Header = InfoRegion.As<FSpoutMemoryFrameHeader>();
+		FrameId = Header->Magic == FSpoutMemoryFrameHeader::MagicValue ? Header->FrameId : 0;
+	}
+
+	const FString PayloadName = SpoutMemoryShare::MakePayloadName(SenderName, Width, Height, Format);
+	if (PayloadRegion.GetName() != PayloadName
+		&& !PayloadRegion.Create(PayloadName, FrameSize))
+		return false;
+
+	FSpoutMemoryFrameHeader* Header = InfoRegion.As<FSpoutMemoryFrameHeader>();
+
+	// odd sequence: receivers skip the frame until it is complete
+	FPlatformAtomics::InterlockedIncrement(&Header->Sequence);
+	FPlatformMisc::MemoryBarrier();
+
+	Header->Magic = FSpoutMemoryFrameHeader::MagicValue;
+	Header->Version = FSpoutMemoryFrameHeader::CurrentVersion;
+	Header->Format = (uint32)Format;
+	Header->Matrix = (uint32)Matrix;
+	Header->Width = Width;
+	Header->Height = Height;
+	Header->FrameId = ++FrameId;
+	Header->PublishTimeUs = (int64)(FPlatformTime::Seconds() * 1000000.0);
+
+	WritePayload(static_cast<uint8*>(PayloadRegion.GetAddress()));
+
+	FPlatformMisc::MemoryBarrier();
+	FPlatformAtomics::InterlockedIncrement(&Header->Sequence);
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+FSpoutMemoryReceiver::FSpoutMemoryReceiver(const FString& SenderName)
+	: SenderName(SenderName)
+{
+}
+
+bool FSpoutMemoryReceiver::OpenInfo()
+{
+	if (InfoRegion.IsValid())
+		return true;
+
+	return InfoRegion.Open(FSpoutSharedRegion::MakeName(SenderName, TEXT("SpoutMem")), sizeof(FSpoutMemoryFrameHeader));
+}
+
+bool FSpoutMemoryReceiver::PeekFrameSize(int32& OutWidth, int32& OutHeight)
+{
+	if (!OpenInfo())
+		return false;
+
+	const FSpoutMemoryFrameHeader* Header = InfoRegion.As<FSpoutMemoryFrameHeader>();
+	if (Header->Magic != FSpoutMemoryFrameHeader::MagicValue)
+		return false;
+
+	OutWidth = Header->Width;
+	OutHeight = Header->Height;
+	return OutWidth > 0 && OutHeight > 0;
+}
+
+bool FSpoutMemoryReceiver::Receive(TArray<FColor>& OutPixels, int32& OutWidth, int32& OutHeight, const FIntRect& Region)
+{
+	return Read([&](const FSpoutMemoryFrameInfo& Info, const uint8* Payload) {
+		const FIntRect Frame(0, 0, Info.Width, Info.Height);
+		const FIntRect Crop = SpoutSourceRegion::Resolve(Frame, Region);
+		if (Crop.Width() <= 0 || Crop.Height() <= 0)
+			return false;
+
+		OutPixels.SetNumUninitialized(Crop.Area());
+
+		if (Crop == Frame)
+		{
+			SpoutYuvConversion::Decode(Info.Format, Payload, Info.Width, Info.Height, OutPixels.GetData(), Info.Matrix);
+		}
+		else if (Info.Format == ESpoutMemoryShareFormat::BGRA)
+		{
+			// only the rows of the crop are read from the payload
+			SpoutSourceRegion::CopyRegion(reinterpret_cast<const FColor*>(Payload), Info.Width, Crop, OutPixels.GetData());
+		}
+		else
+		{
+			DecodedFrame.SetNumUninitialized(Info.Width * Info.Height);
+			SpoutYuvConversion::Decode(Info.Format, Payload, Info.Width, Info.Height, DecodedFrame.GetData(), Info.Matrix);
+			SpoutSourceRegion::CopyRegion(DecodedFrame.GetData(), Info.Width, Crop, OutPixels.GetData());
+		}
+
+		OutWidth = Crop.Width();
+		OutHeight = Crop.Height();
+		return true;
+	});
+}
+
+bool FSpoutMemoryReceiver::ReceiveEncoded(TArray<uint8>& OutPayload, FSpoutMemoryFrameInfo& OutInfo)
+{
+	return Read([&](const FSpoutMemoryFrameInfo& Info, const uint8* Payload) {
+		const SIZE_T FrameSize = SpoutYuvConversion::GetFrameSize(Info.Format, Info.Width, Info.Height);
+
+		OutPayload.SetNumUninitialized(FrameSize);
+		FMemory::Memcpy(OutPayload.GetData(), Payload, FrameSize);
+
+		OutInfo = Info;
+		return true;
+	});
+}
+
+bool FSpoutMemoryReceiver::Read(TFunctionRef<bool(const FSpoutMemoryFrameInfo&, const uint8*)> Consume)
+{
+	if (!OpenInfo())
+		return false;
+
+	FSpoutMemoryFrameHeader* Header = InfoRegion.As<FSpoutMemoryFrameHeader>();
+
+	const int64 SequenceBefore = FPlatformAtomics::AtomicRead(&Header->Sequence);
+	if (SequenceBefore & 1)
+		return false;
+
+	FPlatformMisc::MemoryBarrier();
+
+	if (Header->Magic != FSpoutMemoryFrameHeader::MagicValue
+		|| Header->Version != FSpoutMemoryFrameHeader::CurrentVersion
+		|| Header->FrameId == LastFrameId)
+		return false;
+
+	FSpoutMemoryFrameInfo Info;
+	Info.Format = (ESpoutMemoryShareFormat)Header->Format;
+	Info.Matrix = (ESpoutYuvMatrix)Header->Matrix;
+	Info.Width = Header->Width;
+	Info.Height = Header->Height;
+	Info.FrameId = Header->FrameId;
+	Info.PublishTimeUs = Header->PublishTimeUs;
+
+	const SIZE_T FrameSize = SpoutYuvConversion::GetFrameSize(Info.Format, Info.Width, Info.Height);
+	if (FrameSize == 0)
+		return false;
+
+	const FString PayloadName = SpoutMemoryShare::MakePayloadName(SenderName, Info.Width, Info.Height, Info.Format);
+	if (PayloadRegion.GetName() != PayloadName
+		&& !PayloadRegion.Open(PayloadName, FrameSize))
+		return false;
+
+	if (!Consume(Info, static_cast<const uint8*>(PayloadRegion.GetAddress())))
+		return false;
+
+	// the sender published again while we copied, the frame may be torn
+	FPlatformMisc::MemoryBarrier();
+	if (FPlatformAtomics::AtomicRead(&Header->Sequence) != SequenceBefore)
+		return false;
+
+	LastFrameId = Info.FrameId;
+	return true;
+}
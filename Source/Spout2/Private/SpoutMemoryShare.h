@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include "SpoutSharedRegion.h"
+#include "SpoutTypes.h"
+
+/**
+ * CPU memory-share stream of a sender, for preview monitors and CPU-side consumers.
+ *
+ * A small info region "<Sender>_SpoutMem" describes the current frame and guards it with
+ * a sequence counter (odd while the sender writes). Pixels live in a payload region named
+ * after the frame layout, so a resize never changes the size of a mapping a receiver holds.
+ * PublishTimeUs is FPlatformTime::Seconds in microseconds, the clock every process on the
+ * machine shares, so a recorder keeps the sender's pacing rather than its own polling.
+ */
+struct FSpoutMemoryFrameHeader
+{
+	static constexpr uint32 MagicValue = 0x534d5053; // "SPMS"
+	static constexpr uint32 CurrentVersion = 2;
+
+	uint32 Magic;
+	uint32 Version;
+	uint32 Format;
+	uint32 Matrix;
+	int32 Width;
+	int32 Height;
+	volatile int64 Sequence;
+	int64 FrameId;
+	int64 PublishTimeUs;
+};
+
+/** Layout of one encoded memory-share frame, as published. */
+struct FSpoutMemoryFrameInfo
+{
+	ESpoutMemoryShareFormat Format = ESpoutMemoryShareFormat::BGRA;
+	ESpoutYuvMatrix Matrix = ESpoutYuvMatrix::BT709;
+	int32 Width = 0;
+	int32 Height = 0;
+	int64 FrameId = 0;
+	int64 PublishTimeUs = 0;
+};
+
+class FSpoutMemorySender
+{
+public:
+
+	explicit FSpoutMemorySender(const FString& SenderName);
+
+	/** Encodes and publishes one BGRA frame. Thread safe against receivers, not against other publishers. */
+	bool Publish(const FColor* Pixels, int32 Width, int32 Height, ESpoutMemoryShareFormat Format, ESpoutYuvMatrix Matrix);
+
+	/** Publishes a frame that is already encoded as Info describes, such as a recorded one. Id and time are this publish's own. */
+	bool PublishEncoded(const uint8* Payload, SIZE_T PayloadSize, const FSpoutMemoryFrameInfo& Info);
+
+	const FString& GetSenderName() const { return SenderName; }
+
+private:
+
+	bool Write(int32 Width, int32 Height, ESpoutMemoryShareFormat Format, ESpoutYuvMatrix Matrix, TFunctionRef<void(uint8*)> WritePayload);
+
+	FString SenderName;
+	FSpoutSharedRegion InfoRegion;
+	FSpoutSharedRegion PayloadRegion;
+	int64 FrameId = 0;
+};
+
+class FSpoutMemoryReceiver
+{
+public:
+
+	explicit FSpoutMemoryReceiver(const FString& SenderName);
+
+	/** Size of the newest published frame, without copying it. */
+	bool PeekFrameSize(int32& OutWidth, int32& OutHeight);
+
+	/**
+	 * Decodes the newest frame to BGRA. False when there is no new, consistent frame.
+	 * A non-empty Region (see SpoutSourceRegion::Resolve) receives only that crop, OutWidth/OutHeight are its size.
+	 */
+	bool Receive(TArray<FColor>& OutPixels, int32& OutWidth, int32& OutHeight, const FIntRect& Region = FIntRect());
+
+	/** Copies the newest frame as published, without decoding it. Same rules as Receive. */
+	bool ReceiveEncoded(TArray<uint8>& OutPayload, FSpoutMemoryFrameInfo& OutInfo);
+
+	const FString& GetSenderName() const { return SenderName; }
+	int64 GetLastFrameId() const { return LastFrameId; }
+
+private:
+
+	bool OpenInfo();
+
+	// hands the newest unseen frame to Consume, which may refuse it; false when torn or refused
+	bool Read(TFunctionRef<bool(const FSpoutMemoryFrameInfo&, const uint8*)> Consume);
+
+	FString SenderName;
+	FSpoutSharedRegion InfoRegion;
+	FSpoutSharedRegion PayloadRegion;
+	int64 LastFrameId = 0;
+
+	// whole YUV frames decode here before their crop is copied out
+	TArray<FColor> DecodedFrame;
+};
+
+namespace SpoutMemoryShare
+{
+	FString MakePayloadName(const FString& SenderName, int32 Width, int32 Height, ESpoutMemoryShareFormat Format);
+}
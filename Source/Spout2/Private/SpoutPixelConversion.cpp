@@ -0,0 +1,174 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutPixelConversion.h"
+
+#include "SpoutHdrPacking.h"
+#include "SpoutImageScaler.h"
+
+namespace SpoutPixelConversion
+{
+	float SRGBToLinear(float Value)
+	{
+		return Value <= 0.04045f
+			? Value / 12.92f
+			: FMath::Pow((Value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	float LinearToSRGB(float Value)
+	{
+		return Value <= 0.0031308f
+			? Value * 12.92f
+			: 1.055f * FMath::Pow(Value, 1.f / 2.4f) - 0.055f;
+	}
+
+	bool PremultipliesTaps(const FSpoutConversionOptions& Options, ESpoutScaleFilter Filter)
+	{
+		return Options.Alpha == ESpoutAlphaConversion::Premultiply
+			|| (Options.Alpha == ESpoutAlphaConversion::None && Filter != ESpoutScaleFilter::Point);
+	}
+
+	bool UnpremultipliesOutput(const FSpoutConversionOptions& Options, ESpoutScaleFilter Filter)
+	{
+		return Options.Alpha == ESpoutAlphaConversion::Unpremultiply
+			|| (Options.Alpha == ESpoutAlphaConversion::None && Filter != ESpoutScaleFilter::Point);
+	}
+
+	FLinearColor DecodeTexel(const FLinearColor& Texel, const FSpoutConversionOptions& Options, ESpoutScaleFilter Filter, ESpoutHdrTransport HdrTransport)
+	{
+		FLinearColor Color = Texel;
+
+		if (HdrTransport == ESpoutHdrTransport::PQ10)
+		{
+			Color.R = SpoutHdrPacking::DecodePQ(Color.R);
+			Color.G = SpoutHdrPacking::DecodePQ(Color.G);
+			Color.B = SpoutHdrPacking::DecodePQ(Color.B);
+		}
+		else if (HdrTransport == ESpoutHdrTransport::Log10)
+		{
+			Color.R = SpoutHdrPacking::DecodeLog(Color.R);
+			Color.G = SpoutHdrPacking::DecodeLog(Color.G);
+			Color.B = SpoutHdrPacking::DecodeLog(Color.B);
+		}
+
+		if (Options.bSwizzleRedBlue)
+			Swap(Color.R, Color.B);
+
+		// decoded HDR is already linear, the shader has no permutation decoding it again
+		const bool bHdrDecoded = HdrTransport == ESpoutHdrTransport::PQ10 || HdrTransport == ESpoutHdrTransport::Log10;
+		if (Options.Color == ESpoutColorConversion::SRGBToLinear && !bHdrDecoded)
+		{
+			Color.R = SRGBToLinear(Color.R);
+			Color.G = SRGBToLinear(Color.G);
+			Color.B = SRGBToLinear(Color.B);
+		}
+
+		if (PremultipliesTaps(Options, Filter))
+		{
+			Color.R *= Color.A;
+			Color.G *= Color.A;
+			Color.B *= Color.A;
+		}
+
+		return Color;
+	}
+
+	FLinearColor EncodeOutput(const FLinearColor& Color, const FSpoutConversionOptions& Options, ESpoutScaleFilter Filter)
+	{
+		FLinearColor Out = Color;
+
+		if (UnpremultipliesOutput(Options, Filter))
+		{
+			const float InvAlpha = Out.A > 0.f ? 1.f / Out.A : 0.f;
+			Out.R *= InvAlpha;
+			Out.G *= InvAlpha;
+			Out.B *= InvAlpha;
+		}
+
+		if (Options.Color == ESpoutColorConversion::LinearToSRGB)
+		{
+			Out.R = LinearToSRGB(FMath::Max(Out.R, 0.f));
+			Out.G = LinearToSRGB(FMath::Max(Out.G, 0.f));
+			Out.B = LinearToSRGB(FMath::Max(Out.B, 0.f));
+		}
+
+		return Out;
+	}
+
+	FLinearColor ConvertTexel(const FLinearColor& Texel, const FSpoutConversionOptions& Options, ESpoutHdrTransport HdrTransport)
+	{
+		return EncodeOutput(DecodeTexel(Texel, Options, ESpoutScaleFilter::Point, HdrTransport), Options, ESpoutScaleFilter::Point);
+	}
+
+	uint8 QuantizeUNorm8(float Value)
+	{
+		return (uint8)FMath::FloorToInt(FMath::Clamp(Value, 0.f, 1.f) * 255.f + 0.5f);
+	}
+
+	void ConvertImage(const FLinearColor* Src, FLinearColor* Dst, int32 Width, int32 Height, const FSpoutConversionOptions& Options)
+	{
+		check(!Options.bFlipVertical || Src != Dst);
+
+		for (int32 y = 0; y < Height; ++y)
+		{
+			const int32 SrcRow = Options.bFlipVertical ? Height - 1 - y : y;
+			const FLinearColor* SrcLine = Src + (SIZE_T)SrcRow * Width;
+			FLinearColor* DstLine = Dst + (SIZE_T)y * Width;
+
+			for (int32 x = 0; x < Width; ++x)
+				DstLine[x] = ConvertTexel(SrcLine[x], Options);
+		}
+	}
+
+	void ConvertImage(const FColor* Src, FColor* Dst, int32 Width, int32 Height, const FSpoutConversionOptions& Options)
+	{
+		check(!Options.bFlipVertical || Src != Dst);
+
+		for (int32 y = 0; y < Height; ++y)
+		{
+			const int32 SrcRow = Options.bFlipVertical ? Height - 1 - y : y;
+			const FColor* SrcLine = Src + (SIZE_T)SrcRow * Width;
+			FColor* DstLine = Dst + (SIZE_T)y * Width;
+
+			for (int32 x = 0; x < Width; ++x)
+			{
+				const FColor In = SrcLine[x];
+				const FLinearColor Out = ConvertTexel(FLinearColor(In.R / 255.f, In.G / 255.f, In.B / 255.f, In.A / 255.f), Options);
+
+				DstLine[x] = FColor(QuantizeUNorm8(Out.R), QuantizeUNorm8(Out.G), QuantizeUNorm8(Out.B), QuantizeUNorm8(Out.A));
+			}
+		}
+	}
+
+	void ConvertScaledImage(
+		const FColor* Src, int32 SrcWidth, int32 SrcHeight,
+		FLinearColor* Dst, int32 DstWidth, int32 DstHeight,
+		const FSpoutConversionOptions& Options, ESpoutScaleFilter Filter, ESpoutScaleMode Mode)
+	{
+		check(Src && Dst);
+
+		// every texel is decoded once, the shader decodes each tap
+		TArray<FLinearColor> Decoded;
+		Decoded.SetNumUninitialized(SrcWidth * SrcHeight);
+
+		for (int32 Index = 0; Index < Decoded.Num(); ++Index)
+		{
+			const FColor In = Src[Index];
+			Decoded[Index] = DecodeTexel(FLinearColor(In.R / 255.f, In.G / 255.f, In.B / 255.f, In.A / 255.f), Options, Filter);
+		}
+
+		TArray<FLinearColor> Scaled;
+		Scaled.SetNumUninitialized(DstWidth * DstHeight);
+		SpoutImageScaler::ScaleImage(Decoded.GetData(), SrcWidth, SrcHeight, Scaled.GetData(), DstWidth, DstHeight, Filter, Mode);
+
+		// the shader flips the output UV before mapping it to the source
+		for (int32 y = 0; y < DstHeight; ++y)
+		{
+			const int32 ScaledRow = Options.bFlipVertical ? DstHeight - 1 - y : y;
+			const FLinearColor* ScaledLine = Scaled.GetData() + (SIZE_T)ScaledRow * DstWidth;
+			FLinearColor* DstLine = Dst + (SIZE_T)y * DstWidth;
+
+			for (int32 x = 0; x < DstWidth; ++x)
+				DstLine[x] = EncodeOutput(ScaledLine[x], Options, Filter);
+		}
+	}
+}
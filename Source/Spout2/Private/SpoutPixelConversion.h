@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SpoutTypes.h"
+
+/**
+ * CPU reference of the conversions compiled into SpoutReceiverCopyShader.usf.
+ * Every step mirrors the shader's arithmetic in the same order: source texels are
+ * decoded before they are filtered, output pixels encoded after, so the two paths
+ * agree after quantization to the output format.
+ */
+namespace SpoutPixelConversion
+{
+	float SRGBToLinear(float Value);
+	float LinearToSRGB(float Value);
+
+	/** SPOUT_PREMULTIPLY_TAPS: straight alpha is filtered premultiplied unless it is point sampled. */
+	bool PremultipliesTaps(const FSpoutConversionOptions& Options, ESpoutScaleFilter Filter);
+
+	/** SPOUT_UNPREMULTIPLY_OUTPUT: the filtered pixel is restored to straight alpha. */
+	bool UnpremultipliesOutput(const FSpoutConversionOptions& Options, ESpoutScaleFilter Filter);
+
+	/** SpoutDecodeTexel: HDR decode, swizzle, sRGB decode and premultiply of one source texel. */
+	FLinearColor DecodeTexel(const FLinearColor& Texel, const FSpoutConversionOptions& Options, ESpoutScaleFilter Filter = ESpoutScaleFilter::Point, ESpoutHdrTransport HdrTransport = ESpoutHdrTransport::None);
+
+	/** SpoutEncodeOutput: unpremultiply and sRGB encode of one filtered pixel. */
+	FLinearColor EncodeOutput(const FLinearColor& Color, const FSpoutConversionOptions& Options, ESpoutScaleFilter Filter = ESpoutScaleFilter::Point);
+
+	/** A point sampled texel, decoded and encoded. Flipping is an addressing step and not handled here. */
+	FLinearColor ConvertTexel(const FLinearColor& Texel, const FSpoutConversionOptions& Options, ESpoutHdrTransport HdrTransport = ESpoutHdrTransport::None);
+
+	/** Quantizes like a UNORM render target write. */
+	uint8 QuantizeUNorm8(float Value);
+
+	/** Point sampled copies of a whole image, the output size of the source. */
+	void ConvertImage(const FLinearColor* Src, FLinearColor* Dst, int32 Width, int32 Height, const FSpoutConversionOptions& Options);
+
+	/** 8-bit BGRA variant, as found in Spout memory-share buffers. Src and Dst may alias unless flipping. */
+	void ConvertImage(const FColor* Src, FColor* Dst, int32 Width, int32 Height, const FSpoutConversionOptions& Options);
+
+	/**
+	 * The whole copy draw: decodes Src, scales it to the destination with SpoutImageScaler::ScaleImage, then
+	 * encodes it and flips it. Src is 8-bit BGRA, Dst is left linear or sRGB as Options ask, unquantized.
+	 */
+	void ConvertScaledImage(
+		const FColor* Src, int32 SrcWidth, int32 SrcHeight,
+		FLinearColor* Dst, int32 DstWidth, int32 DstHeight,
+		const FSpoutConversionOptions& Options, ESpoutScaleFilter Filter, ESpoutScaleMode Mode);
+}
@@ -0,0 +1,203 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PixelFormat.h"
+
+/**
+ * Single source of truth for the DXGI formats a Spout sender may announce.
+ *
+ * DXGI values are spelled out as numbers so the table does not depend on Windows
+ * headers. Every mapping and copy-path decision in the plugin reads from here.
+ */
+namespace SpoutPixelFormats
+{
+	// DXGI_FORMAT values, see dxgiformat.h
+	enum EDxgiFormat : uint32
+	{
+		DXGI_Unknown = 0,
+		DXGI_R32G32B32A32_Typeless = 1,
+		DXGI_R32G32B32A32_Float = 2,
+		DXGI_R16G16B16A16_Typeless = 9,
+		DXGI_R16G16B16A16_Float = 10,
+		DXGI_R16G16B16A16_UNorm = 11,
+		DXGI_R10G10B10A2_Typeless = 23,
+		DXGI_R10G10B10A2_UNorm = 24,
+		DXGI_R11G11B10_Float = 26,
+		DXGI_R8G8B8A8_Typeless = 27,
+		DXGI_R8G8B8A8_UNorm = 28,
+		DXGI_R8G8B8A8_UNorm_SRGB = 29,
+		DXGI_R32_Float = 41,
+		DXGI_R8G8_UNorm = 49,
+		DXGI_R16_Float = 54,
+		DXGI_R8_UNorm = 61,
+		DXGI_B8G8R8A8_UNorm = 87,
+		DXGI_B8G8R8X8_UNorm = 88,
+		DXGI_B8G8R8A8_Typeless = 90,
+		DXGI_B8G8R8A8_UNorm_SRGB = 91,
+		DXGI_B8G8R8X8_Typeless = 92,
+		DXGI_B8G8R8X8_UNorm_SRGB = 93,
+	};
+
+	enum class EConversionCost : uint8
+	{
+		// CopyResource into a texture of PixelFormat is valid
+		None,
+		// Same bits in another typeless group (X8 alpha): read back through a staging texture of the
+		// sender's format and uploaded into a texture of PixelFormat with an opaque alpha
+		Readback,
+		// No engine format can hold the data
+		Unsupported,
+	};
+
+	struct FInfo
+	{
+		uint32 DxgiFormat;
+		// member of the same typeless group that shared textures are created with
+		uint32 TypedFormat;
+		uint32 TypelessFormat;
+		// sRGB counterpart of a linear format, or linear counterpart of an sRGB one
+		uint32 SRGBPairFormat;
+		EPixelFormat PixelFormat;
+		uint8 BytesPerPixel;
+		bool bSRGB;
+		bool bDirectCopy;
+		EConversionCost Cost;
+	};
+
+	constexpr FInfo Table[] =
+	{
+		// DxgiFormat                  TypedFormat                  TypelessFormat               SRGBPairFormat              PixelFormat             Bpp  sRGB   Direct Cost
+		{ DXGI_R32G32B32A32_Typeless,  DXGI_R32G32B32A32_Float,     DXGI_R32G32B32A32_Typeless,  DXGI_Unknown,               PF_A32B32G32R32F,       16,  false, true,  EConversionCost::None },
+		{ DXGI_R32G32B32A32_Float,     DXGI_R32G32B32A32_Float,     DXGI_R32G32B32A32_Typeless,  DXGI_Unknown,               PF_A32B32G32R32F,       16,  false, true,  EConversionCost::None },
+		{ DXGI_R16G16B16A16_Typeless,  DXGI_R16G16B16A16_Float,     DXGI_R16G16B16A16_Typeless,  DXGI_Unknown,               PF_FloatRGBA,           8,   false, true,  EConversionCost::None },
+		{ DXGI_R16G16B16A16_Float,     DXGI_R16G16B16A16_Float,     DXGI_R16G16B16A16_Typeless,  DXGI_Unknown,               PF_FloatRGBA,           8,   false, true,  EConversionCost::None },
+		{ DXGI_R16G16B16A16_UNorm,     DXGI_R16G16B16A16_UNorm,     DXGI_R16G16B16A16_Typeless,  DXGI_Unknown,               PF_A16B16G16R16,        8,   false, true,  EConversionCost::None },
+		{ DXGI_R10G10B10A2_Typeless,   DXGI_R10G10B10A2_UNorm,      DXGI_R10G10B10A2_Typeless,   DXGI_Unknown,               PF_A2B10G10R10,         4,   false, true,  EConversionCost::None },
+		{ DXGI_R10G10B10A2_UNorm,      DXGI_R10G10B10A2_UNorm,      DXGI_R10G10B10A2_Typeless,   DXGI_Unknown,               PF_A2B10G10R10,         4,   false, true,  EConversionCost::None },
+		{ DXGI_R11G11B10_Float,        DXGI_R11G11B10_Float,        DXGI_R11G11B10_Float,        DXGI_Unknown,               PF_FloatR11G11B10,      4,   false, true,  EConversionCost::None },
+		{ DXGI_R8G8B8A8_Typeless,      DXGI_R8G8B8A8_UNorm,         DXGI_R8G8B8A8_Typeless,      DXGI_Unknown,               PF_R8G8B8A8,            4,   false, true,  EConversionCost::None },
+		{ DXGI_R8G8B8A8_UNorm,         DXGI_R8G8B8A8_UNorm,         DXGI_R8G8B8A8_Typeless,      DXGI_R8G8B8A8_UNorm_SRGB,   PF_R8G8B8A8,            4,   false, true,  EConversionCost::None },
+		{ DXGI_R8G8B8A8_UNorm_SRGB,    DXGI_R8G8B8A8_UNorm_SRGB,    DXGI_R8G8B8A8_Typeless,      DXGI_R8G8B8A8_UNorm,        PF_R8G8B8A8,            4,   true,  true,  EConversionCost::None },
+		{ DXGI_R32_Float,              DXGI_R32_Float,              DXGI_R32_Float,              DXGI_Unknown,               PF_R32_FLOAT,           4,   false, true,  EConversionCost::None },
+		{ DXGI_R8G8_UNorm,             DXGI_R8G8_UNorm,             DXGI_R8G8_UNorm,             DXGI_Unknown,               PF_R8G8,                2,   false, true,  EConversionCost::None },
+		{ DXGI_R16_Float,              DXGI_R16_Float,              DXGI_R16_Float,              DXGI_Unknown,               PF_R16F,                2,   false, true,  EConversionCost::None },
+		{ DXGI_R8_UNorm,               DXGI_R8_UNorm,               DXGI_R8_UNorm,               DXGI_Unknown,               PF_G8,                  1,   false, true,  EConversionCost::None },
+		{ DXGI_B8G8R8A8_UNorm,         DXGI_B8G8R8A8_UNorm,         DXGI_B8G8R8A8_Typeless,      DXGI_B8G8R8A8_UNorm_SRGB,   PF_B8G8R8A8,            4,   false, true,  EConversionCost::None },
+		{ DXGI_B8G8R8A8_Typeless,      DXGI_B8G8R8A8_UNorm,         DXGI_B8G8R8A8_Typeless,      DXGI_Unknown,               PF_B8G8R8A8,            4,   false, true,  EConversionCost::None },
+		{ DXGI_B8G8R8A8_UNorm_SRGB,    DXGI_B8G8R8A8_UNorm_SRGB,    DXGI_B8G8R8A8_Typeless,      DXGI_B8G8R8A8_UNorm,        PF_B8G8R8A8,            4,   true,  true,  EConversionCost::None },
+		{ DXGI_B8G8R8X8_UNorm,         DXGI_B8G8R8X8_UNorm,         DXGI_B8G8R8X8_Typeless,      DXGI_B8G8R8X8_UNorm_SRGB,   PF_B8G8R8A8,            4,   false, false, EConversionCost::Readback },
+		{ DXGI_B8G8R8X8_Typeless,      DXGI_B8G8R8X8_UNorm,         DXGI_B8G8R8X8_Typeless,      DXGI_Unknown,               PF_B8G8R8A8,            4,   false, false, EConversionCost::Readback },
+		{ DXGI_B8G8R8X8_UNorm_SRGB,    DXGI_B8G8R8X8_UNorm_SRGB,    DXGI_B8G8R8X8_Typeless,      DXGI_B8G8R8X8_UNorm,        PF_B8G8R8A8,            4,   true,  false, EConversionCost::Readback },
+	};
+
+	constexpr int32 NumFormats = sizeof(Table) / sizeof(Table[0]);
+
+	constexpr const FInfo* Find(uint32 DxgiFormat)
+	{
+		for (int32 Index = 0; Index < NumFormats; ++Index)
+		{
+			if (Table[Index].DxgiFormat == DxgiFormat)
+				return &Table[Index];
+		}
+		return nullptr;
+	}
+
+	/** How a received texture of this DXGI format reaches a texture of its engine format. */
+	constexpr EConversionCost GetConversionCost(uint32 DxgiFormat)
+	{
+		const FInfo* Info = Find(DxgiFormat);
+		return Info ? Info->Cost : EConversionCost::Unsupported;
+	}
+
+	/** Engine format a received texture of this DXGI format is copied or converted into, PF_Unknown if unsupported. */
+	constexpr EPixelFormat ToPixelFormat(uint32 DxgiFormat)
+	{
+		const FInfo* Info = Find(DxgiFormat);
+		return Info && Info->Cost != EConversionCost::Unsupported ? Info->PixelFormat : PF_Unknown;
+	}
+
+	/** DXGI format the engine creates textures of this format with, the first direct copy row. DXGI_Unknown if none. */
+	constexpr uint32 FromPixelFormat(EPixelFormat PixelFormat)
+	{
+		for (int32 Index = 0; Index < NumFormats; ++Index)
+		{
+			if (Table[Index].bDirectCopy && Table[Index].PixelFormat == PixelFormat)
+				return Table[Index].TypedFormat;
+		}
+		return DXGI_Unknown;
+	}
+
+	/** Format to create a shared texture with, resolving typeless source formats. DXGI_Unknown if unsupported. */
+	constexpr uint32 ToShareableFormat(uint32 DxgiFormat)
+	{
+		const FInfo* Info = Find(DxgiFormat);
+		return Info ? Info->TypedFormat : (uint32)DXGI_Unknown;
+	}
+
+	constexpr uint32 GetBytesPerPixel(uint32 DxgiFormat)
+	{
+		const FInfo* Info = Find(DxgiFormat);
+		return Info ? Info->BytesPerPixel : 0;
+	}
+
+	/** True when CopyResource between the two formats is valid (same typeless group). */
+	constexpr bool AreCopyCompatible(uint32 A, uint32 B)
+	{
+		const FInfo* InfoA = Find(A);
+		const FInfo* InfoB = Find(B);
+		return InfoA && InfoB && InfoA->TypelessFormat == InfoB->TypelessFormat;
+	}
+
+	namespace Private
+	{
+		constexpr bool IsTableConsistent()
+		{
+			for (int32 Index = 0; Index < NumFormats; ++Index)
+			{
+				const FInfo& Info = Table[Index];
+
+				// no duplicate entries
+				if (Find(Info.DxgiFormat) != &Info)
+					return false;
+
+				// typed and typeless members exist and agree on size
+				const FInfo* Typed = Find(Info.TypedFormat);
+				const FInfo* Typeless = Find(Info.TypelessFormat);
+				if (!Typed || !Typeless
+					|| Typed->BytesPerPixel != Info.BytesPerPixel
+					|| Typeless->BytesPerPixel != Info.BytesPerPixel
+					|| Typed->TypelessFormat != Info.TypelessFormat)
+					return false;
+
+				// sRGB pairs point at each other and differ in sRGB-ness
+				if (Info.SRGBPairFormat != DXGI_Unknown)
+				{
+					const FInfo* Pair = Find(Info.SRGBPairFormat);
+					if (!Pair
+						|| Pair->SRGBPairFormat != Info.DxgiFormat
+						|| Pair->bSRGB == Info.bSRGB
+						|| Pair->TypelessFormat != Info.TypelessFormat)
+						return false;
+				}
+
+				if (Info.bDirectCopy != (Info.Cost == EConversionCost::None))
+					return false;
+
+				// a readback only forces the alpha byte of four byte texels, into a format it cannot be copied to
+				if (Info.Cost == EConversionCost::Readback
+					&& (Info.BytesPerPixel != 4 || AreCopyCompatible(Info.DxgiFormat, FromPixelFormat(Info.PixelFormat))))
+					return false;
+			}
+			return true;
+		}
+	}
+
+	static_assert(Private::IsTableConsistent(), "Spout pixel format table is inconsistent");
+	static_assert(ToPixelFormat(DXGI_B8G8R8A8_UNorm) == PF_B8G8R8A8, "BGRA8 must stay receivable");
+	static_assert(ToPixelFormat(DXGI_R16G16B16A16_Float) == PF_FloatRGBA, "RGBA16F must stay receivable");
+	static_assert(ToPixelFormat(DXGI_R32G32B32A32_Float) == PF_A32B32G32R32F, "RGBA32F must stay receivable");
+	static_assert(ToPixelFormat(DXGI_B8G8R8X8_UNorm) == PF_B8G8R8A8, "BGRX8 must stay receivable");
+	static_assert(ToShareableFormat(DXGI_B8G8R8A8_Typeless) == DXGI_B8G8R8A8_UNorm, "typeless BGRA8 shares as UNORM");
+}
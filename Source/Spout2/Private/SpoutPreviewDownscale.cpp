@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutPreviewDownscale.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+#define SPOUT_DOWNSCALE_SSE2 1
+#include <emmintrin.h>
+#else
+#define SPOUT_DOWNSCALE_SSE2 0
+#endif
+
+namespace SpoutPreviewDownscale
+{
+	int32 GetFactor(ESpoutPreviewScale Scale)
+	{
+		switch (Scale)
+		{
+		case ESpoutPreviewScale::Quarter:
+			return 4;
+		case ESpoutPreviewScale::Eighth:
+			return 8;
+		default:
+			return 1;
+		}
+	}
+
+	FIntPoint GetScaledSize(FIntPoint Size, int32 Factor)
+	{
+		return FIntPoint(
+			FMath::Max(FMath::DivideAndRoundUp(Size.X, Factor), 1),
+			FMath::Max(FMath::DivideAndRoundUp(Size.Y, Factor), 1));
+	}
+
+	FString MakePreviewName(const FString& SenderName)
+	{
+		return SenderName + TEXT("_Preview");
+	}
+
+	static FORCEINLINE FColor AveragePixels(const FColor& A, const FColor& B, const FColor& C, const FColor& D)
+	{
+		FColor Result;
+		Result.B = (uint8)((A.B + B.B + C.B + D.B + 2) >> 2);
+		Result.G = (uint8)((A.G + B.G + C.G + D.G + 2) >> 2);
+		Result.R = (uint8)((A.R + B.R + C.R + D.R + 2) >> 2);
+		Result.A = (uint8)((A.A + B.A + C.A + D.A + 2) >> 2);
+		return Result;
+	}
+
+	static void HalveRowsScalar(const FColor* Row0, const FColor* Row1, int32 Width, FColor* Dst, int32 FirstX, int32 EndX)
+	{
+		for (int32 x = FirstX; x < EndX; ++x)
+		{
+			const int32 x0 = x * 2;
+			const int32 x1 = FMath::Min(x0 + 1, Width - 1);
+			Dst[x] = AveragePixels(Row0[x0], Row0[x1], Row1[x0], Row1[x1]);
+		}
+	}
+
+	void HalveScalar(const FColor* Src, int32 Width, int32 Height, FColor* Dst)
+	{
+		const int32 HalfWidth = (Width + 1) / 2;
+		const int32 HalfHeight = (Height + 1) / 2;
+
+		for (int32 y = 0; y < HalfHeight; ++y)
+		{
+			const FColor* Row0 = Src + (SIZE_T)(y * 2) * Width;
+			const FColor* Row1 = Src + (SIZE_T)FMath::Min(y * 2 + 1, Height - 1) * Width;
+
+			HalveRowsScalar(Row0, Row1, Width, Dst + (SIZE_T)y * HalfWidth, 0, HalfWidth);
+		}
+	}
+
+#if SPOUT_DOWNSCALE_SSE2
+	// sums the two pixels of each 64 bit half of two rows, widened to 16 bit per channel
+	static FORCEINLINE __m128i SumPairs(__m128i Pixels0, __m128i Pixels1, __m128i Zero, bool bHigh)
+	{
+		const __m128i Wide0 = bHigh ? _mm_unpackhi_epi8(Pixels0, Zero) : _mm_unpacklo_epi8(Pixels0, Zero);
+		const __m128i Wide1 = bHigh ? _mm_unpackhi_epi8(Pixels1, Zero) : _mm_unpacklo_epi8(Pixels1, Zero);
+		const __m128i Vertical = _mm_add_epi16(Wide0, Wide1);
+		return _mm_add_epi16(Vertical, _mm_srli_si128(Vertical, 8));
+	}
+#endif
+
+	void Halve(const FColor* Src, int32 Width, int32 Height, FColor* Dst)
+	{
+#if SPOUT_DOWNSCALE_SSE2
+		const int32 HalfWidth = (Width + 1) / 2;
+		const int32 HalfHeight = (Height + 1) / 2;
+
+		// output pixels whose two source columns both exist, four per iteration
+		const int32 SimdEnd = (Width / 2) & ~3;
+
+		const __m128i Zero = _mm_setzero_si128();
+		const __m128i Rounding = _mm_set1_epi16(2);
+
+		for (int32 y = 0; y < HalfHeight; ++y)
+		{
+			const FColor* Row0 = Src + (SIZE_T)(y * 2) * Width;
+			const FColor* Row1 = Src + (SIZE_T)FMath::Min(y * 2 + 1, Height - 1) * Width;
+			FColor* DstRow = Dst + (SIZE_T)y * HalfWidth;
+
+			for (int32 x = 0; x < SimdEnd; x += 4)
+			{
+				const __m128i A0 = _mm_loadu_si128((const __m128i*)(Row0 + x * 2));
+				const __m128i A1 = _mm_loadu_si128((const __m128i*)(Row0 + x * 2 + 4));
+				const __m128i B0 = _mm_loadu_si128((const __m128i*)(Row1 + x * 2));
+				const __m128i B1 = _mm_loadu_si128((const __m128i*)(Row1 + x * 2 + 4));
+
+				const __m128i Sum01 = _mm_unpacklo_epi64(SumPairs(A0, B0, Zero, false), SumPairs(A0, B0, Zero, true));
+				const __m128i Sum23 = _mm_unpacklo_epi64(SumPairs(A1, B1, Zero, false), SumPairs(A1, B1, Zero, true));
+
+				const __m128i Average01 = _mm_srli_epi16(_mm_add_epi16(Sum01, Rounding), 2);
+				const __m128i Average23 = _mm_srli_epi16(_mm_add_epi16(Sum23, Rounding), 2);
+
+				_mm_storeu_si128((__m128i*)(DstRow + x), _mm_packus_epi16(Average01, Average23));
+			}
+
+			HalveRowsScalar(Row0, Row1, Width, DstRow, SimdEnd, HalfWidth);
+		}
+#else
+		HalveScalar(Src, Width, Height, Dst);
+#endif
+	}
+
+	void Downscale(const FColor* Src, int32 Width, int32 Height, int32 Factor, TArray<FColor>& Out, FIntPoint& OutSize)
+	{
+		check(FMath::IsPowerOfTwo(Factor));
+
+		OutSize = FIntPoint(Width, Height);
+
+		if (Factor <= 1)
+		{
+			Out.SetNumUninitialized(Width * Height);
+			FMemory::Memcpy(Out.GetData(), Src, (SIZE_T)Width * Height * sizeof(FColor));
+			return;
+		}
+
+		TArray<FColor> Level;
+		const FColor* LevelData = Src;
+
+		for (; Factor > 1; Factor /= 2)
+		{
+			const FIntPoint HalfSize((OutSize.X + 1) / 2, (OutSize.Y + 1) / 2);
+
+			TArray<FColor> Next;
+			Next.SetNumUninitialized(HalfSize.X * HalfSize.Y);
+			Halve(LevelData, OutSize.X, OutSize.Y, Next.GetData());
+
+			Level = MoveTemp(Next);
+			LevelData = Level.GetData();
+			OutSize = HalfSize;
+		}
+
+		Out = MoveTemp(Level);
+	}
+}
@@ -0,0 +1,32 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SpoutTypes.h"
+
+/**
+ * Low-resolution companion stream of a sender, for thumbnails and monitoring.
+ *
+ * The preview is published as its own sender, "<Sender>_Preview". BGRA box downscales
+ * for the memory-share path halve the image repeatedly, so 1/4 and 1/8 average 4x4 and
+ * 8x8 blocks (rounded at each halving). Odd edges repeat their last row or column.
+ */
+namespace SpoutPreviewDownscale
+{
+	/** 4 or 8, or 1 when the preview is disabled. */
+	int32 GetFactor(ESpoutPreviewScale Scale);
+
+	FIntPoint GetScaledSize(FIntPoint Size, int32 Factor);
+
+	FString MakePreviewName(const FString& SenderName);
+
+	/** Portable reference of Halve, Dst holds (Width + 1) / 2 x (Height + 1) / 2 pixels. */
+	void HalveScalar(const FColor* Src, int32 Width, int32 Height, FColor* Dst);
+
+	/** Same result as HalveScalar, SSE2 where available. */
+	void Halve(const FColor* Src, int32 Width, int32 Height, FColor* Dst);
+
+	/** Downscales by Factor (a power of two) into Out, which is resized to GetScaledSize. */
+	void Downscale(const FColor* Src, int32 Width, int32 Height, int32 Factor, TArray<FColor>& Out, FIntPoint& OutSize);
+}
@@ -1,370 +1,1540 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#include "SpoutRecieverActorComponent.h"
-
-#include <string>
-
-#include "Windows/AllowWindowsPlatformTypes.h" 
-#include <d3d11on12.h>
-#include "Spout.h"
-#include "Windows/HideWindowsPlatformTypes.h"
-
-#include "GlobalShader.h"
-#include "UniformBuffer.h"
-#include "RHICommandList.h"
-#include "RHIUtilities.h"
-#include "MediaShaders.h"
-
-static spoutSenderNames senders;
-
-class FTextureCopyVertexShader : public FGlobalShader
-{
-	DECLARE_SHADER_TYPE(FTextureCopyVertexShader, Global);
-public:
-
-	static bool ShouldCache(EShaderPlatform Platform) { return true; }
-
-	FTextureCopyVertexShader(const ShaderMetaType::CompiledShaderInitializerType& Initializer) :
-		FGlobalShader(Initializer)
-	{}
-	FTextureCopyVertexShader() {}
-
-	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
-	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
-	}
-};
-
-class FTextureCopyPixelShader : public FGlobalShader
-{
-	DECLARE_SHADER_TYPE(FTextureCopyPixelShader, Global);
-public:
-
-#if (ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 25) || (ENGINE_MAJOR_VERSION == 5)
-	LAYOUT_FIELD(FShaderResourceParameter, SrcTexture);
-#else ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION <= 24
-	FShaderResourceParameter SrcTexture;
-
-	virtual bool Serialize(FArchive& Ar) override
-	{
-		bool bShaderHasOutdatedParams = FGlobalShader::Serialize(Ar);
-		Ar << SrcTexture;
-		return bShaderHasOutdatedParams;
-	}
-#endif
-
-	static bool ShouldCache(EShaderPlatform Platform) { return true; }
-
-	FTextureCopyPixelShader(const ShaderMetaType::CompiledShaderInitializerType& Initializer) :
-		FGlobalShader(Initializer)
-	{
-		SrcTexture.Bind(Initializer.ParameterMap, TEXT("SrcTexture"));
-	}
-	FTextureCopyPixelShader() {}
-
-	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
-	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
-	}
-};
-
-struct FTextureVertex
-{
-	FVector4 Position;
-	FVector2D UV;
-};
-
-IMPLEMENT_SHADER_TYPE(, FTextureCopyPixelShader, TEXT("/Plugin/Spout2/SpoutReceiverCopyShader.usf"), TEXT("MainPixelShader"), SF_Pixel)
-
-//////////////////////////////////////////////////////////////////////////
-
-struct USpoutRecieverActorComponent::SpoutRecieverContext
-{
-	unsigned int width = 0, height = 0;
-	DXGI_FORMAT dwFormat = DXGI_FORMAT_UNKNOWN;
-	EPixelFormat format = PF_Unknown;
-	FRHITexture2D* Texture2D;
-
-	ID3D11Device* D3D11Device = nullptr;
-	ID3D11DeviceContext* Context = nullptr;
-
-	ID3D12Device* D3D12Device = nullptr;
-	ID3D11On12Device* D3D11on12Device = nullptr;
-	ID3D11Resource* WrappedDX11Resource = nullptr;
-
-	SpoutRecieverContext(unsigned int width, unsigned int height, DXGI_FORMAT dwFormat, FRHITexture2D* Texture2D)
-		: width(width)
-		, height(height)
-		, dwFormat(dwFormat)
-		, Texture2D(Texture2D)
-	{
-		if (dwFormat == DXGI_FORMAT_B8G8R8A8_UNORM)
-			format = PF_B8G8R8A8;
-		else if (dwFormat == DXGI_FORMAT_R16G16B16A16_FLOAT)
-			format = PF_FloatRGBA;
-		else if (dwFormat == DXGI_FORMAT_R32G32B32A32_FLOAT)
-			format = PF_A32B32G32R32F;
-
-		FString RHIName = GDynamicRHI->GetName();
-
-		if (RHIName == TEXT("D3D11"))
-		{
-			D3D11Device = (ID3D11Device*)GDynamicRHI->RHIGetNativeDevice();
-			D3D11Device->GetImmediateContext(&Context);
-		}
-		else if (RHIName == TEXT("D3D12"))
-		{
-			D3D12Device = static_cast<ID3D12Device*>(GDynamicRHI->RHIGetNativeDevice());
-			UINT DeviceFlags11 = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
-
-			verify(D3D11On12CreateDevice(
-				D3D12Device,
-				DeviceFlags11,
-				nullptr,
-				0,
-				nullptr,
-				0,
-				0,
-				&D3D11Device,
-				&Context,
-				nullptr
-			) == S_OK);
-
-			verify(D3D11Device->QueryInterface(__uuidof(ID3D11On12Device), (void**)&D3D11on12Device) == S_OK);
-			
-			ID3D12Resource* NativeTex = (ID3D12Resource*)Texture2D->GetNativeResource();
-
-			D3D11_RESOURCE_FLAGS rf11 = {};
-
-			verify(D3D11on12Device->CreateWrappedResource(
-				NativeTex, &rf11,
-				D3D12_RESOURCE_STATE_COPY_DEST,
-				D3D12_RESOURCE_STATE_PRESENT, __uuidof(ID3D11Resource),
-				(void**)&WrappedDX11Resource) == S_OK);
-		}
-		else throw;
-	}
-
-	~SpoutRecieverContext()
-	{
-		if (WrappedDX11Resource)
-		{
-			D3D11on12Device->ReleaseWrappedResources(&WrappedDX11Resource, 1);
-			WrappedDX11Resource = nullptr;
-		}
-
-		if (D3D11on12Device)
-		{
-			D3D11on12Device->Release();
-			D3D11on12Device = nullptr;
-		}
-
-		if (D3D11Device)
-		{
-			D3D11Device->Release();
-			D3D11Device = nullptr;
-		}
-
-		if (D3D12Device)
-		{
-			D3D12Device->Release();
-			D3D12Device = nullptr;
-		}
-
-		if (Context)
-		{
-			Context->Release();
-			Context = nullptr;
-		}
-
-	}
-
-	void CopyResource(ID3D11Resource* SrcTexture)
-	{
-		check(IsInRenderingThread());
-		if (!GWorld || !SrcTexture) return;
-
-		FString RHIName = GDynamicRHI->GetName();
-
-		if (RHIName == TEXT("D3D11"))
-		{
-			ID3D11Texture2D* NativeTex = (ID3D11Texture2D*)Texture2D->GetNativeResource();
-
-			Context->CopyResource(NativeTex, SrcTexture);
-			Context->Flush();
-		}
-		else if (RHIName == TEXT("D3D12"))
-		{
-			D3D11on12Device->AcquireWrappedResources(&WrappedDX11Resource, 1);
-			Context->CopyResource(WrappedDX11Resource, SrcTexture);
-			D3D11on12Device->ReleaseWrappedResources(&WrappedDX11Resource, 1);
-			Context->Flush();
-		}
-	}
-};
-
-//////////////////////////////////////////////////////////////////////////
-
-USpoutRecieverActorComponent::USpoutRecieverActorComponent()
-{
-	PrimaryComponentTick.bCanEverTick = true;
-	bTickInEditor = true;
-}
-
-// Called when the game starts
-void USpoutRecieverActorComponent::BeginPlay()
-{
-	Super::BeginPlay();
-}
-
-void USpoutRecieverActorComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
-{
-	Super::EndPlay(EndPlayReason);
-}
-
-// Called every frame
-void USpoutRecieverActorComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
-{
-	check(IsInGameThread());
-	
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
-	if (!OutputRenderTarget)
-		return;
-
-	unsigned int width = 0, height = 0;
-	HANDLE hSharehandle = nullptr;
-	DXGI_FORMAT dwFormat = DXGI_FORMAT_UNKNOWN;
-
-	bool find_sender = senders.FindSender(TCHAR_TO_ANSI(*SubscribeName.ToString()), width, height, hSharehandle, (DWORD&)dwFormat);
-
-	EPixelFormat format = PF_Unknown;
-
-	if (dwFormat == DXGI_FORMAT_B8G8R8A8_UNORM)
-		format = PF_B8G8R8A8;
-	else if (dwFormat == DXGI_FORMAT_R16G16B16A16_FLOAT)
-		format = PF_FloatRGBA;
-	else if (dwFormat == DXGI_FORMAT_R32G32B32A32_FLOAT)
-		format = PF_A32B32G32R32F;
-
-	if (!find_sender
-		|| format == PF_Unknown)
-		return;
-
-	{
-		if (!IntermediateTexture2D
-			|| IntermediateTexture2D->GetSizeX() != width
-			|| IntermediateTexture2D->GetSizeY() != height
-			|| IntermediateTexture2D->GetPixelFormat() != format)
-		{
-			IntermediateTexture2D = UTexture2D::CreateTransient(width, height, format, FName("SpoutIntermediate"));
-			IntermediateTexture2D->UpdateResource();
-
-			context = nullptr;
-		}
-
-		ENQUEUE_RENDER_COMMAND(SpoutRecieverRenderThreadOp)([this, hSharehandle, width, height, dwFormat, format](FRHICommandListImmediate& RHICmdList) {
-			check(IsInRenderingThread());
-
-			if (!OutputRenderTarget || !IntermediateTexture2D)
-				return;
-
-			FTextureRenderTargetResource* OutputRenderTargetResource = OutputRenderTarget->GetRenderTargetResource();
-
-			if (!context)
-			{
-				const FTextureResource* IntermediateTextureResource = IntermediateTexture2D->GetResource();
-				check(IntermediateTextureResource);
-				check(IntermediateTextureResource->TextureRHI);
-			
-				FTexture2DRHIRef IntermediateTextureRef = IntermediateTextureResource->TextureRHI->GetTexture2D();
-				check(IntermediateTextureRef);
-			
-				context = TSharedPtr<SpoutRecieverContext>(new SpoutRecieverContext(width, height, dwFormat, IntermediateTextureRef));
-			}
-
-			this->Tick_RenderThread(RHICmdList, hSharehandle, OutputRenderTargetResource);
-		});
-	}
-}
-
-void USpoutRecieverActorComponent::Tick_RenderThread(
-	FRHICommandListImmediate& RHICmdList,
-	void* hSharehandle,
-	FTextureRenderTargetResource* OutputRenderTargetResource
-)
-{
-	check(IsInRenderingThread());
-
-	SCOPED_DRAW_EVENT(RHICmdList, ProcessSpoutCopyTexture);
-
-	if (!GWorld || !GWorld->Scene || !context) return;
-
-	ID3D11Resource* SrcTexture = nullptr;
-	verify(context->D3D11Device->OpenSharedResource(hSharehandle, __uuidof(ID3D11Resource), (void**)(&SrcTexture)) == S_OK);
-	check(SrcTexture);
-
-	context->CopyResource(SrcTexture);
-	SrcTexture->Release();
-
-	FShaderResourceViewRHIRef IntermediateTextureParameterSRV;
-
-	{
-		auto Resource = IntermediateTexture2D->GetResource();
-		auto ParamRef = (Resource->TextureRHI.GetReference());
-		IntermediateTextureParameterSRV = RHICreateShaderResourceView(ParamRef, 0);
-		check(IntermediateTextureParameterSRV.IsValid());
-	}
-
-	{
-		auto ShaderResource = OutputRenderTargetResource->GetRenderTargetTexture(); 
-		
-		FRHIRenderPassInfo RPInfo(
-			ShaderResource,
-			ERenderTargetActions::DontLoad_Store);
-
-		RHICmdList.BeginRenderPass(RPInfo, TEXT("CopySpoutImage"));
-		{
-			FIntPoint OutputSize(
-				OutputRenderTargetResource->GetSizeX(), OutputRenderTargetResource->GetSizeY());
-
-			auto* GlobalShaderMap = GetGlobalShaderMap(GMaxRHIFeatureLevel);
-			TShaderMapRef<FMediaShadersVS> VertexShader(GlobalShaderMap);
-			TShaderMapRef<FTextureCopyPixelShader> PixelShader(GlobalShaderMap);
-
-			// Set the graphic pipeline state.
-			FGraphicsPipelineStateInitializer GraphicsPSOInit;
-			RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
-			GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Never>::GetRHI();
-			GraphicsPSOInit.BlendState = TStaticBlendState<>::GetRHI();
-			GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
-			GraphicsPSOInit.PrimitiveType = PT_TriangleStrip;
-			GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GMediaVertexDeclaration.VertexDeclarationRHI;
-			
-#if (ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 25) || (ENGINE_MAJOR_VERSION == 5)
-			GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
-			GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
-#else ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION <= 24
-			GraphicsPSOInit.BoundShaderState.VertexShaderRHI = GETSAFERHISHADER_VERTEX(*VertexShader);
-			GraphicsPSOInit.BoundShaderState.PixelShaderRHI = GETSAFERHISHADER_PIXEL(*PixelShader);
-#endif
-
-			SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit,
-				0, EApplyRendertargetOption::CheckApply, true);
-
-			if (PixelShader->SrcTexture.IsBound())
-			{
-				auto PixelShaderRHI = GraphicsPSOInit.BoundShaderState.PixelShaderRHI;
-				RHICmdList.SetShaderResourceViewParameter(PixelShaderRHI, PixelShader->SrcTexture.GetBaseIndex(), IntermediateTextureParameterSRV);
-			}
-			
-			FBufferRHIRef VertexBuffer = CreateTempMediaVertexBuffer();
-			RHICmdList.SetStreamSource(0, VertexBuffer, 0);
-			RHICmdList.SetViewport(0, 0, 0.0, OutputSize.X, OutputSize.Y, 1.f);
-			RHICmdList.DrawPrimitive(0, 2, 1);
-		}
-		RHICmdList.EndRenderPass();
-
-		RHICmdList.CopyToResolveTarget(ShaderResource, ShaderResource, FResolveParams());
-	}
-}
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutRecieverActorComponent.h"
+
+#include <set>
+#include <string>
+
+#include "Windows/AllowWindowsPlatformTypes.h" 
+#include <d3d11on12.h>
+#include "Spout.h"
+#include "Windows/HideWindowsPlatformTypes.h"
+
+#include "Async/Async.h"
+#include "GlobalShader.h"
+#include "UniformBuffer.h"
+#include "RHICommandList.h"
+#include "RHIUtilities.h"
+#include "MediaShaders.h"
+#include "LatentActions.h"
+#include "Misc/App.h"
+
+#include "SpoutAtlasLayout.h"
+#include "SpoutFrameMetadata.h"
+#include "SpoutFrameNotifier.h"
+#include "SpoutHdrPacking.h"
+#include "SpoutImageScaler.h"
+#include "SpoutJitterBuffer.h"
+#include "SpoutLateLatch.h"
+#include "SpoutLocalSenders.h"
+#include "SpoutMemoryShare.h"
+#include "SpoutPixelConversion.h"
+#include "SpoutPixelFormats.h"
+#include "SpoutResizePolicy.h"
+#include "SpoutSharedRegistry.h"
+#include "SpoutSourceRegion.h"
+#include "SpoutStats.h"
+#include "SpoutSubscription.h"
+#include "SpoutTransferScheduler.h"
+
+static spoutSenderNames senders;
+
+// sender lookups of late latched copies, only touched on the render thread
+static spoutSenderNames latch_senders;
+
+static TAutoConsoleVariable<float> CVarSpoutIntermediateShrinkDelay(
+	TEXT("Spout2.IntermediateShrinkDelay"),
+	2.f,
+	TEXT("Seconds a receiver's intermediate texture stays larger than the sender before it shrinks."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarSpoutInProcessFastPath(
+	TEXT("Spout2.InProcessFastPath"),
+	1,
+	TEXT("Receivers draw the texture of a sender in the same process directly, without opening and copying its shared texture."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSpoutSenderTimeout(
+	TEXT("Spout2.SenderTimeout"),
+	5.f,
+	TEXT("Seconds without a heartbeat after which a plugin sender counts as dead: receivers stop opening it and evict its name."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSpoutOpenRetryDelay(
+	TEXT("Spout2.OpenRetryDelay"),
+	1.f,
+	TEXT("Seconds before a receiver tries again to open a shared texture handle that failed to open."),
+	ECVF_Default);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shared Receive Copies Skipped"), STAT_SpoutSharedCopiesSkipped, STATGROUP_Spout2);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shared Texture Open Failures"), STAT_SpoutOpenFailures, STATGROUP_Spout2);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Copies Raced By A Publish"), STAT_SpoutRacedCopies, STATGROUP_Spout2);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Stale Senders Evicted"), STAT_SpoutStaleSendersEvicted, STATGROUP_Spout2);
+DECLARE_DWORD_COUNTER_STAT(TEXT("In-Process Receives"), STAT_SpoutInProcessReceives, STATGROUP_Spout2);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Jitter Buffered Frames"), STAT_SpoutJitterBufferedFrames, STATGROUP_Spout2);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Metadata Reads Overwritten"), STAT_SpoutMetadataOverwritten, STATGROUP_Spout2);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Jitter Buffer Latency (ms)"), STAT_SpoutJitterLatency, STATGROUP_Spout2);
+
+namespace SpoutSenderLiveness
+{
+	// game thread, the sweep opens the control region of every registered name
+	static spoutSenderNames sweep_senders;
+
+	// removes every plugin sender whose heartbeat is stale from Spout's sender set, at most once per second
+	static int32 EvictStaleSenders(double Now, double Timeout, bool bForce = false)
+	{
+		static double LastSweepTime = 0.0;
+		if (!bForce && Now - LastSweepTime < 1.0)
+			return 0;
+
+		LastSweepTime = Now;
+
+		std::set<std::string> SenderNames;
+		if (!sweep_senders.GetSenderNames(&SenderNames))
+			return 0;
+
+		int32 Evicted = 0;
+
+		for (const std::string& SenderName : SenderNames)
+		{
+			if (!SpoutSubscription::ShouldEvictSender(ANSI_TO_TCHAR(SenderName.c_str()), Now, Timeout))
+				continue;
+
+			// a sender that only hitched registers its name again, see SpoutSenderContext::Beat
+			if (sweep_senders.ReleaseSenderName(SenderName.c_str()))
+			{
+				UE_LOG(LogTemp, Log, TEXT("Spout2: evicted stale sender %s"), ANSI_TO_TCHAR(SenderName.c_str()));
+				++Evicted;
+			}
+		}
+
+		INC_DWORD_STAT_BY(STAT_SpoutStaleSendersEvicted, Evicted);
+		return Evicted;
+	}
+}
+
+static FAutoConsoleCommand CmdSpoutEvictStaleSenders(
+	TEXT("Spout2.EvictStaleSenders"),
+	TEXT("Removes every plugin sender whose heartbeat is older than Spout2.SenderTimeout from Spout's sender set, and logs how many."),
+	FConsoleCommandDelegate::CreateLambda([]() {
+		const int32 Evicted = SpoutSenderLiveness::EvictStaleSenders(FPlatformTime::Seconds(), CVarSpoutSenderTimeout.GetValueOnGameThread(), true);
+		UE_LOG(LogTemp, Log, TEXT("Spout2: %d stale senders evicted"), Evicted);
+	}));
+
+#if ENGINE_MAJOR_VERSION == 5
+typedef FVector4f FShaderVector4;
+typedef FVector2f FShaderVector2;
+#else
+typedef FVector4 FShaderVector4;
+typedef FVector2D FShaderVector2;
+#endif
+
+class FTextureCopyVertexShader : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FTextureCopyVertexShader, Global);
+public:
+
+	static bool ShouldCache(EShaderPlatform Platform) { return true; }
+
+	FTextureCopyVertexShader(const ShaderMetaType::CompiledShaderInitializerType& Initializer) :
+		FGlobalShader(Initializer)
+	{}
+	FTextureCopyVertexShader() {}
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+};
+
+class FTextureCopyPixelShader : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FTextureCopyPixelShader, Global);
+public:
+
+	class FSwizzleRedBlue : SHADER_PERMUTATION_BOOL("SPOUT_SWIZZLE_RB");
+	class FFlipVertical : SHADER_PERMUTATION_BOOL("SPOUT_FLIP_Y");
+	class FAlphaMode : SHADER_PERMUTATION_INT("SPOUT_ALPHA_MODE", 3);
+	class FColorMode : SHADER_PERMUTATION_INT("SPOUT_COLOR_MODE", 3);
+	class FFilter : SHADER_PERMUTATION_INT("SPOUT_FILTER", 4);
+	class FHdrDecode : SHADER_PERMUTATION_INT("SPOUT_HDR_DECODE", 3);
+
+	using FPermutationDomain = TShaderPermutationDomain<FSwizzleRedBlue, FFlipVertical, FAlphaMode, FColorMode, FFilter, FHdrDecode>;
+
+	static FPermutationDomain GetPermutationVector(const FSpoutConversionOptions& Conversion, ESpoutScaleFilter Filter, ESpoutHdrTransport HdrTransport)
+	{
+		int32 HdrDecode = 0;
+		if (HdrTransport == ESpoutHdrTransport::PQ10)
+			HdrDecode = 1;
+		else if (HdrTransport == ESpoutHdrTransport::Log10)
+			HdrDecode = 2;
+
+		FPermutationDomain PermutationVector;
+		PermutationVector.Set<FFilter>((int32)Filter);
+		PermutationVector.Set<FSwizzleRedBlue>(Conversion.bSwizzleRedBlue);
+		PermutationVector.Set<FFlipVertical>(Conversion.bFlipVertical);
+		PermutationVector.Set<FAlphaMode>((int32)Conversion.Alpha);
+		PermutationVector.Set<FHdrDecode>(HdrDecode);
+
+		// decoded HDR is already linear, sRGB decoding it again is not compiled
+		if (HdrDecode != 0 && Conversion.Color == ESpoutColorConversion::SRGBToLinear)
+			PermutationVector.Set<FColorMode>((int32)ESpoutColorConversion::None);
+		else
+			PermutationVector.Set<FColorMode>((int32)Conversion.Color);
+
+		return PermutationVector;
+	}
+
+#if (ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 25) || (ENGINE_MAJOR_VERSION == 5)
+	LAYOUT_FIELD(FShaderResourceParameter, SrcTexture);
+	LAYOUT_FIELD(FShaderParameter, UVScaleBias);
+	LAYOUT_FIELD(FShaderParameter, FilterScale);
+	LAYOUT_FIELD(FShaderParameter, SourceSize);
+#else ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION <= 24
+	FShaderResourceParameter SrcTexture;
+	FShaderParameter UVScaleBias;
+	FShaderParameter FilterScale;
+	FShaderParameter SourceSize;
+
+	virtual bool Serialize(FArchive& Ar) override
+	{
+		bool bShaderHasOutdatedParams = FGlobalShader::Serialize(Ar);
+		Ar << SrcTexture;
+		Ar << UVScaleBias;
+		Ar << FilterScale;
+		Ar << SourceSize;
+		return bShaderHasOutdatedParams;
+	}
+#endif
+
+	static bool ShouldCache(EShaderPlatform Platform) { return true; }
+
+	FTextureCopyPixelShader(const ShaderMetaType::CompiledShaderInitializerType& Initializer) :
+		FGlobalShader(Initializer)
+	{
+		SrcTexture.Bind(Initializer.ParameterMap, TEXT("SrcTexture"));
+		UVScaleBias.Bind(Initializer.ParameterMap, TEXT("UVScaleBias"));
+		FilterScale.Bind(Initializer.ParameterMap, TEXT("FilterScale"));
+		SourceSize.Bind(Initializer.ParameterMap, TEXT("SourceSize"));
+	}
+	FTextureCopyPixelShader() {}
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		FPermutationDomain PermutationVector(Parameters.PermutationId);
+
+		if (PermutationVector.Get<FHdrDecode>() != 0
+			&& PermutationVector.Get<FColorMode>() == (int32)ESpoutColorConversion::SRGBToLinear)
+			return false;
+
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+};
+
+struct FTextureVertex
+{
+	FVector4 Position;
+	FVector2D UV;
+};
+
+IMPLEMENT_SHADER_TYPE(, FTextureCopyPixelShader, TEXT("/Plugin/Spout2/SpoutReceiverCopyShader.usf"), TEXT("MainPixelShader"), SF_Pixel)
+
+//////////////////////////////////////////////////////////////////////////
+
+struct USpoutRecieverActorComponent::FDrawSettings
+{
+	FSpoutConversionOptions Conversion;
+	ESpoutScaleFilter ScaleFilter = ESpoutScaleFilter::Point;
+	ESpoutScaleMode ScaleMode = ESpoutScaleMode::Stretch;
+	ESpoutHdrTransport HdrTransport = ESpoutHdrTransport::None;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+struct USpoutRecieverActorComponent::SpoutRecieverContext
+{
+	unsigned int width = 0, height = 0;
+	DXGI_FORMAT dwFormat = DXGI_FORMAT_UNKNOWN;
+	EPixelFormat format = PF_Unknown;
+	FTexture2DRHIRef Texture2D;
+
+	ID3D11Device* D3D11Device = nullptr;
+	ID3D11DeviceContext* Context = nullptr;
+
+	ID3D12Device* D3D12Device = nullptr;
+	ID3D11On12Device* D3D11on12Device = nullptr;
+	ID3D11Resource* WrappedDX11Resource = nullptr;
+
+	// the sender's texture stays open while its handle is unchanged
+	HANDLE OpenedHandle = nullptr;
+	ID3D11Resource* OpenedTexture = nullptr;
+
+	// a handle that failed to open, typically left behind by a crashed sender, is not retried every frame
+	HANDLE FailedHandle = nullptr;
+	double FailedTime = 0.0;
+
+	// signalled once the GPU finished the last copy
+	ID3D11Query* CopyQuery = nullptr;
+
+	// senders of a format in another typeless group than the intermediate texture are read back through these
+	ID3D11Texture2D* StagingTexture = nullptr;
+	TArray<uint32> StagingPixels;
+
+	SpoutRecieverContext(unsigned int width, unsigned int height, DXGI_FORMAT dwFormat, FRHITexture2D* Texture2D)
+		: width(width)
+		, height(height)
+		, dwFormat(dwFormat)
+		, format(SpoutPixelFormats::ToPixelFormat(dwFormat))
+		, Texture2D(Texture2D)
+	{
+		FString RHIName = GDynamicRHI->GetName();
+
+		if (RHIName == TEXT("D3D11"))
+		{
+			D3D11Device = (ID3D11Device*)GDynamicRHI->RHIGetNativeDevice();
+			D3D11Device->GetImmediateContext(&Context);
+		}
+		else if (RHIName == TEXT("D3D12"))
+		{
+			D3D12Device = static_cast<ID3D12Device*>(GDynamicRHI->RHIGetNativeDevice());
+			UINT DeviceFlags11 = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
+
+			verify(D3D11On12CreateDevice(
+				D3D12Device,
+				DeviceFlags11,
+				nullptr,
+				0,
+				nullptr,
+				0,
+				0,
+				&D3D11Device,
+				&Context,
+				nullptr
+			) == S_OK);
+
+			verify(D3D11Device->QueryInterface(__uuidof(ID3D11On12Device), (void**)&D3D11on12Device) == S_OK);
+			
+			ID3D12Resource* NativeTex = (ID3D12Resource*)Texture2D->GetNativeResource();
+
+			D3D11_RESOURCE_FLAGS rf11 = {};
+
+			verify(D3D11on12Device->CreateWrappedResource(
+				NativeTex, &rf11,
+				D3D12_RESOURCE_STATE_COPY_DEST,
+				D3D12_RESOURCE_STATE_PRESENT, __uuidof(ID3D11Resource),
+				(void**)&WrappedDX11Resource) == S_OK);
+		}
+		else throw;
+	}
+
+	~SpoutRecieverContext()
+	{
+		ReleaseSharedTexture();
+
+		if (CopyQuery)
+		{
+			CopyQuery->Release();
+			CopyQuery = nullptr;
+		}
+
+		if (StagingTexture)
+		{
+			StagingTexture->Release();
+			StagingTexture = nullptr;
+		}
+
+		if (WrappedDX11Resource)
+		{
+			D3D11on12Device->ReleaseWrappedResources(&WrappedDX11Resource, 1);
+			WrappedDX11Resource = nullptr;
+		}
+
+		if (D3D11on12Device)
+		{
+			D3D11on12Device->Release();
+			D3D11on12Device = nullptr;
+		}
+
+		if (D3D11Device)
+		{
+			D3D11Device->Release();
+			D3D11Device = nullptr;
+		}
+
+		if (D3D12Device)
+		{
+			D3D12Device->Release();
+			D3D12Device = nullptr;
+		}
+
+		if (Context)
+		{
+			Context->Release();
+			Context = nullptr;
+		}
+
+	}
+
+	// null when the handle does not open, such as one whose sender is gone
+	ID3D11Resource* OpenSharedTexture(HANDLE hSharehandle)
+	{
+		if (OpenedTexture && OpenedHandle == hSharehandle)
+			return OpenedTexture;
+
+		ReleaseSharedTexture();
+
+		const double Now = FPlatformTime::Seconds();
+		if (hSharehandle == FailedHandle && Now - FailedTime < CVarSpoutOpenRetryDelay.GetValueOnRenderThread())
+			return nullptr;
+
+		if (FAILED(D3D11Device->OpenSharedResource(hSharehandle, __uuidof(ID3D11Resource), (void**)(&OpenedTexture))) || !OpenedTexture)
+		{
+			INC_DWORD_STAT(STAT_SpoutOpenFailures);
+			OpenedTexture = nullptr;
+			FailedHandle = hSharehandle;
+			FailedTime = Now;
+			return nullptr;
+		}
+
+		FailedHandle = nullptr;
+		OpenedHandle = hSharehandle;
+		return OpenedTexture;
+	}
+
+	void ReleaseSharedTexture()
+	{
+		if (OpenedTexture)
+		{
+			OpenedTexture->Release();
+			OpenedTexture = nullptr;
+		}
+		OpenedHandle = nullptr;
+	}
+
+	// the intermediate texture is bucketed and may be larger than the sender, the copy fills its top-left corner
+	void CopyResource(ID3D11Resource* SrcTexture, const FIntRect& SrcRect)
+	{
+		check(IsInRenderingThread());
+		if (!GWorld || !SrcTexture) return;
+
+		const D3D11_BOX SrcBox = { (UINT)SrcRect.Min.X, (UINT)SrcRect.Min.Y, 0,
+			(UINT)SrcRect.Min.X + FMath::Min((uint32)SrcRect.Width(), Texture2D->GetSizeX()),
+			(UINT)SrcRect.Min.Y + FMath::Min((uint32)SrcRect.Height(), Texture2D->GetSizeY()), 1 };
+
+		FString RHIName = GDynamicRHI->GetName();
+
+		if (!CopyQuery)
+		{
+			D3D11_QUERY_DESC QueryDesc = { D3D11_QUERY_EVENT, 0 };
+			D3D11Device->CreateQuery(&QueryDesc, &CopyQuery);
+		}
+
+		// a sender's X8 texture cannot be copied into the engine's BGRA8 texture, its bits are read back instead
+		const bool bDirectCopy = SpoutPixelFormats::AreCopyCompatible(dwFormat, SpoutPixelFormats::FromPixelFormat(format));
+		if (!bDirectCopy && !ReadBack(SrcTexture, SrcBox))
+			return;
+
+		ID3D11Resource* DstTexture = nullptr;
+		if (RHIName == TEXT("D3D11"))
+		{
+			DstTexture = (ID3D11Texture2D*)Texture2D->GetNativeResource();
+		}
+		else if (RHIName == TEXT("D3D12"))
+		{
+			D3D11on12Device->AcquireWrappedResources(&WrappedDX11Resource, 1);
+			DstTexture = WrappedDX11Resource;
+		}
+
+		if (bDirectCopy)
+		{
+			Context->CopySubresourceRegion(DstTexture, 0, 0, 0, 0, SrcTexture, 0, &SrcBox);
+		}
+		else
+		{
+			const D3D11_BOX DstBox = { 0, 0, 0, SrcBox.right - SrcBox.left, SrcBox.bottom - SrcBox.top, 1 };
+			Context->UpdateSubresource(DstTexture, 0, &DstBox, StagingPixels.GetData(), DstBox.right * sizeof(uint32), 0);
+		}
+
+		if (RHIName == TEXT("D3D12"))
+			D3D11on12Device->ReleaseWrappedResources(&WrappedDX11Resource, 1);
+
+		if (CopyQuery)
+			Context->End(CopyQuery);
+
+		Context->Flush();
+	}
+
+	// copies the box into a CPU readable texture of the sender's format and reads it with an opaque alpha;
+	// mapping waits for that copy, which only senders of a Readback format pay
+	bool ReadBack(ID3D11Resource* SrcTexture, const D3D11_BOX& SrcBox)
+	{
+		check(SpoutPixelFormats::GetConversionCost(dwFormat) == SpoutPixelFormats::EConversionCost::Readback);
+
+		if (!StagingTexture)
+		{
+			D3D11_TEXTURE2D_DESC Desc = {};
+			Desc.Width = Texture2D->GetSizeX();
+			Desc.Height = Texture2D->GetSizeY();
+			Desc.MipLevels = 1;
+			Desc.ArraySize = 1;
+			Desc.Format = (DXGI_FORMAT)SpoutPixelFormats::ToShareableFormat(dwFormat);
+			Desc.SampleDesc.Count = 1;
+			Desc.Usage = D3D11_USAGE_STAGING;
+			Desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+
+			if (FAILED(D3D11Device->CreateTexture2D(&Desc, nullptr, &StagingTexture)))
+			{
+				StagingTexture = nullptr;
+				return false;
+			}
+		}
+
+		Context->CopySubresourceRegion(StagingTexture, 0, 0, 0, 0, SrcTexture, 0, &SrcBox);
+
+		D3D11_MAPPED_SUBRESOURCE Mapped;
+		if (FAILED(Context->Map(StagingTexture, 0, D3D11_MAP_READ, 0, &Mapped)))
+			return false;
+
+		const uint32 Width = SrcBox.right - SrcBox.left;
+		const uint32 Height = SrcBox.bottom - SrcBox.top;
+		StagingPixels.SetNumUninitialized(Width * Height);
+
+		// the X byte is undefined, the intermediate texture's alpha is not
+		for (uint32 Y = 0; Y < Height; ++Y)
+		{
+			const uint32* Src = (const uint32*)((const uint8*)Mapped.pData + Y * Mapped.RowPitch);
+			uint32* Dst = &StagingPixels[Y * Width];
+
+			for (uint32 X = 0; X < Width; ++X)
+				Dst[X] = Src[X] | 0xFF000000u;
+		}
+
+		Context->Unmap(StagingTexture, 0);
+		return true;
+	}
+
+	// true once the GPU finished every copy issued so far; never waits, the copies were flushed
+	bool IsCopyComplete()
+	{
+		BOOL bDone = FALSE;
+		return CopyQuery && Context->GetData(CopyQuery, &bDone, sizeof(bDone), D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK && bDone;
+	}
+
+	// blocks until IsCopyComplete, for a second at most; false when it was not
+	bool WaitForCopy()
+	{
+		const double Deadline = FPlatformTime::Seconds() + 1.0;
+
+		while (!IsCopyComplete())
+		{
+			if (!CopyQuery || FPlatformTime::Seconds() >= Deadline)
+				return false;
+
+			FPlatformProcess::SleepNoStats(0.0001f);
+		}
+
+		return true;
+	}
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+/**
+ * Everything a sender costs a process to receive, whatever the number of receiver components:
+ * one intermediate texture, one open of the shared texture and at most one copy per rendered
+ * frame. Each component then only draws the intermediate into its own output.
+ * Receivers of different regions of a sender get a reception each, sized to their crop.
+ */
+struct USpoutRecieverActorComponent::FSharedReception
+{
+	const FString SenderName;
+	const bool bFromMemory;
+	const FIntRect Region;
+
+	// game thread
+	UTexture2D* IntermediateTexture2D = nullptr;
+	FSpoutResizePolicy IntermediateResize;
+
+	// received on worker tasks, under MemoryLock
+	FSpoutMemoryReceiver MemoryReceiver;
+
+	// set by the game thread once a component asks for lossless delivery, never cleared
+	volatile bool bAcknowledgeFrames = false;
+
+	// render thread
+	TSharedPtr<SpoutRecieverContext> context;
+	TUniquePtr<FSpoutSubscription> Acknowledger;
+	TUniquePtr<FSpoutPublishedFrames> PublishedFrames;
+	bool bCopied = false;
+	uint32 CopiedFrame = 0;
+	HANDLE CopiedHandle = nullptr;
+	FIntRect CopiedRect;
+	FRHITexture2D* CopiedTarget = nullptr;
+
+	// sender frame id and publish time of the last copy, zero for senders outside the plugin
+	int64 CopiedFrameId = 0;
+	double CopiedFrameTime = 0.0;
+
+	// the frame the last copy read for acknowledging receptions, acknowledged once the GPU finished that copy
+	int64 UnacknowledgedFrameId = 0;
+
+	/** A decoded memory-share frame, cropped; every component converts it to its own output. */
+	struct FMemoryFrame
+	{
+		TArray<FColor> Pixels;
+		FIntPoint Size = FIntPoint::ZeroValue;
+		int64 FrameId = 0;
+	};
+
+	// the first component's task to find a new frame decodes it for the others
+	FCriticalSection MemoryLock;
+	TSharedPtr<const FMemoryFrame, ESPMode::ThreadSafe> MemoryFrame;
+
+	FSharedReception(const FString& SenderName, bool bFromMemory, const FIntRect& Region)
+		: SenderName(SenderName)
+		, bFromMemory(bFromMemory)
+		, Region(Region)
+		, MemoryReceiver(SenderName)
+	{
+	}
+
+	~FSharedReception()
+	{
+		if (IntermediateTexture2D && UObjectInitialized())
+			IntermediateTexture2D->RemoveFromRoot();
+	}
+
+	static TSharedRef<FSharedReception, ESPMode::ThreadSafe> Acquire(const FString& SenderName, bool bFromMemory, const FIntRect& Region)
+	{
+		static TSpoutSharedRegistry<FString, FSharedReception> Registry;
+
+		FString Key = bFromMemory ? SenderName + TEXT("|Memory") : SenderName;
+		if (Region.Area() > 0)
+			Key += FString::Printf(TEXT("|%d,%d,%d,%d"), Region.Min.X, Region.Min.Y, Region.Max.X, Region.Max.Y);
+
+		return Registry.Acquire(Key, [&SenderName, bFromMemory, &Region]() {
+			return MakeShared<FSharedReception, ESPMode::ThreadSafe>(SenderName, bFromMemory, Region);
+		});
+	}
+
+	void UpdateIntermediateTexture(uint32 Width, uint32 Height, EPixelFormat Format)
+	{
+		check(IsInGameThread());
+
+		if (!IntermediateTexture2D)
+			IntermediateResize.Reset();
+
+		if (IntermediateResize.Update(Width, Height, Format, FPlatformTime::Seconds(), CVarSpoutIntermediateShrinkDelay.GetValueOnGameThread()))
+		{
+			const FIntPoint AllocationSize = IntermediateResize.GetAllocationSize();
+
+			if (IntermediateTexture2D)
+				IntermediateTexture2D->RemoveFromRoot();
+
+			IntermediateTexture2D = UTexture2D::CreateTransient(AllocationSize.X, AllocationSize.Y, Format, FName("SpoutIntermediate"));
+			IntermediateTexture2D->AddToRoot();
+			IntermediateTexture2D->UpdateResource();
+		}
+	}
+
+	FRHITexture2D* GetIntermediate_RenderThread() const
+	{
+		const FTextureResource* Resource = IntermediateTexture2D ? IntermediateTexture2D->GetResource() : nullptr;
+		return Resource && Resource->TextureRHI ? Resource->TextureRHI->GetTexture2D() : nullptr;
+	}
+
+	bool IsCopied_RenderThread(HANDLE hSharehandle, const FIntRect& SourceRect, FRHITexture2D* Intermediate) const
+	{
+		return bCopied
+			&& CopiedFrame == GFrameNumberRenderThread
+			&& CopiedHandle == hSharehandle
+			&& CopiedRect == SourceRect
+			&& CopiedTarget == Intermediate;
+	}
+
+	void MarkCopied_RenderThread(HANDLE hSharehandle, const FIntRect& SourceRect, FRHITexture2D* Intermediate)
+	{
+		bCopied = true;
+		CopiedFrame = GFrameNumberRenderThread;
+		CopiedHandle = hSharehandle;
+		CopiedRect = SourceRect;
+		CopiedTarget = Intermediate;
+	}
+
+	// the first receiver of a frame copies, the others find the intermediate already filled;
+	// false when the sender's texture does not open, or the sender published through both copy attempts
+	bool CopySharedTexture_RenderThread(HANDLE hSharehandle, const FIntRect& SourceRect, DXGI_FORMAT DxgiFormat, FRHITexture2D* Intermediate)
+	{
+		check(IsInRenderingThread());
+
+		if (IsCopied_RenderThread(hSharehandle, SourceRect, Intermediate))
+		{
+			INC_DWORD_STAT(STAT_SpoutSharedCopiesSkipped);
+			return true;
+		}
+
+		// a BGRX8 and a BGRA8 sender share an intermediate format but not the copy path
+		if (context && (context->Texture2D != Intermediate || context->dwFormat != DxgiFormat))
+			context.Reset();
+
+		if (!context)
+			context = TSharedPtr<SpoutRecieverContext>(new SpoutRecieverContext(SourceRect.Width(), SourceRect.Height(), DxgiFormat, Intermediate));
+
+		if (!PublishedFrames.IsValid())
+			PublishedFrames = MakeUnique<FSpoutPublishedFrames>(SenderName);
+
+		if (bAcknowledgeFrames && !Acknowledger.IsValid())
+			Acknowledger = MakeUnique<FSpoutSubscription>(SenderName, true);
+
+		if (Acknowledger.IsValid())
+		{
+			Acknowledger->Heartbeat(FPlatformTime::Seconds());
+			AcknowledgeCompletedCopy_RenderThread();
+		}
+
+		ID3D11Resource* SharedTexture = context->OpenSharedTexture(hSharehandle);
+		if (!SharedTexture)
+			return false;
+
+		// the copy is labelled with the newest frame announced when it was issued, senders announce once their GPU
+		// write finished. Acknowledging receptions wait for their copy anyway: one that a write of the sender was in
+		// flight for, or started during, may hold parts of two frames and is retried once, otherwise dropped
+		int64 FrameId = 0;
+		double FrameTime = 0.0;
+
+		for (int32 Attempt = 0;; ++Attempt)
+		{
+			bool bWriting = false;
+			const int64 Writes = PublishedFrames->ReadWrites(bWriting);
+
+			PublishedFrames->ReadNewest(FrameId, FrameTime);
+			context->CopyResource(SharedTexture, SourceRect);
+
+			if (!Acknowledger.IsValid())
+				break;
+
+			// a lossless sender of this process waits for the ack on its game thread, it must not need our next tick
+			bool bWritingAfter = false;
+			if (context->WaitForCopy() && !bWriting && PublishedFrames->ReadWrites(bWritingAfter) == Writes && !bWritingAfter)
+				break;
+
+			INC_DWORD_STAT(STAT_SpoutRacedCopies);
+
+			if (Attempt > 0)
+				return false;
+		}
+
+		// the sender may overwrite the frame once acknowledged, not before our copy of it ran on the GPU
+		if (Acknowledger.IsValid())
+		{
+			UnacknowledgedFrameId = FrameId;
+			AcknowledgeCompletedCopy_RenderThread();
+		}
+
+		CopiedFrameId = FrameId;
+		CopiedFrameTime = FrameTime;
+
+		MarkCopied_RenderThread(hSharehandle, SourceRect, Intermediate);
+		return true;
+	}
+
+	// a later copy's query covers the earlier ones, only the newest frame copied is pending
+	void AcknowledgeCompletedCopy_RenderThread()
+	{
+		if (UnacknowledgedFrameId == 0 || !context || !context->IsCopyComplete())
+			return;
+
+		Acknowledger->Acknowledge(UnacknowledgedFrameId);
+		UnacknowledgedFrameId = 0;
+	}
+
+	// the newest memory-share frame, decoded once whichever component's task asks first; null until one was published
+	TSharedPtr<const FMemoryFrame, ESPMode::ThreadSafe> ReceiveMemory()
+	{
+		FScopeLock Lock(&MemoryLock);
+
+		// a torn read or no new publish keeps the held frame
+		TSharedPtr<FMemoryFrame, ESPMode::ThreadSafe> Frame = MakeShared<FMemoryFrame, ESPMode::ThreadSafe>();
+		if (MemoryReceiver.Receive(Frame->Pixels, Frame->Size.X, Frame->Size.Y, Region) && Frame->Size.X > 0 && Frame->Size.Y > 0)
+		{
+			Frame->FrameId = MemoryReceiver.GetLastFrameId();
+			MemoryFrame = Frame;
+		}
+
+		return MemoryFrame;
+	}
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+/** A receiver's jitter buffer: one texture per slot, filled from the reception's intermediate as frames arrive. */
+struct USpoutRecieverActorComponent::FJitterState
+{
+	FSpoutJitterBuffer Buffer;
+
+	// game thread, the state is replaced rather than resized, after a flush
+	TArray<UTexture2D*> Textures;
+	ESpoutJitterPolicy Policy = ESpoutJitterPolicy::SmoothCadence;
+
+	// render thread, size of the frame held by each slot
+	TArray<FIntPoint> FrameSizes;
+
+	FJitterState(int32 Capacity, const UTexture2D* Intermediate)
+	{
+		Buffer.Reset(Capacity);
+		FrameSizes.SetNumZeroed(Capacity);
+
+		for (int32 Slot = 0; Slot < Capacity; ++Slot)
+		{
+			UTexture2D* Texture = UTexture2D::CreateTransient(Intermediate->GetSizeX(), Intermediate->GetSizeY(), Intermediate->GetPixelFormat(), FName("SpoutJitterSlot"));
+			Texture->AddToRoot();
+			Texture->UpdateResource();
+			Textures.Add(Texture);
+		}
+	}
+
+	~FJitterState()
+	{
+		if (!UObjectInitialized())
+			return;
+
+		for (UTexture2D* Texture : Textures)
+			Texture->RemoveFromRoot();
+	}
+
+	bool Matches(int32 Capacity, const UTexture2D* Intermediate) const
+	{
+		return Textures.Num() == Capacity
+			&& Textures[0]->GetSizeX() == Intermediate->GetSizeX()
+			&& Textures[0]->GetSizeY() == Intermediate->GetSizeY()
+			&& Textures[0]->GetPixelFormat() == Intermediate->GetPixelFormat();
+	}
+
+	FRHITexture2D* GetSlot_RenderThread(int32 Slot) const
+	{
+		const FTextureResource* Resource = Textures[Slot]->GetResource();
+		return Resource && Resource->TextureRHI ? Resource->TextureRHI->GetTexture2D() : nullptr;
+	}
+
+	// buffers the frame the reception copied into Intermediate, then returns the slot to draw at FrameTime, null while empty
+	FRHITexture2D* Select_RenderThread(FRHICommandListImmediate& RHICmdList, int64 FrameId, double PublishTime, FRHITexture2D* Intermediate, FIntPoint FrameSize, double FrameTime, FIntPoint& OutSize)
+	{
+		check(IsInRenderingThread());
+
+		const int32 Slot = Buffer.Push(FrameId, PublishTime);
+		if (Slot != INDEX_NONE)
+		{
+			if (FRHITexture2D* SlotTexture = GetSlot_RenderThread(Slot))
+			{
+				FRHICopyTextureInfo CopyInfo;
+				CopyInfo.Size = FIntVector(FrameSize.X, FrameSize.Y, 1);
+
+				RHICmdList.Transition(FRHITransitionInfo(Intermediate, ERHIAccess::SRVMask, ERHIAccess::CopySrc));
+				RHICmdList.Transition(FRHITransitionInfo(SlotTexture, ERHIAccess::SRVMask, ERHIAccess::CopyDest));
+				RHICmdList.CopyTexture(Intermediate, SlotTexture, CopyInfo);
+				RHICmdList.Transition(FRHITransitionInfo(Intermediate, ERHIAccess::CopySrc, ERHIAccess::SRVMask));
+				RHICmdList.Transition(FRHITransitionInfo(SlotTexture, ERHIAccess::CopyDest, ERHIAccess::SRVMask));
+
+				FrameSizes[Slot] = FrameSize;
+			}
+		}
+
+		const int32 Selected = Buffer.Select(Policy, FrameTime);
+
+		INC_DWORD_STAT_BY(STAT_SpoutJitterBufferedFrames, Buffer.GetOccupancy());
+		SET_FLOAT_STAT(STAT_SpoutJitterLatency, Buffer.GetLatency() * 1000.0);
+
+		if (Selected == INDEX_NONE || FrameSizes[Selected] == FIntPoint::ZeroValue)
+			return nullptr;
+
+		OutSize = FrameSizes[Selected];
+		return GetSlot_RenderThread(Selected);
+	}
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+/**
+ * A receiver's memory-share output: the frame decoded, converted and scaled on a worker task,
+ * then uploaded and drawn unchanged on the render thread.
+ */
+struct USpoutRecieverActorComponent::FMemoryOutput
+{
+	/** A frame as the copy shader would draw it at the output size. */
+	struct FConverted
+	{
+		TArray<FFloat16Color> Pixels;
+		int64 FrameId = 0;
+	};
+
+	typedef TSharedPtr<FConverted, ESPMode::ThreadSafe> FConvertedPtr;
+
+	// game thread, the output is replaced rather than resized, after its task and a flush
+	UTexture2D* Texture = nullptr;
+	const FIntPoint Size;
+	TFuture<FConvertedPtr> Pending;
+
+	explicit FMemoryOutput(FIntPoint Size)
+		: Size(Size)
+	{
+		Texture = UTexture2D::CreateTransient(Size.X, Size.Y, PF_FloatRGBA, FName("SpoutMemoryOutput"));
+		Texture->AddToRoot();
+		Texture->UpdateResource();
+	}
+
+	~FMemoryOutput()
+	{
+		// the task reads the reception, which outlives this output
+		if (Pending.IsValid())
+			Pending.Wait();
+
+		if (UObjectInitialized())
+			Texture->RemoveFromRoot();
+	}
+
+	FRHITexture2D* GetTexture_RenderThread() const
+	{
+		const FTextureResource* Resource = Texture->GetResource();
+		return Resource && Resource->TextureRHI ? Resource->TextureRHI->GetTexture2D() : nullptr;
+	}
+
+	// worker thread: the reception's newest frame, converted again while the sender holds it so settings apply; null until one was published
+	static FConvertedPtr Convert(FSharedReception& Shared, FIntPoint Size, const FDrawSettings& DrawSettings)
+	{
+		TSharedPtr<const FSharedReception::FMemoryFrame, ESPMode::ThreadSafe> Frame = Shared.ReceiveMemory();
+		if (!Frame.IsValid())
+			return nullptr;
+
+		TArray<FLinearColor> Converted;
+		Converted.SetNumUninitialized(Size.X * Size.Y);
+		SpoutPixelConversion::ConvertScaledImage(
+			Frame->Pixels.GetData(), Frame->Size.X, Frame->Size.Y,
+			Converted.GetData(), Size.X, Size.Y,
+			DrawSettings.Conversion, DrawSettings.ScaleFilter, DrawSettings.ScaleMode);
+
+		FConvertedPtr Result = MakeShared<FConverted, ESPMode::ThreadSafe>();
+		Result->FrameId = Frame->FrameId;
+		Result->Pixels.SetNumUninitialized(Converted.Num());
+		for (int32 Index = 0; Index < Converted.Num(); ++Index)
+			Result->Pixels[Index] = FFloat16Color(Converted[Index]);
+
+		return Result;
+	}
+
+	// null until the texture exists
+	FRHITexture2D* Upload_RenderThread(const FConverted& Frame) const
+	{
+		check(IsInRenderingThread());
+
+		FRHITexture2D* Target = GetTexture_RenderThread();
+		if (!Target)
+			return nullptr;
+
+		RHIUpdateTexture2D(Target, 0, FUpdateTextureRegion2D(0, 0, 0, 0, Size.X, Size.Y), Size.X * sizeof(FFloat16Color), (const uint8*)Frame.Pixels.GetData());
+		return Target;
+	}
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+/** "Wait For Next Spout Frame": polls a frame future once per world tick, like the engine's own Delay. */
+class FSpoutWaitForFrameAction : public FPendingLatentAction
+{
+public:
+
+	FSpoutWaitForFrameAction(TFuture<FSpoutReceivedFrame>&& InFuture, float Timeout, bool& InReceived, FSpoutReceivedFrame& InFrame, const FLatentActionInfo& LatentInfo)
+		: Future(MoveTemp(InFuture))
+		, TimeRemaining(Timeout)
+		, bWaitForever(Timeout <= 0.f)
+		, bReceived(InReceived)
+		, Frame(InFrame)
+		, ExecutionFunction(LatentInfo.ExecutionFunction)
+		, OutputLink(LatentInfo.Linkage)
+		, CallbackTarget(LatentInfo.CallbackTarget)
+	{
+	}
+
+	virtual void UpdateOperation(FLatentResponse& Response) override
+	{
+		if (Future.IsReady())
+		{
+			Frame = Future.Get();
+			bReceived = Frame.IsValid();
+			Response.FinishAndTriggerIf(true, ExecutionFunction, OutputLink, CallbackTarget);
+			return;
+		}
+
+		TimeRemaining -= Response.ElapsedTime();
+		if (!bWaitForever && TimeRemaining <= 0.f)
+		{
+			Frame = FSpoutReceivedFrame();
+			bReceived = false;
+			Response.FinishAndTriggerIf(true, ExecutionFunction, OutputLink, CallbackTarget);
+		}
+	}
+
+#if WITH_EDITOR
+	virtual FString GetDescription() const override
+	{
+		return bWaitForever
+			? FString(TEXT("Waiting for the next Spout frame"))
+			: FString::Printf(TEXT("Waiting for the next Spout frame (%.2f s left)"), TimeRemaining);
+	}
+#endif
+
+private:
+
+	TFuture<FSpoutReceivedFrame> Future;
+	float TimeRemaining;
+	const bool bWaitForever;
+	bool& bReceived;
+	FSpoutReceivedFrame& Frame;
+
+	FName ExecutionFunction;
+	int32 OutputLink;
+	FWeakObjectPtr CallbackTarget;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+USpoutRecieverActorComponent::USpoutRecieverActorComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	bTickInEditor = true;
+
+	FrameNotifier = MakeShared<FSpoutFrameNotifier, ESPMode::ThreadSafe>();
+}
+
+// Called when the game starts
+void USpoutRecieverActorComponent::BeginPlay()
+{
+	Super::BeginPlay();
+}
+
+void USpoutRecieverActorComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	ReleaseReception();
+	Subscription.Reset();
+	FrameNotifier->Cancel();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void USpoutRecieverActorComponent::OnUnregister()
+{
+	ReleaseReception();
+	Subscription.Reset();
+	LocalFrames.Reset();
+	FrameNotifier->Cancel();
+
+	if (TransferStreamId != INDEX_NONE)
+	{
+		FSpoutTransferScheduler::Get().UnregisterStream(TransferStreamId);
+		TransferStreamId = INDEX_NONE;
+	}
+
+	Super::OnUnregister();
+}
+
+// Called every frame
+void USpoutRecieverActorComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	check(IsInGameThread());
+	
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// whatever the render thread drew since the last tick
+	if (FrameNotifier->TakeUndispatched(DispatchedFrame))
+		OnFrameReceived.Broadcast(DispatchedFrame.FrameId, DispatchedFrame.Timestamp);
+
+	if (!OutputRenderTarget)
+	{
+		ReleaseReception();
+		Subscription.Reset();
+		return;
+	}
+
+	// senders with bOnlyWhileSubscribed resume publishing the frame after this beats for the first time
+	const FString SenderName = SubscribeName.ToString();
+	if (!Subscription.IsValid() || Subscription->GetSenderName() != SenderName)
+		Subscription = MakeShared<FSpoutSubscription>(SenderName);
+
+	const double Now = FPlatformTime::Seconds();
+	Subscription->Heartbeat(Now);
+
+	// a plugin sender that stopped beating crashed or hangs, its texture is not opened until it beats again
+	const float SenderTimeout = CVarSpoutSenderTimeout.GetValueOnGameThread();
+	if (Subscription->IsSenderStale(Now, SenderTimeout))
+	{
+		ReleaseReception();
+		SpoutSenderLiveness::EvictStaleSenders(Now, SenderTimeout);
+		return;
+	}
+
+	if (bReceiveFromMemory)
+	{
+		LateLatch.Reset();
+		TickMemoryShare();
+		return;
+	}
+
+	unsigned int width = 0, height = 0;
+	HANDLE hSharehandle = nullptr;
+	DXGI_FORMAT dwFormat = DXGI_FORMAT_UNKNOWN;
+
+	bool find_sender = senders.FindSender(TCHAR_TO_ANSI(*SubscribeName.ToString()), width, height, hSharehandle, (DWORD&)dwFormat);
+
+	const EPixelFormat format = SpoutPixelFormats::ToPixelFormat(dwFormat);
+
+	if (!find_sender
+		|| SpoutPixelFormats::GetConversionCost(dwFormat) == SpoutPixelFormats::EConversionCost::Unsupported)
+		return;
+
+	if (!ScheduleTransfer())
+		return;
+
+	FDrawSettings DrawSettings = MakeDrawSettings();
+
+	FIntRect SourceRect(0, 0, width, height);
+	bool bFromAtlas = false;
+
+	SharedTextureInfo SenderInfo;
+	if (senders.getSharedInfo(TCHAR_TO_ANSI(*SubscribeName.ToString()), &SenderInfo))
+	{
+		DrawSettings.HdrTransport = SpoutHdrPacking::FromUsageTag(SenderInfo.usage);
+
+		// a logical sender of an atlas announces the whole atlas, its table has the rectangle
+		FString AtlasName;
+		if (SpoutAtlas::ParseDescription((const TCHAR*)SenderInfo.description, AtlasName))
+		{
+			if (!AtlasReader.IsValid() || AtlasReader->GetAtlasName() != AtlasName)
+				AtlasReader = MakeShared<FSpoutAtlasTableReader>(AtlasName);
+
+			if (!AtlasReader->Find(SenderName, SourceRect))
+				return;
+
+			bFromAtlas = true;
+		}
+		else
+		{
+			AtlasReader.Reset();
+		}
+	}
+
+	// only the crop is copied, and the intermediate texture is sized to it
+	const FIntRect Region = GetSourceRegion();
+	SourceRect = SpoutSourceRegion::Resolve(SourceRect, Region);
+	if (SourceRect.Width() <= 0 || SourceRect.Height() <= 0)
+		return;
+
+	// a sender of this process: no open, no 11On12 wrapping and no copy, the draw reads its texture
+	FTexture2DRHIRef LocalTexture;
+	if (!bFromAtlas && SourceRect.Min == FIntPoint::ZeroValue && CVarSpoutInProcessFastPath.GetValueOnGameThread() != 0)
+		LocalTexture = FSpoutLocalSenders::Get().Find(SenderName, hSharehandle);
+
+	if (LocalTexture.IsValid())
+	{
+		ReleaseReception();
+
+		if (!LocalFrames.IsValid() || LocalFrames->GetSenderName() != SenderName)
+			LocalFrames = MakeShared<FSpoutPublishedFrames>(SenderName);
+
+		int64 LocalFrameId = 0;
+		double LocalFrameTime = 0.0;
+		LocalFrames->ReadNewest(LocalFrameId, LocalFrameTime);
+
+		ENQUEUE_RENDER_COMMAND(SpoutLocalRecieverRenderThreadOp)([this, LocalTexture, SourceSize = SourceRect.Size(), DrawSettings, SenderName, LocalFrameId, LocalFrameTime](FRHICommandListImmediate& RHICmdList) {
+			if (!OutputRenderTarget)
+				return;
+
+			const double StartTime = FPlatformTime::Seconds();
+
+			DrawSpoutTexture_RenderThread(RHICmdList, LocalTexture, SourceSize, OutputRenderTarget->GetRenderTargetResource(), DrawSettings);
+			INC_DWORD_STAT(STAT_SpoutInProcessReceives);
+			NotifyFrameDrawn_RenderThread(LocalFrameId, LocalFrameTime, SenderName);
+
+			FSpoutTransferScheduler::Get().ReportSubmitCost(TransferStreamId, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+		});
+		return;
+	}
+
+	FSharedReception& Shared = AcquireReception(SenderName, false, Region);
+	Shared.UpdateIntermediateTexture(SourceRect.Width(), SourceRect.Height(), format);
+	UpdateJitterState(Shared);
+
+	if (bLossless)
+		Shared.bAcknowledgeFrames = true;
+
+	if (bLateLatch && GetWorld() && GetWorld()->Scene)
+	{
+		if (!LateLatch.IsValid() || LateLatch->GetScene() != GetWorld()->Scene)
+		{
+			LateLatch.Reset();
+			LateLatch = MakeShared<FSpoutLateLatch>(GetWorld()->Scene);
+		}
+
+		// the sender is looked up again when the request runs, a frame published since this tick is not missed
+		LateLatch->Arm([this, SharedReception = &Shared, SenderName, SourceRect, Region, bFromAtlas, DrawSettings, FrameTime = FApp::GetCurrentTime()](FRHICommandListImmediate& RHICmdList) {
+			unsigned int LatchWidth = 0, LatchHeight = 0;
+			HANDLE LatchSharehandle = nullptr;
+			DXGI_FORMAT LatchFormat = DXGI_FORMAT_UNKNOWN;
+
+			if (!latch_senders.FindSender(TCHAR_TO_ANSI(*SenderName), LatchWidth, LatchHeight, LatchSharehandle, (DWORD&)LatchFormat))
+				return;
+
+			// atlas layouts only change on repack, the tick's rectangle stays valid
+			const FIntRect LatchRect = bFromAtlas ? SourceRect : SpoutSourceRegion::Resolve(FIntRect(0, 0, LatchWidth, LatchHeight), Region);
+			if (LatchRect.Width() <= 0 || LatchRect.Height() <= 0)
+				return;
+
+			Receive_RenderThread(RHICmdList, *SharedReception, LatchSharehandle, LatchRect, (uint32)LatchFormat, DrawSettings, FrameTime);
+		});
+		return;
+	}
+
+	LateLatch.Reset();
+
+	ENQUEUE_RENDER_COMMAND(SpoutRecieverRenderThreadOp)([this, SharedReception = &Shared, hSharehandle, SourceRect, dwFormat, DrawSettings, FrameTime = FApp::GetCurrentTime()](FRHICommandListImmediate& RHICmdList) {
+		Receive_RenderThread(RHICmdList, *SharedReception, hSharehandle, SourceRect, (uint32)dwFormat, DrawSettings, FrameTime);
+	});
+}
+
+void USpoutRecieverActorComponent::Receive_RenderThread(FRHICommandListImmediate& RHICmdList, FSharedReception& Shared, void* hSharehandle, FIntRect SourceRect, uint32 DxgiFormat, const FDrawSettings& DrawSettings, double FrameTime)
+{
+	check(IsInRenderingThread());
+
+	if (!OutputRenderTarget)
+		return;
+
+	FRHITexture2D* IntermediateTexture = Shared.GetIntermediate_RenderThread();
+	if (!IntermediateTexture)
+		return;
+
+	// a late latched sender may have changed format since the tick sized the intermediate texture
+	if (SpoutPixelFormats::ToPixelFormat(DxgiFormat) != IntermediateTexture->GetFormat())
+		return;
+
+	SCOPED_DRAW_EVENT(RHICmdList, ProcessSpoutCopyTexture);
+
+	if (!GWorld || !GWorld->Scene)
+		return;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	SourceRect.Max.X = SourceRect.Min.X + FMath::Min(SourceRect.Width(), (int32)IntermediateTexture->GetSizeX());
+	SourceRect.Max.Y = SourceRect.Min.Y + FMath::Min(SourceRect.Height(), (int32)IntermediateTexture->GetSizeY());
+
+	if (!Shared.CopySharedTexture_RenderThread(hSharehandle, SourceRect, (DXGI_FORMAT)DxgiFormat, IntermediateTexture))
+		return;
+
+	FRHITexture2D* DrawTexture = IntermediateTexture;
+	FIntPoint DrawSize = SourceRect.Size();
+	int64 DrawnFrameId = Shared.CopiedFrameId;
+	double DrawnFrameTime = Shared.CopiedFrameTime;
+
+	// senders outside the plugin publish no frame ids, their frames are drawn as they arrive
+	if (Jitter.IsValid() && Shared.CopiedFrameId > 0)
+	{
+		DrawTexture = Jitter->Select_RenderThread(RHICmdList, Shared.CopiedFrameId, Shared.CopiedFrameTime, IntermediateTexture, DrawSize, FrameTime, DrawSize);
+		if (!DrawTexture)
+			return;
+
+		DrawnFrameId = Jitter->Buffer.GetSelectedFrameId();
+		DrawnFrameTime = Jitter->Buffer.GetSelectedTime();
+	}
+
+	DrawSpoutTexture_RenderThread(RHICmdList, DrawTexture, DrawSize, OutputRenderTarget->GetRenderTargetResource(), DrawSettings);
+	NotifyFrameDrawn_RenderThread(DrawnFrameId, DrawnFrameTime, Shared.SenderName);
+
+	FSpoutTransferScheduler::Get().ReportSubmitCost(TransferStreamId, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+bool USpoutRecieverActorComponent::ScheduleTransfer()
+{
+	FSpoutTransferScheduler& Scheduler = FSpoutTransferScheduler::Get();
+
+	if (TransferStreamId == INDEX_NONE)
+		TransferStreamId = Scheduler.RegisterStream(GFrameCounter);
+
+	Scheduler.UpdateStream(TransferStreamId, TransferPriority, TargetFrameRate);
+
+	return Scheduler.ShouldTransfer(TransferStreamId, GFrameCounter, FPlatformTime::Seconds());
+}
+
+USpoutRecieverActorComponent::FDrawSettings USpoutRecieverActorComponent::MakeDrawSettings() const
+{
+	FDrawSettings DrawSettings;
+	DrawSettings.Conversion = Conversion;
+	DrawSettings.ScaleFilter = ScaleFilter;
+	DrawSettings.ScaleMode = ScaleMode;
+	return DrawSettings;
+}
+
+FIntRect USpoutRecieverActorComponent::GetSourceRegion() const
+{
+	if (SourceRegionSize.X <= 0 || SourceRegionSize.Y <= 0)
+		return FIntRect();
+
+	return FIntRect(SourceRegionOffset, SourceRegionOffset + SourceRegionSize);
+}
+
+USpoutRecieverActorComponent::FSharedReception& USpoutRecieverActorComponent::AcquireReception(const FString& SenderName, bool bFromMemory, const FIntRect& Region)
+{
+	if (!Reception.IsValid() || Reception->SenderName != SenderName || Reception->bFromMemory != bFromMemory || Reception->Region != Region)
+	{
+		ReleaseReception();
+		Reception = FSharedReception::Acquire(SenderName, bFromMemory, Region);
+	}
+
+	return *Reception;
+}
+
+void USpoutRecieverActorComponent::UpdateJitterState(const FSharedReception& Shared)
+{
+	const int32 Capacity = FMath::Min(JitterBufferFrames, SpoutJitterBuffer::MaxFrames);
+	const UTexture2D* Intermediate = Shared.IntermediateTexture2D;
+
+	if (Capacity > 1 && Intermediate && Jitter.IsValid() && Jitter->Matches(Capacity, Intermediate))
+	{
+		Jitter->Policy = JitterPolicy;
+		return;
+	}
+
+	ReleaseJitterState();
+
+	if (Capacity > 1 && Intermediate)
+	{
+		Jitter = MakeShared<FJitterState>(Capacity, Intermediate);
+		Jitter->Policy = JitterPolicy;
+	}
+}
+
+void USpoutRecieverActorComponent::ReleaseJitterState()
+{
+	if (!Jitter.IsValid())
+		return;
+
+	// queued draws read the slots through the state
+	FlushRenderingCommands();
+	Jitter.Reset();
+}
+
+void USpoutRecieverActorComponent::UpdateMemoryOutput(FIntPoint Size)
+{
+	if (MemoryOutput.IsValid() && MemoryOutput->Size == Size)
+		return;
+
+	ReleaseMemoryOutput();
+	MemoryOutput = MakeShared<FMemoryOutput>(Size);
+}
+
+void USpoutRecieverActorComponent::ReleaseMemoryOutput()
+{
+	if (!MemoryOutput.IsValid())
+		return;
+
+	// queued draws upload into its texture; the output waits for its task
+	FlushRenderingCommands();
+	MemoryOutput.Reset();
+}
+
+void USpoutRecieverActorComponent::ReleaseReception()
+{
+	// an armed late latch request points at the reception
+	LateLatch.Reset();
+	ReleaseJitterState();
+	ReleaseMemoryOutput();
+
+	if (!Reception.IsValid())
+		return;
+
+	// render commands only hold the reception by pointer, the last receiver lets them finish first
+	if (Reception.IsUnique())
+		FlushRenderingCommands();
+
+	Reception.Reset();
+}
+
+void USpoutRecieverActorComponent::TickMemoryShare()
+{
+	FSharedReception& Shared = AcquireReception(SubscribeName.ToString(), true, GetSourceRegion());
+
+	if (!OutputRenderTarget || OutputRenderTarget->SizeX <= 0 || OutputRenderTarget->SizeY <= 0)
+		return;
+
+	UpdateMemoryOutput(FIntPoint(OutputRenderTarget->SizeX, OutputRenderTarget->SizeY));
+	FMemoryOutput& Output = *MemoryOutput;
+
+	// one conversion in flight, the frame it produced is drawn on the tick after it started
+	FMemoryOutput::FConvertedPtr Converted;
+	if (Output.Pending.IsValid())
+	{
+		if (!Output.Pending.IsReady())
+			return;
+
+		Converted = Output.Pending.Get();
+		Output.Pending.Reset();
+	}
+
+	if (ScheduleTransfer())
+	{
+		Output.Pending = Async(EAsyncExecution::ThreadPool, [SharedReception = &Shared, Size = Output.Size, DrawSettings = MakeDrawSettings()]() {
+			return FMemoryOutput::Convert(*SharedReception, Size, DrawSettings);
+		});
+	}
+
+	if (!Converted.IsValid())
+		return;
+
+	ENQUEUE_RENDER_COMMAND(SpoutMemoryRecieverRenderThreadOp)([this, Output = &Output, Converted](FRHICommandListImmediate& RHICmdList) {
+		check(IsInRenderingThread());
+
+		if (!OutputRenderTarget)
+			return;
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		FRHITexture2D* Texture = Output->Upload_RenderThread(*Converted);
+		if (!Texture)
+			return;
+
+		// converted and scaled to the output already, the draw only writes it in the output's format
+		DrawSpoutTexture_RenderThread(RHICmdList, Texture, Output->Size, OutputRenderTarget->GetRenderTargetResource(), FDrawSettings());
+		// memory-share frames are counted apart from the control block's, no metadata ring follows them
+		NotifyFrameDrawn_RenderThread(Converted->FrameId, 0.0, FString());
+
+		FSpoutTransferScheduler::Get().ReportSubmitCost(TransferStreamId, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	});
+}
+
+void USpoutRecieverActorComponent::NotifyFrameDrawn_RenderThread(int64 FrameId, double PublishTime, const FString& MetadataSender)
+{
+	check(IsInRenderingThread());
+
+	// drawn again on a tick without a new publish
+	if (FrameId != 0 && FrameId == NotifiedFrameId)
+		return;
+
+	FSpoutReceivedFrame Frame;
+	Frame.Timestamp = (float)((PublishTime > 0.0 ? PublishTime : FPlatformTime::Seconds()) - GStartTime);
+
+	if (FrameId != 0 && !MetadataSender.IsEmpty())
+	{
+		if (!MetadataReader.IsValid() || MetadataReader->GetSenderName() != MetadataSender)
+			MetadataReader = MakeShared<FSpoutMetadataReader>(MetadataSender);
+
+		if (MetadataReader->Read(FrameId, Frame.Metadata) == ESpoutMetadataRead::Overwritten)
+			INC_DWORD_STAT(STAT_SpoutMetadataOverwritten);
+	}
+
+	NotifiedFrameId = FrameId;
+
+	// without frame ids, every draw counts as a new frame
+	Frame.FrameId = FrameId != 0 ? FrameId : ++UncountedDraws;
+	FrameNotifier->Publish(Frame);
+}
+
+bool USpoutRecieverActorComponent::GetFrameMetadata(TArray<uint8>& Metadata) const
+{
+	Metadata = DispatchedFrame.Metadata;
+	return Metadata.Num() > 0;
+}
+
+TFuture<FSpoutReceivedFrame> USpoutRecieverActorComponent::AcquireNextFrame()
+{
+	return FrameNotifier->AcquireNext();
+}
+
+void USpoutRecieverActorComponent::WaitForNextFrame(float Timeout, bool& bReceived, FSpoutReceivedFrame& Frame, FLatentActionInfo LatentInfo)
+{
+	UWorld* World = GetWorld();
+	if (!World)
+		return;
+
+	FLatentActionManager& LatentManager = World->GetLatentActionManager();
+	if (LatentManager.FindExistingAction<FSpoutWaitForFrameAction>(LatentInfo.CallbackTarget, LatentInfo.UUID))
+		return;
+
+	LatentManager.AddNewAction(LatentInfo.CallbackTarget, LatentInfo.UUID, new FSpoutWaitForFrameAction(AcquireNextFrame(), Timeout, bReceived, Frame, LatentInfo));
+}
+
+void USpoutRecieverActorComponent::DrawSpoutTexture_RenderThread(
+	FRHICommandListImmediate& RHICmdList,
+	FRHITexture* SourceTexture,
+	FIntPoint SourceSize,
+	FTextureRenderTargetResource* OutputRenderTargetResource,
+	const FDrawSettings& DrawSettings
+)
+{
+	check(IsInRenderingThread());
+
+	FShaderResourceViewRHIRef IntermediateTextureParameterSRV;
+
+	{
+		IntermediateTextureParameterSRV = RHICreateShaderResourceView(SourceTexture->GetTexture2D(), 0);
+		check(IntermediateTextureParameterSRV.IsValid());
+	}
+
+	{
+		auto ShaderResource = OutputRenderTargetResource->GetRenderTargetTexture(); 
+		
+		FRHIRenderPassInfo RPInfo(
+			ShaderResource,
+			ERenderTargetActions::DontLoad_Store);
+
+		RHICmdList.BeginRenderPass(RPInfo, TEXT("CopySpoutImage"));
+		{
+			FIntPoint OutputSize(
+				OutputRenderTargetResource->GetSizeX(), OutputRenderTargetResource->GetSizeY());
+
+			auto* GlobalShaderMap = GetGlobalShaderMap(GMaxRHIFeatureLevel);
+			TShaderMapRef<FMediaShadersVS> VertexShader(GlobalShaderMap);
+			TShaderMapRef<FTextureCopyPixelShader> PixelShader(GlobalShaderMap, FTextureCopyPixelShader::GetPermutationVector(DrawSettings.Conversion, DrawSettings.ScaleFilter, DrawSettings.HdrTransport));
+
+			// Set the graphic pipeline state.
+			FGraphicsPipelineStateInitializer GraphicsPSOInit;
+			RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+			GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Never>::GetRHI();
+			GraphicsPSOInit.BlendState = TStaticBlendState<>::GetRHI();
+			GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
+			GraphicsPSOInit.PrimitiveType = PT_TriangleStrip;
+			GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GMediaVertexDeclaration.VertexDeclarationRHI;
+			
+#if (ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 25) || (ENGINE_MAJOR_VERSION == 5)
+			GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
+			GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
+#else ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION <= 24
+			GraphicsPSOInit.BoundShaderState.VertexShaderRHI = GETSAFERHISHADER_VERTEX(*VertexShader);
+			GraphicsPSOInit.BoundShaderState.PixelShaderRHI = GETSAFERHISHADER_PIXEL(*PixelShader);
+#endif
+
+			SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit,
+				0, EApplyRendertargetOption::CheckApply, true);
+
+			if (PixelShader->SrcTexture.IsBound())
+			{
+				auto PixelShaderRHI = GraphicsPSOInit.BoundShaderState.PixelShaderRHI;
+				RHICmdList.SetShaderResourceViewParameter(PixelShaderRHI, PixelShader->SrcTexture.GetBaseIndex(), IntermediateTextureParameterSRV);
+			}
+
+			{
+				// SourceSize is the content in the top-left corner of a possibly larger source texture
+				const FVector4 UVScaleBias = SpoutImageScaler::ComputeUVScaleBias(SourceSize.X, SourceSize.Y, OutputSize.X, OutputSize.Y, DrawSettings.ScaleMode);
+				const FVector2D FilterScale = SpoutImageScaler::ComputeFilterScale(SourceSize.X, SourceSize.Y, OutputSize.X, OutputSize.Y, UVScaleBias);
+
+				auto PixelShaderRHI = GraphicsPSOInit.BoundShaderState.PixelShaderRHI;
+				SetShaderValue(RHICmdList, PixelShaderRHI, PixelShader->UVScaleBias, FShaderVector4(UVScaleBias));
+				SetShaderValue(RHICmdList, PixelShaderRHI, PixelShader->FilterScale, FShaderVector2(FilterScale));
+				SetShaderValue(RHICmdList, PixelShaderRHI, PixelShader->SourceSize, FShaderVector2(FVector2D(SourceSize)));
+			}
+			
+			FBufferRHIRef VertexBuffer = CreateTempMediaVertexBuffer();
+			RHICmdList.SetStreamSource(0, VertexBuffer, 0);
+			RHICmdList.SetViewport(0, 0, 0.0, OutputSize.X, OutputSize.Y, 1.f);
+			RHICmdList.DrawPrimitive(0, 2, 1);
+		}
+		RHICmdList.EndRenderPass();
+
+		RHICmdList.CopyToResolveTarget(ShaderResource, ShaderResource, FResolveParams());
+	}
+}
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutResizePolicy.h"
+
+int32 FSpoutResizePolicy::GetBucket(int32 Value)
+{
+	if (Value <= 0)
+		return 0;
+
+	const int32 Step = FMath::Max<int32>(MinBucketStep, FMath::RoundUpToPowerOfTwo(Value) / 8);
+	return FMath::DivideAndRoundUp(Value, Step) * Step;
+}
+
+bool FSpoutResizePolicy::Update(int32 Width, int32 Height, int32 Format, double Time, double ShrinkCooldownSeconds)
+{
+	const FIntPoint Bucket(GetBucket(Width), GetBucket(Height));
+
+	if (AllocationSize == FIntPoint::ZeroValue
+		|| Format != AllocationFormat
+		|| Bucket.X > AllocationSize.X
+		|| Bucket.Y > AllocationSize.Y)
+	{
+		// a new format starts from the content, growth keeps the larger axis of the old allocation
+		if (AllocationSize == FIntPoint::ZeroValue || Format != AllocationFormat)
+			AllocationSize = Bucket;
+		else
+			AllocationSize = FIntPoint(FMath::Max(AllocationSize.X, Bucket.X), FMath::Max(AllocationSize.Y, Bucket.Y));
+
+		AllocationFormat = Format;
+		LastFullUseTime = Time;
+		PeakBucket = FIntPoint::ZeroValue;
+		return true;
+	}
+
+	if (Bucket == AllocationSize)
+	{
+		LastFullUseTime = Time;
+		PeakBucket = FIntPoint::ZeroValue;
+		return false;
+	}
+
+	// content alternating between sizes needs the largest of them on each axis
+	PeakBucket = PeakBucket.ComponentMax(Bucket);
+
+	if (Time - LastFullUseTime < ShrinkCooldownSeconds)
+		return false;
+
+	// when different frames used each axis in full there is nothing to shrink; either way a new window starts
+	const bool bShrinks = PeakBucket != AllocationSize;
+
+	if (bShrinks)
+		AllocationSize = PeakBucket;
+
+	LastFullUseTime = Time;
+	PeakBucket = FIntPoint::ZeroValue;
+	return bShrinks;
+}
+
+void FSpoutResizePolicy::Reset()
+{
+	AllocationSize = FIntPoint::ZeroValue;
+	AllocationFormat = 0;
+	LastFullUseTime = 0.0;
+	PeakBucket = FIntPoint::ZeroValue;
+}
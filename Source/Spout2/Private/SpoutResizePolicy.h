@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Decides the allocation size of a texture whose content size changes often.
+ *
+ * Allocations round up to buckets of an eighth of the next power of two (at least
+ * MinBucketStep texels), so at most 1/8 of each axis is wasted. Growing reallocates right
+ * away and never shrinks the other axis; shrinking waits until the content has fitted a
+ * smaller bucket for ShrinkCooldownSeconds, then goes down to the largest bucket of each
+ * axis seen in that time. A format change always reallocates.
+ *
+ * Only sizes, formats and times go in, so the policy runs without any RHI.
+ */
+class FSpoutResizePolicy
+{
+public:
+
+	static constexpr int32 MinBucketStep = 64;
+
+	static int32 GetBucket(int32 Value);
+
+	/** Feeds the content size of a frame. True when the allocation has to be (re)created. */
+	bool Update(int32 Width, int32 Height, int32 Format, double Time, double ShrinkCooldownSeconds);
+
+	/** Forgets the allocation, the next Update reallocates. */
+	void Reset();
+
+	FIntPoint GetAllocationSize() const { return AllocationSize; }
+
+private:
+
+	FIntPoint AllocationSize = FIntPoint::ZeroValue;
+	int32 AllocationFormat = 0;
+
+	// time the content last needed the current allocation
+	double LastFullUseTime = 0.0;
+
+	// per axis, the largest bucket since LastFullUseTime
+	FIntPoint PeakBucket = FIntPoint::ZeroValue;
+};
@@ -0,0 +1,168 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Bookkeeping for a pool of interchangeable resources: reuse by key, least recently
+ * released first eviction, and a byte budget over everything the pool has created.
+ *
+ * Holds no locks and creates nothing; the owner allocates on a miss, reports the size
+ * with OnCreated, and destroys whatever Release or Trim hands back as evicted. Only idle
+ * resources are ever evicted, so the budget can be exceeded while they are all in use.
+ */
+template<typename KeyType, typename ValueType>
+class TSpoutResourcePool
+{
+public:
+
+	struct FStats
+	{
+		uint64 Hits = 0;
+		uint64 Misses = 0;
+		uint64 Evictions = 0;
+		uint64 BytesInUse = 0;
+		uint64 BytesIdle = 0;
+		int32 NumIdle = 0;
+
+		double GetHitRate() const
+		{
+			const uint64 Requests = Hits + Misses;
+			return Requests ? double(Hits) / double(Requests) : 0.0;
+		}
+	};
+
+	explicit TSpoutResourcePool(uint64 InBudgetBytes = 0)
+		: BudgetBytes(InBudgetBytes)
+	{
+	}
+
+	/** 0 disables the budget. Returns what no longer fits. */
+	TArray<ValueType> SetBudget(uint64 InBudgetBytes)
+	{
+		BudgetBytes = InBudgetBytes;
+		return Trim();
+	}
+
+	/** Takes the most recently released idle resource of Key. False is a miss. */
+	bool Acquire(const KeyType& Key, ValueType& OutValue)
+	{
+		int32 BestIndex = INDEX_NONE;
+
+		for (int32 Index = 0; Index < Idle.Num(); ++Index)
+		{
+			if (Idle[Index].Key == Key
+				&& (BestIndex == INDEX_NONE || Idle[Index].ReleaseOrder > Idle[BestIndex].ReleaseOrder))
+				BestIndex = Index;
+		}
+
+		if (BestIndex == INDEX_NONE)
+		{
+			++Stats.Misses;
+			return false;
+		}
+
+		FIdleEntry& Entry = Idle[BestIndex];
+		OutValue = MoveTemp(Entry.Value);
+
+		Stats.BytesIdle -= Entry.Bytes;
+		Stats.BytesInUse += Entry.Bytes;
+		++Stats.Hits;
+
+		Idle.RemoveAtSwap(BestIndex);
+		Stats.NumIdle = Idle.Num();
+		return true;
+	}
+
+	/** Accounts a resource the owner created after a miss; it starts in use. */
+	void OnCreated(uint64 Bytes)
+	{
+		Stats.BytesInUse += Bytes;
+	}
+
+	/** Accounts a resource that failed or was dropped while in use. */
+	void OnDestroyedInUse(uint64 Bytes)
+	{
+		Stats.BytesInUse -= FMath::Min(Bytes, Stats.BytesInUse);
+	}
+
+	/** Returns a resource to the pool, and hands back the idle resources evicted to stay in budget. */
+	TArray<ValueType> Release(const KeyType& Key, ValueType Value, uint64 Bytes)
+	{
+		Stats.BytesInUse -= FMath::Min(Bytes, Stats.BytesInUse);
+		Stats.BytesIdle += Bytes;
+
+		Idle.Add({ Key, MoveTemp(Value), Bytes, NextReleaseOrder++ });
+		Stats.NumIdle = Idle.Num();
+
+		return Trim();
+	}
+
+	/** Evicts idle resources, oldest first, until the pool fits its budget. */
+	TArray<ValueType> Trim()
+	{
+		TArray<ValueType> Evicted;
+
+		while (BudgetBytes > 0
+			&& Stats.BytesInUse + Stats.BytesIdle > BudgetBytes
+			&& Idle.Num() > 0)
+		{
+			int32 OldestIndex = 0;
+			for (int32 Index = 1; Index < Idle.Num(); ++Index)
+			{
+				if (Idle[Index].ReleaseOrder < Idle[OldestIndex].ReleaseOrder)
+					OldestIndex = Index;
+			}
+
+			Stats.BytesIdle -= Idle[OldestIndex].Bytes;
+			++Stats.Evictions;
+
+			Evicted.Add(MoveTemp(Idle[OldestIndex].Value));
+			Idle.RemoveAtSwap(OldestIndex);
+		}
+
+		Stats.NumIdle = Idle.Num();
+		return Evicted;
+	}
+
+	/** Hands back every idle resource. */
+	TArray<ValueType> Empty()
+	{
+		TArray<ValueType> Evicted;
+		for (FIdleEntry& Entry : Idle)
+			Evicted.Add(MoveTemp(Entry.Value));
+
+		Idle.Reset();
+		Stats.BytesIdle = 0;
+		Stats.NumIdle = 0;
+		return Evicted;
+	}
+
+	int32 NumIdle(const KeyType& Key) const
+	{
+		int32 Count = 0;
+		for (const FIdleEntry& Entry : Idle)
+			Count += Entry.Key == Key ? 1 : 0;
+		return Count;
+	}
+
+	const FStats& GetStats() const { return Stats; }
+	uint64 GetBudget() const { return BudgetBytes; }
+
+private:
+
+	struct FIdleEntry
+	{
+		KeyType Key;
+		ValueType Value;
+		uint64 Bytes;
+		uint64 ReleaseOrder;
+	};
+
+	// pools hold a handful of textures, a linear scan beats keeping an ordered index
+	TArray<FIdleEntry> Idle;
+	uint64 NextReleaseOrder = 0;
+	uint64 BudgetBytes;
+	FStats Stats;
+};
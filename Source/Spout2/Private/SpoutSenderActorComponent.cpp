@@ -1,248 +1,2454 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "SpoutSenderActorComponent.h"
-
-#include <string>
-#include <map>
-
-#include "Windows/AllowWindowsPlatformTypes.h" 
-#include <d3d11on12.h>
-#include "Spout.h"
-#include "Windows/HideWindowsPlatformTypes.h"
-
-static std::map<std::string, int> sender_name_reference_countor;
-
-struct USpoutSenderActorComponent::SpoutSenderContext
-{
-	ID3D11Device* D3D11Device = nullptr;
-	ID3D11On12Device* D3D11on12Device = nullptr;
-	ID3D11Resource* WrappedDX11Resource = nullptr;
-
-	spoutSenderNames senders;
-	spoutDirectX sdx;
-
-	FName Name;
-	std::string Name_str;
-	unsigned int width = 0, height = 0;
-
-	HANDLE sharedSendingHandle = nullptr;
-	ID3D11Texture2D* sendingTexture = nullptr;
-	ID3D11DeviceContext* deviceContext = nullptr;
-
-	FRHITexture2D* Texture2D = nullptr;
-
-	SpoutSenderContext(const FName& Name,
-		FRHITexture2D* Texture2D)
-		: Name(Name)
-		, Texture2D(Texture2D)
-	{
-		DXGI_FORMAT texFormat;
-		FString RHIName = GDynamicRHI->GetName();
-
-		if (RHIName == TEXT("D3D11"))
-		{
-			D3D11Device = static_cast<ID3D11Device*>(GDynamicRHI->RHIGetNativeDevice());
-			D3D11Device->GetImmediateContext(&deviceContext);
-
-			ID3D11Texture2D* NativeTex = (ID3D11Texture2D*)Texture2D->GetNativeResource();
-
-			D3D11_TEXTURE2D_DESC desc;
-			NativeTex->GetDesc(&desc);
-
-			width = desc.Width;
-			height = desc.Height;
-
-			texFormat = desc.Format;
-		}
-		else if (RHIName == TEXT("D3D12"))
-		{
-			ID3D12Device* Device12 = static_cast<ID3D12Device*>(GDynamicRHI->RHIGetNativeDevice());
-			UINT DeviceFlags11 = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
-
-			verify(D3D11On12CreateDevice(
-				Device12,
-				DeviceFlags11,
-				nullptr,
-				0,
-				nullptr,
-				0,
-				0,
-				&D3D11Device,
-				&deviceContext,
-				nullptr
-			) == S_OK);
-
-			verify(D3D11Device->QueryInterface(__uuidof(ID3D11On12Device), (void**)&D3D11on12Device) == S_OK);
-
-			D3D12_RESOURCE_DESC desc;
-			ID3D12Resource* NativeTex = (ID3D12Resource*)Texture2D->GetNativeResource();
-			desc = NativeTex->GetDesc();
-
-			width = desc.Width;
-			height = desc.Height;
-
-			texFormat = desc.Format;
-
-			D3D11_RESOURCE_FLAGS rf11 = {};
-
-			verify(D3D11on12Device->CreateWrappedResource(
-				NativeTex, &rf11,
-				D3D12_RESOURCE_STATE_COPY_SOURCE,
-				D3D12_RESOURCE_STATE_PRESENT, __uuidof(ID3D11Resource),
-				(void**)&WrappedDX11Resource) == S_OK);
-
-		}
-		else
-		{
-			throw;
-		}
-
-		if (texFormat == DXGI_FORMAT_B8G8R8A8_TYPELESS) {
-			texFormat = DXGI_FORMAT_B8G8R8A8_UNORM;
-		}
-
-		Name_str = TCHAR_TO_ANSI(*Name.ToString());;
-
-		verify(sdx.CreateSharedDX11Texture(D3D11Device, width, height, texFormat, &sendingTexture, sharedSendingHandle));
-
-		if (sender_name_reference_countor.find(Name_str) == sender_name_reference_countor.end())
-			sender_name_reference_countor[Name_str] = 0;
-
-		sender_name_reference_countor[Name_str] += 1;
-
-		verify(senders.CreateSender(Name_str.c_str(), width, height, sharedSendingHandle, texFormat));
-	}
-
-	~SpoutSenderContext()
-	{
-		sender_name_reference_countor[Name_str] -= 1;
-
-		if (sender_name_reference_countor[Name_str] == 0)
-			senders.ReleaseSenderName(Name_str.c_str());
-
-		if (sendingTexture)
-		{
-			sendingTexture->Release();
-			sendingTexture = nullptr;
-		}
-
-		if (deviceContext)
-		{
-			deviceContext->Release();
-			deviceContext = nullptr;
-		}
-
-		if (WrappedDX11Resource)
-		{
-			D3D11on12Device->ReleaseWrappedResources(&WrappedDX11Resource, 1);
-			WrappedDX11Resource = nullptr;
-		}
-
-		if (D3D11on12Device)
-		{
-			D3D11on12Device->Release();
-			D3D11on12Device = nullptr;
-		}
-
-		if (D3D11Device)
-		{
-			D3D11Device->Release();
-			D3D11Device = nullptr;
-		}
-	}
-
-	void Tick()
-	{
-		if (!deviceContext)
-			return;
-
-		FString RHIName = GDynamicRHI->GetName();
-
-		if (RHIName == TEXT("D3D11"))
-		{
-			ENQUEUE_RENDER_COMMAND(SpoutSenderRenderThreadOp)([this](FRHICommandListImmediate& RHICmdList) {
-				ID3D11Texture2D* NativeTex = (ID3D11Texture2D*)Texture2D->GetNativeResource();
-
-				this->deviceContext->CopyResource(sendingTexture, NativeTex);
-				this->deviceContext->Flush();
-
-				verify(this->senders.UpdateSender(TCHAR_TO_ANSI(*this->Name.ToString()),
-					this->width, this->height,
-					this->sharedSendingHandle));
-			});
-		}
-		else if (RHIName == TEXT("D3D12"))
-		{
-			ENQUEUE_RENDER_COMMAND(SpoutSenderRenderThreadOp)([this](FRHICommandListImmediate& RHICmdList) {
-				this->D3D11on12Device->AcquireWrappedResources(&WrappedDX11Resource, 1);
-				this->deviceContext->CopyResource(sendingTexture, WrappedDX11Resource);
-				this->D3D11on12Device->ReleaseWrappedResources(&WrappedDX11Resource, 1);
-				this->deviceContext->Flush();
-
-				verify(this->senders.UpdateSender(TCHAR_TO_ANSI(*this->Name.ToString()),
-					this->width, this->height,
-					this->sharedSendingHandle));
-			});
-		}
-	}
-
-	const FName& GetName() const { return Name; }
-
-};
-
-///////////////////////////////////////////////////////////////////////////////
-
-USpoutSenderActorComponent::USpoutSenderActorComponent()
-{
-	PrimaryComponentTick.bCanEverTick = true;
-	bTickInEditor = true;
-}
-
-void USpoutSenderActorComponent::BeginPlay()
-{
-	Super::BeginPlay();
-
-	 context.Reset();
-}
-
-void USpoutSenderActorComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
-{
-	context.Reset();
-
-	Super::EndPlay(EndPlayReason);
-}
-
-void USpoutSenderActorComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
-{
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
-	if (!OutputTexture
-		|| !OutputTexture->GetResource()->TextureRHI) return;
-
-	auto Texture2D = OutputTexture->GetResource()->TextureRHI->GetTexture2D();
-	if (!Texture2D)
-	{
-		context.Reset();
-		return;
-	}
-
-	if (!Texture2D->GetNativeResource())
-	{
-		context.Reset();
-		return;
-	}
-
-	if (!context.IsValid())
-	{
-		context = TSharedPtr<SpoutSenderContext>(new SpoutSenderContext(PublishName, Texture2D));
-	}
-	else if (PublishName != context->GetName())
-	{
-		context.Reset();
-		return;
-	}
-
-	context->Tick();
-}
-
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SpoutSenderActorComponent.h"
+
+#include <atomic>
+#include <string>
+#include <map>
+
+#include "Windows/AllowWindowsPlatformTypes.h" 
+#include <d3d11on12.h>
+#include <d3d11_4.h>
+#include "Spout.h"
+#include "Windows/HideWindowsPlatformTypes.h"
+
+#include "Async/Async.h"
+#include "GlobalShader.h"
+#include "RHICommandList.h"
+#include "RHIGPUReadback.h"
+#include "MediaShaders.h"
+#include "Math/Float16Color.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/ScopeLock.h"
+
+#include "SpoutAsyncCreator.h"
+#include "SpoutAtlasLayout.h"
+#include "SpoutAtlasPacker.h"
+#include "SpoutChangeTracker.h"
+#include "SpoutContentHash.h"
+#include "SpoutFrameMetadata.h"
+#include "SpoutHdrPacking.h"
+#include "SpoutLocalSenders.h"
+#include "SpoutMemoryShare.h"
+#include "SpoutPixelFormats.h"
+#include "SpoutPreviewDownscale.h"
+#include "SpoutSharedTexturePool.h"
+#include "SpoutSnapshotRing.h"
+#include "SpoutStats.h"
+#include "SpoutSubscription.h"
+#include "SpoutTransferScheduler.h"
+#include "SpoutTransferWorker.h"
+#include "SpoutViewCapture.h"
+
+static std::map<std::string, int> sender_name_reference_countor;
+static FCriticalSection sender_name_mutex;
+
+static TAutoConsoleVariable<int32> CVarSpoutAsyncTransfer(
+	TEXT("Spout2.AsyncTransfer"),
+	1,
+	TEXT("Publish D3D12 senders from the Spout transfer worker, through a snapshot copied on the RHI queue, instead of the render thread."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSpoutIdleKeepAliveRate(
+	TEXT("Spout2.IdleKeepAliveRate"),
+	1.f,
+	TEXT("Frames per second a sender with bOnlyWhileSubscribed publishes while nobody subscribes, 0 stops publishing."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSpoutSubscriberTimeout(
+	TEXT("Spout2.SubscriberTimeout"),
+	2.f,
+	TEXT("Seconds without a heartbeat after which a receiver no longer counts as subscribed."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSpoutSenderPresenceInterval(
+	TEXT("Spout2.SenderPresenceInterval"),
+	1.f,
+	TEXT("Seconds between checks that a sender's name is still in Spout's sender set, it registers again when a receiver evicted it."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSpoutBackpressureTimeout(
+	TEXT("Spout2.BackpressureTimeout"),
+	1.f,
+	TEXT("Seconds a lossless sender's game thread waits for its receivers to acknowledge a frame, and for its own copy to be published, before going on anyway."),
+	ECVF_Default);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Idle Publishes Skipped"), STAT_SpoutIdlePublishesSkipped, STATGROUP_Spout2);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Unchanged Publishes Skipped"), STAT_SpoutUnchangedPublishesSkipped, STATGROUP_Spout2);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Backpressure Waits"), STAT_SpoutBackpressureWaits, STATGROUP_Spout2);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Backpressure Timeouts"), STAT_SpoutBackpressureTimeouts, STATGROUP_Spout2);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Metadata Blobs Dropped"), STAT_SpoutMetadataDropped, STATGROUP_Spout2);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Memory-Share Readbacks Dropped"), STAT_SpoutReadbacksDropped, STATGROUP_Spout2);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Transfer Snapshots Busy"), STAT_SpoutSnapshotsBusy, STATGROUP_Spout2);
+
+// texture readbacks report their row pitch from 4.25 on, older engines read memory-share frames synchronously
+#define SPOUT_WITH_ASYNC_READBACK ((ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 25) || ENGINE_MAJOR_VERSION == 5)
+
+// game thread, the D3D11 immediate context belongs to the RHI and stays on the render thread
+static bool UseTransferWorker()
+{
+	return CVarSpoutAsyncTransfer.GetValueOnGameThread() != 0
+		&& FString(GDynamicRHI->GetName()) == TEXT("D3D12");
+}
+
+class FSpoutPackPixelShader : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FSpoutPackPixelShader, Global);
+public:
+
+	class FHdrTransport : SHADER_PERMUTATION_RANGE_INT("SPOUT_HDR_TRANSPORT", 1, 3);
+
+	using FPermutationDomain = TShaderPermutationDomain<FHdrTransport>;
+
+#if (ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 25) || (ENGINE_MAJOR_VERSION == 5)
+	LAYOUT_FIELD(FShaderResourceParameter, SrcTexture);
+#else ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION <= 24
+	FShaderResourceParameter SrcTexture;
+
+	virtual bool Serialize(FArchive& Ar) override
+	{
+		bool bShaderHasOutdatedParams = FGlobalShader::Serialize(Ar);
+		Ar << SrcTexture;
+		return bShaderHasOutdatedParams;
+	}
+#endif
+
+	FSpoutPackPixelShader(const ShaderMetaType::CompiledShaderInitializerType& Initializer) :
+		FGlobalShader(Initializer)
+	{
+		SrcTexture.Bind(Initializer.ParameterMap, TEXT("SrcTexture"));
+	}
+	FSpoutPackPixelShader() {}
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+};
+
+IMPLEMENT_SHADER_TYPE(, FSpoutPackPixelShader, TEXT("/Plugin/Spout2/SpoutSenderPackShader.usf"), TEXT("MainPixelShader"), SF_Pixel)
+
+static void PackHdr_RenderThread(FRHICommandListImmediate& RHICmdList, FRHITexture* SourceTexture, FRHITexture* PackedTexture, ESpoutHdrTransport HdrTransport, bool bFlushForNativeCopy)
+{
+	check(IsInRenderingThread());
+
+	if (!SourceTexture || !PackedTexture)
+		return;
+
+	SCOPED_DRAW_EVENT(RHICmdList, PackSpoutHdr);
+
+	FShaderResourceViewRHIRef SourceSRV = RHICreateShaderResourceView(SourceTexture->GetTexture2D(), 0);
+
+	FRHIRenderPassInfo RPInfo(PackedTexture, ERenderTargetActions::DontLoad_Store);
+	RHICmdList.BeginRenderPass(RPInfo, TEXT("PackSpoutHdr"));
+	{
+		const FIntVector PackedSize = PackedTexture->GetSizeXYZ();
+		const FIntPoint OutputSize(PackedSize.X, PackedSize.Y);
+
+		FSpoutPackPixelShader::FPermutationDomain PermutationVector;
+		PermutationVector.Set<FSpoutPackPixelShader::FHdrTransport>((int32)HdrTransport);
+
+		auto* GlobalShaderMap = GetGlobalShaderMap(GMaxRHIFeatureLevel);
+		TShaderMapRef<FMediaShadersVS> VertexShader(GlobalShaderMap);
+		TShaderMapRef<FSpoutPackPixelShader> PixelShader(GlobalShaderMap, PermutationVector);
+
+		FGraphicsPipelineStateInitializer GraphicsPSOInit;
+		RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+		GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Never>::GetRHI();
+		GraphicsPSOInit.BlendState = TStaticBlendState<>::GetRHI();
+		GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
+		GraphicsPSOInit.PrimitiveType = PT_TriangleStrip;
+		GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GMediaVertexDeclaration.VertexDeclarationRHI;
+
+#if (ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 25) || (ENGINE_MAJOR_VERSION == 5)
+		GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
+		GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
+#else ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION <= 24
+		GraphicsPSOInit.BoundShaderState.VertexShaderRHI = GETSAFERHISHADER_VERTEX(*VertexShader);
+		GraphicsPSOInit.BoundShaderState.PixelShaderRHI = GETSAFERHISHADER_PIXEL(*PixelShader);
+#endif
+
+		SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit,
+			0, EApplyRendertargetOption::CheckApply, true);
+
+		if (PixelShader->SrcTexture.IsBound())
+		{
+			RHICmdList.SetShaderResourceViewParameter(GraphicsPSOInit.BoundShaderState.PixelShaderRHI, PixelShader->SrcTexture.GetBaseIndex(), SourceSRV);
+		}
+
+		FBufferRHIRef VertexBuffer = CreateTempMediaVertexBuffer();
+		RHICmdList.SetStreamSource(0, VertexBuffer, 0);
+		RHICmdList.SetViewport(0, 0, 0.0, OutputSize.X, OutputSize.Y, 1.f);
+		RHICmdList.DrawPrimitive(0, 2, 1);
+	}
+	RHICmdList.EndRenderPass();
+
+	// a render thread Spout copy goes straight to the native device, the pack draw must have been submitted;
+	// the transfer worker instead waits on a fence written after it
+	if (bFlushForNativeCopy)
+		RHICmdList.ImmediateFlush(EImmediateFlushType::FlushRHIThread);
+}
+
+class FSpoutPreviewDownscaleCS : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FSpoutPreviewDownscaleCS, Global);
+public:
+
+	static constexpr int32 GroupSize = 8;
+
+#if (ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 25) || (ENGINE_MAJOR_VERSION == 5)
+	LAYOUT_FIELD(FShaderResourceParameter, SrcTexture);
+	LAYOUT_FIELD(FShaderResourceParameter, OutTexture);
+	LAYOUT_FIELD(FShaderParameter, SourceSize);
+	LAYOUT_FIELD(FShaderParameter, OutputSize);
+	LAYOUT_FIELD(FShaderParameter, Factor);
+#else ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION <= 24
+	FShaderResourceParameter SrcTexture;
+	FShaderResourceParameter OutTexture;
+	FShaderParameter SourceSize;
+	FShaderParameter OutputSize;
+	FShaderParameter Factor;
+
+	virtual bool Serialize(FArchive& Ar) override
+	{
+		bool bShaderHasOutdatedParams = FGlobalShader::Serialize(Ar);
+		Ar << SrcTexture;
+		Ar << OutTexture;
+		Ar << SourceSize;
+		Ar << OutputSize;
+		Ar << Factor;
+		return bShaderHasOutdatedParams;
+	}
+#endif
+
+	FSpoutPreviewDownscaleCS(const ShaderMetaType::CompiledShaderInitializerType& Initializer) :
+		FGlobalShader(Initializer)
+	{
+		SrcTexture.Bind(Initializer.ParameterMap, TEXT("SrcTexture"));
+		OutTexture.Bind(Initializer.ParameterMap, TEXT("OutTexture"));
+		SourceSize.Bind(Initializer.ParameterMap, TEXT("SourceSize"));
+		OutputSize.Bind(Initializer.ParameterMap, TEXT("OutputSize"));
+		Factor.Bind(Initializer.ParameterMap, TEXT("Factor"));
+	}
+	FSpoutPreviewDownscaleCS() {}
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+};
+
+IMPLEMENT_SHADER_TYPE(, FSpoutPreviewDownscaleCS, TEXT("/Plugin/Spout2/SpoutPreviewDownscale.usf"), TEXT("MainCS"), SF_Compute)
+
+static void DownscalePreview_RenderThread(FRHICommandListImmediate& RHICmdList, FRHITexture* SourceTexture, FRHITexture* PreviewTexture, int32 Factor, bool bFlushForNativeCopy)
+{
+	check(IsInRenderingThread());
+
+	if (!SourceTexture || !PreviewTexture)
+		return;
+
+	SCOPED_DRAW_EVENT(RHICmdList, DownscaleSpoutPreview);
+
+	const FIntVector SourceSize = SourceTexture->GetSizeXYZ();
+	const FIntVector PreviewSize = PreviewTexture->GetSizeXYZ();
+
+	FShaderResourceViewRHIRef SourceSRV = RHICreateShaderResourceView(SourceTexture->GetTexture2D(), 0);
+	FUnorderedAccessViewRHIRef PreviewUAV = RHICreateUnorderedAccessView(PreviewTexture, 0);
+
+	RHICmdList.Transition(FRHITransitionInfo(PreviewTexture, ERHIAccess::Unknown, ERHIAccess::UAVCompute));
+
+	TShaderMapRef<FSpoutPreviewDownscaleCS> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+	FRHIComputeShader* ShaderRHI = ComputeShader.GetComputeShader();
+
+	SetComputePipelineState(RHICmdList, ShaderRHI);
+
+	RHICmdList.SetShaderResourceViewParameter(ShaderRHI, ComputeShader->SrcTexture.GetBaseIndex(), SourceSRV);
+	RHICmdList.SetUAVParameter(ShaderRHI, ComputeShader->OutTexture.GetBaseIndex(), PreviewUAV);
+	SetShaderValue(RHICmdList, ShaderRHI, ComputeShader->SourceSize, FIntPoint(SourceSize.X, SourceSize.Y));
+	SetShaderValue(RHICmdList, ShaderRHI, ComputeShader->OutputSize, FIntPoint(PreviewSize.X, PreviewSize.Y));
+	SetShaderValue(RHICmdList, ShaderRHI, ComputeShader->Factor, (uint32)Factor);
+
+	RHICmdList.DispatchComputeShader(
+		FMath::DivideAndRoundUp(PreviewSize.X, FSpoutPreviewDownscaleCS::GroupSize),
+		FMath::DivideAndRoundUp(PreviewSize.Y, FSpoutPreviewDownscaleCS::GroupSize), 1);
+
+	RHICmdList.SetUAVParameter(ShaderRHI, ComputeShader->OutTexture.GetBaseIndex(), nullptr);
+	RHICmdList.Transition(FRHITransitionInfo(PreviewTexture, ERHIAccess::UAVCompute, ERHIAccess::SRVMask));
+
+	// same as the HDR pack, the native preview copy must see the dispatch submitted
+	if (bFlushForNativeCopy)
+		RHICmdList.ImmediateFlush(EImmediateFlushType::FlushRHIThread);
+}
+
+struct USpoutSenderActorComponent::SpoutSenderContext
+{
+	ID3D11Device* D3D11Device = nullptr;
+	ID3D11On12Device* D3D11on12Device = nullptr;
+	ID3D11Resource* WrappedDX11Resource = nullptr;
+
+	spoutSenderNames senders;
+
+	FName Name;
+	std::string Name_str;
+	unsigned int width = 0, height = 0;
+
+	HANDLE sharedSendingHandle = nullptr;
+	ID3D11Texture2D* sendingTexture = nullptr;
+	ID3D11DeviceContext* deviceContext = nullptr;
+
+	// pool-owned texture behind sharedSendingHandle, sendingTexture is this device's view of it
+	FSpoutSharedTextureRef PooledTexture;
+
+	FTexture2DRHIRef Texture2D;
+	DXGI_FORMAT texFormat = DXGI_FORMAT_UNKNOWN;
+
+	// set once a copy was handed to the transfer worker
+	bool bUsedTransferWorker = false;
+
+	// D3D12 copies handed to the transfer worker: the RHI queue copies Texture2D into a snapshot,
+	// the worker reads the snapshot, never the texture the next frame already renders into
+	static constexpr int32 NumSnapshots = 3;
+	TSpoutSnapshotRing<FGPUFenceRHIRef, NumSnapshots> Snapshots;
+
+	// created on the game thread with the first handoff
+	UTexture2D* SnapshotTextures[NumSnapshots] = {};
+
+	// Texture2D is a view capture slot the renderer copies frames into, see BeginCapture_RenderThread
+	const bool bCaptureSlot;
+
+	// D3D11 capture slots created shareable are the shared texture themselves
+	bool bInPlace = false;
+
+	// D3D12 capture slots are their own single snapshot
+	TSpoutSnapshotRing<FGPUFenceRHIRef, 1> CaptureSnapshot;
+
+	// transfer worker
+	ID3D11Resource* WrappedSnapshots[NumSnapshots] = {};
+
+	// copying thread, see WaitForCopy
+	ID3D11Query* CopyQuery = nullptr;
+
+	// D3D11: signalled on the immediate context behind each write into sendingTexture, the transfer worker announces it once passed
+	ID3D11Fence* CopyFence = nullptr;
+	ID3D11DeviceContext4* FenceContext = nullptr;
+	uint64 CopyFenceValue = 0;
+
+	// ESpoutChangeDetection::GpuHash, render thread
+	TUniquePtr<FSpoutContentHasher> ContentHasher;
+	TSpoutChangeTracker<uint64> PublishedHash;
+
+	// frame counter and writes into sendingTexture; mapped by the constructor, then used by whichever thread copies
+	FSpoutSubscriberMonitor ControlMonitor;
+
+	// per-frame metadata by the game frame it was attached in, oldest first; taken by the copying thread
+	FCriticalSection MetadataMutex;
+	TArray<TPair<uint32, TArray<uint8>>> PendingMetadata;
+	TUniquePtr<FSpoutMetadataWriter> MetadataWriter;
+
+	// heartbeat, re-registration and lossless acks, game thread; separate from the copying thread's
+	FSpoutSubscriberMonitor LivenessMonitor;
+	spoutSenderNames presence_senders;
+	double LastPresenceCheck = 0.0;
+
+	SpoutSenderContext(const FName& Name,
+		FRHITexture2D* Texture2D,
+		ESpoutHdrTransport HdrTransport,
+		bool bCaptureSlot)
+		: Name(Name)
+		, Texture2D(Texture2D)
+		, bCaptureSlot(bCaptureSlot)
+		, ControlMonitor(Name.ToString())
+		, LivenessMonitor(Name.ToString())
+	{
+		FString RHIName = GDynamicRHI->GetName();
+
+		if (RHIName == TEXT("D3D11"))
+		{
+			D3D11Device = static_cast<ID3D11Device*>(GDynamicRHI->RHIGetNativeDevice());
+			D3D11Device->GetImmediateContext(&deviceContext);
+
+			ID3D11Texture2D* NativeTex = (ID3D11Texture2D*)Texture2D->GetNativeResource();
+
+			D3D11_TEXTURE2D_DESC desc;
+			NativeTex->GetDesc(&desc);
+
+			width = desc.Width;
+			height = desc.Height;
+
+			texFormat = desc.Format;
+
+			CreateCopyFence();
+		}
+		else if (RHIName == TEXT("D3D12"))
+		{
+			ID3D12Device* Device12 = static_cast<ID3D12Device*>(GDynamicRHI->RHIGetNativeDevice());
+			UINT DeviceFlags11 = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
+
+			verify(D3D11On12CreateDevice(
+				Device12,
+				DeviceFlags11,
+				nullptr,
+				0,
+				nullptr,
+				0,
+				0,
+				&D3D11Device,
+				&deviceContext,
+				nullptr
+			) == S_OK);
+
+			verify(D3D11Device->QueryInterface(__uuidof(ID3D11On12Device), (void**)&D3D11on12Device) == S_OK);
+
+			D3D12_RESOURCE_DESC desc;
+			ID3D12Resource* NativeTex = (ID3D12Resource*)Texture2D->GetNativeResource();
+			desc = NativeTex->GetDesc();
+
+			width = desc.Width;
+			height = desc.Height;
+
+			texFormat = desc.Format;
+
+			D3D11_RESOURCE_FLAGS rf11 = {};
+
+			// the renderer leaves a capture slot in copy source state and tracks it as such
+			verify(D3D11on12Device->CreateWrappedResource(
+				NativeTex, &rf11,
+				D3D12_RESOURCE_STATE_COPY_SOURCE,
+				bCaptureSlot ? D3D12_RESOURCE_STATE_COPY_SOURCE : D3D12_RESOURCE_STATE_PRESENT, __uuidof(ID3D11Resource),
+				(void**)&WrappedDX11Resource) == S_OK);
+
+		}
+		else
+		{
+			return;
+		}
+
+		// shared textures need a typed format, the engine often allocates typeless ones
+		if (uint32 ShareableFormat = SpoutPixelFormats::ToShareableFormat(texFormat))
+			texFormat = (DXGI_FORMAT)ShareableFormat;
+
+		Name_str = TCHAR_TO_ANSI(*Name.ToString());;
+
+		if (bCaptureSlot && !D3D11on12Device)
+			bInPlace = ShareInPlace();
+
+		if (!bInPlace)
+		{
+			PooledTexture = FSpoutSharedTexturePool::Get().Acquire({ width, height, (uint32)texFormat });
+			if (!PooledTexture.IsValid())
+				return;
+
+			sharedSendingHandle = PooledTexture->ShareHandle;
+
+			if (D3D11Device->OpenSharedResource(sharedSendingHandle, __uuidof(ID3D11Texture2D), (void**)&sendingTexture) != S_OK)
+			{
+				sendingTexture = nullptr;
+				return;
+			}
+		}
+
+		{
+			FScopeLock Lock(&sender_name_mutex);
+
+			if (sender_name_reference_countor.find(Name_str) == sender_name_reference_countor.end())
+				sender_name_reference_countor[Name_str] = 0;
+
+			sender_name_reference_countor[Name_str] += 1;
+		}
+
+		verify(senders.CreateSender(Name_str.c_str(), width, height, sharedSendingHandle, texFormat));
+
+		// receivers of this process draw Texture2D directly when they find this handle
+		FSpoutLocalSenders::Get().Register(Name.ToString(), sharedSendingHandle, Texture2D);
+
+		// mapped here, so the copying threads never map it concurrently
+		ControlMonitor.GetNextFrameId();
+
+		// packed HDR senders announce the plain DXGI format, the curve travels in the unused usage field
+		if (HdrTransport != ESpoutHdrTransport::None)
+		{
+			SharedTextureInfo info;
+			if (senders.getSharedInfo(Name_str.c_str(), &info))
+			{
+				info.usage = SpoutHdrPacking::GetUsageTag(HdrTransport);
+				senders.setSharedInfo(Name_str.c_str(), &info);
+			}
+		}
+	}
+
+	// D3D11, a slot created with a legacy shared handle is announced as it is and never copied
+	bool ShareInPlace()
+	{
+		ID3D11Texture2D* NativeTex = (ID3D11Texture2D*)Texture2D->GetNativeResource();
+
+		D3D11_TEXTURE2D_DESC desc;
+		NativeTex->GetDesc(&desc);
+
+		if (!(desc.MiscFlags & D3D11_RESOURCE_MISC_SHARED))
+			return false;
+
+		IDXGIResource* DxgiResource = nullptr;
+		if (NativeTex->QueryInterface(__uuidof(IDXGIResource), (void**)&DxgiResource) != S_OK)
+			return false;
+
+		HANDLE Handle = nullptr;
+		const bool bShared = DxgiResource->GetSharedHandle(&Handle) == S_OK && Handle;
+		DxgiResource->Release();
+
+		if (!bShared)
+			return false;
+
+		sharedSendingHandle = Handle;
+		sendingTexture = NativeTex;
+		sendingTexture->AddRef();
+		return true;
+	}
+
+	~SpoutSenderContext()
+	{
+		// handed-off copies reference this context until the worker ran them
+		if (bUsedTransferWorker)
+		{
+			FlushRenderingCommands();
+			FSpoutTransferWorker::Get().Flush();
+		}
+
+		if (sendingTexture)
+		{
+			FSpoutLocalSenders::Get().Unregister(Name.ToString(), sharedSendingHandle);
+
+			FScopeLock Lock(&sender_name_mutex);
+
+			sender_name_reference_countor[Name_str] -= 1;
+
+			if (sender_name_reference_countor[Name_str] == 0)
+			{
+				LivenessMonitor.Retire();
+				senders.ReleaseSenderName(Name_str.c_str());
+			}
+
+			sendingTexture->Release();
+			sendingTexture = nullptr;
+		}
+
+		FSpoutSharedTexturePool::Get().Release(MoveTemp(PooledTexture));
+
+		for (int32 Index = 0; Index < NumSnapshots; ++Index)
+		{
+			if (WrappedSnapshots[Index])
+			{
+				WrappedSnapshots[Index]->Release();
+				WrappedSnapshots[Index] = nullptr;
+			}
+
+			if (SnapshotTextures[Index] && UObjectInitialized())
+				SnapshotTextures[Index]->RemoveFromRoot();
+
+			SnapshotTextures[Index] = nullptr;
+		}
+
+		if (CopyQuery)
+		{
+			CopyQuery->Release();
+			CopyQuery = nullptr;
+		}
+
+		if (FenceContext)
+		{
+			FenceContext->Release();
+			FenceContext = nullptr;
+		}
+
+		if (CopyFence)
+		{
+			CopyFence->Release();
+			CopyFence = nullptr;
+		}
+
+		if (deviceContext)
+		{
+			deviceContext->Release();
+			deviceContext = nullptr;
+		}
+
+		if (WrappedDX11Resource)
+		{
+			D3D11on12Device->ReleaseWrappedResources(&WrappedDX11Resource, 1);
+			WrappedDX11Resource = nullptr;
+		}
+
+		if (D3D11on12Device)
+		{
+			D3D11on12Device->Release();
+			D3D11on12Device = nullptr;
+		}
+
+		if (D3D11Device)
+		{
+			D3D11Device->Release();
+			D3D11Device = nullptr;
+		}
+	}
+
+	// bHashGate: copy only when the GPU hash of Texture2D changed, or when bForce
+	void Tick(int32 TransferStreamId, bool bHashGate = false, bool bForce = true)
+	{
+		if (!deviceContext)
+			return;
+
+		FString RHIName = GDynamicRHI->GetName();
+
+		if (RHIName == TEXT("D3D11"))
+		{
+			ENQUEUE_RENDER_COMMAND(SpoutSenderRenderThreadOp)([this, TransferStreamId, bHashGate, bForce](FRHICommandListImmediate& RHICmdList) {
+				if (bHashGate && !HasContentChanged_RenderThread(RHICmdList, bForce))
+					return;
+
+				CopyToSharedTexture_D3D11(TransferStreamId, GFrameNumberRenderThread);
+			});
+		}
+		else if (UseTransferWorker())
+		{
+			bUsedTransferWorker = true;
+			CreateSnapshots();
+
+			ENQUEUE_RENDER_COMMAND(SpoutSenderHandoffOp)([this, TransferStreamId, bHashGate, bForce](FRHICommandListImmediate& RHICmdList) {
+				if (bHashGate && !HasContentChanged_RenderThread(RHICmdList, bForce))
+					return;
+
+				HandOffToWorker_RenderThread(RHICmdList, TransferStreamId);
+			});
+		}
+		else if (RHIName == TEXT("D3D12"))
+		{
+			ENQUEUE_RENDER_COMMAND(SpoutSenderRenderThreadOp)([this, TransferStreamId, bHashGate, bForce](FRHICommandListImmediate& RHICmdList) {
+				if (bHashGate && !HasContentChanged_RenderThread(RHICmdList, bForce))
+					return;
+
+				CopyToSharedTexture_D3D12(TransferStreamId, GFrameNumberRenderThread);
+			});
+		}
+	}
+
+	// hashes the texture every call; the hash that decides is a few frames old, so a change is published that much later
+	bool HasContentChanged_RenderThread(FRHICommandListImmediate& RHICmdList, bool bForce)
+	{
+		if (!ContentHasher.IsValid())
+			ContentHasher = MakeUnique<FSpoutContentHasher>();
+
+		ContentHasher->Enqueue(RHICmdList, Texture2D);
+
+		const TOptional<uint64> Hash = ContentHasher->Poll();
+		const bool bChanged = bForce || (Hash.IsSet() && PublishedHash.HasChanged(Hash.GetValue()));
+
+		if (bChanged && Hash.IsSet())
+			PublishedHash.MarkPublished(Hash.GetValue());
+
+		if (!bChanged)
+			INC_DWORD_STAT(STAT_SpoutUnchangedPublishesSkipped);
+
+		return bChanged;
+	}
+
+	/** Game thread, before handing PublishAfterRender_RenderThread to the renderer. */
+	void PrepareRenderThreadPublish()
+	{
+		if (!D3D11on12Device)
+			return;
+
+		bUsedTransferWorker = true;
+
+		if (!bCaptureSlot)
+			CreateSnapshots();
+	}
+
+	// game thread; the render thread finds them created in command order
+	void CreateSnapshots()
+	{
+		if (SnapshotTextures[0])
+			return;
+
+		for (UTexture2D*& Snapshot : SnapshotTextures)
+		{
+			Snapshot = UTexture2D::CreateTransient(width, height, Texture2D->GetFormat(), FName("SpoutTransferSnapshot"));
+			Snapshot->AddToRoot();
+			Snapshot->UpdateResource();
+		}
+	}
+
+	// publishes after the passes already recorded into RHICmdList, such as a scene view capture into Texture2D
+	void PublishAfterRender_RenderThread(FRHICommandListImmediate& RHICmdList, int32 TransferStreamId)
+	{
+		if (!deviceContext)
+			return;
+
+		if (D3D11on12Device)
+		{
+			HandOffToWorker_RenderThread(RHICmdList, TransferStreamId);
+		}
+		else
+		{
+			// the native copy shares the immediate context with the RHI, so it runs in command list order
+			RHICmdList.EnqueueLambda([this, TransferStreamId, FrameNumber = GFrameNumberRenderThread](FRHICommandListImmediate&) {
+				CopyToSharedTexture_D3D11(TransferStreamId, FrameNumber);
+			});
+		}
+	}
+
+	void HandOffToWorker_RenderThread(FRHICommandListImmediate& RHICmdList, int32 TransferStreamId)
+	{
+		// the render thread never waits for the worker, a frame finding the oldest snapshot still in use is dropped
+		const int32 Slot = Snapshots.Claim();
+		const FTextureResource* Resource = Slot != INDEX_NONE && SnapshotTextures[Slot] ? SnapshotTextures[Slot]->GetResource() : nullptr;
+		FRHITexture* Snapshot = Resource ? Resource->TextureRHI.GetReference() : nullptr;
+
+		if (!Snapshot)
+		{
+			INC_DWORD_STAT(STAT_SpoutSnapshotsBusy);
+			return;
+		}
+
+		// recorded on the RHI queue with its state tracking, ordered against this frame's writes and the next one's
+		FRHICopyTextureInfo CopyInfo;
+		CopyInfo.Size = FIntVector(width, height, 1);
+
+		RHICmdList.Transition({
+			FRHITransitionInfo(Texture2D, ERHIAccess::Unknown, ERHIAccess::CopySrc),
+			FRHITransitionInfo(Snapshot, ERHIAccess::Unknown, ERHIAccess::CopyDest) });
+
+		RHICmdList.CopyTexture(Texture2D, Snapshot, CopyInfo);
+
+		// the worker's device expects the snapshot in copy source state and hands it back in it
+		RHICmdList.Transition({
+			FRHITransitionInfo(Texture2D, ERHIAccess::CopySrc, ERHIAccess::SRVMask),
+			FRHITransitionInfo(Snapshot, ERHIAccess::CopyDest, ERHIAccess::CopySrc) });
+
+		SubmitSnapshot_RenderThread(RHICmdList, TransferStreamId, Snapshots, Slot, [this, Slot]() { return GetWrappedSnapshot(Slot); });
+	}
+
+	/** Render thread, before the renderer copies a frame into a capture slot; false drops the frame while the transfer worker still reads the last one. */
+	bool BeginCapture_RenderThread()
+	{
+		// the renderer writes the shared texture itself from here on, PublishCapture_RenderThread ends the write
+		if (bInPlace && deviceContext)
+			ControlMonitor.BeginWrite();
+
+		if (!D3D11on12Device || CaptureSnapshot.Claim() != INDEX_NONE)
+			return true;
+
+		INC_DWORD_STAT(STAT_SpoutSnapshotsBusy);
+		return false;
+	}
+
+	/** Render thread, after the renderer copied a frame into the capture slot and left it in copy source state. */
+	void PublishCapture_RenderThread(FRHICommandListImmediate& RHICmdList, int32 TransferStreamId)
+	{
+		if (!deviceContext)
+			return;
+
+		if (D3D11on12Device)
+		{
+			SubmitSnapshot_RenderThread(RHICmdList, TransferStreamId, CaptureSnapshot, 0, [this]() { return WrappedDX11Resource; });
+			return;
+		}
+
+		// the native copy shares the immediate context with the RHI, so it runs in command list order
+		RHICmdList.EnqueueLambda([this, TransferStreamId, FrameNumber = GFrameNumberRenderThread](FRHICommandListImmediate&) {
+			if (!bInPlace)
+			{
+				CopyToSharedTexture_D3D11(TransferStreamId, FrameNumber);
+				return;
+			}
+
+			// the slot is the shared texture, the capture into it was the write
+			AnnounceOnCompletion_D3D11(TransferStreamId, FrameNumber, FPlatformTime::Seconds());
+		});
+	}
+
+	// RHICmdList recorded a copy into a snapshot slot of Ring; GetWrapped gives the worker its D3D11On12 view
+	template<typename RingType, typename GetWrappedType>
+	void SubmitSnapshot_RenderThread(FRHICommandListImmediate& RHICmdList, int32 TransferStreamId, RingType& Ring, int32 Slot, GetWrappedType GetWrapped)
+	{
+		// completes once the GPU finished the snapshot
+		FGPUFenceRHIRef Fence = RHICreateGPUFence(TEXT("SpoutTransfer"));
+		RHICmdList.WriteGPUFence(Fence);
+		Ring.Submit(Slot, Fence);
+
+		RHICmdList.EnqueueLambda([this, TransferStreamId, Fence, Ring = &Ring, Slot, GetWrapped, FrameNumber = GFrameNumberRenderThread](FRHICommandListImmediate&) {
+			const bool bQueued = FSpoutTransferWorker::Get().Enqueue([this, TransferStreamId, Fence, Ring, Slot, GetWrapped, FrameNumber]() {
+				// a snapshot given up on is claimed again once its fence signalled
+				if (FSpoutTransferWorker::WaitForFence(Fence))
+					CopySnapshotToSharedTexture_D3D12(TransferStreamId, FrameNumber, GetWrapped());
+
+				Ring->Release(Slot);
+			});
+
+			if (!bQueued)
+				Ring->Release(Slot);
+		});
+	}
+
+	/** Game thread, every tick the sender is alive, whether it publishes or not. */
+	void Beat(double Now)
+	{
+		if (!sendingTexture)
+			return;
+
+		LivenessMonitor.Beat(Now);
+
+		if (Now - LastPresenceCheck < CVarSpoutSenderPresenceInterval.GetValueOnGameThread())
+			return;
+
+		LastPresenceCheck = Now;
+
+		// a receiver took a long hitch for a crash and evicted the name, announce it again
+		if (!presence_senders.FindSenderName(Name_str.c_str()))
+			presence_senders.CreateSender(Name_str.c_str(), width, height, sharedSendingHandle, texFormat);
+	}
+
+	/**
+	 * Game thread, lossless senders before the next frame is handed over: waits until acknowledging
+	 * receivers consumed the published one, whichever process they run in. They acknowledge from their
+	 * render thread, which keeps running meanwhile; a receiver that stops beating is waited for no longer.
+	 */
+	void WaitForAcknowledgements()
+	{
+		INC_DWORD_STAT(STAT_SpoutBackpressureWaits);
+
+		const float Timeout = CVarSpoutBackpressureTimeout.GetValueOnGameThread();
+
+		if (LivenessMonitor.WaitForAcknowledgements(Timeout, CVarSpoutSubscriberTimeout.GetValueOnGameThread()))
+			return;
+
+		INC_DWORD_STAT(STAT_SpoutBackpressureTimeouts);
+		UE_LOG(LogTemp, Warning, TEXT("Spout2: receivers of %s did not acknowledge within %.2fs, publishing over their frame"), *Name.ToString(), Timeout);
+	}
+
+	/**
+	 * Game thread, lossless senders once the frame's copy was handed over: waits until it was published or
+	 * dropped, so receivers ticking next frame find it. A marker follows every copy recorded so far through the
+	 * render thread, the RHI thread and the transfer worker, the way the copy and its announcement travel.
+	 */
+	void WaitForPublished()
+	{
+		TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bPassed = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+
+		ENQUEUE_RENDER_COMMAND(SpoutLosslessMarkerOp)([bPassed](FRHICommandListImmediate& RHICmdList) {
+			RHICmdList.EnqueueLambda([bPassed](FRHICommandListImmediate&) {
+				// a full queue has jobs in it, the acknowledgement wait still holds the next frame back
+				if (!FSpoutTransferWorker::Get().Enqueue([bPassed]() { *bPassed = true; }))
+					*bPassed = true;
+			});
+
+			RHICmdList.ImmediateFlush(EImmediateFlushType::DispatchToRHIThread);
+		});
+
+		const float Timeout = CVarSpoutBackpressureTimeout.GetValueOnGameThread();
+		const double Deadline = FPlatformTime::Seconds() + Timeout;
+
+		while (!*bPassed)
+		{
+			if (FPlatformTime::Seconds() >= Deadline)
+			{
+				INC_DWORD_STAT(STAT_SpoutBackpressureTimeouts);
+				UE_LOG(LogTemp, Warning, TEXT("Spout2: the copy of %s was not published within %.2fs"), *Name.ToString(), Timeout);
+				return;
+			}
+
+			FPlatformProcess::SleepNoStats(0.0001f);
+		}
+	}
+
+	/** Game thread, metadata of the frame copied from the texture as it is in game frame FrameNumber. */
+	void AttachMetadata(uint32 FrameNumber, TArray<uint8>&& Metadata)
+	{
+		FScopeLock Lock(&MetadataMutex);
+
+		if (PendingMetadata.Num() > 0 && PendingMetadata.Last().Key == FrameNumber)
+			PendingMetadata.Last().Value = MoveTemp(Metadata);
+		else
+			PendingMetadata.Emplace(FrameNumber, MoveTemp(Metadata));
+
+		// nothing copies while the context is not ready, keep the newest few
+		if (PendingMetadata.Num() > FSpoutMetadataRing::SlotCount)
+			PendingMetadata.RemoveAt(0);
+	}
+
+	// copying thread, before MarkPublished announces the frame; takes the newest metadata attached up to its game frame
+	void PublishMetadata(uint32 FrameNumber)
+	{
+		TArray<uint8> Metadata;
+		bool bAttached = false;
+		{
+			FScopeLock Lock(&MetadataMutex);
+
+			int32 NumTaken = 0;
+			while (NumTaken < PendingMetadata.Num() && PendingMetadata[NumTaken].Key <= FrameNumber)
+				++NumTaken;
+
+			if (NumTaken > 0)
+			{
+				Metadata = MoveTemp(PendingMetadata[NumTaken - 1].Value);
+				PendingMetadata.RemoveAt(0, NumTaken);
+				bAttached = true;
+			}
+		}
+
+		// senders that never attached metadata have no ring
+		if (!bAttached && !MetadataWriter.IsValid())
+			return;
+
+		if (!MetadataWriter.IsValid())
+			MetadataWriter = MakeUnique<FSpoutMetadataWriter>(Name.ToString());
+
+		if (!MetadataWriter->Write(ControlMonitor.GetNextFrameId(), Metadata.GetData(), Metadata.Num())
+			&& Metadata.Num() > FSpoutMetadataRing::MaxBlobSize)
+		{
+			INC_DWORD_STAT(STAT_SpoutMetadataDropped);
+			UE_LOG(LogTemp, Warning, TEXT("Spout2: %d bytes of metadata for %s are over the %d byte limit, the frame is published without"), Metadata.Num(), *Name.ToString(), FSpoutMetadataRing::MaxBlobSize);
+		}
+	}
+
+	void CopyToSharedTexture_D3D11(int32 TransferStreamId, uint32 FrameNumber)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		ID3D11Texture2D* NativeTex = (ID3D11Texture2D*)Texture2D->GetNativeResource();
+
+		ControlMonitor.BeginWrite();
+		this->deviceContext->CopyResource(sendingTexture, NativeTex);
+
+		AnnounceOnCompletion_D3D11(TransferStreamId, FrameNumber, StartTime);
+	}
+
+	// D3D11On12 device and context are private to this sender, the copy may run on any one thread at a time;
+	// render thread with Spout2.AsyncTransfer off: reads Texture2D itself, ordered only by what the RHI already submitted,
+	// and waits for this device's copy before announcing it
+	void CopyToSharedTexture_D3D12(int32 TransferStreamId, uint32 FrameNumber)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		ControlMonitor.BeginWrite();
+		this->D3D11on12Device->AcquireWrappedResources(&WrappedDX11Resource, 1);
+		this->deviceContext->CopyResource(sendingTexture, WrappedDX11Resource);
+		this->D3D11on12Device->ReleaseWrappedResources(&WrappedDX11Resource, 1);
+
+		FinishWrite(TransferStreamId, FrameNumber, StartTime, WaitForCopy());
+	}
+
+	// transfer worker, once the fence behind the snapshot's copy signalled; returns once this device read it, the caller releases the slot
+	void CopySnapshotToSharedTexture_D3D12(int32 TransferStreamId, uint32 FrameNumber, ID3D11Resource* Snapshot)
+	{
+		if (!Snapshot)
+			return;
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		ControlMonitor.BeginWrite();
+		this->D3D11on12Device->AcquireWrappedResources(&Snapshot, 1);
+		this->deviceContext->CopyResource(sendingTexture, Snapshot);
+		this->D3D11on12Device->ReleaseWrappedResources(&Snapshot, 1);
+
+		FinishWrite(TransferStreamId, FrameNumber, StartTime, WaitForCopy());
+	}
+
+	// transfer worker
+	ID3D11Resource* GetWrappedSnapshot(int32 Slot)
+	{
+		if (WrappedSnapshots[Slot])
+			return WrappedSnapshots[Slot];
+
+		const FTextureResource* Resource = SnapshotTextures[Slot]->GetResource();
+		ID3D12Resource* NativeSnapshot = Resource && Resource->TextureRHI ? (ID3D12Resource*)Resource->TextureRHI->GetNativeResource() : nullptr;
+		if (!NativeSnapshot)
+			return nullptr;
+
+		D3D11_RESOURCE_FLAGS rf11 = {};
+
+		if (D3D11on12Device->CreateWrappedResource(
+			NativeSnapshot, &rf11,
+			D3D12_RESOURCE_STATE_COPY_SOURCE,
+			D3D12_RESOURCE_STATE_COPY_SOURCE, __uuidof(ID3D11Resource),
+			(void**)&WrappedSnapshots[Slot]) != S_OK)
+			WrappedSnapshots[Slot] = nullptr;
+
+		return WrappedSnapshots[Slot];
+	}
+
+	// copying thread, submits this device's copy and waits until the GPU finished it; false when the device is lost
+	bool WaitForCopy()
+	{
+		if (!CopyQuery)
+		{
+			D3D11_QUERY_DESC QueryDesc = { D3D11_QUERY_EVENT, 0 };
+			if (D3D11Device->CreateQuery(&QueryDesc, &CopyQuery) != S_OK)
+			{
+				CopyQuery = nullptr;
+				deviceContext->Flush();
+				return false;
+			}
+		}
+
+		deviceContext->End(CopyQuery);
+		deviceContext->Flush();
+
+		HRESULT Result;
+		while ((Result = deviceContext->GetData(CopyQuery, nullptr, 0, 0)) == S_FALSE)
+			FPlatformProcess::Sleep(0.0001f);
+
+		return Result == S_OK;
+	}
+
+	// D3D11 constructor; without fences (before Windows 10) the copying thread waits for its copies itself
+	void CreateCopyFence()
+	{
+		ID3D11Device5* Device5 = nullptr;
+		if (D3D11Device->QueryInterface(__uuidof(ID3D11Device5), (void**)&Device5) != S_OK)
+			return;
+
+		if (Device5->CreateFence(0, D3D11_FENCE_FLAG_NONE, __uuidof(ID3D11Fence), (void**)&CopyFence) != S_OK)
+			CopyFence = nullptr;
+
+		Device5->Release();
+
+		if (CopyFence && deviceContext->QueryInterface(__uuidof(ID3D11DeviceContext4), (void**)&FenceContext) != S_OK)
+		{
+			FenceContext = nullptr;
+			CopyFence->Release();
+			CopyFence = nullptr;
+		}
+
+		// announcements reference this context until the worker ran them
+		if (CopyFence)
+			bUsedTransferWorker = true;
+	}
+
+	// the thread recording the immediate context, behind a write into sendingTexture: the frame is announced once the GPU finished it
+	void AnnounceOnCompletion_D3D11(int32 TransferStreamId, uint32 FrameNumber, double StartTime)
+	{
+		if (!CopyFence)
+		{
+			FinishWrite(TransferStreamId, FrameNumber, StartTime, WaitForCopy());
+			return;
+		}
+
+		const uint64 FenceValue = ++CopyFenceValue;
+		FenceContext->Signal(CopyFence, FenceValue);
+		deviceContext->Flush();
+
+		const bool bQueued = FSpoutTransferWorker::Get().Enqueue([this, TransferStreamId, FrameNumber, StartTime, FenceValue]() {
+			FinishWrite(TransferStreamId, FrameNumber, StartTime, WaitForCopyFence(FenceValue));
+		});
+
+		// the worker announces in order, a frame it has no room for stays unannounced and the next one goes out
+		if (!bQueued)
+		{
+			WaitForCopyFence(FenceValue);
+			ControlMonitor.EndWrite();
+		}
+	}
+
+	// false when the fence did not pass Value within FSpoutTransferWorker::FenceTimeoutSeconds
+	bool WaitForCopyFence(uint64 Value)
+	{
+		const double Deadline = FPlatformTime::Seconds() + FSpoutTransferWorker::FenceTimeoutSeconds;
+
+		while (CopyFence->GetCompletedValue() < Value)
+		{
+			if (FPlatformTime::Seconds() >= Deadline)
+				return false;
+
+			FPlatformProcess::SleepNoStats(0.0001f);
+		}
+
+		return true;
+	}
+
+	// the copying thread, once a write into sendingTexture finished on the GPU, or was given up on when !bFinished
+	void FinishWrite(int32 TransferStreamId, uint32 FrameNumber, double StartTime, bool bFinished)
+	{
+		// a write the GPU did not finish, on a lost device or past the timeout, is not announced
+		if (bFinished)
+			Announce(TransferStreamId, FrameNumber, StartTime);
+
+		// after the id moved, a receiver that finds no write in flight finds the frame announced
+		ControlMonitor.EndWrite();
+	}
+
+	// the copying thread, once the shared texture holds the frame
+	void Announce(int32 TransferStreamId, uint32 FrameNumber, double StartTime)
+	{
+		verify(this->senders.UpdateSender(Name_str.c_str(),
+			this->width, this->height,
+			this->sharedSendingHandle, this->texFormat));
+
+		PublishMetadata(FrameNumber);
+
+		// receivers order frames by this, whatever their tick rate
+		ControlMonitor.MarkPublished(FPlatformTime::Seconds());
+
+		FSpoutTransferScheduler::Get().ReportSubmitCost(TransferStreamId, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+
+	bool IsValid() const { return deviceContext && sendingTexture; }
+
+	const FName& GetName() const { return Name; }
+	const FRHITexture2D* GetTexture() const { return Texture2D; }
+
+};
+
+struct FSpoutSenderContextKey
+{
+	FName Name;
+	FTexture2DRHIRef Texture;
+	ESpoutHdrTransport HdrTransport;
+	bool bCaptureSlot = false;
+
+	bool operator==(const FSpoutSenderContextKey& Other) const
+	{
+		return Name == Other.Name && Texture == Other.Texture && HdrTransport == Other.HdrTransport && bCaptureSlot == Other.bCaptureSlot;
+	}
+};
+
+// device setup, shared texture and sender registration run on the thread pool, the component publishes once ready
+struct USpoutSenderActorComponent::FContextCreator : TSpoutAsyncCreator<FSpoutSenderContextKey, SpoutSenderContext>
+{
+	FContextCreator()
+		: TSpoutAsyncCreator(&CreateContext)
+	{
+	}
+
+	static FResourcePtr CreateContext(const FSpoutSenderContextKey& Key)
+	{
+		FResourcePtr Context = MakeShared<SpoutSenderContext, ESPMode::ThreadSafe>(Key.Name, Key.Texture, Key.HdrTransport, Key.bCaptureSlot);
+		return Context->IsValid() ? Context : nullptr;
+	}
+};
+
+// what decides whether a texture source changed without looking at its pixels
+struct FSpoutSourceVersionKey
+{
+	const void* Context = nullptr;
+	const void* Resource = nullptr;
+	FIntVector Size = FIntVector::ZeroValue;
+	uint32 Format = 0;
+	uint64 DirtyCount = 0;
+
+	bool operator==(const FSpoutSourceVersionKey& Other) const
+	{
+		return Context == Other.Context
+			&& Resource == Other.Resource
+			&& Size == Other.Size
+			&& Format == Other.Format
+			&& DirtyCount == Other.DirtyCount;
+	}
+};
+
+struct USpoutSenderActorComponent::FSourceVersion : TSpoutChangeTracker<FSpoutSourceVersionKey>
+{
+};
+
+// "<PublishName>_Preview": its own context and shared texture, published at its own rate
+struct USpoutSenderActorComponent::FPreviewStream
+{
+	TSharedPtr<FContextCreator> ContextCreator;
+	TSharedPtr<SpoutSenderContext, ESPMode::ThreadSafe> Context;
+	TSharedPtr<FSpoutMemorySender, ESPMode::ThreadSafe> MemorySender;
+	int32 StreamId = INDEX_NONE;
+
+	FSourceVersion SourceVersion;
+	TSharedPtr<FSpoutSubscriberMonitor> SubscriberMonitor;
+	double LastKeepAliveTime = 0.0;
+
+	// the memory-share preview is downscaled from the main stream's readback, it goes out with the next one
+	bool bMemoryShareDue = false;
+
+	~FPreviewStream()
+	{
+		if (StreamId != INDEX_NONE)
+			FSpoutTransferScheduler::Get().UnregisterStream(StreamId);
+	}
+};
+
+/**
+ * Memory-share frames in flight: each copy goes to a staging texture of a small ring and is
+ * read from the first render thread tick that finds the GPU done with it, a frame or two
+ * later, instead of stalling the render thread on a synchronous read every frame. The YUV
+ * encode, the preview downscale and the shared memory write then run on a worker task, one
+ * frame at a time in copy order.
+ */
+struct USpoutSenderActorComponent::FMemoryReadback
+{
+	static constexpr int32 NumSlots = 3;
+
+	/** Where and how a frame is published, fixed when it is copied. */
+	struct FPublish
+	{
+		TSharedPtr<FSpoutMemorySender, ESPMode::ThreadSafe> Sender;
+		TSharedPtr<FSpoutMemorySender, ESPMode::ThreadSafe> PreviewSender;
+		int32 PreviewFactor = 1;
+		ESpoutMemoryShareFormat Format = ESpoutMemoryShareFormat::BGRA;
+		ESpoutYuvMatrix Matrix = ESpoutYuvMatrix::BT709;
+	};
+
+	// render thread from here on
+	struct FSlot
+	{
+		TUniquePtr<FRHIGPUTextureReadback> Readback;
+		FPublish Publish;
+		FIntPoint Size = FIntPoint::ZeroValue;
+		EPixelFormat PixelFormat = PF_Unknown;
+		// copy order, 0 while the slot is free
+		uint64 Sequence = 0;
+	};
+
+	FSlot Slots[NumSlots];
+	uint64 NextSequence = 1;
+
+	// read into on the render thread while no task publishes it
+	TSharedRef<TArray<FColor>, ESPMode::ThreadSafe> Pixels = MakeShared<TArray<FColor>, ESPMode::ThreadSafe>();
+	TFuture<void> Publishing;
+
+	~FMemoryReadback()
+	{
+		if (Publishing.IsValid())
+			Publishing.Wait();
+	}
+
+	/** Formats converted to BGRA here; ReadSurfaceData converts the same ways. */
+	static bool CanReadBack(EPixelFormat Format)
+	{
+		return SPOUT_WITH_ASYNC_READBACK
+			&& (Format == PF_B8G8R8A8 || Format == PF_R8G8B8A8 || Format == PF_FloatRGBA);
+	}
+
+	/** Encodes and publishes a frame read synchronously or from a finished readback; worker thread. */
+	static void PublishPixels(const FPublish& Publish, const FColor* Pixels, int32 Width, int32 Height)
+	{
+		Publish.Sender->Publish(Pixels, Width, Height, Publish.Format, Publish.Matrix);
+
+		if (!Publish.PreviewSender.IsValid())
+			return;
+
+		// the preview is downscaled on the CPU from the frame read back for the full stream
+		TArray<FColor> PreviewPixels;
+		FIntPoint PreviewSize;
+		SpoutPreviewDownscale::Downscale(Pixels, Width, Height, Publish.PreviewFactor, PreviewPixels, PreviewSize);
+
+		Publish.PreviewSender->Publish(PreviewPixels.GetData(), PreviewSize.X, PreviewSize.Y, Publish.Format, Publish.Matrix);
+	}
+
+	/** False while a task still publishes Pixels; the frame waiting for it keeps its slot. */
+	bool CanPublish_RenderThread() const
+	{
+		return !Publishing.IsValid() || Publishing.IsReady();
+	}
+
+	TArray<FColor>& GetPixels_RenderThread()
+	{
+		check(CanPublish_RenderThread());
+		return *Pixels;
+	}
+
+	/** Publishes what was read into Pixels on a worker task. */
+	void PublishAsync_RenderThread(FPublish&& Publish, FIntPoint Size)
+	{
+		check(IsInRenderingThread() && CanPublish_RenderThread());
+
+		Publishing = Async(EAsyncExecution::ThreadPool, [Publish = MoveTemp(Publish), Pixels = Pixels, Size]() {
+			PublishPixels(Publish, Pixels->GetData(), Size.X, Size.Y);
+		});
+	}
+
+	void Copy_RenderThread(FRHICommandListImmediate& RHICmdList, FRHITexture* Source, FPublish&& Publish)
+	{
+		check(IsInRenderingThread());
+
+		PublishFinished_RenderThread(RHICmdList);
+
+		// with every slot in flight, the oldest frame is the one nobody will miss
+		FSlot* Slot = FindOldest();
+		if (Slot->Sequence != 0)
+			INC_DWORD_STAT(STAT_SpoutReadbacksDropped);
+
+		if (!Slot->Readback.IsValid())
+			Slot->Readback = MakeUnique<FRHIGPUTextureReadback>(TEXT("SpoutMemoryShare"));
+
+		Slot->Readback->EnqueueCopy(RHICmdList, Source);
+
+		const FIntVector Size = Source->GetSizeXYZ();
+		Slot->Size = FIntPoint(Size.X, Size.Y);
+		Slot->PixelFormat = Source->GetFormat();
+		Slot->Publish = MoveTemp(Publish);
+		Slot->Sequence = NextSequence++;
+	}
+
+	/** Publishes finished frames in copy order; one still in flight holds back the newer ones. */
+	void PublishFinished_RenderThread(FRHICommandListImmediate& RHICmdList)
+	{
+		check(IsInRenderingThread());
+
+		for (;;)
+		{
+			FSlot* Slot = FindOldestInFlight();
+			if (!Slot || !Slot->Readback->IsReady() || !CanPublish_RenderThread())
+				return;
+
+			ReadSlot_RenderThread(RHICmdList, *Slot);
+
+			Slot->Publish = FPublish();
+			Slot->Sequence = 0;
+		}
+	}
+
+private:
+
+	FSlot* FindOldest()
+	{
+		FSlot* Oldest = &Slots[0];
+		for (FSlot& Slot : Slots)
+		{
+			if (Slot.Sequence == 0)
+				return &Slot;
+
+			if (Slot.Sequence < Oldest->Sequence)
+				Oldest = &Slot;
+		}
+		return Oldest;
+	}
+
+	FSlot* FindOldestInFlight()
+	{
+		FSlot* Oldest = nullptr;
+		for (FSlot& Slot : Slots)
+		{
+			if (Slot.Sequence != 0 && (!Oldest || Slot.Sequence < Oldest->Sequence))
+				Oldest = &Slot;
+		}
+		return Oldest;
+	}
+
+	// only the row copy and swizzle stay on the render thread, the locked staging memory is released before publishing
+	void ReadSlot_RenderThread(FRHICommandListImmediate& RHICmdList, FSlot& Slot)
+	{
+#if SPOUT_WITH_ASYNC_READBACK
+		int32 RowPitchInPixels = 0;
+
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1
+		const uint8* Data = static_cast<const uint8*>(Slot.Readback->Lock(RowPitchInPixels));
+#else
+		void* LockedData = nullptr;
+		Slot.Readback->LockTexture(RHICmdList, LockedData, RowPitchInPixels);
+		const uint8* Data = static_cast<const uint8*>(LockedData);
+#endif
+
+		if (!Data)
+			return;
+
+		const int32 Width = Slot.Size.X;
+		const int32 Height = Slot.Size.Y;
+
+		TArray<FColor>& Frame = GetPixels_RenderThread();
+		Frame.SetNumUninitialized(Width * Height);
+
+		for (int32 y = 0; y < Height; ++y)
+		{
+			FColor* Dst = Frame.GetData() + (SIZE_T)y * Width;
+
+			switch (Slot.PixelFormat)
+			{
+			case PF_B8G8R8A8:
+				FMemory::Memcpy(Dst, reinterpret_cast<const FColor*>(Data) + (SIZE_T)y * RowPitchInPixels, Width * sizeof(FColor));
+				break;
+
+			case PF_R8G8B8A8:
+			{
+				const FColor* Src = reinterpret_cast<const FColor*>(Data) + (SIZE_T)y * RowPitchInPixels;
+				for (int32 x = 0; x < Width; ++x)
+					Dst[x] = FColor(Src[x].B, Src[x].G, Src[x].R, Src[x].A);
+				break;
+			}
+
+			default:
+			{
+				// display-referred like ReadSurfaceData's default
+				const FFloat16Color* Src = reinterpret_cast<const FFloat16Color*>(Data) + (SIZE_T)y * RowPitchInPixels;
+				for (int32 x = 0; x < Width; ++x)
+					Dst[x] = FLinearColor(Src[x]).ToFColor(true);
+				break;
+			}
+			}
+		}
+
+		Slot.Readback->Unlock();
+
+		PublishAsync_RenderThread(MoveTemp(Slot.Publish), Slot.Size);
+#endif
+	}
+};
+
+// many small senders in one shared texture; logical senders are registered with the atlas' handle and described by its table
+struct USpoutSenderActorComponent::FAtlasPublisher
+{
+	static constexpr int32 MaxSize = 8192;
+
+	const FName AtlasName;
+
+	static TSharedRef<FAtlasPublisher> Join(FName AtlasName)
+	{
+		check(IsInGameThread());
+
+		static TMap<FName, TWeakPtr<FAtlasPublisher>> Publishers;
+
+		TSharedPtr<FAtlasPublisher> Publisher = Publishers.FindRef(AtlasName).Pin();
+		if (!Publisher.IsValid())
+		{
+			Publisher = MakeShareable(new FAtlasPublisher(AtlasName));
+			Publishers.Add(AtlasName, Publisher);
+		}
+		return Publisher.ToSharedRef();
+	}
+
+	~FAtlasPublisher()
+	{
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+
+		// copies still queued reference the context
+		FlushRenderingCommands();
+
+		for (const FName& Name : Registered)
+			ReleaseLogicalSender(Name);
+
+		Context.Reset();
+		ContextCreator.Reset();
+
+		if (AtlasTarget)
+			AtlasTarget->RemoveFromRoot();
+	}
+
+	/** The atlas takes textures of its members' format, or any while it has none. */
+	bool Accepts(const FRHITexture2D* Texture) const
+	{
+		return Format == PF_Unknown || Texture->GetFormat() == Format;
+	}
+
+	EPixelFormat GetFormat() const { return Format; }
+
+	/** Game thread. Copies Texture into the atlas at the end of this frame. False when its format differs from the atlas'. */
+	bool Submit(const void* Owner, FName SenderName, FRHITexture2D* Texture)
+	{
+		if (!Accepts(Texture))
+			return false;
+
+		if (Format == PF_Unknown)
+			Format = Texture->GetFormat();
+
+		FMember& Member = Members.FindOrAdd(Owner);
+
+		if (Member.Name != SenderName
+			|| !Member.Texture.IsValid()
+			|| Member.Texture->GetSizeXY() != Texture->GetSizeXY())
+			bLayoutDirty = true;
+
+		Member.Name = SenderName;
+		Member.Texture = Texture;
+		Member.bSubmitted = true;
+		return true;
+	}
+
+	void Leave(const void* Owner)
+	{
+		FMember Member;
+		if (!Members.RemoveAndCopyValue(Owner, Member))
+			return;
+
+		bLayoutDirty = true;
+
+		// a member refused for its format publishes the name on its own next, the atlas lets go of it now
+		bool bNameInUse = false;
+		for (const TPair<const void*, FMember>& Pair : Members)
+			bNameInUse |= Pair.Value.Name == Member.Name;
+
+		if (!bNameInUse && Registered.Remove(Member.Name) > 0)
+			ReleaseLogicalSender(Member.Name);
+
+		if (Members.Num() == 0)
+		{
+			Format = PF_Unknown;
+
+			// nothing repacks an empty atlas, receivers must not keep finding rectangles in it
+			TableWriter.Publish(AtlasSize, {});
+		}
+	}
+
+private:
+
+	struct FMember
+	{
+		FName Name;
+		FTexture2DRHIRef Texture;
+		FIntRect Rect;
+		bool bSubmitted = false;
+	};
+
+	TMap<const void*, FMember> Members;
+	EPixelFormat Format = PF_Unknown;
+	bool bLayoutDirty = false;
+	bool bTableDirty = false;
+
+	UTextureRenderTarget2D* AtlasTarget = nullptr;
+	FIntPoint AtlasSize = FIntPoint::ZeroValue;
+
+	TSharedPtr<FContextCreator> ContextCreator = MakeShared<FContextCreator>();
+	TSharedPtr<SpoutSenderContext, ESPMode::ThreadSafe> Context;
+
+	FSpoutAtlasTableWriter TableWriter;
+	TSet<FName> Registered;
+	spoutSenderNames senders;
+
+	FDelegateHandle EndFrameHandle;
+
+	explicit FAtlasPublisher(FName InAtlasName)
+		: AtlasName(InAtlasName)
+		, TableWriter(InAtlasName.ToString())
+	{
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FAtlasPublisher::OnEndFrame);
+	}
+
+	// after every component ticked, so all sub-copies of the frame go out in one submission
+	void OnEndFrame()
+	{
+		if (Members.Num() == 0)
+			return;
+
+		if (bLayoutDirty && !Repack())
+			return;
+
+		FTextureResource* AtlasResource = AtlasTarget ? AtlasTarget->GetResource() : nullptr;
+		if (!AtlasResource || !AtlasResource->TextureRHI || !AtlasResource->TextureRHI->GetTexture2D())
+			return;
+
+		FTexture2DRHIRef AtlasTexture = AtlasResource->TextureRHI->GetTexture2D();
+
+		TSharedPtr<SpoutSenderContext, ESPMode::ThreadSafe> ReadyContext = ContextCreator->Update({ AtlasName, AtlasTexture, ESpoutHdrTransport::None }, FPlatformTime::Seconds());
+		if (ReadyContext != Context)
+		{
+			if (Context.IsValid())
+				FlushRenderingCommands();
+
+			Context = ReadyContext;
+			bTableDirty = true;
+		}
+
+		if (!Context.IsValid())
+			return;
+
+		if (bTableDirty)
+		{
+			PublishLayout();
+			bTableDirty = false;
+		}
+
+		TArray<TPair<FTexture2DRHIRef, FIntPoint>> Copies;
+		for (TPair<const void*, FMember>& Pair : Members)
+		{
+			if (!Pair.Value.bSubmitted)
+				continue;
+
+			Copies.Emplace(Pair.Value.Texture, Pair.Value.Rect.Min);
+			Pair.Value.bSubmitted = false;
+		}
+
+		if (Copies.Num() == 0)
+			return;
+
+		Context->PrepareRenderThreadPublish();
+
+		ENQUEUE_RENDER_COMMAND(SpoutAtlasCopy)([Context = Context.Get(), AtlasTexture, Copies = MoveTemp(Copies)](FRHICommandListImmediate& RHICmdList) {
+			SCOPED_DRAW_EVENT(RHICmdList, CopySpoutAtlas);
+
+			RHICmdList.Transition(FRHITransitionInfo(AtlasTexture, ERHIAccess::Unknown, ERHIAccess::CopyDest));
+
+			for (const TPair<FTexture2DRHIRef, FIntPoint>& Copy : Copies)
+			{
+				FRHICopyTextureInfo CopyInfo;
+				CopyInfo.Size = FIntVector(Copy.Key->GetSizeX(), Copy.Key->GetSizeY(), 1);
+				CopyInfo.DestPosition = FIntVector(Copy.Value.X, Copy.Value.Y, 0);
+
+				RHICmdList.Transition(FRHITransitionInfo(Copy.Key, ERHIAccess::Unknown, ERHIAccess::CopySrc));
+				RHICmdList.CopyTexture(Copy.Key, AtlasTexture, CopyInfo);
+				RHICmdList.Transition(FRHITransitionInfo(Copy.Key, ERHIAccess::CopySrc, ERHIAccess::SRVMask));
+			}
+
+			RHICmdList.Transition(FRHITransitionInfo(AtlasTexture, ERHIAccess::CopyDest, ERHIAccess::SRVMask));
+
+			// one native copy of the whole atlas into the shared texture
+			Context->PublishAfterRender_RenderThread(RHICmdList, INDEX_NONE);
+		});
+	}
+
+	bool Repack()
+	{
+		TArray<FIntPoint> Sizes;
+		for (const TPair<const void*, FMember>& Pair : Members)
+			Sizes.Add(FIntPoint(Pair.Value.Texture->GetSizeX(), Pair.Value.Texture->GetSizeY()));
+
+		TArray<FIntRect> Rects;
+		const TOptional<FIntPoint> PackedSize = FSpoutSkylinePacker::PackSmallest(Sizes, 0, MaxSize, Rects);
+
+		if (!PackedSize.IsSet() || Members.Num() > FSpoutAtlasTable::MaxEntries)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Spout2: %d senders do not fit atlas '%s'"), Members.Num(), *AtlasName.ToString());
+			return false;
+		}
+
+		int32 Index = 0;
+		for (TPair<const void*, FMember>& Pair : Members)
+		{
+			Pair.Value.Rect = Rects[Index++];
+
+			// moved members are copied again, wherever they were before is stale now
+			Pair.Value.bSubmitted = true;
+		}
+
+		if (!AtlasTarget || PackedSize.GetValue() != AtlasSize || AtlasTarget->GetFormat() != Format)
+		{
+			if (AtlasTarget)
+				AtlasTarget->RemoveFromRoot();
+
+			AtlasSize = PackedSize.GetValue();
+
+			AtlasTarget = NewObject<UTextureRenderTarget2D>(GetTransientPackage(), NAME_None, RF_Transient);
+			AtlasTarget->AddToRoot();
+			AtlasTarget->InitCustomFormat(AtlasSize.X, AtlasSize.Y, Format, false);
+		}
+
+		bLayoutDirty = false;
+		bTableDirty = true;
+		return true;
+	}
+
+	void PublishLayout()
+	{
+		TArray<FSpoutAtlasEntry> Entries;
+		TSet<FName> Current;
+
+		for (const TPair<const void*, FMember>& Pair : Members)
+		{
+			Entries.Add({ Pair.Value.Name.ToString(), Pair.Value.Rect });
+			Current.Add(Pair.Value.Name);
+		}
+
+		// the table first, a receiver finding the logical sender then also finds its rectangle
+		TableWriter.Publish(AtlasSize, Entries);
+
+		const FString Description = SpoutAtlas::MakeDescription(AtlasName.ToString());
+
+		for (const FName& Name : Current)
+		{
+			const std::string Name_str = TCHAR_TO_ANSI(*Name.ToString());
+
+			if (!Registered.Contains(Name))
+			{
+				FScopeLock Lock(&sender_name_mutex);
+				sender_name_reference_countor[Name_str] += 1;
+
+				senders.CreateSender(Name_str.c_str(), Context->width, Context->height, Context->sharedSendingHandle, Context->texFormat);
+				Registered.Add(Name);
+			}
+			else
+			{
+				senders.UpdateSender(Name_str.c_str(), Context->width, Context->height, Context->sharedSendingHandle, Context->texFormat);
+			}
+
+			SharedTextureInfo info;
+			if (senders.getSharedInfo(Name_str.c_str(), &info))
+			{
+				FCString::Strncpy((TCHAR*)info.description, *Description, UE_ARRAY_COUNT(info.description));
+				senders.setSharedInfo(Name_str.c_str(), &info);
+			}
+		}
+
+		for (auto It = Registered.CreateIterator(); It; ++It)
+		{
+			if (Current.Contains(*It))
+				continue;
+
+			ReleaseLogicalSender(*It);
+			It.RemoveCurrent();
+		}
+	}
+
+	void ReleaseLogicalSender(const FName& Name)
+	{
+		const std::string Name_str = TCHAR_TO_ANSI(*Name.ToString());
+
+		FScopeLock Lock(&sender_name_mutex);
+
+		sender_name_reference_countor[Name_str] -= 1;
+
+		if (sender_name_reference_countor[Name_str] == 0)
+			senders.ReleaseSenderName(Name_str.c_str());
+	}
+};
+
+struct USpoutSenderActorComponent::FViewCapture
+{
+	ESpoutSenderSource Source;
+	ESpoutCaptureStage Stage;
+
+	FSpoutCaptureHandoffRef Handoff = MakeShared<FSpoutCaptureHandoff, ESPMode::ThreadSafe>();
+
+#if SPOUT_WITH_VIEW_CAPTURE
+	TSharedPtr<FSpoutSceneViewExtension, ESPMode::ThreadSafe> SceneViewExtension;
+#endif
+	TUniquePtr<FSpoutBackBufferCapture> BackBufferCapture;
+
+	// rebuilt when the context changes
+	FSpoutCaptureHandoff::FTargetPtr Target;
+	const SpoutSenderContext* TargetContext = nullptr;
+
+	FViewCapture(ESpoutSenderSource InSource, ESpoutCaptureStage InStage, UGameViewportClient* GameViewport)
+		: Source(InSource)
+		, Stage(InStage)
+	{
+		if (Source == ESpoutSenderSource::BackBuffer)
+		{
+			BackBufferCapture = MakeUnique<FSpoutBackBufferCapture>(Handoff, GameViewport->GetWindow());
+		}
+#if SPOUT_WITH_VIEW_CAPTURE
+		else
+		{
+			SceneViewExtension = FSceneViewExtensions::NewExtension<FSpoutSceneViewExtension>(Handoff, Stage, GameViewport->Viewport);
+		}
+#endif
+	}
+};
+
+/**
+ * bLossless pacing, on the game thread around the ticks of every actor. Once all of them ticked the
+ * frame's copy waits until acknowledging receivers consumed the frame it overwrites, then it is handed
+ * over; at the end of the frame the game thread waits until it was published. Receivers of this process
+ * tick in between, find the frame published and acknowledge it from the render thread, which the game
+ * thread never holds up, so the sender never waits on itself.
+ */
+struct USpoutSenderActorComponent::FLosslessPacing
+{
+	TWeakObjectPtr<UWorld> World;
+
+	// set by a tick that publishes, until the end of its frame
+	TSharedPtr<SpoutSenderContext, ESPMode::ThreadSafe> Context;
+	TFunction<void()> Copy;
+
+	FDelegateHandle PostActorTickHandle;
+	FDelegateHandle EndFrameHandle;
+
+	explicit FLosslessPacing(UWorld* InWorld)
+		: World(InWorld)
+	{
+		PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddRaw(this, &FLosslessPacing::OnWorldPostActorTick);
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FLosslessPacing::OnEndFrame);
+	}
+
+	~FLosslessPacing()
+	{
+		FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	}
+
+	/** Game thread, from the tick that publishes through InContext; InCopy hands the frame to the renderer, view captures hand it over themselves. */
+	void Publish(const TSharedPtr<SpoutSenderContext, ESPMode::ThreadSafe>& InContext, TFunction<void()>&& InCopy = TFunction<void()>())
+	{
+		Context = InContext;
+		Copy = MoveTemp(InCopy);
+	}
+
+	void OnWorldPostActorTick(UWorld* TickedWorld, ELevelTick TickType, float DeltaSeconds)
+	{
+		if (Context.IsValid() && TickedWorld == World.Get())
+			HandOver();
+	}
+
+	void OnEndFrame()
+	{
+		if (!Context.IsValid())
+			return;
+
+		// a world that did not announce the end of its actor ticks still hands the frame over, later
+		if (Copy)
+			HandOver();
+
+		Context->WaitForPublished();
+		Context.Reset();
+	}
+
+	void HandOver()
+	{
+		Context->WaitForAcknowledgements();
+
+		if (Copy)
+		{
+			Copy();
+			Copy = TFunction<void()>();
+		}
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+USpoutSenderActorComponent::USpoutSenderActorComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	bTickInEditor = true;
+}
+
+void USpoutSenderActorComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	 ResetContext();
+}
+
+void USpoutSenderActorComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	ResetViewCapture();
+	LeaveAtlas();
+
+	ResetPreview();
+
+	LosslessPacing.Reset();
+	context.Reset();
+	ContextCreator.Reset();
+	MemorySender.Reset();
+	MemoryReadback.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void USpoutSenderActorComponent::ResetContext()
+{
+	// the renderer may hold the old context through the armed target, it must let go before the context is released here
+	if (ViewCapture.IsValid() && ViewCapture->Target.IsValid())
+	{
+		ViewCapture->Handoff->Disarm();
+		ViewCapture->Target.Reset();
+		ViewCapture->TargetContext = nullptr;
+		FlushRenderingCommands();
+	}
+
+	context.Reset();
+
+	if (ContextCreator.IsValid())
+		ContextCreator->Reset();
+}
+
+void USpoutSenderActorComponent::OnUnregister()
+{
+	ResetPreview();
+	LosslessPacing.Reset();
+
+	if (TransferStreamId != INDEX_NONE)
+	{
+		FSpoutTransferScheduler::Get().UnregisterStream(TransferStreamId);
+		TransferStreamId = INDEX_NONE;
+	}
+
+	Super::OnUnregister();
+}
+
+void USpoutSenderActorComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// also on ticks that copy nothing, so the last frame before a pause still goes out
+	PublishFinishedReadbacks();
+
+	if (!bLossless)
+		LosslessPacing.Reset();
+	else if (!LosslessPacing.IsValid())
+		LosslessPacing = MakeShared<FLosslessPacing>(GetWorld());
+
+	if (Source != ESpoutSenderSource::Texture)
+	{
+		LeaveAtlas();
+		ResetPreview();
+		TickViewCapture();
+		return;
+	}
+
+	if (ViewCapture.IsValid())
+	{
+		ResetViewCapture();
+		ResetContext();
+	}
+
+	if (!OutputTexture
+		|| !OutputTexture->GetResource()->TextureRHI) return;
+
+	if (AtlasName == NAME_None)
+		LeaveAtlas();
+	else if (TickAtlas())
+	{
+		ResetPreview();
+		return;
+	}
+
+	UTexture* SourceTexture = OutputTexture;
+
+	if (HdrTransport != ESpoutHdrTransport::None)
+	{
+		if (!UpdatePackedRenderTarget())
+			return;
+
+		SourceTexture = PackedRenderTarget;
+	}
+	else
+	{
+		PackedRenderTarget = nullptr;
+	}
+
+	if (!SourceTexture->GetResource()->TextureRHI) return;
+
+	auto Texture2D = SourceTexture->GetResource()->TextureRHI->GetTexture2D();
+	if (!Texture2D)
+	{
+		ResetContext();
+		return;
+	}
+
+	if (!Texture2D->GetNativeResource())
+	{
+		ResetContext();
+		return;
+	}
+
+	if (!ContextCreator.IsValid())
+		ContextCreator = MakeShared<FContextCreator>();
+
+	// null until the context for this name, texture and transport is built
+	context = ContextCreator->Update({ PublishName, Texture2D, HdrTransport }, FPlatformTime::Seconds());
+	if (!context.IsValid())
+		return;
+
+	context->Beat(FPlatformTime::Seconds());
+
+	if (!SourceVersion.IsValid())
+		SourceVersion = MakeShared<FSourceVersion>();
+
+	// the source's resource, so a packed HDR target does not hide a reallocated OutputTexture
+	FRHITexture* SourceRHI = OutputTexture->GetResource()->TextureRHI;
+
+	FSpoutSourceVersionKey SourceKey;
+	SourceKey.Context = context.Get();
+	SourceKey.Resource = SourceRHI;
+	SourceKey.Size = SourceRHI->GetSizeXYZ();
+	SourceKey.Format = (uint32)SourceRHI->GetFormat();
+	SourceKey.DirtyCount = DirtyCount;
+
+	const bool bSourceChanged = SourceVersion->HasChanged(SourceKey);
+
+	FSpoutTransferScheduler& Scheduler = FSpoutTransferScheduler::Get();
+
+	if (TransferStreamId == INDEX_NONE)
+		TransferStreamId = Scheduler.RegisterStream(GFrameCounter);
+
+	Scheduler.UpdateStream(TransferStreamId, TransferPriority, TargetFrameRate);
+
+	// also while unchanged, so the first change after a quiet stretch is planned like any other copy
+	bool bPublish = Scheduler.ShouldTransfer(TransferStreamId, GFrameCounter, FPlatformTime::Seconds());
+
+	if (bPublish && ChangeDetection == ESpoutChangeDetection::MarkDirty && !bSourceChanged)
+	{
+		INC_DWORD_STAT(STAT_SpoutUnchangedPublishesSkipped);
+		Scheduler.Withdraw(TransferStreamId, GFrameCounter);
+		bPublish = false;
+	}
+
+	if (bPublish && !ShouldPublishForSubscribers(PublishName.ToString(), SubscriberMonitor, LastKeepAliveTime))
+	{
+		Scheduler.Withdraw(TransferStreamId, GFrameCounter);
+		bPublish = false;
+	}
+
+	if (bPublish)
+	{
+		SourceVersion->MarkPublished(SourceKey);
+
+		if (HdrTransport != ESpoutHdrTransport::None)
+		{
+			FTextureResource* SourceResource = OutputTexture->GetResource();
+			FTextureResource* PackedResource = PackedRenderTarget->GetResource();
+
+			ENQUEUE_RENDER_COMMAND(SpoutSenderPackOp)([SourceResource, PackedResource, Transport = HdrTransport, bFlush = !UseTransferWorker()](FRHICommandListImmediate& RHICmdList) {
+				PackHdr_RenderThread(RHICmdList, SourceResource->TextureRHI, PackedResource->TextureRHI, Transport, bFlush);
+			});
+		}
+
+		AttachPendingMetadata();
+
+		if (LosslessPacing.IsValid())
+		{
+			LosslessPacing->Publish(context, [Context = context, StreamId = TransferStreamId, bHashGate = ChangeDetection == ESpoutChangeDetection::GpuHash, bSourceChanged]() {
+				Context->Tick(StreamId, bHashGate, bSourceChanged);
+			});
+		}
+		else
+		{
+			context->Tick(TransferStreamId, ChangeDetection == ESpoutChangeDetection::GpuHash, bSourceChanged);
+		}
+	}
+
+	// a stream of its own, it asks whether or not the main copy runs this frame
+	TickPreview(SourceKey);
+
+	if (MemoryShareFormat == ESpoutMemoryShareFormat::Disabled)
+	{
+		MemorySender.Reset();
+		MemoryReadback.Reset();
+	}
+	else if (bPublish)
+	{
+		PublishMemoryShare();
+	}
+}
+
+void USpoutSenderActorComponent::TickPreview(const FSpoutSourceVersionKey& SourceKey)
+{
+	const int32 Factor = SpoutPreviewDownscale::GetFactor(PreviewScale);
+	if (Factor <= 1)
+	{
+		ResetPreview();
+		return;
+	}
+
+	const FIntPoint SourceSize(FMath::TruncToInt(OutputTexture->GetSurfaceWidth()), FMath::TruncToInt(OutputTexture->GetSurfaceHeight()));
+	if (SourceSize.X <= 0 || SourceSize.Y <= 0)
+		return;
+
+	const FIntPoint PreviewSize = SpoutPreviewDownscale::GetScaledSize(SourceSize, Factor);
+
+	if (!PreviewRenderTarget
+		|| PreviewRenderTarget->SizeX != PreviewSize.X
+		|| PreviewRenderTarget->SizeY != PreviewSize.Y)
+	{
+		PreviewRenderTarget = NewObject<UTextureRenderTarget2D>(this, FName("SpoutPreview"), RF_Transient);
+		PreviewRenderTarget->bCanCreateUAV = true;
+		// D3D11 has typed UAV stores to RGBA but not BGRA
+		PreviewRenderTarget->InitCustomFormat(PreviewSize.X, PreviewSize.Y, PF_R8G8B8A8, true);
+	}
+
+	FTextureResource* PreviewResource = PreviewRenderTarget->GetResource();
+	if (!PreviewResource || !PreviewResource->TextureRHI)
+		return;
+
+	if (!Preview.IsValid())
+		Preview = MakeShared<FPreviewStream>();
+
+	FSpoutTransferScheduler& Scheduler = FSpoutTransferScheduler::Get();
+
+	if (Preview->StreamId == INDEX_NONE)
+		Preview->StreamId = Scheduler.RegisterStream(GFrameCounter);
+
+	// yields to the main copy when both are due and the budget holds one
+	Scheduler.UpdateStream(Preview->StreamId, TransferPriority - 1, PreviewFrameRate);
+
+	if (!Scheduler.ShouldTransfer(Preview->StreamId, GFrameCounter, FPlatformTime::Seconds()))
+		return;
+
+	// tracked apart from the main stream, which may have published a change the preview has not
+	const FString PreviewName = SpoutPreviewDownscale::MakePreviewName(PublishName.ToString());
+
+	if ((ChangeDetection == ESpoutChangeDetection::MarkDirty && !Preview->SourceVersion.HasChanged(SourceKey))
+		|| !ShouldPublishForSubscribers(PreviewName, Preview->SubscriberMonitor, Preview->LastKeepAliveTime))
+	{
+		Scheduler.Withdraw(Preview->StreamId, GFrameCounter);
+		return;
+	}
+
+	Preview->SourceVersion.MarkPublished(SourceKey);
+	Preview->bMemoryShareDue = true;
+
+	if (!Preview->ContextCreator.IsValid())
+		Preview->ContextCreator = MakeShared<FContextCreator>();
+
+	Preview->Context = Preview->ContextCreator->Update({ FName(*PreviewName), PreviewResource->TextureRHI->GetTexture2D(), ESpoutHdrTransport::None }, FPlatformTime::Seconds());
+
+	// the unpacked source, display-referred 8-bit like the memory share
+	FTextureResource* SourceResource = OutputTexture->GetResource();
+
+	ENQUEUE_RENDER_COMMAND(SpoutSenderPreviewOp)([SourceResource, PreviewResource, Factor, bFlush = !UseTransferWorker()](FRHICommandListImmediate& RHICmdList) {
+		DownscalePreview_RenderThread(RHICmdList, SourceResource->TextureRHI, PreviewResource->TextureRHI, Factor, bFlush);
+	});
+
+	if (Preview->Context.IsValid())
+	{
+		Preview->Context->Beat(FPlatformTime::Seconds());
+		Preview->Context->Tick(Preview->StreamId);
+	}
+}
+
+void USpoutSenderActorComponent::ResetPreview()
+{
+	if (!Preview.IsValid())
+		return;
+
+	// queued preview copies hold the context by pointer
+	if (Preview->Context.IsValid())
+		FlushRenderingCommands();
+
+	Preview.Reset();
+	PreviewRenderTarget = nullptr;
+}
+
+void USpoutSenderActorComponent::TickViewCapture()
+{
+	UGameViewportClient* GameViewport = GEngine ? GEngine->GameViewport : nullptr;
+
+#if !SPOUT_WITH_VIEW_CAPTURE
+	// scene view capture needs the post-processing subscriptions of newer engines
+	if (Source == ESpoutSenderSource::SceneView)
+		GameViewport = nullptr;
+#endif
+
+	if (!GameViewport || !GameViewport->Viewport)
+	{
+		ResetViewCapture();
+		return;
+	}
+
+	if (!ViewCapture.IsValid()
+		|| ViewCapture->Source != Source
+		|| ViewCapture->Stage != CaptureStage)
+	{
+		ResetViewCapture();
+		ViewCapture = MakeShared<FViewCapture>(Source, CaptureStage, GameViewport);
+	}
+
+	// the slot follows whatever the renderer last saw of the view or back buffer
+	FIntPoint ViewSize;
+	int32 ViewFormat;
+	ViewCapture->Handoff->GetObserved(ViewSize, ViewFormat);
+
+	if (ViewSize.X <= 0 || ViewSize.Y <= 0)
+		return;
+
+	if (!CaptureRenderTarget
+		|| CaptureRenderTarget->SizeX != ViewSize.X
+		|| CaptureRenderTarget->SizeY != ViewSize.Y
+		|| CaptureRenderTarget->GetFormat() != (EPixelFormat)ViewFormat)
+	{
+		ResetContext();
+
+		CaptureRenderTarget = NewObject<UTextureRenderTarget2D>(this, FName("SpoutCaptureSlot"), RF_Transient);
+#if ENGINE_MAJOR_VERSION == 5
+		// D3D11 publishes a slot with a shared handle as the shared texture itself, D3D12 handles are not legacy ones Spout opens
+		CaptureRenderTarget->bGPUSharedFlag = FString(GDynamicRHI->GetName()) == TEXT("D3D11");
+#endif
+		CaptureRenderTarget->InitCustomFormat(ViewSize.X, ViewSize.Y, (EPixelFormat)ViewFormat, true);
+		return;
+	}
+
+	FTextureResource* SlotResource = CaptureRenderTarget->GetResource();
+	if (!SlotResource || !SlotResource->TextureRHI || !SlotResource->TextureRHI->GetTexture2D())
+		return;
+
+	FRHITexture2D* Slot = SlotResource->TextureRHI->GetTexture2D();
+
+	if (!ContextCreator.IsValid())
+		ContextCreator = MakeShared<FContextCreator>();
+
+	// the slot is published as captured, HDR packing and the memory share apply to texture sources
+	TSharedPtr<SpoutSenderContext, ESPMode::ThreadSafe> ReadyContext = ContextCreator->Update({ PublishName, Slot, ESpoutHdrTransport::None, true }, FPlatformTime::Seconds());
+	if (ReadyContext != context && ViewCapture->Target.IsValid())
+	{
+		// the armed target still publishes through the old context
+		ViewCapture->Handoff->Disarm();
+		ViewCapture->Target.Reset();
+		ViewCapture->TargetContext = nullptr;
+		FlushRenderingCommands();
+	}
+	context = ReadyContext;
+
+	if (!context.IsValid())
+		return;
+
+	context->Beat(FPlatformTime::Seconds());
+
+	FSpoutTransferScheduler& Scheduler = FSpoutTransferScheduler::Get();
+
+	if (TransferStreamId == INDEX_NONE)
+		TransferStreamId = Scheduler.RegisterStream(GFrameCounter);
+
+	Scheduler.UpdateStream(TransferStreamId, TransferPriority, TargetFrameRate);
+
+	if (!Scheduler.ShouldTransfer(TransferStreamId, GFrameCounter, FPlatformTime::Seconds()))
+		return;
+
+	if (!ShouldPublishForSubscribers(PublishName.ToString(), SubscriberMonitor, LastKeepAliveTime))
+	{
+		Scheduler.Withdraw(TransferStreamId, GFrameCounter);
+		return;
+	}
+
+	if (LosslessPacing.IsValid())
+		LosslessPacing->Publish(context);
+
+	if (ViewCapture->TargetContext != context.Get())
+	{
+		context->PrepareRenderThreadPublish();
+
+		ViewCapture->Target = MakeShared<FSpoutCaptureTarget, ESPMode::ThreadSafe>();
+		ViewCapture->Target->Slot = Slot;
+		ViewCapture->Target->Begin_RenderThread = [Context = context.Get()]() {
+			return Context->BeginCapture_RenderThread();
+		};
+		ViewCapture->Target->Publish_RenderThread = [Context = context.Get(), StreamId = TransferStreamId](FRHICommandListImmediate& RHICmdList) {
+			Context->PublishCapture_RenderThread(RHICmdList, StreamId);
+		};
+		ViewCapture->TargetContext = context.Get();
+	}
+
+	AttachPendingMetadata();
+
+	// frame numbers of the view family rendered from this tick
+	ViewCapture->Handoff->Arm(ViewCapture->Target, ViewSize, ViewFormat, GFrameNumber);
+}
+
+// false when the atlas refused the texture and the caller publishes it with its own context
+bool USpoutSenderActorComponent::TickAtlas()
+{
+	FRHITexture2D* Texture2D = OutputTexture->GetResource()->TextureRHI->GetTexture2D();
+	if (!Texture2D)
+		return true;
+
+	if (!AtlasPublisher.IsValid() || AtlasPublisher->AtlasName != AtlasName)
+	{
+		LeaveAtlas();
+		AtlasPublisher = FAtlasPublisher::Join(AtlasName);
+	}
+
+	// checked every tick, the atlas takes the texture back once its format matches or the other members left
+	if (!AtlasPublisher->Accepts(Texture2D))
+		return RefuseAtlas(Texture2D);
+
+	if (bAtlasRefused)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Spout2: %s joins atlas '%s' again"), *PublishName.ToString(), *AtlasName.ToString());
+		bAtlasRefused = false;
+	}
+
+	if (context.IsValid())
+		ResetContext();
+
+	FSpoutTransferScheduler& Scheduler = FSpoutTransferScheduler::Get();
+
+	if (TransferStreamId == INDEX_NONE)
+		TransferStreamId = Scheduler.RegisterStream(GFrameCounter);
+
+	Scheduler.UpdateStream(TransferStreamId, TransferPriority, TargetFrameRate);
+
+	if (!Scheduler.ShouldTransfer(TransferStreamId, GFrameCounter, FPlatformTime::Seconds()))
+		return true;
+
+	if (!ShouldPublishForSubscribers(PublishName.ToString(), SubscriberMonitor, LastKeepAliveTime))
+	{
+		Scheduler.Withdraw(TransferStreamId, GFrameCounter);
+		return true;
+	}
+
+	// HDR packing, change detection and the memory share are for senders with their own shared texture
+	if (!AtlasPublisher->Submit(this, PublishName, Texture2D))
+	{
+		// the standalone path asks the scheduler again this tick
+		Scheduler.Withdraw(TransferStreamId, GFrameCounter);
+		return RefuseAtlas(Texture2D);
+	}
+
+	return true;
+}
+
+bool USpoutSenderActorComponent::RefuseAtlas(FRHITexture2D* Texture2D)
+{
+	if (!bAtlasRefused)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Spout2: %s is %s, atlas '%s' holds %s; publishing it on its own"),
+			*PublishName.ToString(), GPixelFormats[Texture2D->GetFormat()].Name, *AtlasName.ToString(), GPixelFormats[AtlasPublisher->GetFormat()].Name);
+		bAtlasRefused = true;
+	}
+
+	// a member whose texture changed format must not be copied into the atlas with its old one
+	AtlasPublisher->Leave(this);
+
+	return false;
+}
+
+void USpoutSenderActorComponent::LeaveAtlas()
+{
+	if (!AtlasPublisher.IsValid())
+		return;
+
+	AtlasPublisher->Leave(this);
+	AtlasPublisher.Reset();
+	bAtlasRefused = false;
+}
+
+// asked once the scheduler admitted the copy, so a keep-alive is never spent on one that does not run
+bool USpoutSenderActorComponent::ShouldPublishForSubscribers(const FString& SenderName, TSharedPtr<FSpoutSubscriberMonitor>& Monitor, double& InOutLastKeepAliveTime) const
+{
+	if (!bOnlyWhileSubscribed)
+	{
+		Monitor.Reset();
+		return true;
+	}
+
+	if (!Monitor.IsValid() || Monitor->GetSenderName() != SenderName)
+		Monitor = MakeShared<FSpoutSubscriberMonitor>(SenderName);
+
+	const double Now = FPlatformTime::Seconds();
+
+	// also publishes when the control region is unusable, nothing is known about subscribers then
+	if (Monitor->CountSubscribers(Now, CVarSpoutSubscriberTimeout.GetValueOnGameThread()) != 0)
+	{
+		InOutLastKeepAliveTime = Now;
+		return true;
+	}
+
+	// keeps the shared texture from looking frozen to receivers outside the plugin
+	const float KeepAliveRate = CVarSpoutIdleKeepAliveRate.GetValueOnGameThread();
+	if (KeepAliveRate > 0.f && Now - InOutLastKeepAliveTime >= 1.0 / KeepAliveRate)
+	{
+		InOutLastKeepAliveTime = Now;
+		return true;
+	}
+
+	INC_DWORD_STAT(STAT_SpoutIdlePublishesSkipped);
+	return false;
+}
+
+void USpoutSenderActorComponent::MarkDirty()
+{
+	++DirtyCount;
+}
+
+void USpoutSenderActorComponent::SetFrameMetadata(const TArray<uint8>& Metadata)
+{
+	PendingMetadata = Metadata;
+	bMetadataPending = true;
+}
+
+void USpoutSenderActorComponent::AttachPendingMetadata()
+{
+	if (!bMetadataPending)
+		return;
+
+	// the copy enqueued from this tick runs in this game frame, see SpoutSenderContext::PublishMetadata
+	context->AttachMetadata(GFrameNumber, MoveTemp(PendingMetadata));
+	PendingMetadata.Reset();
+	bMetadataPending = false;
+}
+
+void USpoutSenderActorComponent::ResetViewCapture()
+{
+	if (!ViewCapture.IsValid())
+		return;
+
+	ViewCapture->Handoff->Disarm();
+
+	// render thread callbacks of the extension or the back buffer delegate may still be queued
+	FlushRenderingCommands();
+
+	ViewCapture.Reset();
+	CaptureRenderTarget = nullptr;
+}
+
+void USpoutSenderActorComponent::PublishMemoryShare()
+{
+	const FString SenderName = PublishName.ToString();
+
+	if (!MemorySender.IsValid() || MemorySender->GetSenderName() != SenderName)
+		MemorySender = MakeShared<FSpoutMemorySender, ESPMode::ThreadSafe>(SenderName);
+
+	FMemoryReadback::FPublish Publish;
+	Publish.Sender = MemorySender;
+	Publish.PreviewFactor = SpoutPreviewDownscale::GetFactor(PreviewScale);
+	Publish.Format = MemoryShareFormat;
+	Publish.Matrix = YuvMatrix;
+
+	if (Preview.IsValid() && Preview->bMemoryShareDue)
+	{
+		Preview->bMemoryShareDue = false;
+
+		const FString PreviewName = SpoutPreviewDownscale::MakePreviewName(SenderName);
+
+		if (!Preview->MemorySender.IsValid() || Preview->MemorySender->GetSenderName() != PreviewName)
+			Preview->MemorySender = MakeShared<FSpoutMemorySender, ESPMode::ThreadSafe>(PreviewName);
+
+		Publish.PreviewSender = Preview->MemorySender;
+	}
+
+	if (!MemoryReadback.IsValid())
+		MemoryReadback = MakeShared<FMemoryReadback, ESPMode::ThreadSafe>();
+
+	// the unpacked source, memory-share consumers get display-referred 8-bit BGRA
+	FTextureResource* SourceResource = OutputTexture->GetResource();
+
+	ENQUEUE_RENDER_COMMAND(SpoutSenderMemoryShareOp)([SourceResource, Readback = MemoryReadback, Publish = MoveTemp(Publish)](FRHICommandListImmediate& RHICmdList) mutable {
+		FRHITexture* SourceRHI = SourceResource->TextureRHI;
+		if (!SourceRHI)
+			return;
+
+		if (FMemoryReadback::CanReadBack(SourceRHI->GetFormat()))
+		{
+			Readback->Copy_RenderThread(RHICmdList, SourceRHI, MoveTemp(Publish));
+			return;
+		}
+
+		// formats the readback does not convert stall the render thread on a synchronous read, only the publish is deferred
+		if (!Readback->CanPublish_RenderThread())
+		{
+			INC_DWORD_STAT(STAT_SpoutReadbacksDropped);
+			return;
+		}
+
+		const FIntVector Size = SourceRHI->GetSizeXYZ();
+
+		TArray<FColor>& Pixels = Readback->GetPixels_RenderThread();
+		RHICmdList.ReadSurfaceData(SourceRHI, FIntRect(0, 0, Size.X, Size.Y), Pixels, FReadSurfaceDataFlags());
+
+		if (Pixels.Num() == Size.X * Size.Y)
+			Readback->PublishAsync_RenderThread(MoveTemp(Publish), FIntPoint(Size.X, Size.Y));
+	});
+}
+
+void USpoutSenderActorComponent::PublishFinishedReadbacks()
+{
+	if (!MemoryReadback.IsValid())
+		return;
+
+	ENQUEUE_RENDER_COMMAND(SpoutSenderReadbackOp)([Readback = MemoryReadback](FRHICommandListImmediate& RHICmdList) {
+		Readback->PublishFinished_RenderThread(RHICmdList);
+	});
+}
+
+bool USpoutSenderActorComponent::UpdatePackedRenderTarget()
+{
+	const int32 Width = FMath::TruncToInt(OutputTexture->GetSurfaceWidth());
+	const int32 Height = FMath::TruncToInt(OutputTexture->GetSurfaceHeight());
+	const EPixelFormat Format = HdrTransport == ESpoutHdrTransport::Float11 ? PF_FloatR11G11B10 : PF_A2B10G10R10;
+
+	if (Width <= 0 || Height <= 0)
+		return false;
+
+	if (!PackedRenderTarget
+		|| PackedRenderTarget->SizeX != Width
+		|| PackedRenderTarget->SizeY != Height
+		|| PackedRenderTarget->GetFormat() != Format)
+	{
+		PackedRenderTarget = NewObject<UTextureRenderTarget2D>(this, FName("SpoutPackedHdr"), RF_Transient);
+		PackedRenderTarget->InitCustomFormat(Width, Height, Format, true);
+	}
+
+	return PackedRenderTarget->GetResource() != nullptr;
+}
+
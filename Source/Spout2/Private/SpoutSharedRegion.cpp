@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutSharedRegion.h"
+
+bool FSpoutSharedRegion::Create(const FString& InName, SIZE_T Size)
+{
+	return Map(InName, Size, true);
+}
+
+bool FSpoutSharedRegion::Open(const FString& InName, SIZE_T Size)
+{
+	return Map(InName, Size, false);
+}
+
+bool FSpoutSharedRegion::Map(const FString& InName, SIZE_T Size, bool bCreate)
+{
+	Close();
+
+	Region = FPlatformMemory::MapNamedSharedMemoryRegion(InName, bCreate,
+		(uint32)FPlatformMemory::ESharedMemoryAccess::Read | (uint32)FPlatformMemory::ESharedMemoryAccess::Write, Size);
+
+	if (!Region)
+		return false;
+
+	Name = InName;
+	return true;
+}
+
+void FSpoutSharedRegion::Close()
+{
+	if (Region)
+	{
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+		Region = nullptr;
+	}
+	Name.Reset();
+}
+
+void* FSpoutSharedRegion::GetAddress() const
+{
+	return Region ? Region->GetAddress() : nullptr;
+}
+
+SIZE_T FSpoutSharedRegion::GetSize() const
+{
+	return Region ? Region->GetSize() : 0;
+}
+
+FString FSpoutSharedRegion::MakeName(const FString& SenderName, const TCHAR* Suffix)
+{
+	return FString::Printf(TEXT("%s_%s"), *SenderName, Suffix);
+}
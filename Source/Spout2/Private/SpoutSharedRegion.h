@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformMemory.h"
+
+/**
+ * Named shared memory owned by the plugin, next to Spout's own sender registry.
+ * Thin RAII wrapper over FPlatformMemory::MapNamedSharedMemoryRegion, so the same
+ * code maps file mappings on Windows and POSIX shared memory elsewhere.
+ */
+class FSpoutSharedRegion
+{
+public:
+
+	FSpoutSharedRegion() {}
+	~FSpoutSharedRegion() { Close(); }
+
+	FSpoutSharedRegion(const FSpoutSharedRegion&) = delete;
+	FSpoutSharedRegion& operator=(const FSpoutSharedRegion&) = delete;
+
+	/** Creates the region, or maps it when another process already created it. */
+	bool Create(const FString& InName, SIZE_T Size);
+
+	/** Maps an existing region, fails when nobody created it. */
+	bool Open(const FString& InName, SIZE_T Size);
+
+	void Close();
+
+	bool IsValid() const { return Region != nullptr; }
+	const FString& GetName() const { return Name; }
+	void* GetAddress() const;
+	SIZE_T GetSize() const;
+
+	template<typename T>
+	T* As() const
+	{
+		check(GetSize() >= sizeof(T));
+		return static_cast<T*>(GetAddress());
+	}
+
+	/** Region name for a sender, "<SenderName>_<Suffix>". */
+	static FString MakeName(const FString& SenderName, const TCHAR* Suffix);
+
+private:
+
+	bool Map(const FString& InName, SIZE_T Size, bool bCreate);
+
+	FPlatformMemory::FSharedMemoryRegion* Region = nullptr;
+	FString Name;
+};
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeLock.h"
+
+/**
+ * Process-wide instances shared by key: the first Acquire of a key creates the value,
+ * later ones get the same value, and the value is destroyed with its last reference.
+ *
+ * The registry only holds weak references, so teardown is whatever releases the last
+ * TSharedPtr. Values are plain types, the counting runs without any RHI.
+ */
+template<typename KeyType, typename ValueType>
+class TSpoutSharedRegistry
+{
+public:
+
+	typedef TSharedRef<ValueType, ESPMode::ThreadSafe> FValueRef;
+
+	/** Returns the live value of Key, or the one Factory() makes when there is none. */
+	template<typename FactoryType>
+	FValueRef Acquire(const KeyType& Key, FactoryType&& Factory)
+	{
+		FScopeLock Lock(&Mutex);
+
+		if (const TWeakPtr<ValueType, ESPMode::ThreadSafe>* Existing = Entries.Find(Key))
+		{
+			if (TSharedPtr<ValueType, ESPMode::ThreadSafe> Value = Existing->Pin())
+				return Value.ToSharedRef();
+		}
+
+		RemoveExpired();
+
+		FValueRef Value = Factory();
+		Entries.Add(Key, Value);
+		return Value;
+	}
+
+	/** Live value of Key without creating one. */
+	TSharedPtr<ValueType, ESPMode::ThreadSafe> Find(const KeyType& Key) const
+	{
+		FScopeLock Lock(&Mutex);
+
+		const TWeakPtr<ValueType, ESPMode::ThreadSafe>* Existing = Entries.Find(Key);
+		return Existing ? Existing->Pin() : nullptr;
+	}
+
+	/** Number of keys whose value is still referenced. */
+	int32 Num() const
+	{
+		FScopeLock Lock(&Mutex);
+
+		int32 Count = 0;
+		for (const auto& Entry : Entries)
+		{
+			if (Entry.Value.IsValid())
+				++Count;
+		}
+		return Count;
+	}
+
+private:
+
+	void RemoveExpired()
+	{
+		for (auto It = Entries.CreateIterator(); It; ++It)
+		{
+			if (!It.Value().IsValid())
+				It.RemoveCurrent();
+		}
+	}
+
+	mutable FCriticalSection Mutex;
+	TMap<KeyType, TWeakPtr<ValueType, ESPMode::ThreadSafe>> Entries;
+};
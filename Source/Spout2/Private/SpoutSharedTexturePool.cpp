@@ -0,0 +1,279 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutSharedTexturePool.h"
+
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/ScopeLock.h"
+#include "RHI.h"
+
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include <d3d11on12.h>
+#include "Windows/HideWindowsPlatformTypes.h"
+
+#include "SpoutPixelFormats.h"
+#include "SpoutStats.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pool Hits"), STAT_SpoutPoolHits, STATGROUP_Spout2);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pool Misses"), STAT_SpoutPoolMisses, STATGROUP_Spout2);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pool Evictions"), STAT_SpoutPoolEvictions, STATGROUP_Spout2);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Pool Hit Rate"), STAT_SpoutPoolHitRate, STATGROUP_Spout2);
+DECLARE_MEMORY_STAT(TEXT("Pooled Textures In Use"), STAT_SpoutPoolBytesInUse, STATGROUP_Spout2);
+DECLARE_MEMORY_STAT(TEXT("Pooled Textures Idle"), STAT_SpoutPoolBytesIdle, STATGROUP_Spout2);
+
+static TAutoConsoleVariable<int32> CVarSpoutPoolBudgetMB(
+	TEXT("Spout2.SharedTexturePoolBudgetMB"),
+	512,
+	TEXT("Memory budget in MB for all shared textures the Spout pool created. Idle ones are evicted past it, 0 disables the budget."),
+	ECVF_Default);
+
+static FAutoConsoleCommand CmdSpoutPoolStats(
+	TEXT("Spout2.SharedTexturePoolStats"),
+	TEXT("Logs hit rate and memory of the Spout shared texture pool."),
+	FConsoleCommandDelegate::CreateLambda([]() {
+		const FSpoutSharedTexturePool::FPolicy::FStats Stats = FSpoutSharedTexturePool::Get().GetStats();
+		UE_LOG(LogTemp, Log, TEXT("Spout2 pool: %llu hits, %llu misses (%.1f%%), %llu evictions, %.1f MB in use, %.1f MB idle in %d textures"),
+			Stats.Hits, Stats.Misses, Stats.GetHitRate() * 100.0, Stats.Evictions,
+			Stats.BytesInUse / (1024.0 * 1024.0), Stats.BytesIdle / (1024.0 * 1024.0), Stats.NumIdle);
+	}));
+
+uint64 FSpoutSharedTextureDesc::GetSizeBytes() const
+{
+	return (uint64)Width * Height * SpoutPixelFormats::GetBytesPerPixel(Format);
+}
+
+bool FSpoutSharedTextureDesc::Parse(const FString& Text, FSpoutSharedTextureDesc& OutDesc)
+{
+	FString Size, FormatName;
+	if (!Text.TrimStartAndEnd().Split(TEXT(" "), &Size, &FormatName))
+		return false;
+
+	FString WidthText, HeightText;
+	if (!Size.Split(TEXT("x"), &WidthText, &HeightText))
+		return false;
+
+	OutDesc.Width = FCString::Atoi(*WidthText);
+	OutDesc.Height = FCString::Atoi(*HeightText);
+	OutDesc.Format = 0;
+
+	FormatName.TrimStartAndEndInline();
+
+	// the typed, linear member of each group is what senders create shared textures with
+	for (const SpoutPixelFormats::FInfo& Info : SpoutPixelFormats::Table)
+	{
+		if (Info.DxgiFormat == Info.TypedFormat
+			&& !Info.bSRGB
+			&& Info.bDirectCopy
+			&& FormatName == GPixelFormats[Info.PixelFormat].Name)
+		{
+			OutDesc.Format = Info.DxgiFormat;
+			break;
+		}
+	}
+
+	return OutDesc.Width > 0 && OutDesc.Height > 0 && OutDesc.Format != 0;
+}
+
+FSpoutSharedTexture::~FSpoutSharedTexture()
+{
+	if (Texture)
+	{
+		Texture->Release();
+		Texture = nullptr;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+FSpoutSharedTexturePool& FSpoutSharedTexturePool::Get()
+{
+	static FSpoutSharedTexturePool Instance;
+	return Instance;
+}
+
+FSpoutSharedTextureRef FSpoutSharedTexturePool::Acquire(const FSpoutSharedTextureDesc& Desc)
+{
+	// evicted textures are destroyed after the lock is dropped
+	TArray<FSpoutSharedTextureRef> Evicted;
+	FSpoutSharedTextureRef Texture;
+
+	{
+		FScopeLock Lock(&Mutex);
+
+		const bool bHit = Policy.Acquire(Desc, Texture);
+		UpdateBudgetAndStats(Evicted);
+
+		if (bHit)
+			return Texture;
+	}
+
+	Texture = Create(Desc);
+
+	if (Texture.IsValid())
+	{
+		FScopeLock Lock(&Mutex);
+		Policy.OnCreated(Desc.GetSizeBytes());
+		UpdateBudgetAndStats(Evicted);
+	}
+
+	return Texture;
+}
+
+void FSpoutSharedTexturePool::Release(FSpoutSharedTextureRef Texture)
+{
+	if (!Texture.IsValid())
+		return;
+
+	TArray<FSpoutSharedTextureRef> Evicted;
+
+	FScopeLock Lock(&Mutex);
+
+	const FSpoutSharedTextureDesc Desc = Texture->Desc;
+	Evicted = Policy.Release(Desc, MoveTemp(Texture), Desc.GetSizeBytes());
+	UpdateBudgetAndStats(Evicted);
+}
+
+void FSpoutSharedTexturePool::Prewarm(const FSpoutSharedTextureDesc& Desc, int32 Count)
+{
+	int32 NumIdle;
+	{
+		FScopeLock Lock(&Mutex);
+		NumIdle = Policy.NumIdle(Desc);
+	}
+
+	for (int32 Index = NumIdle; Index < Count; ++Index)
+	{
+		FSpoutSharedTextureRef Texture = Create(Desc);
+		if (!Texture.IsValid())
+			return;
+
+		{
+			FScopeLock Lock(&Mutex);
+			Policy.OnCreated(Desc.GetSizeBytes());
+		}
+
+		Release(MoveTemp(Texture));
+	}
+}
+
+FSpoutSharedTexturePool::FPolicy::FStats FSpoutSharedTexturePool::GetStats()
+{
+	FScopeLock Lock(&Mutex);
+	return Policy.GetStats();
+}
+
+void FSpoutSharedTexturePool::UpdateBudgetAndStats(TArray<FSpoutSharedTextureRef>& OutEvicted)
+{
+	const uint64 BudgetBytes = (uint64)FMath::Max(CVarSpoutPoolBudgetMB.GetValueOnAnyThread(), 0) * 1024 * 1024;
+	if (BudgetBytes != Policy.GetBudget())
+		OutEvicted.Append(Policy.SetBudget(BudgetBytes));
+
+	const FPolicy::FStats& Stats = Policy.GetStats();
+	SET_DWORD_STAT(STAT_SpoutPoolHits, Stats.Hits);
+	SET_DWORD_STAT(STAT_SpoutPoolMisses, Stats.Misses);
+	SET_DWORD_STAT(STAT_SpoutPoolEvictions, Stats.Evictions);
+	SET_FLOAT_STAT(STAT_SpoutPoolHitRate, Stats.GetHitRate());
+	SET_MEMORY_STAT(STAT_SpoutPoolBytesInUse, Stats.BytesInUse);
+	SET_MEMORY_STAT(STAT_SpoutPoolBytesIdle, Stats.BytesIdle);
+}
+
+void FSpoutSharedTexturePool::PrewarmFromConfig()
+{
+	TArray<FString> Profiles;
+	GConfig->GetArray(TEXT("Spout2"), TEXT("PrewarmProfiles"), Profiles, GEngineIni);
+
+	TArray<FSpoutSharedTextureDesc> Descs;
+	for (const FString& Profile : Profiles)
+	{
+		FSpoutSharedTextureDesc Desc;
+		if (FSpoutSharedTextureDesc::Parse(Profile, Desc))
+			Descs.Add(Desc);
+		else
+			UE_LOG(LogTemp, Warning, TEXT("Spout2: ignoring prewarm profile '%s', expected '<Width>x<Height> <PixelFormat>'"), *Profile);
+	}
+
+	if (Descs.Num() == 0)
+		return;
+
+	Async(EAsyncExecution::ThreadPool, [this, Descs]() {
+		for (const FSpoutSharedTextureDesc& Desc : Descs)
+			Prewarm(Desc);
+	});
+}
+
+void FSpoutSharedTexturePool::Shutdown()
+{
+	FScopeLock Lock(&Mutex);
+
+	Policy.Empty();
+
+	if (Device)
+	{
+		Device->Release();
+		Device = nullptr;
+	}
+}
+
+FSpoutSharedTextureRef FSpoutSharedTexturePool::Create(const FSpoutSharedTextureDesc& Desc)
+{
+	ID3D11Device* PoolDevice = GetDevice();
+	if (!PoolDevice)
+		return nullptr;
+
+	FSpoutSharedTextureRef Texture = MakeShared<FSpoutSharedTexture, ESPMode::ThreadSafe>();
+	Texture->Desc = Desc;
+
+	// same description spoutDirectX::CreateSharedDX11Texture uses, plus the requested misc flags
+	D3D11_TEXTURE2D_DESC TextureDesc = {};
+	TextureDesc.Width = Desc.Width;
+	TextureDesc.Height = Desc.Height;
+	TextureDesc.MipLevels = 1;
+	TextureDesc.ArraySize = 1;
+	TextureDesc.Format = (DXGI_FORMAT)Desc.Format;
+	TextureDesc.SampleDesc.Count = 1;
+	TextureDesc.Usage = D3D11_USAGE_DEFAULT;
+	TextureDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+	TextureDesc.MiscFlags = D3D11_RESOURCE_MISC_SHARED | Desc.Flags;
+
+	if (PoolDevice->CreateTexture2D(&TextureDesc, nullptr, &Texture->Texture) != S_OK)
+	{
+		Texture->Texture = nullptr;
+		return nullptr;
+	}
+
+	IDXGIResource* DxgiResource = nullptr;
+	if (Texture->Texture->QueryInterface(__uuidof(IDXGIResource), (void**)&DxgiResource) != S_OK)
+		return nullptr;
+
+	const bool bHasHandle = DxgiResource->GetSharedHandle(&Texture->ShareHandle) == S_OK;
+	DxgiResource->Release();
+
+	return bHasHandle ? Texture : nullptr;
+}
+
+ID3D11Device* FSpoutSharedTexturePool::GetDevice()
+{
+	FScopeLock Lock(&Mutex);
+
+	if (Device || !GDynamicRHI)
+		return Device;
+
+	FString RHIName = GDynamicRHI->GetName();
+
+	if (RHIName == TEXT("D3D11"))
+	{
+		Device = static_cast<ID3D11Device*>(GDynamicRHI->RHIGetNativeDevice());
+		Device->AddRef();
+	}
+	else if (RHIName == TEXT("D3D12"))
+	{
+		ID3D12Device* Device12 = static_cast<ID3D12Device*>(GDynamicRHI->RHIGetNativeDevice());
+
+		// only creates textures, so it never needs the wrapped-resource interface
+		if (D3D11On12CreateDevice(Device12, D3D11_CREATE_DEVICE_BGRA_SUPPORT, nullptr, 0, nullptr, 0, 0, &Device, nullptr, nullptr) != S_OK)
+			Device = nullptr;
+	}
+
+	return Device;
+}
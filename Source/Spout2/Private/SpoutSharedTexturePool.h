@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "SpoutResourcePool.h"
+
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include <d3d11.h>
+#include "Windows/HideWindowsPlatformTypes.h"
+
+struct FSpoutSharedTextureDesc
+{
+	uint32 Width = 0;
+	uint32 Height = 0;
+	uint32 Format = 0;
+	// D3D11_RESOURCE_MISC flags on top of SHARED, e.g. SHARED_KEYEDMUTEX
+	uint32 Flags = 0;
+
+	bool operator==(const FSpoutSharedTextureDesc& Other) const
+	{
+		return Width == Other.Width && Height == Other.Height && Format == Other.Format && Flags == Other.Flags;
+	}
+
+	uint64 GetSizeBytes() const;
+
+	/** Parses "<Width>x<Height> <Format>", Format being an engine pixel format name such as B8G8R8A8 or FloatRGBA. */
+	static bool Parse(const FString& Text, FSpoutSharedTextureDesc& OutDesc);
+};
+
+/** A shareable D3D11 texture owned by the pool, opened by senders through its handle. */
+struct FSpoutSharedTexture
+{
+	FSpoutSharedTextureDesc Desc;
+	ID3D11Texture2D* Texture = nullptr;
+	HANDLE ShareHandle = nullptr;
+
+	~FSpoutSharedTexture();
+};
+
+typedef TSharedPtr<FSpoutSharedTexture, ESPMode::ThreadSafe> FSpoutSharedTextureRef;
+
+/**
+ * Process-wide store of shared textures.
+ *
+ * Textures are created on one device owned by the pool (the engine's device on D3D11,
+ * a D3D11On12 device on D3D12) and reach other devices through their share handle, so a
+ * texture released by one sender can be handed to the next one of the same description.
+ * Profiles listed in [Spout2] PrewarmProfiles of the engine ini are created after engine init.
+ *
+ * Idle textures are evicted least recently released first once everything the pool created
+ * exceeds Spout2.SharedTexturePoolBudgetMB. Spout2.SharedTexturePoolStats logs the counters.
+ */
+class FSpoutSharedTexturePool
+{
+public:
+
+	static FSpoutSharedTexturePool& Get();
+
+	/** Hands out a free texture matching Desc, creating one when none is free. Thread safe. */
+	FSpoutSharedTextureRef Acquire(const FSpoutSharedTextureDesc& Desc);
+
+	/** Returns a texture for reuse. Thread safe. */
+	void Release(FSpoutSharedTextureRef Texture);
+
+	/** Creates textures up front so the first senders of that description skip the allocation. */
+	void Prewarm(const FSpoutSharedTextureDesc& Desc, int32 Count = 1);
+
+	/** Prewarms the profiles configured in the engine ini on the thread pool. */
+	void PrewarmFromConfig();
+
+	/** Releases every free texture and the pool device. */
+	void Shutdown();
+
+	typedef TSpoutResourcePool<FSpoutSharedTextureDesc, FSpoutSharedTextureRef> FPolicy;
+
+	FPolicy::FStats GetStats();
+
+private:
+
+	FSpoutSharedTextureRef Create(const FSpoutSharedTextureDesc& Desc);
+	ID3D11Device* GetDevice();
+
+	/** Applies a changed budget cvar and publishes the counters, with Mutex held. */
+	void UpdateBudgetAndStats(TArray<FSpoutSharedTextureRef>& OutEvicted);
+
+	FCriticalSection Mutex;
+	FPolicy Policy;
+
+	ID3D11Device* Device = nullptr;
+};
@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+/**
+ * Snapshot slots handed from one GPU queue to another, in order.
+ *
+ * The writing thread records a copy into the claimed slot on its queue and submits the slot
+ * with a fence written behind that copy; the reading thread waits for the fence, reads the
+ * slot from its own device and releases it once that read completed. A slot is claimed again
+ * only after it was released and the fence of its last write signalled, so neither queue
+ * touches a slot the other one still uses.
+ *
+ * Slots are claimed strictly round robin: while the oldest slot is busy nothing is claimed,
+ * and a reader processing submissions in order never finds a newer frame overtaken.
+ *
+ * FenceRefType is a nullable reference with IsValid() and Poll(), such as FGPUFenceRHIRef.
+ */
+template<typename FenceRefType, int32 NumSlots>
+class TSpoutSnapshotRing
+{
+	static_assert(NumSlots > 0, "A ring needs a slot");
+
+public:
+
+	static constexpr int32 Num = NumSlots;
+
+	TSpoutSnapshotRing() = default;
+	TSpoutSnapshotRing(const TSpoutSnapshotRing&) = delete;
+	TSpoutSnapshotRing& operator=(const TSpoutSnapshotRing&) = delete;
+
+	/** Writing thread. The slot to write next, INDEX_NONE while the reader or the GPU still uses it. */
+	int32 Claim()
+	{
+		FSlot& Slot = Slots[NextSlot];
+
+		if (Slot.bSubmitted.load(std::memory_order_acquire))
+			return INDEX_NONE;
+
+		// a reader that gave up on the fence released the slot before the GPU wrote it
+		if (Slot.Fence.IsValid() && !Slot.Fence->Poll())
+			return INDEX_NONE;
+
+		const int32 Index = NextSlot;
+		NextSlot = (NextSlot + 1) % NumSlots;
+		return Index;
+	}
+
+	/** Writing thread, after recording the copy into a claimed slot and Fence behind it. */
+	void Submit(int32 Index, FenceRefType Fence)
+	{
+		check(Index >= 0 && Index < NumSlots);
+
+		Slots[Index].Fence = MoveTemp(Fence);
+		Slots[Index].bSubmitted.store(true, std::memory_order_release);
+	}
+
+	/** Reading thread, once its read of the slot completed or it dropped the frame. */
+	void Release(int32 Index)
+	{
+		check(Index >= 0 && Index < NumSlots);
+
+		Slots[Index].bSubmitted.store(false, std::memory_order_release);
+	}
+
+	/** Approximate from any thread, for stats and tests. */
+	int32 NumSubmitted() const
+	{
+		int32 Count = 0;
+		for (const FSlot& Slot : Slots)
+			Count += Slot.bSubmitted.load(std::memory_order_acquire) ? 1 : 0;
+
+		return Count;
+	}
+
+private:
+
+	struct FSlot
+	{
+		// writing thread
+		FenceRefType Fence;
+
+		// set by the writer, cleared by the reader
+		std::atomic<bool> bSubmitted{ false };
+	};
+
+	FSlot Slots[NumSlots];
+
+	// writing thread
+	int32 NextSlot = 0;
+};
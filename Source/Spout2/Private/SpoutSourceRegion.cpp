@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutSourceRegion.h"
+
+namespace SpoutSourceRegion
+{
+	FIntRect Resolve(const FIntRect& Bounds, const FIntRect& Region)
+	{
+		if (Region.Width() <= 0 || Region.Height() <= 0)
+			return Bounds;
+
+		const FIntPoint Min = FIntPoint(
+			FMath::Max(Bounds.Min.X + Region.Min.X, Bounds.Min.X),
+			FMath::Max(Bounds.Min.Y + Region.Min.Y, Bounds.Min.Y));
+
+		const FIntPoint Max = FIntPoint(
+			FMath::Min(Bounds.Min.X + Region.Max.X, Bounds.Max.X),
+			FMath::Min(Bounds.Min.Y + Region.Max.Y, Bounds.Max.Y));
+
+		if (Max.X <= Min.X || Max.Y <= Min.Y)
+			return FIntRect();
+
+		return FIntRect(Min, Max);
+	}
+
+	void CopyRows(const uint8* Src, SIZE_T SrcPitch, uint8* Dst, SIZE_T DstPitch, SIZE_T RowBytes, int32 NumRows)
+	{
+		if (SrcPitch == RowBytes && DstPitch == RowBytes)
+		{
+			FMemory::Memcpy(Dst, Src, RowBytes * NumRows);
+			return;
+		}
+
+		for (int32 Row = 0; Row < NumRows; ++Row)
+			FMemory::Memcpy(Dst + Row * DstPitch, Src + Row * SrcPitch, RowBytes);
+	}
+
+	void CopyRegion(const FColor* Src, int32 Width, const FIntRect& Region, FColor* Dst)
+	{
+		const SIZE_T RowBytes = (SIZE_T)Region.Width() * sizeof(FColor);
+
+		CopyRows(
+			(const uint8*)(Src + (SIZE_T)Region.Min.Y * Width + Region.Min.X), (SIZE_T)Width * sizeof(FColor),
+			(uint8*)Dst, RowBytes,
+			RowBytes, Region.Height());
+	}
+}
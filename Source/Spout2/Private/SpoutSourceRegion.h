@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Region-of-interest receiving: only a crop of the sender is copied, into an intermediate
+ * the size of the crop. Plain rectangles and memory, no RHI.
+ */
+namespace SpoutSourceRegion
+{
+	/**
+	 * Region in the coordinates of Bounds (an empty region selects all of Bounds), clamped
+	 * into Bounds and offset to Bounds' origin. Empty when the region lies outside.
+	 */
+	FIntRect Resolve(const FIntRect& Bounds, const FIntRect& Region);
+
+	/** Copies NumRows rows of RowBytes each between buffers of different pitch. */
+	void CopyRows(const uint8* Src, SIZE_T SrcPitch, uint8* Dst, SIZE_T DstPitch, SIZE_T RowBytes, int32 NumRows);
+
+	/** Copies Region of a Width-wide BGRA image into a tightly packed Region-sized one. */
+	void CopyRegion(const FColor* Src, int32 Width, const FIntRect& Region, FColor* Dst);
+}
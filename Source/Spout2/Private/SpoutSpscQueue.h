@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+/**
+ * Bounded lock-free ring for exactly one producer thread and one consumer thread.
+ *
+ * Head and tail are free-running counters; the producer publishes a slot with a release
+ * store of the tail and the consumer hands it back with a release store of the head, so
+ * neither side ever takes a lock or allocates once the ring is built.
+ */
+template<typename ElementType>
+class TSpoutSpscQueue
+{
+public:
+
+	explicit TSpoutSpscQueue(uint32 InCapacity)
+		: Capacity(FMath::RoundUpToPowerOfTwo(FMath::Max<uint32>(InCapacity, 2)))
+		, Mask(Capacity - 1)
+	{
+		Slots.SetNum(Capacity);
+	}
+
+	TSpoutSpscQueue(const TSpoutSpscQueue&) = delete;
+	TSpoutSpscQueue& operator=(const TSpoutSpscQueue&) = delete;
+
+	/** Producer only. False when the ring is full, the element is left untouched. */
+	bool Push(ElementType&& Element)
+	{
+		const uint32 Tail = TailIndex.load(std::memory_order_relaxed);
+		if (Tail - HeadIndex.load(std::memory_order_acquire) == Capacity)
+			return false;
+
+		Slots[Tail & Mask] = MoveTemp(Element);
+		TailIndex.store(Tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/** Consumer only. False when the ring is empty. */
+	bool Pop(ElementType& OutElement)
+	{
+		const uint32 Head = HeadIndex.load(std::memory_order_relaxed);
+		if (Head == TailIndex.load(std::memory_order_acquire))
+			return false;
+
+		OutElement = MoveTemp(Slots[Head & Mask]);
+		HeadIndex.store(Head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/** Approximate from any thread other than the two owners. */
+	uint32 Num() const
+	{
+		return TailIndex.load(std::memory_order_acquire) - HeadIndex.load(std::memory_order_acquire);
+	}
+
+	bool IsEmpty() const { return Num() == 0; }
+	uint32 GetCapacity() const { return Capacity; }
+
+private:
+
+	const uint32 Capacity;
+	const uint32 Mask;
+	TArray<ElementType> Slots;
+
+	// separate lines, the producer and the consumer each write only one of them
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> HeadIndex{ 0 };
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> TailIndex{ 0 };
+};
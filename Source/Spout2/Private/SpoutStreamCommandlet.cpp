@@ -0,0 +1,130 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutStreamCommandlet.h"
+
+#include "Misc/Paths.h"
+#include "SpoutStreamRecording.h"
+
+USpoutStreamCommandlet::USpoutStreamCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 USpoutStreamCommandlet::Main(const FString& Params)
+{
+	FString SenderName;
+	if (FParse::Value(*Params, TEXT("Record="), SenderName))
+		return Record(Params, SenderName);
+
+	FString Path;
+	if (FParse::Value(*Params, TEXT("Replay="), Path))
+		return Replay(Params, Path);
+
+	UE_LOG(LogTemp, Error, TEXT("Usage: -run=SpoutStream -Record=<Sender> -File=<Path> [-Compress] [-Seconds=<N>] [-Frames=<N>]"));
+	UE_LOG(LogTemp, Error, TEXT("       -run=SpoutStream -Replay=<Path> [-As=<Sender>] [-Fast] [-Loops=<N>]"));
+	return 1;
+}
+
+int32 USpoutStreamCommandlet::Record(const FString& Params, const FString& SenderName)
+{
+	FString Path;
+	if (!FParse::Value(*Params, TEXT("File="), Path))
+		Path = SenderName + TEXT(".spoutrec");
+
+	float Seconds = 0.f;
+	int32 MaxFrames = 0;
+	FParse::Value(*Params, TEXT("Seconds="), Seconds);
+	FParse::Value(*Params, TEXT("Frames="), MaxFrames);
+
+	FSpoutStreamRecorder Recorder(SenderName);
+	if (!Recorder.Start(Path, FParse::Param(*Params, TEXT("Compress"))))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Spout2 cannot write %s"), *Path);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Spout2 recording %s into %s"), *SenderName, *Path);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	while (!IsEngineExitRequested())
+	{
+		const double Now = FPlatformTime::Seconds();
+		if (Seconds > 0.f && Now - StartTime >= Seconds)
+			break;
+
+		// the share only holds the newest frame, a long sleep loses the ones published meanwhile
+		if (!Recorder.Poll())
+			FPlatformProcess::SleepNoStats(0.0001f);
+
+		if (MaxFrames > 0 && Recorder.GetWriter().GetNumFrames() >= MaxFrames)
+			break;
+	}
+
+	const int32 NumFrames = Recorder.GetWriter().GetNumFrames();
+	const uint64 NumBytes = Recorder.GetWriter().GetBytesWritten();
+
+	if (!Recorder.Stop())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Spout2 could not finish %s"), *Path);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Spout2 recorded %d frames, %.1f MB"), NumFrames, NumBytes / (1024.0 * 1024.0));
+
+	if (Recorder.GetNumMissedFrames() > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Spout2 missed %lld frames of %s in %d gaps, the sender published faster than it was polled"),
+			Recorder.GetNumMissedFrames(), *SenderName, Recorder.GetNumGaps());
+	}
+
+	return 0;
+}
+
+int32 USpoutStreamCommandlet::Replay(const FString& Params, const FString& Path)
+{
+	FString SenderName;
+	if (!FParse::Value(*Params, TEXT("As="), SenderName))
+		SenderName = FPaths::GetBaseFilename(Path);
+
+	const ESpoutReplayTiming Timing = FParse::Param(*Params, TEXT("Fast")) ? ESpoutReplayTiming::AsFastAsPossible : ESpoutReplayTiming::Original;
+
+	int32 Loops = 1;
+	FParse::Value(*Params, TEXT("Loops="), Loops);
+
+	FSpoutStreamReplayer Replayer(SenderName);
+	if (!Replayer.Open(Path))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Spout2 cannot read %s"), *Path);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Spout2 replaying %d frames of %s as %s"), Replayer.GetNumFrames(), *Path, *SenderName);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	for (int32 Loop = 0; (Loops <= 0 || Loop < Loops) && !IsEngineExitRequested(); ++Loop)
+	{
+		Replayer.Rewind();
+
+		while (!IsEngineExitRequested())
+		{
+			const double Now = FPlatformTime::Seconds();
+			if (!Replayer.Tick(Now, Timing))
+				break;
+
+			const double Wait = Replayer.GetTimeUntilNextFrame(FPlatformTime::Seconds());
+			if (Wait > 0.0)
+				FPlatformProcess::Sleep((float)FMath::Min(Wait, 0.01));
+		}
+	}
+
+	const double Elapsed = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogTemp, Display, TEXT("Spout2 published %d frames in %.3f s, %.1f fps"),
+		Replayer.GetNumPublished(), Elapsed, Elapsed > 0.0 ? Replayer.GetNumPublished() / Elapsed : 0.0);
+
+	return 0;
+}
@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "SpoutStreamCommandlet.generated.h"
+
+/**
+ * Headless recorder and replayer of memory-share streams, for reproducing and benchmarking:
+ *
+ *   -run=SpoutStream -Record=<Sender> -File=<Path> [-Compress] [-Seconds=<N>] [-Frames=<N>]
+ *   -run=SpoutStream -Replay=<Path> [-As=<Sender>] [-Fast] [-Loops=<N>]
+ *
+ * A replay publishes under the recorded file's base name unless -As names the sender.
+ */
+UCLASS()
+class USpoutStreamCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	USpoutStreamCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+
+	int32 Record(const FString& Params, const FString& SenderName);
+	int32 Replay(const FString& Params, const FString& Path);
+};
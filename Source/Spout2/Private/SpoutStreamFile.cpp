@@ -0,0 +1,255 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutStreamFile.h"
+
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Compression.h"
+#include "SpoutYuvConversion.h"
+
+// chunks start 8 byte aligned, so headers can be read in place from the mapping
+static constexpr uint64 SpoutStreamChunkAlignment = 8;
+
+FSpoutStreamWriter::FSpoutStreamWriter()
+{
+}
+
+FSpoutStreamWriter::~FSpoutStreamWriter()
+{
+	Close();
+}
+
+bool FSpoutStreamWriter::Open(const FString& Path, bool bInCompress)
+{
+	Close();
+
+	File.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Path));
+	if (!File.IsValid())
+		return false;
+
+	bCompress = bInCompress;
+	Offset = 0;
+	Index.Reset();
+
+	FSpoutStreamFileHeader Header;
+	Header.Magic = FSpoutStreamFileHeader::MagicValue;
+	Header.Version = FSpoutStreamFileHeader::CurrentVersion;
+
+	return Write(&Header, sizeof(Header));
+}
+
+bool FSpoutStreamWriter::Write(const void* Bytes, SIZE_T NumBytes)
+{
+	if (!File->Write(static_cast<const uint8*>(Bytes), NumBytes))
+		return false;
+
+	Offset += NumBytes;
+	return true;
+}
+
+bool FSpoutStreamWriter::Append(const FSpoutMemoryFrameInfo& Info, const uint8* Payload, SIZE_T PayloadSize, int64 TimestampUs)
+{
+	if (!File.IsValid() || !Payload || PayloadSize == 0 || PayloadSize > MAX_int32)
+		return false;
+
+	const uint8* Stored = Payload;
+	uint64 StoredSize = PayloadSize;
+	uint32 Compression = FSpoutStreamChunkHeader::None;
+
+	if (bCompress)
+	{
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_LZ4, (int32)PayloadSize);
+		CompressedPayload.SetNumUninitialized(CompressedSize);
+
+		// incompressible frames, such as noise, are kept as they are
+		if (FCompression::CompressMemory(NAME_LZ4, CompressedPayload.GetData(), CompressedSize, Payload, (int32)PayloadSize)
+			&& (SIZE_T)CompressedSize < PayloadSize)
+		{
+			Stored = CompressedPayload.GetData();
+			StoredSize = CompressedSize;
+			Compression = FSpoutStreamChunkHeader::LZ4;
+		}
+	}
+
+	FSpoutStreamChunkHeader Chunk;
+	Chunk.Magic = FSpoutStreamChunkHeader::MagicValue;
+	Chunk.Compression = Compression;
+	Chunk.TimestampUs = TimestampUs;
+	Chunk.FrameId = Info.FrameId;
+	Chunk.Width = Info.Width;
+	Chunk.Height = Info.Height;
+	Chunk.Format = (uint32)Info.Format;
+	Chunk.Matrix = (uint32)Info.Matrix;
+	Chunk.StoredSize = StoredSize;
+	Chunk.RawSize = PayloadSize;
+
+	const uint64 ChunkOffset = Offset;
+	const uint8 Padding[SpoutStreamChunkAlignment] = {};
+	const uint64 PaddingSize = Align(StoredSize, SpoutStreamChunkAlignment) - StoredSize;
+
+	if (!Write(&Chunk, sizeof(Chunk))
+		|| !Write(Stored, StoredSize)
+		|| (PaddingSize > 0 && !Write(Padding, PaddingSize)))
+		return false;
+
+	Index.Add({ ChunkOffset, TimestampUs });
+	return true;
+}
+
+bool FSpoutStreamWriter::Close()
+{
+	if (!File.IsValid())
+		return false;
+
+	FSpoutStreamFileFooter Footer;
+	Footer.Magic = FSpoutStreamFileFooter::MagicValue;
+	Footer.NumFrames = Index.Num();
+	Footer.IndexOffset = Offset;
+
+	const bool bWritten = Write(Index.GetData(), Index.Num() * sizeof(FSpoutStreamIndexEntry))
+		&& Write(&Footer, sizeof(Footer))
+		&& File->Flush();
+
+	File.Reset();
+	return bWritten;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+FSpoutStreamReader::FSpoutStreamReader()
+{
+}
+
+FSpoutStreamReader::~FSpoutStreamReader()
+{
+	Close();
+}
+
+bool FSpoutStreamReader::Open(const FString& Path)
+{
+	Close();
+
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Path));
+	if (!MappedFile.IsValid())
+		return false;
+
+	MappedRegion.Reset(MappedFile->MapRegion());
+	if (!MappedRegion.IsValid())
+	{
+		Close();
+		return false;
+	}
+
+	Data = MappedRegion->GetMappedPtr();
+	Size = MappedRegion->GetMappedSize();
+
+	const FSpoutStreamFileHeader* Header = reinterpret_cast<const FSpoutStreamFileHeader*>(Data);
+	if (Size < sizeof(FSpoutStreamFileHeader)
+		|| Header->Magic != FSpoutStreamFileHeader::MagicValue
+		|| Header->Version != FSpoutStreamFileHeader::CurrentVersion)
+	{
+		Close();
+		return false;
+	}
+
+	if (!ReadIndex())
+		RebuildIndex();
+
+	return true;
+}
+
+void FSpoutStreamReader::Close()
+{
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	Data = nullptr;
+	Size = 0;
+	Index.Reset();
+}
+
+const FSpoutStreamChunkHeader* FSpoutStreamReader::GetChunk(uint64 ChunkOffset) const
+{
+	if (ChunkOffset % SpoutStreamChunkAlignment != 0
+		|| ChunkOffset + sizeof(FSpoutStreamChunkHeader) > Size)
+		return nullptr;
+
+	const FSpoutStreamChunkHeader* Chunk = reinterpret_cast<const FSpoutStreamChunkHeader*>(Data + ChunkOffset);
+	if (Chunk->Magic != FSpoutStreamChunkHeader::MagicValue
+		|| Chunk->StoredSize > Size - ChunkOffset - sizeof(FSpoutStreamChunkHeader))
+		return nullptr;
+
+	return Chunk;
+}
+
+bool FSpoutStreamReader::ReadIndex()
+{
+	if (Size < sizeof(FSpoutStreamFileHeader) + sizeof(FSpoutStreamFileFooter))
+		return false;
+
+	const uint64 FooterOffset = Size - sizeof(FSpoutStreamFileFooter);
+	const FSpoutStreamFileFooter* Footer = reinterpret_cast<const FSpoutStreamFileFooter*>(Data + FooterOffset);
+
+	if (Footer->Magic != FSpoutStreamFileFooter::MagicValue
+		|| Footer->IndexOffset + (uint64)Footer->NumFrames * sizeof(FSpoutStreamIndexEntry) != FooterOffset)
+		return false;
+
+	Index.SetNumUninitialized(Footer->NumFrames);
+	FMemory::Memcpy(Index.GetData(), Data + Footer->IndexOffset, Footer->NumFrames * sizeof(FSpoutStreamIndexEntry));
+	return true;
+}
+
+void FSpoutStreamReader::RebuildIndex()
+{
+	Index.Reset();
+
+	// the recorder stopped without an index, every complete chunk is still usable
+	uint64 ChunkOffset = Align((uint64)sizeof(FSpoutStreamFileHeader), SpoutStreamChunkAlignment);
+	while (const FSpoutStreamChunkHeader* Chunk = GetChunk(ChunkOffset))
+	{
+		Index.Add({ ChunkOffset, Chunk->TimestampUs });
+		ChunkOffset += sizeof(FSpoutStreamChunkHeader) + Align(Chunk->StoredSize, SpoutStreamChunkAlignment);
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("Spout2 recording has no index, recovered %d frames"), Index.Num());
+}
+
+bool FSpoutStreamReader::ReadFrame(int32 FrameIndex, FSpoutMemoryFrameInfo& OutInfo, const uint8*& OutPayload, SIZE_T& OutPayloadSize)
+{
+	if (!Index.IsValidIndex(FrameIndex))
+		return false;
+
+	const FSpoutStreamChunkHeader* Chunk = GetChunk(Index[FrameIndex].ChunkOffset);
+	if (!Chunk)
+		return false;
+
+	OutInfo.Format = (ESpoutMemoryShareFormat)Chunk->Format;
+	OutInfo.Matrix = (ESpoutYuvMatrix)Chunk->Matrix;
+	OutInfo.Width = Chunk->Width;
+	OutInfo.Height = Chunk->Height;
+	OutInfo.FrameId = Chunk->FrameId;
+
+	if (Chunk->RawSize != SpoutYuvConversion::GetFrameSize(OutInfo.Format, OutInfo.Width, OutInfo.Height))
+		return false;
+
+	const uint8* Stored = reinterpret_cast<const uint8*>(Chunk + 1);
+
+	switch (Chunk->Compression)
+	{
+	case FSpoutStreamChunkHeader::None:
+		OutPayload = Stored;
+		OutPayloadSize = Chunk->RawSize;
+		return Chunk->StoredSize == Chunk->RawSize;
+
+	case FSpoutStreamChunkHeader::LZ4:
+		DecompressedPayload.SetNumUninitialized(Chunk->RawSize);
+		if (!FCompression::UncompressMemory(NAME_LZ4, DecompressedPayload.GetData(), (int32)Chunk->RawSize, Stored, (int32)Chunk->StoredSize))
+			return false;
+
+		OutPayload = DecompressedPayload.GetData();
+		OutPayloadSize = Chunk->RawSize;
+		return true;
+
+	default:
+		return false;
+	}
+}
@@ -0,0 +1,130 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SpoutMemoryShare.h"
+
+class IFileHandle;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Recorded memory-share stream, a chunked file:
+ *
+ *   FSpoutStreamFileHeader
+ *   one chunk per frame: FSpoutStreamChunkHeader, then the encoded payload (LZ4 when compressed)
+ *   the index: one FSpoutStreamIndexEntry per frame
+ *   FSpoutStreamFileFooter
+ *
+ * Frames are appended as they arrive and the index is written when the recording closes.
+ * A recording that never closed has no footer, the reader then rebuilds the index from
+ * the chunk headers. Payloads stay in the format the sender published, nothing is re-encoded.
+ */
+struct FSpoutStreamFileHeader
+{
+	static constexpr uint32 MagicValue = 0x46525053; // "SPRF"
+	static constexpr uint32 CurrentVersion = 1;
+
+	uint32 Magic;
+	uint32 Version;
+};
+
+struct FSpoutStreamChunkHeader
+{
+	static constexpr uint32 MagicValue = 0x4b435053; // "SPCK"
+
+	enum ECompression : uint32
+	{
+		None,
+		LZ4,
+	};
+
+	uint32 Magic;
+	uint32 Compression;
+	int64 TimestampUs;
+	int64 FrameId;
+	int32 Width;
+	int32 Height;
+	uint32 Format;
+	uint32 Matrix;
+	uint64 StoredSize;
+	uint64 RawSize;
+};
+
+struct FSpoutStreamIndexEntry
+{
+	uint64 ChunkOffset;
+	int64 TimestampUs;
+};
+
+struct FSpoutStreamFileFooter
+{
+	static constexpr uint32 MagicValue = 0x58495053; // "SPIX"
+
+	uint32 Magic;
+	uint32 NumFrames;
+	uint64 IndexOffset;
+};
+
+class FSpoutStreamWriter
+{
+public:
+
+	FSpoutStreamWriter();
+	~FSpoutStreamWriter();
+
+	bool Open(const FString& Path, bool bCompress);
+
+	/** Appends one encoded frame published at TimestampUs, relative to the first frame of the recording. */
+	bool Append(const FSpoutMemoryFrameInfo& Info, const uint8* Payload, SIZE_T PayloadSize, int64 TimestampUs);
+
+	/** Writes the index and footer. */
+	bool Close();
+
+	bool IsOpen() const { return File.IsValid(); }
+	int32 GetNumFrames() const { return Index.Num(); }
+	uint64 GetBytesWritten() const { return Offset; }
+
+private:
+
+	bool Write(const void* Data, SIZE_T Size);
+
+	TUniquePtr<IFileHandle> File;
+	TArray<FSpoutStreamIndexEntry> Index;
+	TArray<uint8> CompressedPayload;
+	uint64 Offset = 0;
+	bool bCompress = false;
+};
+
+/** Reads a recording through a memory mapping of the whole file, uncompressed payloads are never copied. */
+class FSpoutStreamReader
+{
+public:
+
+	FSpoutStreamReader();
+	~FSpoutStreamReader();
+
+	bool Open(const FString& Path);
+	void Close();
+
+	int32 GetNumFrames() const { return Index.Num(); }
+	int64 GetTimestampUs(int32 FrameIndex) const { return Index[FrameIndex].TimestampUs; }
+
+	/** OutPayload points into the mapping, or into a buffer valid until the next call for compressed frames. */
+	bool ReadFrame(int32 FrameIndex, FSpoutMemoryFrameInfo& OutInfo, const uint8*& OutPayload, SIZE_T& OutPayloadSize);
+
+private:
+
+	const FSpoutStreamChunkHeader* GetChunk(uint64 ChunkOffset) const;
+	bool ReadIndex();
+	void RebuildIndex();
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	const uint8* Data = nullptr;
+	uint64 Size = 0;
+
+	TArray<FSpoutStreamIndexEntry> Index;
+	TArray<uint8> DecompressedPayload;
+};
@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutStreamRecording.h"
+
+FSpoutStreamRecorder::FSpoutStreamRecorder(const FString& SenderName)
+	: Receiver(SenderName)
+{
+}
+
+bool FSpoutStreamRecorder::Start(const FString& Path, bool bCompress)
+{
+	StartTimeUs = -1;
+	LastFrameId = 0;
+	NumMissedFrames = 0;
+	NumGaps = 0;
+	return Writer.Open(Path, bCompress);
+}
+
+bool FSpoutStreamRecorder::Poll()
+{
+	if (!Writer.IsOpen())
+		return false;
+
+	FSpoutMemoryFrameInfo Info;
+	if (!Receiver.ReceiveEncoded(Payload, Info))
+		return false;
+
+	// a sender that restarted counts from 1 again, that is no gap
+	if (LastFrameId > 0 && Info.FrameId > LastFrameId + 1)
+	{
+		NumMissedFrames += Info.FrameId - LastFrameId - 1;
+		++NumGaps;
+	}
+
+	LastFrameId = Info.FrameId;
+
+	// timestamps count from the first recorded frame, on the sender's clock
+	if (StartTimeUs < 0)
+		StartTimeUs = Info.PublishTimeUs;
+
+	return Writer.Append(Info, Payload.GetData(), Payload.Num(), FMath::Max<int64>(Info.PublishTimeUs - StartTimeUs, 0));
+}
+
+bool FSpoutStreamRecorder::Stop()
+{
+	return Writer.Close();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+FSpoutStreamReplayer::FSpoutStreamReplayer(const FString& SenderName)
+	: Sender(SenderName)
+{
+}
+
+bool FSpoutStreamReplayer::Open(const FString& Path)
+{
+	Rewind();
+	NumPublished = 0;
+	return Reader.Open(Path) && Reader.GetNumFrames() > 0;
+}
+
+void FSpoutStreamReplayer::Rewind()
+{
+	NextFrame = 0;
+	StartTime = -1.0;
+}
+
+double FSpoutStreamReplayer::GetTimeUntilNextFrame(double Now) const
+{
+	if (StartTime < 0.0 || NextFrame >= Reader.GetNumFrames())
+		return 0.0;
+
+	const double DueTime = StartTime + (Reader.GetTimestampUs(NextFrame) - Reader.GetTimestampUs(0)) / 1000000.0;
+	return FMath::Max(DueTime - Now, 0.0);
+}
+
+bool FSpoutStreamReplayer::Tick(double Now, ESpoutReplayTiming Timing)
+{
+	if (NextFrame >= Reader.GetNumFrames())
+		return false;
+
+	if (StartTime < 0.0)
+		StartTime = Now;
+
+	if (Timing == ESpoutReplayTiming::Original && GetTimeUntilNextFrame(Now) > 0.0)
+		return true;
+
+	FSpoutMemoryFrameInfo Info;
+	const uint8* Payload = nullptr;
+	SIZE_T PayloadSize = 0;
+
+	if (Reader.ReadFrame(NextFrame, Info, Payload, PayloadSize)
+		&& Sender.PublishEncoded(Payload, PayloadSize, Info))
+		++NumPublished;
+
+	++NextFrame;
+
+	return NextFrame < Reader.GetNumFrames();
+}
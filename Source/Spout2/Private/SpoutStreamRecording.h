@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SpoutMemoryShare.h"
+#include "SpoutStreamFile.h"
+
+/**
+ * Records a sender's memory-share stream into a FSpoutStreamWriter file, with the time
+ * the sender published each frame. The share only holds the newest frame, so frames the
+ * sender published between two polls are lost; they show as gaps in the frame ids and
+ * are counted.
+ */
+class FSpoutStreamRecorder
+{
+public:
+
+	explicit FSpoutStreamRecorder(const FString& SenderName);
+
+	bool Start(const FString& Path, bool bCompress);
+
+	/** Appends the newest frame when it is new. True when a frame was recorded. */
+	bool Poll();
+
+	bool Stop();
+
+	const FSpoutStreamWriter& GetWriter() const { return Writer; }
+
+	/** Frames the sender published that were overwritten before a poll saw them. */
+	int64 GetNumMissedFrames() const { return NumMissedFrames; }
+
+	/** Polls that found frames missing, each one a hole in the recording. */
+	int32 GetNumGaps() const { return NumGaps; }
+
+private:
+
+	FSpoutMemoryReceiver Receiver;
+	FSpoutStreamWriter Writer;
+	TArray<uint8> Payload;
+	int64 StartTimeUs = -1;
+	int64 LastFrameId = 0;
+	int64 NumMissedFrames = 0;
+	int32 NumGaps = 0;
+};
+
+enum class ESpoutReplayTiming : uint8
+{
+	// Frames are published as far apart as they were recorded
+	Original,
+	// Every frame is published as soon as the previous one is
+	AsFastAsPossible,
+};
+
+/** Publishes a recording again as a synthetic memory-share sender. */
+class FSpoutStreamReplayer
+{
+public:
+
+	explicit FSpoutStreamReplayer(const FString& SenderName);
+
+	bool Open(const FString& Path);
+
+	/**
+	 * Publishes the next frame once it is due at Now, at most one per call: the share holds
+	 * only the newest frame, a second publish would overwrite the first before anyone read it.
+	 * A replay running late catches up one call at a time. False once the recording is over.
+	 */
+	bool Tick(double Now, ESpoutReplayTiming Timing);
+
+	/** Seconds until the next frame is due, 0 when it already is. */
+	double GetTimeUntilNextFrame(double Now) const;
+
+	/** Starts over from the first frame, at the next Tick. */
+	void Rewind();
+
+	int32 GetNumFrames() const { return Reader.GetNumFrames(); }
+	int32 GetNumPublished() const { return NumPublished; }
+
+private:
+
+	FSpoutStreamReader Reader;
+	FSpoutMemorySender Sender;
+	int32 NextFrame = 0;
+	int32 NumPublished = 0;
+	double StartTime = -1.0;
+};
@@ -0,0 +1,357 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutSubscription.h"
+
+#include "HAL/PlatformAtomics.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+
+namespace SpoutSubscription
+{
+	static int64 ToHeartbeat(double Seconds)
+	{
+		return (int64)(Seconds * 1000000.0);
+	}
+
+	static double FromHeartbeat(int64 Heartbeat)
+	{
+		return Heartbeat / 1000000.0;
+	}
+
+	static int64 MakeToken()
+	{
+		static volatile int32 Counter = 0;
+
+		// unique across processes as long as process ids are, positive so that its negation marks a claim
+		const uint32 Serial = (uint32)FPlatformAtomics::InterlockedIncrement(&Counter);
+		return ((int64)FPlatformProcess::GetCurrentProcessId() << 32) | Serial;
+	}
+
+	FSpoutControlBlock* OpenControlBlock(FSpoutSharedRegion& Region, const FString& SenderName, bool bCreate)
+	{
+		if (!Region.IsValid())
+		{
+			const FString RegionName = FSpoutSharedRegion::MakeName(SenderName, TEXT("SpoutControl"));
+
+			if (bCreate ? !Region.Create(RegionName, sizeof(FSpoutControlBlock)) : !Region.Open(RegionName, sizeof(FSpoutControlBlock)))
+				return nullptr;
+		}
+
+		FSpoutControlBlock* Block = Region.As<FSpoutControlBlock>();
+
+		// new mappings are zero filled, the first side to see one stamps it
+		if (FPlatformAtomics::InterlockedCompareExchange(&Block->Magic, (int32)FSpoutControlBlock::MagicValue, 0) == 0)
+			Block->Version = FSpoutControlBlock::CurrentVersion;
+
+		if ((uint32)Block->Magic != FSpoutControlBlock::MagicValue
+			|| Block->Version != FSpoutControlBlock::CurrentVersion)
+			return nullptr;
+
+		return Block;
+	}
+
+	bool IsSenderStale(const FSpoutControlBlock& Block, double Now, double Timeout)
+	{
+		const int64 Beat = FPlatformAtomics::AtomicRead(&Block.SenderHeartbeat);
+		return Beat != 0 && Beat < ToHeartbeat(Now - Timeout);
+	}
+
+	bool ShouldEvictSender(const FString& SenderName, double Now, double Timeout)
+	{
+		// opened only, the sweep must not leave a control region behind for every foreign name
+		FSpoutSharedRegion Region;
+		const FSpoutControlBlock* Block = OpenControlBlock(Region, SenderName, false);
+
+		return Block && IsSenderStale(*Block, Now, Timeout);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+FSpoutSubscription::FSpoutSubscription(const FString& SenderName, bool bAcknowledges)
+	: SenderName(SenderName)
+	, Token(SpoutSubscription::MakeToken())
+	, bAcknowledges(bAcknowledges)
+{
+}
+
+FSpoutSubscription::~FSpoutSubscription()
+{
+	Release();
+}
+
+void FSpoutSubscription::Heartbeat(double Now)
+{
+	FSpoutControlBlock* ControlBlock = SpoutSubscription::OpenControlBlock(Region, SenderName);
+	if (!ControlBlock)
+		return;
+
+	if (Block != ControlBlock)
+		FPlatformAtomics::InterlockedExchangePtr((void**)&Block, ControlBlock);
+
+	const int64 Beat = SpoutSubscription::ToHeartbeat(Now);
+
+	// the sender reclaims slots that stopped beating, a stalled receiver subscribes again
+	if (SlotIndex != INDEX_NONE && ControlBlock->Slots[SlotIndex].Token != Token)
+		SlotIndex = INDEX_NONE;
+
+	if (SlotIndex == INDEX_NONE)
+	{
+		for (int32 Index = 0; Index < FSpoutControlBlock::MaxSubscribers; ++Index)
+		{
+			FSpoutControlBlock::FSlot& Slot = ControlBlock->Slots[Index];
+
+			if (Slot.Token != 0)
+				continue;
+
+			// claim first, then fill in: the sender must never see our token next to the previous owner's heartbeat or acks
+			if (FPlatformAtomics::InterlockedCompareExchange(&Slot.Token, -Token, 0) != 0)
+				continue;
+
+			FPlatformAtomics::InterlockedExchange(&Slot.Heartbeat, Beat);
+			FPlatformAtomics::InterlockedExchange(&Slot.AckedFrameId, 0);
+			FPlatformAtomics::InterlockedExchange(&Slot.Acknowledges, bAcknowledges ? 1 : 0);
+
+			// fails only when the sender gave up on a claim that stalled longer than its timeout
+			if (FPlatformAtomics::InterlockedCompareExchange(&Slot.Token, Token, -Token) != -Token)
+				continue;
+
+			FPlatformAtomics::InterlockedIncrement(&ControlBlock->SubscriberCount);
+
+			SlotIndex = Index;
+			break;
+		}
+
+		// every slot taken, the sender keeps publishing anyway since the count is not zero
+		if (SlotIndex == INDEX_NONE)
+			return;
+	}
+
+	FPlatformAtomics::InterlockedExchange(&ControlBlock->Slots[SlotIndex].Heartbeat, Beat);
+}
+
+void FSpoutSubscription::Acknowledge(int64 FrameId)
+{
+	FSpoutControlBlock* ControlBlock = Block;
+	const int32 Index = SlotIndex;
+
+	if (!ControlBlock || Index == INDEX_NONE)
+		return;
+
+	// the slot may have been reclaimed since, its new owner's acks are not ours to write
+	FSpoutControlBlock::FSlot& Slot = ControlBlock->Slots[Index];
+	if (FPlatformAtomics::AtomicRead(&Slot.Token) == Token)
+		FPlatformAtomics::InterlockedExchange(&Slot.AckedFrameId, FrameId);
+}
+
+bool FSpoutSubscription::IsSenderStale(double Now, double Timeout) const
+{
+	const FSpoutControlBlock* ControlBlock = Block;
+	return ControlBlock && SpoutSubscription::IsSenderStale(*ControlBlock, Now, Timeout);
+}
+
+void FSpoutSubscription::Release()
+{
+	if (SlotIndex == INDEX_NONE || !Region.IsValid())
+		return;
+
+	FSpoutControlBlock* ControlBlock = Region.As<FSpoutControlBlock>();
+
+	// lost to the sender already when the exchange fails, it did the decrement then
+	if (FPlatformAtomics::InterlockedCompareExchange(&ControlBlock->Slots[SlotIndex].Token, 0, Token) == Token)
+		FPlatformAtomics::InterlockedDecrement(&ControlBlock->SubscriberCount);
+
+	SlotIndex = INDEX_NONE;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+FSpoutSubscriberMonitor::FSpoutSubscriberMonitor(const FString& SenderName)
+	: SenderName(SenderName)
+{
+}
+
+int32 FSpoutSubscriberMonitor::CountSubscribers(double Now, double Timeout)
+{
+	FSpoutControlBlock* Block = SpoutSubscription::OpenControlBlock(Region, SenderName);
+	if (!Block)
+		return INDEX_NONE;
+
+	const int64 Oldest = SpoutSubscription::ToHeartbeat(Now - Timeout);
+
+	for (int32 Index = 0; Index < FSpoutControlBlock::MaxSubscribers; ++Index)
+	{
+		FSpoutControlBlock::FSlot& Slot = Block->Slots[Index];
+
+		const int64 SlotToken = FPlatformAtomics::AtomicRead(&Slot.Token);
+		if (SlotToken >= 0)
+			ClaimTokens[Index] = 0;
+
+		if (SlotToken == 0)
+			continue;
+
+		// a claim in progress still shows the previous owner's heartbeat, it is judged by how long it has been seen
+		if (SlotToken < 0)
+		{
+			if (ClaimTokens[Index] != SlotToken)
+			{
+				ClaimTokens[Index] = SlotToken;
+				ClaimSeenTimes[Index] = Now;
+			}
+			else if (Now - ClaimSeenTimes[Index] > Timeout)
+			{
+				// not counted yet, nothing to count down
+				FPlatformAtomics::InterlockedCompareExchange(&Slot.Token, 0, SlotToken);
+			}
+
+			continue;
+		}
+
+		FPlatformMisc::MemoryBarrier();
+
+		if (FPlatformAtomics::AtomicRead(&Slot.Heartbeat) >= Oldest)
+			continue;
+
+		// the owner may beat or release at the same time, only the side whose exchange succeeds counts it down
+		if (FPlatformAtomics::InterlockedCompareExchange(&Slot.Token, 0, SlotToken) == SlotToken)
+			FPlatformAtomics::InterlockedDecrement(&Block->SubscriberCount);
+	}
+
+	return FMath::Max(0, (int32)FPlatformAtomics::AtomicRead(&Block->SubscriberCount));
+}
+
+bool FSpoutSubscriberMonitor::WaitForAcknowledgements(double WaitTimeout, double SubscriberTimeout)
+{
+	FSpoutControlBlock* Block = SpoutSubscription::OpenControlBlock(Region, SenderName);
+	if (!Block)
+		return true;
+
+	const int64 Published = FPlatformAtomics::AtomicRead(&Block->PublishedFrameId);
+	const double Deadline = FPlatformTime::Seconds() + WaitTimeout;
+
+	for (;;)
+	{
+		const double Now = FPlatformTime::Seconds();
+		const int64 Oldest = SpoutSubscription::ToHeartbeat(Now - SubscriberTimeout);
+
+		bool bPending = false;
+
+		for (int32 Index = 0; Index < FSpoutControlBlock::MaxSubscribers && !bPending; ++Index)
+		{
+			FSpoutControlBlock::FSlot& Slot = Block->Slots[Index];
+
+			const int64 SlotToken = FPlatformAtomics::AtomicRead(&Slot.Token);
+			if (SlotToken <= 0)
+				continue;
+
+			FPlatformMisc::MemoryBarrier();
+
+			// a dead receiver holds the sender back until its heartbeat expires, not longer
+			if (FPlatformAtomics::AtomicRead(&Slot.Acknowledges) == 0
+				|| FPlatformAtomics::AtomicRead(&Slot.Heartbeat) < Oldest)
+				continue;
+
+			bPending = FPlatformAtomics::AtomicRead(&Slot.AckedFrameId) < Published;
+		}
+
+		if (!bPending)
+			return true;
+
+		if (Now >= Deadline)
+			return false;
+
+		FPlatformProcess::SleepNoStats(0.0001f);
+	}
+}
+
+void FSpoutSubscriberMonitor::MarkPublished(double Now)
+{
+	FSpoutControlBlock* Block = SpoutSubscription::OpenControlBlock(Region, SenderName);
+	if (!Block)
+		return;
+
+	// the only writer, the next id is known before it is announced
+	const int64 FrameId = FPlatformAtomics::AtomicRead(&Block->PublishedFrameId) + 1;
+
+	FPlatformAtomics::InterlockedExchange(&Block->PublishTimes[FrameId % FSpoutControlBlock::PublishTimeCount], SpoutSubscription::ToHeartbeat(Now));
+	FPlatformAtomics::InterlockedExchange(&Block->PublishedFrameId, FrameId);
+}
+
+void FSpoutSubscriberMonitor::BeginWrite()
+{
+	if (FSpoutControlBlock* Block = SpoutSubscription::OpenControlBlock(Region, SenderName))
+		FPlatformAtomics::InterlockedIncrement(&Block->WritesStarted);
+}
+
+void FSpoutSubscriberMonitor::EndWrite()
+{
+	if (FSpoutControlBlock* Block = SpoutSubscription::OpenControlBlock(Region, SenderName))
+		FPlatformAtomics::InterlockedIncrement(&Block->WritesFinished);
+}
+
+int64 FSpoutSubscriberMonitor::GetNextFrameId()
+{
+	const FSpoutControlBlock* Block = SpoutSubscription::OpenControlBlock(Region, SenderName);
+	return Block ? FPlatformAtomics::AtomicRead(&Block->PublishedFrameId) + 1 : 0;
+}
+
+void FSpoutSubscriberMonitor::Beat(double Now)
+{
+	if (FSpoutControlBlock* Block = SpoutSubscription::OpenControlBlock(Region, SenderName))
+		FPlatformAtomics::InterlockedExchange(&Block->SenderHeartbeat, SpoutSubscription::ToHeartbeat(Now));
+}
+
+void FSpoutSubscriberMonitor::Retire()
+{
+	if (FSpoutControlBlock* Block = SpoutSubscription::OpenControlBlock(Region, SenderName))
+		FPlatformAtomics::InterlockedExchange(&Block->SenderHeartbeat, 0);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+FSpoutPublishedFrames::FSpoutPublishedFrames(const FString& SenderName)
+	: SenderName(SenderName)
+{
+}
+
+bool FSpoutPublishedFrames::ReadNewest(int64& OutFrameId, double& OutTime)
+{
+	FSpoutControlBlock* Block = SpoutSubscription::OpenControlBlock(Region, SenderName);
+	if (!Block)
+		return false;
+
+	for (;;)
+	{
+		const int64 FrameId = FPlatformAtomics::AtomicRead(&Block->PublishedFrameId);
+		if (FrameId <= 0)
+			return false;
+
+		FPlatformMisc::MemoryBarrier();
+		const int64 Time = FPlatformAtomics::AtomicRead(&Block->PublishTimes[FrameId % FSpoutControlBlock::PublishTimeCount]);
+		FPlatformMisc::MemoryBarrier();
+
+		// the time is only ours while the ring has not wrapped onto its entry
+		if (FPlatformAtomics::AtomicRead(&Block->PublishedFrameId) - FrameId < FSpoutControlBlock::PublishTimeCount - 1)
+		{
+			OutFrameId = FrameId;
+			OutTime = SpoutSubscription::FromHeartbeat(Time);
+			return true;
+		}
+	}
+}
+
+int64 FSpoutPublishedFrames::ReadWrites(bool& bOutInFlight)
+{
+	bOutInFlight = false;
+
+	FSpoutControlBlock* Block = SpoutSubscription::OpenControlBlock(Region, SenderName);
+	if (!Block)
+		return 0;
+
+	// started first: a write that begins and ends in between reads as in flight, never the other way round
+	const int64 Started = FPlatformAtomics::AtomicRead(&Block->WritesStarted);
+	FPlatformMisc::MemoryBarrier();
+	bOutInFlight = FPlatformAtomics::AtomicRead(&Block->WritesFinished) != Started;
+
+	return Started;
+}
@@ -0,0 +1,185 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SpoutSharedRegion.h"
+
+/**
+ * Who is watching a sender, in a control region "<Sender>_SpoutControl".
+ *
+ * Every subscribed receiver owns a slot and refreshes its heartbeat while it ticks; the
+ * subscriber count is adjusted atomically as slots are claimed and released. A receiver
+ * that dies without releasing its slot stops beating, and the sender reclaims the slot
+ * once the heartbeat is older than the timeout. Heartbeats are FPlatformTime::Seconds in
+ * microseconds, a monotonic clock shared by every process on the machine.
+ *
+ * Plugin senders count their frames in PublishedFrameId, and keep the time of the last few
+ * publishes in a ring indexed by frame id, so receivers can order frames by when the sender
+ * produced them rather than by when they happened to look. A frame is announced once the GPU
+ * finished writing it; WritesStarted and WritesFinished count the writes into the shared
+ * texture, so a receiver that waited for its own copy can tell whether one overlapped it.
+ * Acknowledging receivers write the id they consumed into their slot, and the sender only
+ * overwrites its texture once every live acknowledging slot caught up, or a timeout passed.
+ * The sender never waits without a bound and receivers never wait for the sender, so the
+ * protocol cannot deadlock, and a receiver that dies stops holding the sender back once its heartbeat expires.
+ *
+ * Plugin senders beat too, in SenderHeartbeat. A crashed sender leaves its name in Spout's
+ * sender set; once its heartbeat is stale receivers stop opening its texture and evict the
+ * name. Senders outside the plugin never beat and are never judged.
+ */
+struct FSpoutControlBlock
+{
+	static constexpr uint32 MagicValue = 0x43505053; // "SPPC"
+	static constexpr uint32 CurrentVersion = 6;
+	static constexpr int32 MaxSubscribers = 64;
+	static constexpr int32 PublishTimeCount = 8;
+
+	struct FSlot
+	{
+		// zero while the slot is free, the owner's token negated while it fills the slot in
+		volatile int64 Token;
+		volatile int64 Heartbeat;
+		volatile int64 AckedFrameId;
+		volatile int32 Acknowledges;
+		int32 Reserved;
+	};
+
+	volatile int32 Magic;
+	uint32 Version;
+	volatile int32 SubscriberCount;
+	uint32 Reserved;
+	volatile int64 PublishedFrameId;
+
+	// zero until a plugin sender beats, and again once it stopped cleanly
+	volatile int64 SenderHeartbeat;
+
+	// a write is in flight while they differ; started before it is submitted, finished after PublishedFrameId moved
+	volatile int64 WritesStarted;
+	volatile int64 WritesFinished;
+
+	// heartbeat clock, written before PublishedFrameId moves to the frame
+	volatile int64 PublishTimes[PublishTimeCount];
+
+	FSlot Slots[MaxSubscribers];
+};
+
+/** A receiver's subscription to one sender. Released when destroyed. */
+class FSpoutSubscription
+{
+public:
+
+	/** bAcknowledges: the subscriber acknowledges consumed frames, lossless senders wait for it. */
+	explicit FSpoutSubscription(const FString& SenderName, bool bAcknowledges = false);
+	~FSpoutSubscription();
+
+	FSpoutSubscription(const FSpoutSubscription&) = delete;
+	FSpoutSubscription& operator=(const FSpoutSubscription&) = delete;
+
+	/** Claims a slot on first use or after the sender expired ours, then beats. */
+	void Heartbeat(double Now);
+
+	/** Tells a lossless sender FrameId was consumed. Any thread, while the subscription lives. */
+	void Acknowledge(int64 FrameId);
+
+	/** The sender is a plugin sender whose heartbeat is older than Timeout. False before the first Heartbeat. */
+	bool IsSenderStale(double Now, double Timeout) const;
+
+	bool IsSubscribed() const { return SlotIndex != INDEX_NONE; }
+	const FString& GetSenderName() const { return SenderName; }
+
+private:
+
+	void Release();
+
+	FString SenderName;
+	FSpoutSharedRegion Region;
+
+	// published once Region is mapped, for Acknowledge on other threads
+	FSpoutControlBlock* volatile Block = nullptr;
+
+	int64 Token;
+	volatile int32 SlotIndex = INDEX_NONE;
+	bool bAcknowledges = false;
+};
+
+/** The sender's side: reclaims stale slots and counts who is left. */
+class FSpoutSubscriberMonitor
+{
+public:
+
+	explicit FSpoutSubscriberMonitor(const FString& SenderName);
+
+	/** Subscribers with a heartbeat newer than Timeout, INDEX_NONE when the control region is unusable. */
+	int32 CountSubscribers(double Now, double Timeout);
+
+	/**
+	 * Lossless mode, before overwriting the shared texture: waits until every acknowledging subscriber
+	 * with a heartbeat newer than SubscriberTimeout consumed the published frame. False when WaitTimeout
+	 * passed first; a WaitTimeout of 0 only checks. Subscribers of this process count like any other,
+	 * the caller must not hold up the thread they acknowledge from.
+	 */
+	bool WaitForAcknowledgements(double WaitTimeout, double SubscriberTimeout);
+
+	/** After the shared texture holds the next frame, Now being when it got there. */
+	void MarkPublished(double Now);
+
+	/** Before a write into the shared texture is submitted to the GPU. Any thread, once the region is mapped. */
+	void BeginWrite();
+
+	/** Once that write finished on the GPU, after its MarkPublished, or was given up on. Any thread, once the region is mapped. */
+	void EndWrite();
+
+	/** Id the next MarkPublished announces, 0 when the control region is unusable. */
+	int64 GetNextFrameId();
+
+	/** The sender's own heartbeat, while it is registered. */
+	void Beat(double Now);
+
+	/** Before the sender releases its name, receivers then no longer wait for it to come back. */
+	void Retire();
+
+	const FString& GetSenderName() const { return SenderName; }
+
+private:
+
+	FString SenderName;
+	FSpoutSharedRegion Region;
+
+	// a receiver that died while claiming a slot leaves it claimed, it is reclaimed once seen claimed for longer than the timeout
+	int64 ClaimTokens[FSpoutControlBlock::MaxSubscribers] = {};
+	double ClaimSeenTimes[FSpoutControlBlock::MaxSubscribers] = {};
+};
+
+/** Reads the frame counter a plugin sender keeps in its control block, without subscribing. Any one thread at a time. */
+class FSpoutPublishedFrames
+{
+public:
+
+	explicit FSpoutPublishedFrames(const FString& SenderName);
+
+	/** Newest published frame and the FPlatformTime::Seconds it was published at, false before the first plugin publish. */
+	bool ReadNewest(int64& OutFrameId, double& OutTime);
+
+	/** Writes the sender started into its texture so far, bOutInFlight while one has not finished. Zero for senders outside the plugin. */
+	int64 ReadWrites(bool& bOutInFlight);
+
+	const FString& GetSenderName() const { return SenderName; }
+
+private:
+
+	FString SenderName;
+	FSpoutSharedRegion Region;
+};
+
+namespace SpoutSubscription
+{
+	/** Maps and initializes the control region, whichever side comes first. Null on a foreign layout, or when !bCreate and nobody created it. */
+	FSpoutControlBlock* OpenControlBlock(FSpoutSharedRegion& Region, const FString& SenderName, bool bCreate = true);
+
+	/** SenderHeartbeat is set and older than Timeout. */
+	bool IsSenderStale(const FSpoutControlBlock& Block, double Now, double Timeout);
+
+	/** A registered name to evict: a plugin sender's whose heartbeat is stale. Names without a control region belong to senders outside the plugin and never are. */
+	bool ShouldEvictSender(const FString& SenderName, double Now, double Timeout);
+}
@@ -0,0 +1,233 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutTransferScheduler.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+#include "SpoutStats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scheduled Copies"), STAT_SpoutScheduledCopies, STATGROUP_Spout2);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred Copies"), STAT_SpoutDeferredCopies, STATGROUP_Spout2);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Planned Submit Cost (ms)"), STAT_SpoutPlannedCost, STATGROUP_Spout2);
+
+static TAutoConsoleVariable<float> CVarSpoutSubmitBudgetMs(
+	TEXT("Spout2.SubmitBudgetMs"),
+	0.f,
+	TEXT("CPU time budget in milliseconds for submitting all Spout copies of a frame, measured around recording and flushing them; GPU execution time is not included. 0 disables the budget."),
+	ECVF_Default);
+
+FSpoutTransferScheduler& FSpoutTransferScheduler::Get()
+{
+	static FSpoutTransferScheduler Instance;
+	return Instance;
+}
+
+FSpoutTransferScheduler::FStreamId FSpoutTransferScheduler::RegisterStream(uint64 FrameNumber)
+{
+	FScopeLock Lock(&Mutex);
+
+	FStreamId StreamId = NextStreamId++;
+	FStream& Stream = Streams.Add(StreamId);
+	Stream.LastQueryFrame = FrameNumber;
+	return StreamId;
+}
+
+void FSpoutTransferScheduler::UnregisterStream(FStreamId StreamId)
+{
+	FScopeLock Lock(&Mutex);
+	Streams.Remove(StreamId);
+}
+
+void FSpoutTransferScheduler::UpdateStream(FStreamId StreamId, int32 Priority, float TargetRate)
+{
+	FScopeLock Lock(&Mutex);
+
+	if (FStream* Stream = Streams.Find(StreamId))
+	{
+		Stream->Priority = Priority;
+		Stream->TargetRate = FMath::Max(TargetRate, 0.f);
+	}
+}
+
+bool FSpoutTransferScheduler::ShouldTransfer(FStreamId StreamId, uint64 FrameNumber, double Time)
+{
+	return ShouldTransfer(StreamId, FrameNumber, Time, CVarSpoutSubmitBudgetMs.GetValueOnAnyThread());
+}
+
+bool FSpoutTransferScheduler::ShouldTransfer(FStreamId StreamId, uint64 FrameNumber, double Time, double BudgetMs)
+{
+	FScopeLock Lock(&Mutex);
+
+	FStream* Stream = Streams.Find(StreamId);
+	if (!Stream)
+		return false;
+
+	Stream->LastQueryFrame = FrameNumber;
+
+	if (PlannedFrame != FrameNumber)
+		BuildPlan(FrameNumber, Time, BudgetMs);
+
+	// idle when the plan was built, it takes whatever budget is left
+	if (!Stream->bConsidered && IsDue(*Stream, Time))
+	{
+		Stream->bConsidered = true;
+
+		if (FitsBudget(*Stream, BudgetMs))
+		{
+			Stream->bPlanned = true;
+			PlannedCostMs += Stream->EstimatedCostMs;
+			++NumScheduled;
+			UpdateStats(0);
+		}
+		else
+		{
+			++Stream->StarvedFrames;
+			UpdateStats(1);
+		}
+	}
+
+	if (!Stream->bPlanned)
+		return false;
+
+	Stream->bPlanned = false;
+	Stream->PreviousDueTime = Stream->NextDueTime;
+	Stream->PreviousRunFrame = Stream->LastRunFrame;
+	Stream->LastRunFrame = FrameNumber;
+	Stream->StarvedFrames = 0;
+
+	if (Stream->TargetRate > 0.f)
+	{
+		// stay on the rate grid while on time, never burst to catch up when late
+		const double Interval = 1.0 / Stream->TargetRate;
+		Stream->NextDueTime = FMath::Max(Stream->NextDueTime + Interval, Time + Interval * 0.5);
+	}
+
+	return true;
+}
+
+void FSpoutTransferScheduler::Withdraw(FStreamId StreamId, uint64 FrameNumber)
+{
+	FScopeLock Lock(&Mutex);
+
+	FStream* Stream = Streams.Find(StreamId);
+	if (!Stream || PlannedFrame != FrameNumber || Stream->LastRunFrame != FrameNumber)
+		return;
+
+	PlannedCostMs = FMath::Max(PlannedCostMs - Stream->EstimatedCostMs, 0.0);
+	--NumScheduled;
+
+	Stream->NextDueTime = Stream->PreviousDueTime;
+	Stream->LastRunFrame = Stream->PreviousRunFrame;
+
+	UpdateStats(0);
+}
+
+void FSpoutTransferScheduler::ReportSubmitCost(FStreamId StreamId, double Milliseconds)
+{
+	FScopeLock Lock(&Mutex);
+
+	FStream* Stream = Streams.Find(StreamId);
+	if (!Stream)
+		return;
+
+	if (!Stream->bHasCostSample)
+	{
+		Stream->EstimatedCostMs = Milliseconds;
+		Stream->bHasCostSample = true;
+	}
+	else
+	{
+		Stream->EstimatedCostMs += (Milliseconds - Stream->EstimatedCostMs) * CostSmoothing;
+	}
+}
+
+double FSpoutTransferScheduler::GetEstimatedCost(FStreamId StreamId) const
+{
+	FScopeLock Lock(&Mutex);
+
+	const FStream* Stream = Streams.Find(StreamId);
+	return Stream ? Stream->EstimatedCostMs : 0.0;
+}
+
+bool FSpoutTransferScheduler::FitsBudget(const FStream& Stream, double BudgetMs) const
+{
+	// the first copy always runs, otherwise a stream costlier than the budget would never make progress
+	return BudgetMs <= 0.0
+		|| NumScheduled == 0
+		|| PlannedCostMs + Stream.EstimatedCostMs <= BudgetMs;
+}
+
+void FSpoutTransferScheduler::UpdateStats(int32 NumDeferred)
+{
+	SET_DWORD_STAT(STAT_SpoutScheduledCopies, NumScheduled);
+	INC_DWORD_STAT_BY(STAT_SpoutDeferredCopies, NumDeferred);
+	SET_FLOAT_STAT(STAT_SpoutPlannedCost, PlannedCostMs);
+}
+
+void FSpoutTransferScheduler::BuildPlan(uint64 FrameNumber, double Time, double BudgetMs)
+{
+	PlannedFrame = FrameNumber;
+	PlannedCostMs = 0.0;
+	NumScheduled = 0;
+
+	TArray<TPair<FStreamId, FStream*>> Candidates;
+	Candidates.Reserve(Streams.Num());
+
+	for (TPair<FStreamId, FStream>& It : Streams)
+	{
+		FStream& Stream = It.Value;
+		Stream.bPlanned = false;
+		Stream.bConsidered = false;
+
+		// streams that stopped asking (no sender, disabled component) must not hold budget;
+		// one that skipped a frame or two still does, and any other is admitted late when it asks
+		if (Stream.LastQueryFrame + IdleFrames < FrameNumber)
+			continue;
+
+		if (!IsDue(Stream, Time))
+			continue;
+
+		Stream.bConsidered = true;
+		Candidates.Emplace(It.Key, &Stream);
+	}
+
+	Candidates.Sort([](const TPair<FStreamId, FStream*>& A, const TPair<FStreamId, FStream*>& B)
+	{
+		const FStream& SA = *A.Value;
+		const FStream& SB = *B.Value;
+
+		const bool bStarvedA = SA.StarvedFrames >= StarvationThreshold;
+		const bool bStarvedB = SB.StarvedFrames >= StarvationThreshold;
+
+		if (bStarvedA != bStarvedB)
+			return bStarvedA;
+
+		// starved streams take turns regardless of priority
+		if (!bStarvedA && SA.Priority != SB.Priority)
+			return SA.Priority > SB.Priority;
+
+		if (SA.LastRunFrame != SB.LastRunFrame)
+			return SA.LastRunFrame < SB.LastRunFrame;
+
+		return A.Key < B.Key;
+	});
+
+	for (TPair<FStreamId, FStream*>& Candidate : Candidates)
+	{
+		FStream& Stream = *Candidate.Value;
+
+		if (FitsBudget(Stream, BudgetMs))
+		{
+			Stream.bPlanned = true;
+			PlannedCostMs += Stream.EstimatedCostMs;
+			++NumScheduled;
+		}
+		else
+		{
+			++Stream.StarvedFrames;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_SpoutDeferredCopies, 0);
+	UpdateStats(Candidates.Num() - NumScheduled);
+}
@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+/**
+ * Per-frame planner for Spout copies.
+ *
+ * Every sender and receiver registers a stream with a priority and a target rate.
+ * The first query of an engine frame builds a plan that admits due streams, highest
+ * priority first, until the estimated cost reaches the frame budget. Streams that were
+ * due but skipped become starved and are served round-robin ahead of everyone else.
+ * A stream that was idle when the plan was built is admitted on its query if the
+ * budget still has room, so the order in which streams ask does not matter.
+ *
+ * Costs are CPU submit costs: the time the copying thread spends recording and flushing
+ * a copy, as measured around it and folded back into the estimates of the next plan.
+ * They are not GPU execution times.
+ *
+ * The planner only works on frame numbers, times and costs handed to it, so it can be
+ * driven by a simulated cost model as well as by the components.
+ */
+class FSpoutTransferScheduler
+{
+public:
+
+	typedef int32 FStreamId;
+
+	/** Streams skipped this many consecutive due frames are served before priority order. */
+	static constexpr int32 StarvationThreshold = 2;
+
+	/** Streams that did not ask for more frames than this hold no budget in the plan. */
+	static constexpr uint64 IdleFrames = 4;
+
+	/** Weight of the newest sample in the running cost estimate. */
+	static constexpr double CostSmoothing = 0.2;
+
+	static FSpoutTransferScheduler& Get();
+
+	FStreamId RegisterStream(uint64 FrameNumber);
+	void UnregisterStream(FStreamId StreamId);
+
+	/** TargetRate is in transfers per second, 0 means every frame. */
+	void UpdateStream(FStreamId StreamId, int32 Priority, float TargetRate);
+
+	/**
+	 * Asks whether the stream may copy in FrameNumber. Builds the frame's plan on the
+	 * first call of a new frame. BudgetMs <= 0 disables the budget. Streams should ask
+	 * every frame they could copy in, before any gating of their own, and withdraw what
+	 * that gating turns down.
+	 */
+	bool ShouldTransfer(FStreamId StreamId, uint64 FrameNumber, double Time, double BudgetMs);
+
+	/** Same as above, with the budget taken from Spout2.SubmitBudgetMs. */
+	bool ShouldTransfer(FStreamId StreamId, uint64 FrameNumber, double Time);
+
+	/**
+	 * Hands back a copy admitted in FrameNumber that the stream's own gating turned down.
+	 * Its budget goes to streams asking later in the frame and it stays due, as if it had not run.
+	 */
+	void Withdraw(FStreamId StreamId, uint64 FrameNumber);
+
+	/** Feeds the CPU time a copy took to submit back into the stream's estimate. Thread safe. */
+	void ReportSubmitCost(FStreamId StreamId, double Milliseconds);
+
+	double GetEstimatedCost(FStreamId StreamId) const;
+	double GetPlannedCost() const { return PlannedCostMs; }
+	int32 GetNumStreams() const { return Streams.Num(); }
+
+private:
+
+	struct FStream
+	{
+		int32 Priority = 0;
+		float TargetRate = 0.f;
+
+		double EstimatedCostMs = 0.0;
+		bool bHasCostSample = false;
+
+		double NextDueTime = 0.0;
+		uint64 LastQueryFrame = 0;
+		uint64 LastRunFrame = 0;
+		int32 StarvedFrames = 0;
+
+		// restored by Withdraw
+		double PreviousDueTime = 0.0;
+		uint64 PreviousRunFrame = 0;
+
+		bool bPlanned = false;
+		bool bConsidered = false;
+	};
+
+	void BuildPlan(uint64 FrameNumber, double Time, double BudgetMs);
+	bool IsDue(const FStream& Stream, double Time) const { return Stream.TargetRate <= 0.f || Time >= Stream.NextDueTime; }
+	bool FitsBudget(const FStream& Stream, double BudgetMs) const;
+	void UpdateStats(int32 NumDeferred);
+
+	mutable FCriticalSection Mutex;
+	TMap<FStreamId, FStream> Streams;
+	FStreamId NextStreamId = 0;
+
+	uint64 PlannedFrame = MAX_uint64;
+	double PlannedCostMs = 0.0;
+	int32 NumScheduled = 0;
+};
@@ -0,0 +1,129 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutTransferWorker.h"
+
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/ScopeLock.h"
+#include "SpoutStats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dropped Transfers"), STAT_SpoutDroppedTransfers, STATGROUP_Spout2);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Queued Transfers"), STAT_SpoutQueuedTransfers, STATGROUP_Spout2);
+
+static FCriticalSection GSpoutTransferWorkerMutex;
+static TUniquePtr<FSpoutTransferWorker> GSpoutTransferWorker;
+
+FSpoutTransferWorker& FSpoutTransferWorker::Get()
+{
+	FScopeLock Lock(&GSpoutTransferWorkerMutex);
+
+	if (!GSpoutTransferWorker)
+		GSpoutTransferWorker.Reset(new FSpoutTransferWorker());
+
+	return *GSpoutTransferWorker;
+}
+
+void FSpoutTransferWorker::Shutdown()
+{
+	FScopeLock Lock(&GSpoutTransferWorkerMutex);
+	GSpoutTransferWorker.Reset();
+}
+
+FSpoutTransferWorker::FSpoutTransferWorker()
+	: Jobs(QueueCapacity)
+{
+	WorkEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("SpoutTransferWorker"), 0, TPri_AboveNormal);
+}
+
+FSpoutTransferWorker::~FSpoutTransferWorker()
+{
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	// jobs pushed after the thread saw the stop request
+	RunPendingJobs();
+
+	FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+	WorkEvent = nullptr;
+}
+
+bool FSpoutTransferWorker::Enqueue(FJob&& Job)
+{
+	if (!Jobs.Push(MoveTemp(Job)))
+	{
+		INC_DWORD_STAT(STAT_SpoutDroppedTransfers);
+		return false;
+	}
+
+	NumEnqueued.fetch_add(1, std::memory_order_release);
+	INC_DWORD_STAT(STAT_SpoutQueuedTransfers);
+
+	WorkEvent->Trigger();
+	return true;
+}
+
+void FSpoutTransferWorker::Flush()
+{
+	const uint64 Target = NumEnqueued.load(std::memory_order_acquire);
+
+	while (NumCompleted.load(std::memory_order_acquire) < Target)
+	{
+		WorkEvent->Trigger();
+		FPlatformProcess::Sleep(0.f);
+	}
+}
+
+bool FSpoutTransferWorker::WaitForFence(FRHIGPUFence* Fence, double TimeoutSeconds)
+{
+	if (!Fence)
+		return true;
+
+	const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+
+	while (!Fence->Poll())
+	{
+		if (FPlatformTime::Seconds() > Deadline)
+			return false;
+
+		FPlatformProcess::Sleep(0.0001f);
+	}
+
+	return true;
+}
+
+uint32 FSpoutTransferWorker::Run()
+{
+	while (!bStopping.load(std::memory_order_acquire))
+	{
+		WorkEvent->Wait(10);
+		RunPendingJobs();
+	}
+
+	return 0;
+}
+
+void FSpoutTransferWorker::Stop()
+{
+	bStopping.store(true, std::memory_order_release);
+	WorkEvent->Trigger();
+}
+
+void FSpoutTransferWorker::RunPendingJobs()
+{
+	FJob Job;
+
+	while (Jobs.Pop(Job))
+	{
+		Job();
+		Job = nullptr;
+
+		DEC_DWORD_STAT(STAT_SpoutQueuedTransfers);
+		NumCompleted.fetch_add(1, std::memory_order_release);
+	}
+}
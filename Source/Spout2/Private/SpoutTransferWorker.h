@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "RHIResources.h"
+#include "SpoutSpscQueue.h"
+
+/**
+ * Thread that performs sender publishing away from the render thread.
+ *
+ * The render thread copies a texture into a snapshot on the RHI queue, writes a GPU fence
+ * behind that copy and hands the rest over as a job. Jobs run in submission order; each
+ * waits for its fence before reading the snapshot from the sender's own device context, and
+ * gives the snapshot back once that device's copy completed (see TSpoutSnapshotRing). A job
+ * never sees a frame the GPU has not finished, never overtakes an earlier one, and never
+ * reads a texture the RHI writes meanwhile.
+ *
+ * Jobs are pushed from one thread at a time: the thread translating the immediate command
+ * list (the RHI thread, or the render thread when it is bypassed).
+ */
+class FSpoutTransferWorker : public FRunnable
+{
+public:
+
+	typedef TUniqueFunction<void()> FJob;
+
+	static constexpr uint32 QueueCapacity = 64;
+
+	/** How long a job waits for its fence before the frame is dropped. */
+	static constexpr double FenceTimeoutSeconds = 0.1;
+
+	static FSpoutTransferWorker& Get();
+
+	/** Stops the thread, pending jobs are run first. Called on module shutdown. */
+	static void Shutdown();
+
+	/** False when the queue is full; the caller drops that frame. */
+	bool Enqueue(FJob&& Job);
+
+	/** Blocks until every job enqueued before the call has run. */
+	void Flush();
+
+	/** Waits for a GPU fence from a job, false on timeout. */
+	static bool WaitForFence(FRHIGPUFence* Fence, double TimeoutSeconds = FenceTimeoutSeconds);
+
+	virtual ~FSpoutTransferWorker();
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+
+	FSpoutTransferWorker();
+
+	void RunPendingJobs();
+
+	TSpoutSpscQueue<FJob> Jobs;
+
+	FEvent* WorkEvent = nullptr;
+	FRunnableThread* Thread = nullptr;
+
+	std::atomic<uint64> NumEnqueued{ 0 };
+	std::atomic<uint64> NumCompleted{ 0 };
+	std::atomic<bool> bStopping{ false };
+};
@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutViewCapture.h"
+
+#include "Framework/Application/SlateApplication.h"
+#include "Rendering/SlateRenderer.h"
+#include "RenderGraphUtils.h"
+#include "RHICommandList.h"
+#include "UnrealClient.h"
+
+#if SPOUT_WITH_VIEW_CAPTURE
+#include "PostProcess/PostProcessMaterialInputs.h"
+
+static TOptional<ESpoutCaptureStage> ToCaptureStage(ISceneViewExtension::EPostProcessingPass Pass)
+{
+	switch (Pass)
+	{
+	case ISceneViewExtension::EPostProcessingPass::MotionBlur:
+		return ESpoutCaptureStage::AfterMotionBlur;
+	case ISceneViewExtension::EPostProcessingPass::Tonemap:
+		return ESpoutCaptureStage::AfterTonemap;
+	case ISceneViewExtension::EPostProcessingPass::FXAA:
+		return ESpoutCaptureStage::AfterFXAA;
+	default:
+		return {};
+	}
+}
+
+FSpoutSceneViewExtension::FSpoutSceneViewExtension(const FAutoRegister& AutoRegister, FSpoutCaptureHandoffRef InHandoff, ESpoutCaptureStage InStage, FViewport* InViewport)
+	: FSceneViewExtensionBase(AutoRegister)
+	, Handoff(InHandoff)
+	, Stage(InStage)
+	, Viewport(InViewport)
+{
+}
+
+bool FSpoutSceneViewExtension::IsActiveThisFrame_Internal(const FSceneViewExtensionContext& Context) const
+{
+	return Context.Viewport == Viewport;
+}
+
+void FSpoutSceneViewExtension::SubscribeToPostProcessingPass(EPostProcessingPass Pass, FAfterPassCallbackDelegateArray& InOutPassCallbacks, bool bIsPassEnabled)
+{
+	const TOptional<ESpoutCaptureStage> PassStage = ToCaptureStage(Pass);
+	if (!PassStage.IsSet())
+		return;
+
+	// every view is offered its passes in pipeline order, motion blur first
+	if (Pass == EPostProcessingPass::MotionBlur || !CurrentSelection.IsValid())
+	{
+		CurrentSelection = MakeShared<FSpoutStageSelection, ESPMode::ThreadSafe>();
+		CurrentSelection->Requested = Stage;
+	}
+
+	if (CurrentSelection->Offer(PassStage.GetValue(), bIsPassEnabled))
+	{
+		InOutPassCallbacks.Add(FAfterPassCallbackDelegate::CreateRaw(this, &FSpoutSceneViewExtension::CaptureAfterPass_RenderThread,
+			PassStage.GetValue(), CurrentSelection.ToSharedRef()));
+	}
+}
+
+FScreenPassTexture FSpoutSceneViewExtension::CaptureAfterPass_RenderThread(FRDGBuilder& GraphBuilder, const FSceneView& View, const FPostProcessMaterialInputs& Inputs, ESpoutCaptureStage PassStage, FSelectionRef Selection)
+{
+	const FScreenPassTexture& SceneColor = Inputs.GetInput(EPostProcessMaterialInput::SceneColor);
+
+	if (!Selection->IsSelected(PassStage) || View.bIsSceneCapture || !SceneColor.IsValid())
+		return Inputs.ReturnUntouchedSceneColorForPostProcessing(GraphBuilder);
+
+	const FIntRect ViewRect = SceneColor.ViewRect;
+
+	FSpoutCaptureHandoff::FTargetPtr Target = Handoff->Claim(View.Family->FrameNumber, ViewRect.Size(), SceneColor.Texture->Desc.Format);
+	if (!Target.IsValid() || !Target->Begin_RenderThread())
+		return Inputs.ReturnUntouchedSceneColorForPostProcessing(GraphBuilder);
+
+	FRDGTextureRef Slot = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(Target->Slot, TEXT("SpoutCaptureSlot")));
+
+	FRHICopyTextureInfo CopyInfo;
+	CopyInfo.SourcePosition = FIntVector(ViewRect.Min.X, ViewRect.Min.Y, 0);
+	CopyInfo.Size = FIntVector(ViewRect.Width(), ViewRect.Height(), 1);
+	AddCopyTexturePass(GraphBuilder, SceneColor.Texture, Slot, CopyInfo);
+	GraphBuilder.SetTextureAccessFinal(Slot, ERHIAccess::CopySrc);
+
+	AddPass(GraphBuilder, RDG_EVENT_NAME("SpoutPublish"), [Target](FRHICommandListImmediate& RHICmdList) {
+		Target->Publish_RenderThread(RHICmdList);
+	});
+
+	return Inputs.ReturnUntouchedSceneColorForPostProcessing(GraphBuilder);
+}
+
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+
+FSpoutBackBufferCapture::FSpoutBackBufferCapture(FSpoutCaptureHandoffRef InHandoff, TSharedPtr<SWindow> InWindow)
+	: Handoff(InHandoff)
+	, Window(InWindow.Get())
+{
+	if (FSlateApplication::IsInitialized() && FSlateApplication::Get().GetRenderer())
+		BackBufferReadyHandle = FSlateApplication::Get().GetRenderer()->OnBackBufferReadyToPresent().AddRaw(this, &FSpoutBackBufferCapture::OnBackBufferReady_RenderThread);
+}
+
+FSpoutBackBufferCapture::~FSpoutBackBufferCapture()
+{
+	if (BackBufferReadyHandle.IsValid() && FSlateApplication::IsInitialized() && FSlateApplication::Get().GetRenderer())
+		FSlateApplication::Get().GetRenderer()->OnBackBufferReadyToPresent().Remove(BackBufferReadyHandle);
+}
+
+void FSpoutBackBufferCapture::OnBackBufferReady_RenderThread(SWindow& InWindow, const FTexture2DRHIRef& BackBuffer)
+{
+	check(IsInRenderingThread());
+
+	if (&InWindow != Window || !BackBuffer.IsValid())
+		return;
+
+	const FIntPoint Size(BackBuffer->GetSizeX(), BackBuffer->GetSizeY());
+
+	FSpoutCaptureHandoff::FTargetPtr Target = Handoff->Claim(GFrameNumberRenderThread, Size, BackBuffer->GetFormat());
+	if (!Target.IsValid() || !Target->Begin_RenderThread())
+		return;
+
+	FRHICommandListImmediate& RHICmdList = FRHICommandListExecutor::GetImmediateCommandList();
+
+	FRHICopyTextureInfo CopyInfo;
+	CopyInfo.Size = FIntVector(Size.X, Size.Y, 1);
+
+	RHICmdList.Transition({
+		FRHITransitionInfo(BackBuffer, ERHIAccess::Unknown, ERHIAccess::CopySrc),
+		FRHITransitionInfo(Target->Slot, ERHIAccess::Unknown, ERHIAccess::CopyDest) });
+
+	RHICmdList.CopyTexture(BackBuffer, Target->Slot, CopyInfo);
+
+	RHICmdList.Transition({
+		FRHITransitionInfo(BackBuffer, ERHIAccess::CopySrc, ERHIAccess::Present),
+		FRHITransitionInfo(Target->Slot, ERHIAccess::CopyDest, ERHIAccess::CopySrc) });
+
+	Target->Publish_RenderThread(RHICmdList);
+}
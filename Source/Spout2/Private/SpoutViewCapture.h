@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RHIResources.h"
+#include "SceneViewExtension.h"
+#include "SpoutCaptureHandoff.h"
+
+// post-processing subscriptions with FPostProcessMaterialInputs in a public header
+#define SPOUT_WITH_VIEW_CAPTURE (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1)
+
+class FRHICommandListImmediate;
+class FViewport;
+class SWindow;
+
+/**
+ * What a sender hands the renderer: the slot to write a frame into and how to publish it once written.
+ * On D3D11 the slot is the shared texture when the RHI created it shareable, the capture is the only
+ * copy; on D3D12 the sender's device copies the slot into its shared texture once the GPU wrote it.
+ */
+struct FSpoutCaptureTarget
+{
+	FTexture2DRHIRef Slot;
+
+	// false while the slot is still read from the last frame, the view is not captured then
+	TFunction<bool()> Begin_RenderThread;
+
+	// the slot is left in copy source state
+	TFunction<void(FRHICommandListImmediate&)> Publish_RenderThread;
+};
+
+typedef TSpoutCaptureHandoff<FSpoutCaptureTarget> FSpoutCaptureHandoff;
+typedef TSharedRef<FSpoutCaptureHandoff, ESPMode::ThreadSafe> FSpoutCaptureHandoffRef;
+
+#if SPOUT_WITH_VIEW_CAPTURE
+
+/**
+ * Copies one view of a viewport into the sender's slot right after a post-processing
+ * pass, inside the frame's render graph, then publishes it on the render thread.
+ */
+class FSpoutSceneViewExtension : public FSceneViewExtensionBase
+{
+public:
+
+	FSpoutSceneViewExtension(const FAutoRegister& AutoRegister, FSpoutCaptureHandoffRef InHandoff, ESpoutCaptureStage InStage, FViewport* InViewport);
+
+	// ISceneViewExtension
+	virtual void SetupViewFamily(FSceneViewFamily& InViewFamily) override {}
+	virtual void SetupView(FSceneViewFamily& InViewFamily, FSceneView& InView) override {}
+	virtual void BeginRenderViewFamily(FSceneViewFamily& InViewFamily) override {}
+	virtual void SubscribeToPostProcessingPass(EPostProcessingPass Pass, FAfterPassCallbackDelegateArray& InOutPassCallbacks, bool bIsPassEnabled) override;
+
+protected:
+
+	virtual bool IsActiveThisFrame_Internal(const FSceneViewExtensionContext& Context) const override;
+
+private:
+
+	typedef TSharedRef<FSpoutStageSelection, ESPMode::ThreadSafe> FSelectionRef;
+
+	FScreenPassTexture CaptureAfterPass_RenderThread(FRDGBuilder& GraphBuilder, const FSceneView& View, const FPostProcessMaterialInputs& Inputs, ESpoutCaptureStage Stage, FSelectionRef Selection);
+
+	FSpoutCaptureHandoffRef Handoff;
+	ESpoutCaptureStage Stage;
+	FViewport* Viewport;
+
+	// selection of the view whose passes are being subscribed, render thread
+	TSharedPtr<FSpoutStageSelection, ESPMode::ThreadSafe> CurrentSelection;
+};
+
+#endif
+
+/** Copies a window's back buffer into the sender's slot just before Slate presents it. */
+class FSpoutBackBufferCapture
+{
+public:
+
+	FSpoutBackBufferCapture(FSpoutCaptureHandoffRef InHandoff, TSharedPtr<SWindow> InWindow);
+	~FSpoutBackBufferCapture();
+
+	FSpoutBackBufferCapture(const FSpoutBackBufferCapture&) = delete;
+	FSpoutBackBufferCapture& operator=(const FSpoutBackBufferCapture&) = delete;
+
+private:
+
+	void OnBackBufferReady_RenderThread(SWindow& InWindow, const FTexture2DRHIRef& BackBuffer);
+
+	FSpoutCaptureHandoffRef Handoff;
+
+	// only compared against, the window may be gone by the time the capture is released
+	const SWindow* Window;
+
+	FDelegateHandle BackBufferReadyHandle;
+};
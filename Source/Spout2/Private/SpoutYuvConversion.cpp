@@ -0,0 +1,476 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpoutYuvConversion.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && !PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+#define SPOUT_YUV_SSE 1
+#include <emmintrin.h>
+#else
+#define SPOUT_YUV_SSE 0
+#endif
+
+namespace SpoutYuvConversion
+{
+	struct FCoefficients
+	{
+		// encode, 16.16 fixed point on 8-bit RGB
+		int32 YR, YG, YB;
+		int32 UR, UG, UB;
+		int32 VR, VG, VB;
+
+		// decode, 16.16 fixed point on offset-removed Y/Cb/Cr
+		int32 Y;
+		int32 RV;
+		int32 GU, GV;
+		int32 BU;
+	};
+
+	static FCoefficients MakeCoefficients(double Kr, double Kb)
+	{
+		const double Kg = 1.0 - Kr - Kb;
+		const double YScale = 219.0 / 255.0;
+		const double CScale = 224.0 / 255.0;
+		const double One = 65536.0;
+
+		FCoefficients C;
+		C.YR = FMath::RoundToInt(Kr * YScale * One);
+		C.YG = FMath::RoundToInt(Kg * YScale * One);
+		C.YB = FMath::RoundToInt(Kb * YScale * One);
+
+		C.UR = FMath::RoundToInt(-Kr / (2.0 * (1.0 - Kb)) * CScale * One);
+		C.UG = FMath::RoundToInt(-Kg / (2.0 * (1.0 - Kb)) * CScale * One);
+		C.UB = FMath::RoundToInt(0.5 * CScale * One);
+
+		C.VR = FMath::RoundToInt(0.5 * CScale * One);
+		C.VG = FMath::RoundToInt(-Kg / (2.0 * (1.0 - Kr)) * CScale * One);
+		C.VB = FMath::RoundToInt(-Kb / (2.0 * (1.0 - Kr)) * CScale * One);
+
+		C.Y = FMath::RoundToInt(One / YScale);
+		C.RV = FMath::RoundToInt(2.0 * (1.0 - Kr) / CScale * One);
+		C.GU = FMath::RoundToInt(2.0 * Kb * (1.0 - Kb) / Kg / CScale * One);
+		C.GV = FMath::RoundToInt(2.0 * Kr * (1.0 - Kr) / Kg / CScale * One);
+		C.BU = FMath::RoundToInt(2.0 * (1.0 - Kb) / CScale * One);
+		return C;
+	}
+
+	static const FCoefficients& GetCoefficients(ESpoutYuvMatrix Matrix)
+	{
+		static const FCoefficients BT709 = MakeCoefficients(0.2126, 0.0722);
+		static const FCoefficients BT2020 = MakeCoefficients(0.2627, 0.0593);
+		return Matrix == ESpoutYuvMatrix::BT2020 ? BT2020 : BT709;
+	}
+
+	static FORCEINLINE uint8 ClampByte(int32 Value)
+	{
+		return (uint8)FMath::Clamp(Value, 0, 255);
+	}
+
+	static FORCEINLINE uint8 EncodeY(const FCoefficients& C, int32 R, int32 G, int32 B)
+	{
+		return ClampByte(16 + ((C.YR * R + C.YG * G + C.YB * B + 32768) >> 16));
+	}
+
+	static FORCEINLINE uint8 EncodeU(const FCoefficients& C, int32 R, int32 G, int32 B)
+	{
+		return ClampByte(128 + ((C.UR * R + C.UG * G + C.UB * B + 32768) >> 16));
+	}
+
+	static FORCEINLINE uint8 EncodeV(const FCoefficients& C, int32 R, int32 G, int32 B)
+	{
+		return ClampByte(128 + ((C.VR * R + C.VG * G + C.VB * B + 32768) >> 16));
+	}
+
+	static FORCEINLINE FColor DecodePixel(const FCoefficients& C, int32 Y, int32 U, int32 V)
+	{
+		const int32 L = (Y - 16) * C.Y;
+		U -= 128;
+		V -= 128;
+
+		return FColor(
+			ClampByte((L + C.RV * V + 32768) >> 16),
+			ClampByte((L - C.GU * U - C.GV * V + 32768) >> 16),
+			ClampByte((L + C.BU * U + 32768) >> 16),
+			255);
+	}
+
+#if SPOUT_YUV_SSE
+	/*
+	 * Four texels at a time in float lanes, with the same results as the fixed point kernels above:
+	 * every product and partial sum is an integer below 2^24, which float holds exactly, and the
+	 * >> 16 is a multiply by 2^-16 and a floor. Decode coefficients are split into whole units and
+	 * a 16 bit remainder to stay in that range.
+	 */
+
+	static FORCEINLINE __m128i FloorLanes(__m128 Value)
+	{
+		// truncation rounds negative values up, step those back
+		const __m128i Truncated = _mm_cvttps_epi32(Value);
+		return _mm_add_epi32(Truncated, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(Truncated), Value)));
+	}
+
+	// low four bytes hold the lanes clamped to 0..255
+	static FORCEINLINE __m128i PackLanes(__m128i Lanes)
+	{
+		const __m128i Words = _mm_packs_epi32(Lanes, Lanes);
+		return _mm_packus_epi16(Words, Words);
+	}
+
+	static FORCEINLINE void LoadTexels(const FColor* Src, __m128& OutR, __m128& OutG, __m128& OutB)
+	{
+		const __m128i Texels = _mm_loadu_si128((const __m128i*)Src);
+		const __m128i Mask = _mm_set1_epi32(0xff);
+
+		OutB = _mm_cvtepi32_ps(_mm_and_si128(Texels, Mask));
+		OutG = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(Texels, 8), Mask));
+		OutR = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(Texels, 16), Mask));
+	}
+
+	static FORCEINLINE void StoreTexels(__m128i B, __m128i G, __m128i R, FColor* Dst)
+	{
+		// B0..3 G0..3 R0..3 A0..3, then interleaved to BGRA per texel
+		const __m128i Bytes = _mm_packus_epi16(_mm_packs_epi32(B, G), _mm_packs_epi32(R, _mm_set1_epi32(255)));
+		const __m128i BG = _mm_unpacklo_epi8(Bytes, _mm_srli_si128(Bytes, 4));
+		const __m128i RA = _mm_unpacklo_epi8(_mm_srli_si128(Bytes, 8), _mm_srli_si128(Bytes, 12));
+
+		_mm_storeu_si128((__m128i*)Dst, _mm_unpacklo_epi16(BG, RA));
+	}
+
+	static FORCEINLINE __m128 LoadBytes(const uint8* Src)
+	{
+		int32 Packed;
+		FMemory::Memcpy(&Packed, Src, sizeof(Packed));
+
+		const __m128i Zero = _mm_setzero_si128();
+		return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(Packed), Zero), Zero));
+	}
+
+	// sums of pairs of neighbours across two registers of four lanes, floored after adding Bias and scaling
+	static FORCEINLINE __m128 AveragePairs(__m128 A, __m128 B, __m128 Bias, __m128 Scale)
+	{
+		const __m128 Sum = _mm_add_ps(_mm_shuffle_ps(A, B, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(A, B, _MM_SHUFFLE(3, 1, 3, 1)));
+		return _mm_cvtepi32_ps(FloorLanes(_mm_mul_ps(_mm_add_ps(Sum, Bias), Scale)));
+	}
+
+	struct FEncodeLanes
+	{
+		__m128 R, G, B;
+		__m128 Bias;
+
+		FEncodeLanes(int32 CR, int32 CG, int32 CB, int32 Offset)
+			: R(_mm_set1_ps((float)CR))
+			, G(_mm_set1_ps((float)CG))
+			, B(_mm_set1_ps((float)CB))
+			, Bias(_mm_set1_ps(Offset * 65536.f + 32768.f))
+		{
+		}
+
+		FORCEINLINE __m128i Encode(__m128 InR, __m128 InG, __m128 InB) const
+		{
+			const __m128 Sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(Bias, _mm_mul_ps(InR, R)), _mm_mul_ps(InG, G)), _mm_mul_ps(InB, B));
+			return FloorLanes(_mm_mul_ps(Sum, _mm_set1_ps(1.f / 65536.f)));
+		}
+	};
+
+	struct FDecodeLanes
+	{
+		// whole units and remainders of Y, RV, -GU, -GV and BU
+		__m128 YWhole, YRest;
+		__m128 RVWhole, RVRest;
+		__m128 GUWhole, GURest;
+		__m128 GVWhole, GVRest;
+		__m128 BUWhole, BURest;
+
+		explicit FDecodeLanes(const FCoefficients& C)
+		{
+			Split(C.Y, YWhole, YRest);
+			Split(C.RV, RVWhole, RVRest);
+			Split(-C.GU, GUWhole, GURest);
+			Split(-C.GV, GVWhole, GVRest);
+			Split(C.BU, BUWhole, BURest);
+		}
+
+		static void Split(int32 Coefficient, __m128& OutWhole, __m128& OutRest)
+		{
+			const int32 Rest = Coefficient & 0xffff;
+			OutWhole = _mm_set1_ps((float)((Coefficient - Rest) / 65536));
+			OutRest = _mm_set1_ps((float)Rest);
+		}
+
+		static FORCEINLINE __m128i Channel(__m128 Whole, __m128 Rest)
+		{
+			return _mm_add_epi32(_mm_cvttps_epi32(Whole), FloorLanes(_mm_mul_ps(Rest, _mm_set1_ps(1.f / 65536.f))));
+		}
+
+		FORCEINLINE void Decode(__m128 Y, __m128 U, __m128 V, FColor* Dst) const
+		{
+			Y = _mm_sub_ps(Y, _mm_set1_ps(16.f));
+			U = _mm_sub_ps(U, _mm_set1_ps(128.f));
+			V = _mm_sub_ps(V, _mm_set1_ps(128.f));
+
+			const __m128 LWhole = _mm_mul_ps(Y, YWhole);
+			const __m128 LRest = _mm_add_ps(_mm_mul_ps(Y, YRest), _mm_set1_ps(32768.f));
+
+			const __m128i R = Channel(
+				_mm_add_ps(LWhole, _mm_mul_ps(V, RVWhole)),
+				_mm_add_ps(LRest, _mm_mul_ps(V, RVRest)));
+			const __m128i G = Channel(
+				_mm_add_ps(_mm_add_ps(LWhole, _mm_mul_ps(U, GUWhole)), _mm_mul_ps(V, GVWhole)),
+				_mm_add_ps(_mm_add_ps(LRest, _mm_mul_ps(U, GURest)), _mm_mul_ps(V, GVRest)));
+			const __m128i B = Channel(
+				_mm_add_ps(LWhole, _mm_mul_ps(U, BUWhole)),
+				_mm_add_ps(LRest, _mm_mul_ps(U, BURest)));
+
+			StoreTexels(B, G, R, Dst);
+		}
+	};
+#endif
+
+	SIZE_T GetFrameSize(ESpoutMemoryShareFormat Format, int32 Width, int32 Height)
+	{
+		const SIZE_T ChromaWidth = (Width + 1) / 2;
+		const SIZE_T ChromaHeight = (Height + 1) / 2;
+
+		switch (Format)
+		{
+		case ESpoutMemoryShareFormat::BGRA:
+			return (SIZE_T)Width * Height * 4;
+		case ESpoutMemoryShareFormat::NV12:
+			return (SIZE_T)Width * Height + ChromaWidth * ChromaHeight * 2;
+		case ESpoutMemoryShareFormat::YUY2:
+			return ChromaWidth * 4 * Height;
+		default:
+			return 0;
+		}
+	}
+
+	void BGRAToNV12(const FColor* Src, int32 Width, int32 Height, uint8* Dst, ESpoutYuvMatrix Matrix)
+	{
+		const FCoefficients& C = GetCoefficients(Matrix);
+		const int32 ChromaWidth = (Width + 1) / 2;
+		const int32 ChromaHeight = (Height + 1) / 2;
+
+		uint8* LumaPlane = Dst;
+		uint8* ChromaPlane = Dst + (SIZE_T)Width * Height;
+
+#if SPOUT_YUV_SSE
+		const FEncodeLanes YLanes(C.YR, C.YG, C.YB, 16);
+		const FEncodeLanes ULanes(C.UR, C.UG, C.UB, 128);
+		const FEncodeLanes VLanes(C.VR, C.VG, C.VB, 128);
+		const __m128 Two = _mm_set1_ps(2.f);
+		const __m128 Quarter = _mm_set1_ps(0.25f);
+#endif
+
+		for (int32 y = 0; y < Height; ++y)
+		{
+			const FColor* SrcLine = Src + (SIZE_T)y * Width;
+			uint8* DstLine = LumaPlane + (SIZE_T)y * Width;
+
+			int32 x = 0;
+#if SPOUT_YUV_SSE
+			for (; x + 4 <= Width; x += 4)
+			{
+				__m128 R, G, B;
+				LoadTexels(SrcLine + x, R, G, B);
+
+				const int32 Bytes = _mm_cvtsi128_si32(PackLanes(YLanes.Encode(R, G, B)));
+				FMemory::Memcpy(DstLine + x, &Bytes, sizeof(Bytes));
+			}
+#endif
+			for (; x < Width; ++x)
+				DstLine[x] = EncodeY(C, SrcLine[x].R, SrcLine[x].G, SrcLine[x].B);
+		}
+
+		for (int32 cy = 0; cy < ChromaHeight; ++cy)
+		{
+			const FColor* Line0 = Src + (SIZE_T)(cy * 2) * Width;
+			const FColor* Line1 = Src + (SIZE_T)FMath::Min(cy * 2 + 1, Height - 1) * Width;
+			uint8* DstLine = ChromaPlane + (SIZE_T)cy * ChromaWidth * 2;
+
+			int32 cx = 0;
+#if SPOUT_YUV_SSE
+			// four blocks of eight texels, none past the last column
+			for (; cx * 2 + 8 <= Width; cx += 4)
+			{
+				__m128 R00, G00, B00, R01, G01, B01, R10, G10, B10, R11, G11, B11;
+				LoadTexels(Line0 + cx * 2, R00, G00, B00);
+				LoadTexels(Line0 + cx * 2 + 4, R01, G01, B01);
+				LoadTexels(Line1 + cx * 2, R10, G10, B10);
+				LoadTexels(Line1 + cx * 2 + 4, R11, G11, B11);
+
+				const __m128 R = AveragePairs(_mm_add_ps(R00, R10), _mm_add_ps(R01, R11), Two, Quarter);
+				const __m128 G = AveragePairs(_mm_add_ps(G00, G10), _mm_add_ps(G01, G11), Two, Quarter);
+				const __m128 B = AveragePairs(_mm_add_ps(B00, B10), _mm_add_ps(B01, B11), Two, Quarter);
+
+				_mm_storel_epi64((__m128i*)(DstLine + cx * 2), _mm_unpacklo_epi8(PackLanes(ULanes.Encode(R, G, B)), PackLanes(VLanes.Encode(R, G, B))));
+			}
+#endif
+			for (; cx < ChromaWidth; ++cx)
+			{
+				const int32 x0 = cx * 2;
+				const int32 x1 = FMath::Min(x0 + 1, Width - 1);
+
+				const int32 R = (Line0[x0].R + Line0[x1].R + Line1[x0].R + Line1[x1].R + 2) >> 2;
+				const int32 G = (Line0[x0].G + Line0[x1].G + Line1[x0].G + Line1[x1].G + 2) >> 2;
+				const int32 B = (Line0[x0].B + Line0[x1].B + Line1[x0].B + Line1[x1].B + 2) >> 2;
+
+				DstLine[cx * 2 + 0] = EncodeU(C, R, G, B);
+				DstLine[cx * 2 + 1] = EncodeV(C, R, G, B);
+			}
+		}
+	}
+
+	void NV12ToBGRA(const uint8* Src, int32 Width, int32 Height, FColor* Dst, ESpoutYuvMatrix Matrix)
+	{
+		const FCoefficients& C = GetCoefficients(Matrix);
+		const int32 ChromaWidth = (Width + 1) / 2;
+
+		const uint8* LumaPlane = Src;
+		const uint8* ChromaPlane = Src + (SIZE_T)Width * Height;
+
+#if SPOUT_YUV_SSE
+		const FDecodeLanes Lanes(C);
+#endif
+
+		for (int32 y = 0; y < Height; ++y)
+		{
+			const uint8* LumaLine = LumaPlane + (SIZE_T)y * Width;
+			const uint8* ChromaLine = ChromaPlane + (SIZE_T)(y / 2) * ChromaWidth * 2;
+			FColor* DstLine = Dst + (SIZE_T)y * Width;
+
+			int32 x = 0;
+#if SPOUT_YUV_SSE
+			for (; x + 4 <= Width; x += 4)
+			{
+				// U0 V0 U1 V1 for two pairs of texels
+				const __m128 UV = LoadBytes(ChromaLine + x);
+				Lanes.Decode(LoadBytes(LumaLine + x), _mm_shuffle_ps(UV, UV, _MM_SHUFFLE(2, 2, 0, 0)), _mm_shuffle_ps(UV, UV, _MM_SHUFFLE(3, 3, 1, 1)), DstLine + x);
+			}
+#endif
+			for (; x < Width; ++x)
+				DstLine[x] = DecodePixel(C, LumaLine[x], ChromaLine[(x / 2) * 2 + 0], ChromaLine[(x / 2) * 2 + 1]);
+		}
+	}
+
+	void BGRAToYUY2(const FColor* Src, int32 Width, int32 Height, uint8* Dst, ESpoutYuvMatrix Matrix)
+	{
+		const FCoefficients& C = GetCoefficients(Matrix);
+		const int32 ChromaWidth = (Width + 1) / 2;
+
+#if SPOUT_YUV_SSE
+		const FEncodeLanes YLanes(C.YR, C.YG, C.YB, 16);
+		const FEncodeLanes ULanes(C.UR, C.UG, C.UB, 128);
+		const FEncodeLanes VLanes(C.VR, C.VG, C.VB, 128);
+		const __m128 One = _mm_set1_ps(1.f);
+		const __m128 Half = _mm_set1_ps(0.5f);
+#endif
+
+		for (int32 y = 0; y < Height; ++y)
+		{
+			const FColor* SrcLine = Src + (SIZE_T)y * Width;
+			uint8* DstLine = Dst + (SIZE_T)y * ChromaWidth * 4;
+
+			int32 cx = 0;
+#if SPOUT_YUV_SSE
+			for (; cx * 2 + 8 <= Width; cx += 4)
+			{
+				__m128 R0, G0, B0, R1, G1, B1;
+				LoadTexels(SrcLine + cx * 2, R0, G0, B0);
+				LoadTexels(SrcLine + cx * 2 + 4, R1, G1, B1);
+
+				const __m128 R = AveragePairs(R0, R1, One, Half);
+				const __m128 G = AveragePairs(G0, G1, One, Half);
+				const __m128 B = AveragePairs(B0, B1, One, Half);
+
+				// Y0 U0 Y1 V0 ... for four pairs
+				const __m128i Words = _mm_packs_epi32(YLanes.Encode(R0, G0, B0), YLanes.Encode(R1, G1, B1));
+				const __m128i Luma = _mm_packus_epi16(Words, Words);
+				const __m128i Chroma = _mm_unpacklo_epi8(PackLanes(ULanes.Encode(R, G, B)), PackLanes(VLanes.Encode(R, G, B)));
+
+				_mm_storeu_si128((__m128i*)(DstLine + cx * 4), _mm_unpacklo_epi8(Luma, Chroma));
+			}
+#endif
+			for (; cx < ChromaWidth; ++cx)
+			{
+				const FColor& P0 = SrcLine[cx * 2];
+				const FColor& P1 = SrcLine[FMath::Min(cx * 2 + 1, Width - 1)];
+
+				const int32 R = (P0.R + P1.R + 1) >> 1;
+				const int32 G = (P0.G + P1.G + 1) >> 1;
+				const int32 B = (P0.B + P1.B + 1) >> 1;
+
+				DstLine[cx * 4 + 0] = EncodeY(C, P0.R, P0.G, P0.B);
+				DstLine[cx * 4 + 1] = EncodeU(C, R, G, B);
+				DstLine[cx * 4 + 2] = EncodeY(C, P1.R, P1.G, P1.B);
+				DstLine[cx * 4 + 3] = EncodeV(C, R, G, B);
+			}
+		}
+	}
+
+	void YUY2ToBGRA(const uint8* Src, int32 Width, int32 Height, FColor* Dst, ESpoutYuvMatrix Matrix)
+	{
+		const FCoefficients& C = GetCoefficients(Matrix);
+		const int32 ChromaWidth = (Width + 1) / 2;
+
+#if SPOUT_YUV_SSE
+		const FDecodeLanes Lanes(C);
+#endif
+
+		for (int32 y = 0; y < Height; ++y)
+		{
+			const uint8* SrcLine = Src + (SIZE_T)y * ChromaWidth * 4;
+			FColor* DstLine = Dst + (SIZE_T)y * Width;
+
+			int32 x = 0;
+#if SPOUT_YUV_SSE
+			for (; x + 4 <= Width; x += 4)
+			{
+				// Y0 U0 Y1 V0 and Y2 U1 Y3 V1
+				const __m128 A = LoadBytes(SrcLine + x * 2);
+				const __m128 B = LoadBytes(SrcLine + x * 2 + 4);
+				Lanes.Decode(_mm_shuffle_ps(A, B, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(A, B, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(A, B, _MM_SHUFFLE(3, 3, 3, 3)), DstLine + x);
+			}
+#endif
+			for (; x < Width; ++x)
+			{
+				const uint8* Pair = SrcLine + (x / 2) * 4;
+				DstLine[x] = DecodePixel(C, Pair[(x & 1) * 2], Pair[1], Pair[3]);
+			}
+		}
+	}
+
+	void Encode(ESpoutMemoryShareFormat Format, const FColor* Src, int32 Width, int32 Height, uint8* Dst, ESpoutYuvMatrix Matrix)
+	{
+		switch (Format)
+		{
+		case ESpoutMemoryShareFormat::BGRA:
+			FMemory::Memcpy(Dst, Src, GetFrameSize(Format, Width, Height));
+			break;
+		case ESpoutMemoryShareFormat::NV12:
+			BGRAToNV12(Src, Width, Height, Dst, Matrix);
+			break;
+		case ESpoutMemoryShareFormat::YUY2:
+			BGRAToYUY2(Src, Width, Height, Dst, Matrix);
+			break;
+		default:
+			break;
+		}
+	}
+
+	void Decode(ESpoutMemoryShareFormat Format, const uint8* Src, int32 Width, int32 Height, FColor* Dst, ESpoutYuvMatrix Matrix)
+	{
+		switch (Format)
+		{
+		case ESpoutMemoryShareFormat::BGRA:
+			FMemory::Memcpy(Dst, Src, GetFrameSize(Format, Width, Height));
+			break;
+		case ESpoutMemoryShareFormat::NV12:
+			NV12ToBGRA(Src, Width, Height, Dst, Matrix);
+			break;
+		case ESpoutMemoryShareFormat::YUY2:
+			YUY2ToBGRA(Src, Width, Height, Dst, Matrix);
+			break;
+		default:
+			break;
+		}
+	}
+}
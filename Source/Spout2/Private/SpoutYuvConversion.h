@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SpoutTypes.h"
+
+/**
+ * BGRA <-> YUV conversion for memory-share streams, limited (video) range.
+ *
+ * The kernels run in 16.16 fixed point; with SSE, four texels at a time in float lanes
+ * that give the same bytes, the scalar loops finish each row. Chroma is taken from the
+ * average of each 2x2 (NV12) or 2x1 (YUY2) block. Odd sizes replicate the last column/row.
+ */
+namespace SpoutYuvConversion
+{
+	/** Payload size in bytes of one frame. */
+	SIZE_T GetFrameSize(ESpoutMemoryShareFormat Format, int32 Width, int32 Height);
+
+	void BGRAToNV12(const FColor* Src, int32 Width, int32 Height, uint8* Dst, ESpoutYuvMatrix Matrix);
+	void NV12ToBGRA(const uint8* Src, int32 Width, int32 Height, FColor* Dst, ESpoutYuvMatrix Matrix);
+
+	void BGRAToYUY2(const FColor* Src, int32 Width, int32 Height, uint8* Dst, ESpoutYuvMatrix Matrix);
+	void YUY2ToBGRA(const uint8* Src, int32 Width, int32 Height, FColor* Dst, ESpoutYuvMatrix Matrix);
+
+	/** Dispatches on Format. BGRA is a plain copy. */
+	void Encode(ESpoutMemoryShareFormat Format, const FColor* Src, int32 Width, int32 Height, uint8* Dst, ESpoutYuvMatrix Matrix);
+	void Decode(ESpoutMemoryShareFormat Format, const uint8* Src, int32 Width, int32 Height, FColor* Dst, ESpoutYuvMatrix Matrix);
+}
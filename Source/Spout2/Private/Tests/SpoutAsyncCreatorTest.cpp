@@ -0,0 +1,191 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/AutomationTest.h"
+#include "SpoutAsyncCreator.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutAsyncCreatorTest
+{
+	struct FMockResource
+	{
+		int32 Key;
+		// which build made it, counting from 1
+		int32 Build;
+	};
+
+	/** A factory whose builds block until released, failing for negative keys. */
+	struct FMockFactory
+	{
+		FThreadSafeBool bReleased = false;
+		FThreadSafeCounter Builds;
+
+		static TSpoutAsyncCreator<int32, FMockResource>::FFactory Make(TSharedRef<FMockFactory, ESPMode::ThreadSafe> Factory)
+		{
+			return [Factory](const int32& Key) -> TSharedPtr<FMockResource, ESPMode::ThreadSafe> {
+				const int32 Build = Factory->Builds.Increment();
+
+				while (!Factory->bReleased)
+					FPlatformProcess::Sleep(0.001f);
+
+				if (Key < 0)
+					return nullptr;
+
+				return MakeShared<FMockResource, ESPMode::ThreadSafe>(FMockResource{ Key, Build });
+			};
+		}
+	};
+
+	/** Polls until Predicate holds, false after a few seconds. */
+	template<typename PredicateType>
+	static bool PollUntil(PredicateType&& Predicate)
+	{
+		const double Deadline = FPlatformTime::Seconds() + 5.0;
+
+		while (!Predicate())
+		{
+			if (FPlatformTime::Seconds() > Deadline)
+				return false;
+
+			FPlatformProcess::Sleep(0.001f);
+		}
+
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutAsyncCreatorBuildTest, "Spout2.AsyncCreator.Build", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutAsyncCreatorBuildTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutAsyncCreatorTest;
+
+	TSharedRef<FMockFactory, ESPMode::ThreadSafe> Factory = MakeShared<FMockFactory, ESPMode::ThreadSafe>();
+	TSpoutAsyncCreator<int32, FMockResource> Creator(FMockFactory::Make(Factory));
+
+	TestFalse(TEXT("Nothing while the build runs"), Creator.Update(1, 0.0).IsValid());
+	TestTrue(TEXT("Pending"), Creator.GetState() == ESpoutCreationState::Pending);
+	TestFalse(TEXT("Still nothing"), Creator.Update(1, 0.1).IsValid());
+
+	Factory->bReleased = true;
+
+	TSharedPtr<FMockResource, ESPMode::ThreadSafe> Resource;
+	TestTrue(TEXT("Build finishes"), PollUntil([&]() { Resource = Creator.Update(1, 0.2); return Resource.IsValid(); }));
+
+	if (Resource.IsValid())
+		TestEqual(TEXT("Built for the key"), Resource->Key, 1);
+
+	TestTrue(TEXT("Ready"), Creator.GetState() == ESpoutCreationState::Ready);
+	TestTrue(TEXT("Same resource on later updates"), Creator.Update(1, 0.3) == Resource);
+	TestEqual(TEXT("Built once"), Factory->Builds.GetValue(), 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutAsyncCreatorKeyChangeTest, "Spout2.AsyncCreator.KeyChangeDuringBuild", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutAsyncCreatorKeyChangeTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutAsyncCreatorTest;
+
+	TSharedRef<FMockFactory, ESPMode::ThreadSafe> Factory = MakeShared<FMockFactory, ESPMode::ThreadSafe>();
+	TSpoutAsyncCreator<int32, FMockResource> Creator(FMockFactory::Make(Factory));
+
+	Creator.Update(1, 0.0);
+	TestTrue(TEXT("First build started"), PollUntil([&]() { return Factory->Builds.GetValue() == 1; }));
+
+	// the owner wants another key while the first build is in flight
+	TestFalse(TEXT("Nothing for the new key"), Creator.Update(2, 0.1).IsValid());
+	TestTrue(TEXT("Waits for the outdated build rather than starting another"), Creator.GetState() == ESpoutCreationState::Idle);
+
+	Factory->bReleased = true;
+
+	bool bHandedOutStale = false;
+	TSharedPtr<FMockResource, ESPMode::ThreadSafe> Resource;
+	TestTrue(TEXT("The new key is built"), PollUntil([&]() {
+		Resource = Creator.Update(2, 0.2);
+		bHandedOutStale |= Resource.IsValid() && Resource->Key != 2;
+		return Resource.IsValid();
+	}));
+
+	TestFalse(TEXT("The outdated build is never handed out"), bHandedOutStale);
+	TestEqual(TEXT("Two builds"), Factory->Builds.GetValue(), 2);
+
+	// switching away and back while a build is in flight: the ready resource went with the first switch
+	Factory->bReleased = false;
+	Creator.Update(3, 0.3);
+	TestFalse(TEXT("The old key's resource is dropped with the key change"), Creator.Update(2, 0.4).IsValid());
+
+	Factory->bReleased = true;
+	TestTrue(TEXT("Rebuilt for the key wanted again"), PollUntil([&]() { Resource = Creator.Update(2, 0.5); return Resource.IsValid(); }));
+
+	if (Resource.IsValid())
+		TestEqual(TEXT("Built for the key wanted again"), Resource->Key, 2);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutAsyncCreatorRetryTest, "Spout2.AsyncCreator.RetryAfterFailure", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutAsyncCreatorRetryTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutAsyncCreatorTest;
+
+	TSharedRef<FMockFactory, ESPMode::ThreadSafe> Factory = MakeShared<FMockFactory, ESPMode::ThreadSafe>();
+	Factory->bReleased = true;
+
+	TSpoutAsyncCreator<int32, FMockResource> Creator(FMockFactory::Make(Factory), 1.0);
+
+	Creator.Update(-1, 0.0);
+	TestTrue(TEXT("The build fails"), PollUntil([&]() { Creator.Update(-1, 0.0); return Creator.GetState() == ESpoutCreationState::Failed; }));
+
+	TestFalse(TEXT("Nothing within the retry delay"), Creator.Update(-1, 0.5).IsValid());
+	TestEqual(TEXT("No retry within the delay"), Factory->Builds.GetValue(), 1);
+
+	Creator.Update(-1, 1.5);
+	TestTrue(TEXT("Pending again after the delay"), Creator.GetState() == ESpoutCreationState::Pending);
+	TestTrue(TEXT("Retried after the delay"), PollUntil([&]() { return Factory->Builds.GetValue() == 2; }));
+
+	// a failed key does not hold back another one
+	TestTrue(TEXT("Retry fails too"), PollUntil([&]() { Creator.Update(-1, 1.5); return Creator.GetState() == ESpoutCreationState::Failed; }));
+
+	TSharedPtr<FMockResource, ESPMode::ThreadSafe> Resource;
+	TestTrue(TEXT("Another key builds at once"), PollUntil([&]() { Resource = Creator.Update(4, 1.6); return Resource.IsValid(); }));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutAsyncCreatorResetTest, "Spout2.AsyncCreator.ResetDuringBuild", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutAsyncCreatorResetTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutAsyncCreatorTest;
+
+	TSharedRef<FMockFactory, ESPMode::ThreadSafe> Factory = MakeShared<FMockFactory, ESPMode::ThreadSafe>();
+	TSpoutAsyncCreator<int32, FMockResource> Creator(FMockFactory::Make(Factory));
+
+	Creator.Update(1, 0.0);
+	Creator.Reset();
+	TestTrue(TEXT("Idle after a reset"), Creator.GetState() == ESpoutCreationState::Idle);
+
+	Factory->bReleased = true;
+
+	// the build started before the reset belongs to what was reset, even for the same key
+	TSharedPtr<FMockResource, ESPMode::ThreadSafe> Resource;
+	TestTrue(TEXT("Built again"), PollUntil([&]() { Resource = Creator.Update(1, 0.1); return Resource.IsValid(); }));
+
+	if (Resource.IsValid())
+		TestEqual(TEXT("From a build after the reset"), Resource->Build, 2);
+
+	// a reset resource is not handed out again
+	Creator.Reset();
+	TestFalse(TEXT("Nothing right after a reset"), Creator.Update(1, 0.2).IsValid());
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,167 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "SpoutAtlasPacker.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutAtlasPackerTest
+{
+	/** Widget and thumbnail sized senders. */
+	static TArray<FIntPoint> MakeSizes(FRandomStream& Random, int32 Count)
+	{
+		TArray<FIntPoint> Sizes;
+		for (int32 Index = 0; Index < Count; ++Index)
+			Sizes.Add(FIntPoint(Random.RandRange(2, 32) * 16, Random.RandRange(2, 24) * 16));
+
+		return Sizes;
+	}
+
+	static bool IsInBounds(const TArray<FIntRect>& Rects, FIntPoint AtlasSize)
+	{
+		for (const FIntRect& Rect : Rects)
+		{
+			if (Rect.Min.X < 0 || Rect.Min.Y < 0 || Rect.Max.X > AtlasSize.X || Rect.Max.Y > AtlasSize.Y)
+				return false;
+		}
+
+		return true;
+	}
+
+	/** True when every two rectangles are at least Padding apart on one axis. */
+	static bool IsSeparated(const TArray<FIntRect>& Rects, int32 Padding)
+	{
+		for (int32 i = 0; i < Rects.Num(); ++i)
+		{
+			for (int32 j = i + 1; j < Rects.Num(); ++j)
+			{
+				const FIntRect& A = Rects[i];
+				const FIntRect& B = Rects[j];
+
+				if (A.Max.X + Padding > B.Min.X && B.Max.X + Padding > A.Min.X
+					&& A.Max.Y + Padding > B.Min.Y && B.Max.Y + Padding > A.Min.Y)
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	static bool HasSizes(const TArray<FIntRect>& Rects, const TArray<FIntPoint>& Sizes)
+	{
+		for (int32 Index = 0; Index < Sizes.Num(); ++Index)
+		{
+			if (Rects[Index].Size() != Sizes[Index])
+				return false;
+		}
+
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutAtlasPackerPlacementTest, "Spout2.AtlasPacker.Placement", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutAtlasPackerPlacementTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutAtlasPackerTest;
+
+	FRandomStream Random(0x5350);
+
+	for (int32 Padding : { 0, 2, 5 })
+	{
+		for (int32 Count : { 1, 8, 32, 128 })
+		{
+			const TArray<FIntPoint> Sizes = MakeSizes(Random, Count);
+
+			TArray<FIntRect> Rects;
+			const TOptional<FIntPoint> AtlasSize = FSpoutSkylinePacker::PackSmallest(Sizes, Padding, 8192, Rects);
+
+			const FString What = FString::Printf(TEXT("%d senders, padding %d"), Count, Padding);
+			if (!AtlasSize.IsSet())
+			{
+				AddError(What + TEXT(": no atlas"));
+				continue;
+			}
+
+			TestTrue(What + TEXT(": one rectangle per sender, in order"), Rects.Num() == Sizes.Num() && HasSizes(Rects, Sizes));
+			TestTrue(What + TEXT(": inside the atlas"), IsInBounds(Rects, AtlasSize.GetValue()));
+			TestTrue(What + TEXT(": no overlaps, padding kept"), IsSeparated(Rects, Padding));
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutAtlasPackerInsertTest, "Spout2.AtlasPacker.Insert", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutAtlasPackerInsertTest::RunTest(const FString& Parameters)
+{
+	FSpoutSkylinePacker Packer(128, 64, 2);
+
+	// bottom-left: rows fill from the left, the next rectangle rests on the lowest edge
+	TOptional<FIntRect> First = Packer.Insert(FIntPoint(60, 30));
+	TOptional<FIntRect> Second = Packer.Insert(FIntPoint(60, 20));
+	TestTrue(TEXT("First at the origin"), First.IsSet() && First.GetValue() == FIntRect(0, 0, 60, 30));
+	TestTrue(TEXT("Second beside it, past the padding"), Second.IsSet() && Second.GetValue() == FIntRect(62, 0, 122, 20));
+
+	TOptional<FIntRect> Third = Packer.Insert(FIntPoint(60, 20));
+	TestTrue(TEXT("Third on the lower of the two"), Third.IsSet() && Third.GetValue() == FIntRect(62, 22, 122, 42));
+
+	// padding is dropped at the atlas edge
+	FSpoutSkylinePacker Exact(64, 64, 4);
+	TestTrue(TEXT("A sender as large as the atlas fits"), Exact.Insert(FIntPoint(64, 64)).IsSet());
+	TestEqual(TEXT("Full"), Exact.GetOccupancy(), 1.f);
+	TestFalse(TEXT("Nothing fits beside it"), Exact.Insert(FIntPoint(1, 1)).IsSet());
+
+	TestFalse(TEXT("Larger than the atlas"), Packer.Insert(FIntPoint(129, 1)).IsSet());
+	TestFalse(TEXT("Empty"), Packer.Insert(FIntPoint(0, 16)).IsSet());
+
+	Packer.Reset(128, 64);
+	TestEqual(TEXT("Reset empties the atlas"), Packer.GetOccupancy(), 0.f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutAtlasPackerSmallestTest, "Spout2.AtlasPacker.PackSmallest", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutAtlasPackerSmallestTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutAtlasPackerTest;
+
+	TArray<FIntRect> Rects;
+
+	auto PackSmallest = [&Rects](const TArray<FIntPoint>& Sizes, int32 Padding) {
+		return FSpoutSkylinePacker::PackSmallest(Sizes, Padding, 8192, Rects).Get(FIntPoint::ZeroValue);
+	};
+
+	TestEqual(TEXT("Two squares side by side"), PackSmallest({ FIntPoint(64, 64), FIntPoint(64, 64) }, 0), FIntPoint(128, 64));
+	TestEqual(TEXT("Four squares"), PackSmallest({ FIntPoint(64, 64), FIntPoint(64, 64), FIntPoint(64, 64), FIntPoint(64, 64) }, 0), FIntPoint(128, 128));
+	TestEqual(TEXT("Padding between two squares needs the next size"), PackSmallest({ FIntPoint(64, 64), FIntPoint(64, 64) }, 2), FIntPoint(256, 128));
+	TestEqual(TEXT("No padding at the edge of a single sender"), PackSmallest({ FIntPoint(256, 256) }, 2), FIntPoint(256, 256));
+	TestEqual(TEXT("Too large"), PackSmallest({ FIntPoint(8193, 16) }, 0), FIntPoint::ZeroValue);
+	TestEqual(TEXT("Nothing to pack"), PackSmallest({}, 0), FIntPoint::ZeroValue);
+
+	// the candidate tried just before the result, half as tall or half as wide, is too small
+	FRandomStream Random(0x5350);
+
+	for (int32 Iteration = 0; Iteration < 64; ++Iteration)
+	{
+		const TArray<FIntPoint> Sizes = MakeSizes(Random, Random.RandRange(1, 64));
+		const int32 Padding = Random.RandRange(0, 1) * 2;
+
+		const FIntPoint AtlasSize = PackSmallest(Sizes, Padding);
+		if (!TestTrue(TEXT("Packed"), AtlasSize.X > 0))
+			continue;
+
+		TestTrue(TEXT("Power of two sides"), FMath::IsPowerOfTwo(AtlasSize.X) && FMath::IsPowerOfTwo(AtlasSize.Y));
+
+		const FIntPoint Smaller = AtlasSize.X == AtlasSize.Y ? FIntPoint(AtlasSize.X, AtlasSize.Y / 2) : FIntPoint(AtlasSize.Y, AtlasSize.Y);
+		TArray<FIntRect> SmallerRects;
+		TestFalse(FString::Printf(TEXT("%d senders do not fit %dx%d"), Sizes.Num(), Smaller.X, Smaller.Y), FSpoutSkylinePacker::PackAll(Sizes, Smaller, Padding, SmallerRects));
+	}
+
+	return true;
+}
+
+#endif
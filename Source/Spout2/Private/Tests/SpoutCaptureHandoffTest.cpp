@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "SpoutCaptureHandoff.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutCaptureHandoffTest
+{
+	/** Stands in for the slot and publish callback, only its identity matters. */
+	struct FTarget
+	{
+		int32 Id = 0;
+	};
+
+	typedef TSpoutCaptureHandoff<FTarget> FHandoff;
+
+	static constexpr int32 Format = 7;
+
+	static FHandoff::FTargetPtr MakeTarget(int32 Id)
+	{
+		FHandoff::FTargetPtr Target = MakeShared<FTarget, ESPMode::ThreadSafe>();
+		Target->Id = Id;
+		return Target;
+	}
+
+	/** Offers the passes the way the renderer does for one view, in pipeline order. */
+	static FSpoutStageSelection Offer(ESpoutCaptureStage Requested, bool bMotionBlur, bool bTonemap, bool bFXAA, TArray<ESpoutCaptureStage>& OutSubscribed)
+	{
+		FSpoutStageSelection Selection;
+		Selection.Requested = Requested;
+
+		const ESpoutCaptureStage Stages[] = { ESpoutCaptureStage::AfterMotionBlur, ESpoutCaptureStage::AfterTonemap, ESpoutCaptureStage::AfterFXAA };
+		const bool bEnabled[] = { bMotionBlur, bTonemap, bFXAA };
+
+		OutSubscribed.Reset();
+		for (int32 Pass = 0; Pass < UE_ARRAY_COUNT(Stages); ++Pass)
+		{
+			if (Selection.Offer(Stages[Pass], bEnabled[Pass]))
+				OutSubscribed.Add(Stages[Pass]);
+		}
+
+		return Selection;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutCaptureStageSelectionTest, "Spout2.CaptureHandoff.StageSelection", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutCaptureStageSelectionTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutCaptureHandoffTest;
+
+	TArray<ESpoutCaptureStage> Subscribed;
+
+	FSpoutStageSelection Selection = Offer(ESpoutCaptureStage::AfterFXAA, true, true, true, Subscribed);
+	TestEqual(TEXT("Every enabled pass up to the request is subscribed"), Subscribed.Num(), 3);
+	TestTrue(TEXT("The requested pass is selected"), Selection.IsSelected(ESpoutCaptureStage::AfterFXAA));
+	TestFalse(TEXT("Earlier passes are not"), Selection.IsSelected(ESpoutCaptureStage::AfterTonemap) || Selection.IsSelected(ESpoutCaptureStage::AfterMotionBlur));
+
+	Selection = Offer(ESpoutCaptureStage::AfterFXAA, true, true, false, Subscribed);
+	TestTrue(TEXT("Without FXAA, the tonemapper"), Selection.IsSelected(ESpoutCaptureStage::AfterTonemap));
+	TestEqual(TEXT("FXAA is not subscribed"), Subscribed.Num(), 2);
+
+	Selection = Offer(ESpoutCaptureStage::AfterFXAA, true, false, false, Subscribed);
+	TestTrue(TEXT("Without either, motion blur"), Selection.IsSelected(ESpoutCaptureStage::AfterMotionBlur));
+
+	Selection = Offer(ESpoutCaptureStage::AfterTonemap, true, true, true, Subscribed);
+	TestTrue(TEXT("Later passes are not offered past the request"), Selection.IsSelected(ESpoutCaptureStage::AfterTonemap) && Subscribed.Num() == 2);
+
+	Selection = Offer(ESpoutCaptureStage::AfterMotionBlur, false, true, true, Subscribed);
+	TestFalse(TEXT("Nothing enabled up to the request, nothing selected"), Selection.Selected.IsSet());
+	TestEqual(TEXT("Nor subscribed"), Subscribed.Num(), 0);
+
+	// a pass the selection moved past still has its callback, and must let the view through
+	Selection = Offer(ESpoutCaptureStage::AfterFXAA, true, true, true, Subscribed);
+	TestFalse(TEXT("Subscribed but not selected"), Selection.IsSelected(ESpoutCaptureStage::AfterMotionBlur));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutCaptureHandoffClaimTest, "Spout2.CaptureHandoff.Claim", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutCaptureHandoffClaimTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutCaptureHandoffTest;
+
+	const FIntPoint Size(1920, 1080);
+
+	FHandoff Handoff;
+	TestFalse(TEXT("Nothing armed"), Handoff.Claim(1, Size, Format).IsValid());
+
+	FIntPoint ObservedSize;
+	int32 ObservedFormat = 0;
+	Handoff.GetObserved(ObservedSize, ObservedFormat);
+	TestTrue(TEXT("Views are observed even when not captured"), ObservedSize == Size && ObservedFormat == Format);
+
+	FHandoff::FTargetPtr Target = MakeTarget(1);
+	Handoff.Arm(Target, Size, Format, 10);
+
+	TestFalse(TEXT("A view of an earlier frame"), Handoff.Claim(9, Size, Format).IsValid());
+	TestFalse(TEXT("A view of another size"), Handoff.Claim(10, FIntPoint(1280, 720), Format).IsValid());
+	TestFalse(TEXT("A view of another format"), Handoff.Claim(10, Size, Format + 1).IsValid());
+
+	Handoff.GetObserved(ObservedSize, ObservedFormat);
+	TestTrue(TEXT("The last candidate is observed"), ObservedSize == Size && ObservedFormat == Format + 1);
+
+	FHandoff::FTargetPtr Claimed = Handoff.Claim(10, Size, Format);
+	TestTrue(TEXT("The armed frame's view"), Claimed.IsValid() && Claimed->Id == 1);
+	TestEqual(TEXT("Claimed frame"), (int64)Handoff.GetClaimedFrame(), (int64)10);
+
+	TestFalse(TEXT("A second view of the frame"), Handoff.Claim(10, Size, Format).IsValid());
+	TestFalse(TEXT("A later frame without a new arm"), Handoff.Claim(11, Size, Format).IsValid());
+
+	// a late frame: the renderer is behind the game thread, the first view of a later frame takes it
+	Handoff.Arm(Target, Size, Format, 12);
+	Claimed = Handoff.Claim(14, Size, Format);
+	TestTrue(TEXT("A later frame claims a pending arm"), Claimed.IsValid());
+	TestFalse(TEXT("Once"), Handoff.Claim(15, Size, Format).IsValid());
+
+	// re-arming before the renderer got to it replaces the target
+	Handoff.Arm(MakeTarget(2), Size, Format, 16);
+	Handoff.Arm(MakeTarget(3), Size, Format, 17);
+	Claimed = Handoff.Claim(17, Size, Format);
+	TestTrue(TEXT("The newest target"), Claimed.IsValid() && Claimed->Id == 3);
+
+	Handoff.Arm(Target, Size, Format, 18);
+	Handoff.Disarm();
+	TestFalse(TEXT("Nothing after a disarm"), Handoff.Claim(18, Size, Format).IsValid());
+	TestEqual(TEXT("The last claim stays"), (int64)Handoff.GetClaimedFrame(), (int64)17);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "SpoutChangeTracker.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutChangeTrackerTest
+{
+	/** Compared by operator== only, the way the sender's source keys are. */
+	struct FKey
+	{
+		const void* Resource = nullptr;
+		uint64 DirtyCount = 0;
+
+		bool operator==(const FKey& Other) const
+		{
+			return Resource == Other.Resource && DirtyCount == Other.DirtyCount;
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutChangeTrackerPublishTest, "Spout2.ChangeTracker.Publish", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutChangeTrackerPublishTest::RunTest(const FString& Parameters)
+{
+	TSpoutChangeTracker<uint64> Tracker;
+
+	TestTrue(TEXT("The first value is a change"), Tracker.HasChanged(0));
+	TestEqual(TEXT("Nothing published"), (int64)Tracker.GetVersion(), (int64)0);
+
+	Tracker.MarkPublished(0);
+	TestFalse(TEXT("The published value"), Tracker.HasChanged(0));
+	TestTrue(TEXT("Another one"), Tracker.HasChanged(1));
+	TestEqual(TEXT("One version"), (int64)Tracker.GetVersion(), (int64)1);
+
+	Tracker.MarkPublished(0);
+	TestEqual(TEXT("Publishing the same value again is no new version"), (int64)Tracker.GetVersion(), (int64)1);
+
+	// the scheduler deferred the publish: asking does not record anything
+	TestTrue(TEXT("Changed"), Tracker.HasChanged(5));
+	TestTrue(TEXT("Still changed on the next tick"), Tracker.HasChanged(5));
+
+	Tracker.MarkPublished(5);
+	Tracker.MarkPublished(6);
+	TestEqual(TEXT("A version per distinct publish"), (int64)Tracker.GetVersion(), (int64)3);
+
+	// back to an earlier value is a change too, only the last publish is remembered
+	TestTrue(TEXT("An earlier value"), Tracker.HasChanged(5));
+	Tracker.MarkPublished(5);
+	TestEqual(TEXT("Counted"), (int64)Tracker.GetVersion(), (int64)4);
+
+	Tracker.Reset();
+	TestTrue(TEXT("After a reset the last value is a change again"), Tracker.HasChanged(5));
+	TestEqual(TEXT("The version is kept"), (int64)Tracker.GetVersion(), (int64)4);
+
+	Tracker.MarkPublished(5);
+	TestEqual(TEXT("And counts on"), (int64)Tracker.GetVersion(), (int64)5);
+	TestFalse(TEXT("Settled"), Tracker.HasChanged(5));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutChangeTrackerKeyTest, "Spout2.ChangeTracker.Key", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutChangeTrackerKeyTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutChangeTrackerTest;
+
+	int32 TextureA = 0;
+	int32 TextureB = 0;
+
+	TSpoutChangeTracker<FKey> Tracker;
+
+	const FKey First{ &TextureA, 1 };
+	Tracker.MarkPublished(First);
+	TestFalse(TEXT("An equal key"), Tracker.HasChanged(FKey{ &TextureA, 1 }));
+	TestTrue(TEXT("The source was marked dirty"), Tracker.HasChanged(FKey{ &TextureA, 2 }));
+	TestTrue(TEXT("Another resource"), Tracker.HasChanged(FKey{ &TextureB, 1 }));
+
+	// skipped frames: the source is dirtied several times before one publish goes out
+	TestTrue(TEXT("Dirty twice"), Tracker.HasChanged(FKey{ &TextureA, 3 }));
+	Tracker.MarkPublished(FKey{ &TextureA, 3 });
+	TestFalse(TEXT("The newest state is published"), Tracker.HasChanged(FKey{ &TextureA, 3 }));
+	TestEqual(TEXT("One version for the skipped ones"), (int64)Tracker.GetVersion(), (int64)2);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "SpoutFrameLatch.h"
+#include "Templates/UniquePtr.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutFrameLatchTest
+{
+	// requests hold the copy's resources, the latch only ever moves them
+	typedef TUniquePtr<int32> FRequest;
+	typedef TSpoutFrameLatch<FRequest> FLatch;
+
+	static bool Holds(const TOptional<FRequest>& Latched, int32 Value)
+	{
+		return Latched.IsSet() && Latched.GetValue().IsValid() && *Latched.GetValue() == Value;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutFrameLatchArmTest, "Spout2.FrameLatch.Arm", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutFrameLatchArmTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutFrameLatchTest;
+
+	FLatch Latch;
+	TestFalse(TEXT("Nothing armed"), Latch.IsArmed());
+	TestFalse(TEXT("Nothing to latch before render"), Latch.LatchBeforeRender().IsSet());
+	TestFalse(TEXT("Nor at the end of the frame"), Latch.LatchAtEndOfFrame().IsSet());
+
+	Latch.Arm(MakeUnique<int32>(1));
+	TestTrue(TEXT("Armed"), Latch.IsArmed());
+
+	// two game ticks before the renderer got to the first one
+	Latch.Arm(MakeUnique<int32>(2));
+	TestEqual(TEXT("The older request is replaced"), (int32)Latch.GetStats().Replaced, 1);
+
+	TestTrue(TEXT("The newest request is latched"), Holds(Latch.LatchBeforeRender(), 2));
+	TestFalse(TEXT("Once"), Latch.IsArmed() || Latch.LatchBeforeRender().IsSet());
+
+	Latch.Arm(MakeUnique<int32>(3));
+	TestEqual(TEXT("Arming a latched request replaces nothing"), (int32)Latch.GetStats().Replaced, 1);
+
+	Latch.Disarm();
+	TestFalse(TEXT("Disarmed"), Latch.IsArmed());
+	TestFalse(TEXT("Nothing latched before render after a disarm"), Latch.LatchBeforeRender().IsSet());
+	TestFalse(TEXT("Nor at the end of the frame"), Latch.LatchAtEndOfFrame().IsSet());
+
+	Latch.Arm(MakeUnique<int32>(4));
+	TestEqual(TEXT("A disarmed request is not counted as replaced"), (int32)Latch.GetStats().Replaced, 1);
+	TestTrue(TEXT("Armed again after a disarm"), Holds(Latch.LatchAtEndOfFrame(), 4));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutFrameLatchFrameTest, "Spout2.FrameLatch.Frame", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutFrameLatchFrameTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutFrameLatchTest;
+
+	FLatch Latch;
+
+	// a frame with two view families: the first takes the request, the rest of the frame finds nothing
+	Latch.Arm(MakeUnique<int32>(1));
+	TestTrue(TEXT("The first view family latches"), Holds(Latch.LatchBeforeRender(), 1));
+	TestFalse(TEXT("The second finds nothing"), Latch.LatchBeforeRender().IsSet());
+	TestFalse(TEXT("Nor does the end of the frame"), Latch.LatchAtEndOfFrame().IsSet());
+
+	// a frame nobody renders, a minimized window: the end of the frame takes it
+	Latch.Arm(MakeUnique<int32>(2));
+	TestTrue(TEXT("Latched at the end of the frame"), Holds(Latch.LatchAtEndOfFrame(), 2));
+
+	// a request armed after the frame's views rendered waits for the end of that frame
+	Latch.Arm(MakeUnique<int32>(3));
+	TestTrue(TEXT("A late request still lands in its frame"), Holds(Latch.LatchAtEndOfFrame(), 3));
+
+	Latch.Arm(MakeUnique<int32>(4));
+	TestTrue(TEXT("Before render again"), Holds(Latch.LatchBeforeRender(), 4));
+
+	const FLatch::FStats& Stats = Latch.GetStats();
+	TestEqual(TEXT("Latched before render"), (int32)Stats.BeforeRender, 2);
+	TestEqual(TEXT("Latched at the end of the frame"), (int32)Stats.EndOfFrame, 2);
+	TestEqual(TEXT("Nothing replaced"), (int32)Stats.Replaced, 0);
+
+	// every armed request is latched exactly once, or replaced
+	FLatch Counted;
+	int32 Armed = 0;
+	int32 Latched = 0;
+
+	for (int32 Frame = 0; Frame < 100; ++Frame)
+	{
+		// one to three ticks per frame, some frames render no view
+		for (int32 Tick = 0; Tick <= Frame % 3; ++Tick)
+		{
+			Counted.Arm(MakeUnique<int32>(Frame));
+			++Armed;
+		}
+
+		if (Frame % 4 != 0)
+			Latched += Holds(Counted.LatchBeforeRender(), Frame) ? 1 : 0;
+
+		Latched += Holds(Counted.LatchAtEndOfFrame(), Frame) ? 1 : 0;
+	}
+
+	TestEqual(TEXT("One latch per frame"), Latched, 100);
+	TestEqual(TEXT("The others replaced"), (int32)Counted.GetStats().Replaced, Armed - Latched);
+	TestEqual(TEXT("Split between the two points"), (int32)(Counted.GetStats().BeforeRender + Counted.GetStats().EndOfFrame), 100);
+	TestEqual(TEXT("The end of the frame only takes frames nobody rendered"), (int32)Counted.GetStats().EndOfFrame, 25);
+
+	return true;
+}
+
+#endif
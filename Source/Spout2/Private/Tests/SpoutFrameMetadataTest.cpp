@@ -0,0 +1,232 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Async/Async.h"
+#include "HAL/PlatformAtomics.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/AutomationTest.h"
+#include "SpoutFrameMetadata.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutFrameMetadataTest
+{
+	/** A sender name of this process only, the ring lives as long as someone maps it. */
+	static FString MakeSenderName(const TCHAR* Test)
+	{
+		return FString::Printf(TEXT("Spout2MetadataTest_%s_%u"), Test, FPlatformProcess::GetCurrentProcessId());
+	}
+
+	// the frame id, then a pattern of it; every 97th blob is over the limit
+	static void MakeBlob(int64 FrameId, TArray<uint8>& OutBlob)
+	{
+		const int32 Size = FrameId % 97 == 0 ? FSpoutMetadataRing::MaxBlobSize + 1 : (int32)(sizeof(int64) + FrameId % 512);
+
+		OutBlob.SetNumUninitialized(Size);
+		FMemory::Memcpy(OutBlob.GetData(), &FrameId, sizeof(int64));
+
+		for (int32 Index = sizeof(int64); Index < Size; ++Index)
+			OutBlob[Index] = (uint8)(FrameId * 31 + Index);
+	}
+
+	static bool IsBlobDropped(int64 FrameId)
+	{
+		return FrameId % 97 == 0;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutFrameMetadataReadTest, "Spout2.FrameMetadata.Read", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutFrameMetadataReadTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutFrameMetadataTest;
+
+	const FString SenderName = MakeSenderName(TEXT("Read"));
+	TArray<uint8> Data, Expected;
+
+	FSpoutMetadataReader Early(SenderName);
+	TestTrue(TEXT("No ring before the sender attached metadata"), Early.Read(1, Data) == ESpoutMetadataRead::Unavailable);
+
+	FSpoutMetadataWriter Writer(SenderName);
+	FSpoutMetadataReader Reader(SenderName);
+
+	MakeBlob(1, Expected);
+	TestTrue(TEXT("Written"), Writer.Write(1, Expected.GetData(), Expected.Num()));
+	TestTrue(TEXT("Found"), Reader.Read(1, Data) == ESpoutMetadataRead::Found);
+	TestTrue(TEXT("The blob written for the frame"), Data == Expected);
+
+	TestTrue(TEXT("A frame without metadata"), Writer.Write(2, nullptr, 0));
+	TestTrue(TEXT("Is missing"), Reader.Read(2, Data) == ESpoutMetadataRead::Missing && Data.Num() == 0);
+
+	TestTrue(TEXT("Not published yet, an older frame holds the slot"), Reader.Read(3, Data) == ESpoutMetadataRead::Missing);
+
+	MakeBlob(97, Expected);
+	TestFalse(TEXT("Over the limit"), Writer.Write(97, Expected.GetData(), Expected.Num()));
+	TestTrue(TEXT("The frame has none"), Reader.Read(97, Data) == ESpoutMetadataRead::Missing && Data.Num() == 0);
+
+	TestFalse(TEXT("Frame ids start at 1"), Writer.Write(0, nullptr, 0));
+	TestTrue(TEXT("Senders outside the plugin have no frame ids"), Reader.Read(0, Data) == ESpoutMetadataRead::Unavailable);
+
+	// a ring of another layout is left alone by both sides
+	const FString ForeignName = MakeSenderName(TEXT("Foreign"));
+	FSpoutSharedRegion ForeignRegion;
+	if (TestTrue(TEXT("Foreign ring created"), ForeignRegion.Create(FSpoutSharedRegion::MakeName(ForeignName, TEXT("SpoutMeta")), sizeof(FSpoutMetadataRing))))
+	{
+		FSpoutMetadataRing* ForeignRing = ForeignRegion.As<FSpoutMetadataRing>();
+		ForeignRing->Magic = (int32)FSpoutMetadataRing::MagicValue;
+		ForeignRing->Version = FSpoutMetadataRing::CurrentVersion + 1;
+
+		const uint8 Byte = 0;
+		FSpoutMetadataWriter ForeignWriter(ForeignName);
+		FSpoutMetadataReader ForeignReader(ForeignName);
+
+		TestFalse(TEXT("Foreign ring, write refused"), ForeignWriter.Write(1, &Byte, 1));
+		TestTrue(TEXT("Foreign ring, unavailable"), ForeignReader.Read(1, Data) == ESpoutMetadataRead::Unavailable);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutFrameMetadataRingWrapTest, "Spout2.FrameMetadata.RingWrap", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutFrameMetadataRingWrapTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutFrameMetadataTest;
+
+	const FString SenderName = MakeSenderName(TEXT("RingWrap"));
+	const int64 NumFrames = FSpoutMetadataRing::SlotCount + 5;
+
+	FSpoutMetadataWriter Writer(SenderName);
+	FSpoutMetadataReader Reader(SenderName);
+	TArray<uint8> Data, Expected;
+
+	for (int64 FrameId = 1; FrameId <= NumFrames; ++FrameId)
+	{
+		MakeBlob(FrameId, Expected);
+		Writer.Write(FrameId, Expected.GetData(), Expected.Num());
+	}
+
+	// a receiver more than SlotCount frames behind finds newer frames, never theirs
+	for (int64 FrameId = 1; FrameId <= NumFrames - FSpoutMetadataRing::SlotCount; ++FrameId)
+	{
+		TestTrue(FString::Printf(TEXT("Frame %lld overwritten"), FrameId), Reader.Read(FrameId, Data) == ESpoutMetadataRead::Overwritten);
+		TestEqual(FString::Printf(TEXT("Frame %lld, nothing read"), FrameId), Data.Num(), 0);
+	}
+
+	for (int64 FrameId = NumFrames - FSpoutMetadataRing::SlotCount + 1; FrameId <= NumFrames; ++FrameId)
+	{
+		MakeBlob(FrameId, Expected);
+		TestTrue(FString::Printf(TEXT("Frame %lld in the ring"), FrameId), Reader.Read(FrameId, Data) == ESpoutMetadataRead::Found && Data == Expected);
+	}
+
+	// a restarted sender clears the slots a previous run left behind while receivers kept the ring
+	{
+		FSpoutMetadataWriter Restarted(SenderName);
+		const uint8 Byte = 1;
+		Restarted.Write(1, &Byte, 1);
+	}
+
+	TestTrue(TEXT("The previous run's frames are gone"), Reader.Read(NumFrames, Data) == ESpoutMetadataRead::Missing);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutFrameMetadataSeqlockTest, "Spout2.FrameMetadata.Seqlock", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutFrameMetadataSeqlockTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutFrameMetadataTest;
+
+	TArray<uint8> Data, Expected;
+
+	// a slot caught while written is dropped
+	{
+		const FString SenderName = MakeSenderName(TEXT("Odd"));
+		FSpoutMetadataWriter Writer(SenderName);
+		FSpoutMetadataReader Reader(SenderName);
+
+		MakeBlob(1, Expected);
+		Writer.Write(1, Expected.GetData(), Expected.Num());
+
+		FSpoutSharedRegion Region;
+		if (TestTrue(TEXT("Ring mapped"), Region.Open(FSpoutSharedRegion::MakeName(SenderName, TEXT("SpoutMeta")), sizeof(FSpoutMetadataRing))))
+		{
+			FSpoutMetadataRing::FSlot& Slot = Region.As<FSpoutMetadataRing>()->Slots[1];
+
+			FPlatformAtomics::InterlockedIncrement(&Slot.Sequence);
+			TestTrue(TEXT("Odd sequence, overwritten"), Reader.Read(1, Data) == ESpoutMetadataRead::Overwritten && Data.Num() == 0);
+
+			FPlatformAtomics::InterlockedIncrement(&Slot.Sequence);
+			TestTrue(TEXT("Even again, found"), Reader.Read(1, Data) == ESpoutMetadataRead::Found && Data == Expected);
+		}
+	}
+
+	// a writer and a reader on two threads and two mappings, as two processes would be; the reader sometimes stalls past the ring
+	const FString SenderName = MakeSenderName(TEXT("Seqlock"));
+	const int64 NumFrames = 8000;
+
+	volatile int64 Published = 0;
+
+	TFuture<void> Writer = Async(EAsyncExecution::Thread, [&SenderName, &Published, NumFrames]() {
+		FSpoutMetadataWriter MetadataWriter(SenderName);
+		TArray<uint8> Blob;
+
+		for (int64 FrameId = 1; FrameId <= NumFrames; ++FrameId)
+		{
+			MakeBlob(FrameId, Blob);
+			MetadataWriter.Write(FrameId, Blob.GetData(), Blob.Num());
+
+			// announced after the blob, like MarkPublished
+			FPlatformAtomics::InterlockedExchange(&Published, FrameId);
+
+			if (FrameId % 32 == 0)
+				FPlatformProcess::Sleep(0.001f);
+		}
+	});
+
+	FSpoutMetadataReader Reader(SenderName);
+	int32 Reads = 0, Found = 0, Wrong = 0, StalledFound = 0;
+	int64 LastNewest = 0;
+
+	while (!Writer.IsReady())
+	{
+		const int64 Newest = FPlatformAtomics::AtomicRead(&Published);
+		if (Newest == LastNewest)
+		{
+			FPlatformProcess::Yield();
+			continue;
+		}
+
+		LastNewest = Newest;
+
+		const bool bStalled = ++Reads % 16 == 0;
+		const int64 FrameId = bStalled ? FMath::Max<int64>(Newest - FSpoutMetadataRing::SlotCount - 8, 1) : Newest;
+
+		switch (Reader.Read(FrameId, Data))
+		{
+		case ESpoutMetadataRead::Found:
+			++Found;
+			MakeBlob(FrameId, Expected);
+			Wrong += Data != Expected ? 1 : 0;
+			StalledFound += bStalled && FrameId + FSpoutMetadataRing::SlotCount <= Newest ? 1 : 0;
+			break;
+
+		case ESpoutMetadataRead::Missing:
+			Wrong += IsBlobDropped(FrameId) ? 0 : 1;
+			break;
+
+		case ESpoutMetadataRead::Overwritten:
+		case ESpoutMetadataRead::Unavailable:
+			break;
+		}
+	}
+
+	Writer.Wait();
+
+	TestTrue(TEXT("Frames were read"), Found > 0);
+	TestEqual(TEXT("Never a torn or another frame's blob, never missing one that was written"), Wrong, 0);
+	TestEqual(TEXT("Nothing found past the ring"), StalledFound, 0);
+
+	return true;
+}
+
+#endif
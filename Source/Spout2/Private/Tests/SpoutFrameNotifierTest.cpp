@@ -0,0 +1,188 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Async/Async.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "SpoutFrameNotifier.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutFrameNotifierTest
+{
+	static FSpoutReceivedFrame MakeFrame(int64 FrameId)
+	{
+		FSpoutReceivedFrame Frame;
+		Frame.FrameId = FrameId;
+		Frame.Timestamp = FrameId / 60.f;
+		return Frame;
+	}
+
+	struct FWaiterResult
+	{
+		int32 Wakeups = 0;
+		// frames not newer than the one published before the future was acquired
+		int32 Stale = 0;
+		bool bCancelled = false;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutFrameNotifierDeliveryTest, "Spout2.FrameNotifier.Delivery", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutFrameNotifierDeliveryTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutFrameNotifierTest;
+
+	FSpoutFrameNotifier Notifier;
+
+	TFuture<FSpoutReceivedFrame> First = Notifier.AcquireNext();
+	TFuture<FSpoutReceivedFrame> AlsoFirst = Notifier.AcquireNext();
+	TestFalse(TEXT("Nothing before a publish"), First.IsReady());
+	TestEqual(TEXT("Two waiters"), Notifier.GetNumWaiters(), 2);
+
+	Notifier.Publish(MakeFrame(1));
+	TestTrue(TEXT("Fulfilled on the publishing thread"), First.IsReady() && AlsoFirst.IsReady());
+	TestEqual(TEXT("With the published frame"), (int64)First.Get().FrameId, (int64)1);
+	TestEqual(TEXT("Every waiter gets it"), (int64)AlsoFirst.Get().FrameId, (int64)1);
+	TestEqual(TEXT("No waiters left"), Notifier.GetNumWaiters(), 0);
+
+	// a future waits for the next frame, never one published before it
+	TFuture<FSpoutReceivedFrame> Second = Notifier.AcquireNext();
+	TestFalse(TEXT("Not fulfilled by an earlier frame"), Second.IsReady());
+
+	Notifier.Publish(MakeFrame(1));
+	TestFalse(TEXT("Not by the same frame drawn again"), Second.IsReady());
+
+	Notifier.Publish(MakeFrame(2));
+	TestTrue(TEXT("By the next one"), Second.IsReady() && Second.Get().FrameId == 2);
+
+	// the game thread takes the newest frame once
+	Notifier.Publish(MakeFrame(3));
+	FSpoutReceivedFrame Taken;
+	TestTrue(TEXT("Undispatched frame"), Notifier.TakeUndispatched(Taken));
+	TestEqual(TEXT("Frames coalesce, the newest wins"), (int64)Taken.FrameId, (int64)3);
+	TestFalse(TEXT("Taken once"), Notifier.TakeUndispatched(Taken));
+
+	Notifier.Publish(MakeFrame(3));
+	TestFalse(TEXT("The same frame is not dispatched again"), Notifier.TakeUndispatched(Taken));
+
+	// a restarted sender counts from 1 again
+	TFuture<FSpoutReceivedFrame> Restarted = Notifier.AcquireNext();
+	Notifier.Publish(MakeFrame(1));
+	TestTrue(TEXT("A lower id is a new frame"), Restarted.IsReady() && Restarted.Get().FrameId == 1);
+	TestEqual(TEXT("Newest"), (int64)Notifier.GetNewest().FrameId, (int64)1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutFrameNotifierOnceTest, "Spout2.FrameNotifier.ExactlyOnce", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutFrameNotifierOnceTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutFrameNotifierTest;
+
+	FSpoutFrameNotifier Notifier;
+
+	// a fulfilled future keeps its frame, later publishes and cancellations find no promise of it
+	TFuture<FSpoutReceivedFrame> Future = Notifier.AcquireNext();
+	Notifier.Publish(MakeFrame(1));
+	Notifier.Publish(MakeFrame(2));
+	Notifier.Cancel();
+	TestEqual(TEXT("The frame it was fulfilled with"), (int64)Future.Get().FrameId, (int64)1);
+
+	// waiters on other threads: each future completes once, with a frame published after it was acquired
+	const int32 NumWaiters = 4;
+	const int32 NumFrames = 500;
+
+	TSharedRef<FSpoutFrameNotifier, ESPMode::ThreadSafe> Shared = MakeShared<FSpoutFrameNotifier, ESPMode::ThreadSafe>();
+
+	TArray<TFuture<FWaiterResult>> Waiters;
+	for (int32 WaiterIndex = 0; WaiterIndex < NumWaiters; ++WaiterIndex)
+	{
+		Waiters.Add(Async(EAsyncExecution::Thread, [Shared]() {
+			FWaiterResult Result;
+
+			for (;;)
+			{
+				const int64 Before = Shared->GetNewest().FrameId;
+
+				const FSpoutReceivedFrame Frame = Shared->AcquireNext().Get();
+				if (!Frame.IsValid())
+				{
+					Result.bCancelled = true;
+					return Result;
+				}
+
+				++Result.Wakeups;
+				if (Frame.FrameId <= Before)
+					++Result.Stale;
+			}
+		}));
+	}
+
+	for (int32 FrameId = 1; FrameId <= NumFrames; ++FrameId)
+	{
+		Shared->Publish(MakeFrame(FrameId));
+		Shared->Publish(MakeFrame(FrameId));
+		FPlatformProcess::Sleep(0.001f);
+	}
+
+	// waiters block on a frame that never comes until cancelled
+	const double Deadline = FPlatformTime::Seconds() + 5.0;
+	while (Waiters.ContainsByPredicate([](const TFuture<FWaiterResult>& Waiter) { return !Waiter.IsReady(); }))
+	{
+		if (!TestTrue(TEXT("Waiters finish once cancelled"), FPlatformTime::Seconds() < Deadline))
+			return true;
+
+		Shared->Cancel();
+		FPlatformProcess::Sleep(0.001f);
+	}
+
+	for (int32 WaiterIndex = 0; WaiterIndex < Waiters.Num(); ++WaiterIndex)
+	{
+		const FWaiterResult& Result = Waiters[WaiterIndex].Get();
+		const FString What = FString::Printf(TEXT("Waiter %d"), WaiterIndex);
+
+		TestTrue(What + TEXT(" woke up"), Result.Wakeups > 0 && Result.Wakeups <= NumFrames);
+		TestEqual(What + TEXT(" never got a stale frame"), Result.Stale, 0);
+		TestTrue(What + TEXT(" ended by cancellation"), Result.bCancelled);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutFrameNotifierCancelTest, "Spout2.FrameNotifier.Cancel", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutFrameNotifierCancelTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutFrameNotifierTest;
+
+	FSpoutFrameNotifier Notifier;
+	Notifier.Publish(MakeFrame(1));
+
+	TFuture<FSpoutReceivedFrame> Waiting = Notifier.AcquireNext();
+	Notifier.Cancel();
+	TestTrue(TEXT("Cancelled waiters are fulfilled"), Waiting.IsReady());
+	TestFalse(TEXT("With an invalid frame"), Waiting.Get().IsValid());
+	TestEqual(TEXT("No waiters left"), Notifier.GetNumWaiters(), 0);
+
+	Notifier.Cancel();
+	TestEqual(TEXT("Cancelling nothing"), Notifier.GetNumWaiters(), 0);
+
+	// frames keep flowing to waiters acquired after a cancellation
+	TFuture<FSpoutReceivedFrame> After = Notifier.AcquireNext();
+	Notifier.Publish(MakeFrame(2));
+	TestTrue(TEXT("Later waiters get later frames"), After.IsReady() && After.Get().FrameId == 2);
+
+	// a notifier going away cancels whoever still waits
+	TFuture<FSpoutReceivedFrame> Orphaned;
+	{
+		FSpoutFrameNotifier Scoped;
+		Orphaned = Scoped.AcquireNext();
+	}
+	TestTrue(TEXT("Fulfilled on destruction"), Orphaned.IsReady() && !Orphaned.Get().IsValid());
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,206 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include <limits>
+
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "SpoutHdrPacking.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutHdrPackingTest
+{
+	static constexpr int32 NumSteps = 4096;
+
+	/** Worst relative round-trip error of one channel over log-spaced values from Min to Max. */
+	static float GetWorstError(ESpoutHdrTransport Transport, int32 Channel, float Min, float Max)
+	{
+		float Worst = 0.f;
+
+		for (int32 Step = 0; Step <= NumSteps; ++Step)
+		{
+			const float Value = Min * FMath::Pow(Max / Min, (float)Step / NumSteps);
+
+			FLinearColor Color(0.5f, 0.5f, 0.5f, 1.f);
+			Color.Component(Channel) = Value;
+
+			const FLinearColor Decoded = SpoutHdrPacking::UnpackTexel(SpoutHdrPacking::PackTexel(Color, Transport), Transport);
+			Worst = FMath::Max(Worst, FMath::Abs(Decoded.Component(Channel) - Value) / Value);
+		}
+
+		return Worst;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutHdrPackingErrorBoundsTest, "Spout2.HdrPacking.ErrorBounds", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutHdrPackingErrorBoundsTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutHdrPackingTest;
+
+	// the bounds documented in SpoutHdrPacking.h
+	for (int32 Channel = 0; Channel < 3; ++Channel)
+	{
+		TestTrue(FString::Printf(TEXT("PQ10 channel %d, 0.01 to 100"), Channel), GetWorstError(ESpoutHdrTransport::PQ10, Channel, 0.01f, 100.f) <= 0.010f);
+		TestTrue(FString::Printf(TEXT("PQ10 channel %d, 0.001 to 0.01"), Channel), GetWorstError(ESpoutHdrTransport::PQ10, Channel, 0.001f, 0.01f) <= 0.019f);
+		TestTrue(FString::Printf(TEXT("Log10 channel %d"), Channel), GetWorstError(ESpoutHdrTransport::Log10, Channel, FMath::Exp2(-11.99f), 256.f) <= 0.007f);
+	}
+
+	const float Float11Min = FMath::Exp2(-14.f);
+	TestTrue(TEXT("Float11 R"), GetWorstError(ESpoutHdrTransport::Float11, 0, Float11Min, 64000.f) <= 0.008f);
+	TestTrue(TEXT("Float11 G"), GetWorstError(ESpoutHdrTransport::Float11, 1, Float11Min, 64000.f) <= 0.008f);
+	TestTrue(TEXT("Float11 B"), GetWorstError(ESpoutHdrTransport::Float11, 2, Float11Min, 64000.f) <= 0.016f);
+
+	TestEqual(TEXT("Log10 below its range decodes to 0"), SpoutHdrPacking::DecodeLog(SpoutHdrPacking::EncodeLog(FMath::Exp2(-13.f))), 0.f);
+	TestEqual(TEXT("PQ10 black stays black"), SpoutHdrPacking::UnpackTexel(SpoutHdrPacking::PackTexel(FLinearColor::Black, ESpoutHdrTransport::PQ10), ESpoutHdrTransport::PQ10).R, 0.f);
+
+	// two alpha bits
+	TestEqual(TEXT("Opaque alpha"), SpoutHdrPacking::UnpackTexel(SpoutHdrPacking::PackTexel(FLinearColor(1.f, 1.f, 1.f, 1.f), ESpoutHdrTransport::PQ10), ESpoutHdrTransport::PQ10).A, 1.f);
+	TestEqual(TEXT("Transparent alpha"), SpoutHdrPacking::UnpackTexel(SpoutHdrPacking::PackTexel(FLinearColor(1.f, 1.f, 1.f, 0.f), ESpoutHdrTransport::Log10), ESpoutHdrTransport::Log10).A, 0.f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutHdrPackingFloat11Test, "Spout2.HdrPacking.Float11", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutHdrPackingFloat11Test::RunTest(const FString& Parameters)
+{
+	TestEqual(TEXT("1.0 is exact"), SpoutHdrPacking::UFloatToFloat(SpoutHdrPacking::FloatToUFloat(1.f, 6), 6), 1.f);
+	TestEqual(TEXT("Negative values clamp to 0"), SpoutHdrPacking::FloatToUFloat(-2.f, 6), 0u);
+	TestEqual(TEXT("Values above the range clamp to the largest finite value"), SpoutHdrPacking::UFloatToFloat(SpoutHdrPacking::FloatToUFloat(1e6f, 6), 6), 65024.f);
+	TestEqual(TEXT("Largest finite 5 bit mantissa value"), SpoutHdrPacking::UFloatToFloat(SpoutHdrPacking::FloatToUFloat(1e6f, 5), 5), 64512.f);
+	TestEqual(TEXT("Infinity is kept"), SpoutHdrPacking::FloatToUFloat(std::numeric_limits<float>::infinity(), 6), 31u << 6);
+	TestTrue(TEXT("NaN is kept"), FMath::IsNaN(SpoutHdrPacking::UFloatToFloat(SpoutHdrPacking::FloatToUFloat(std::numeric_limits<float>::quiet_NaN(), 5), 5)));
+
+	// denormals: the smallest step is 2^-14 / 64
+	const float Smallest = FMath::Exp2(-20.f);
+	TestEqual(TEXT("Smallest denormal is exact"), SpoutHdrPacking::UFloatToFloat(SpoutHdrPacking::FloatToUFloat(Smallest, 6), 6), Smallest);
+	TestEqual(TEXT("Half the smallest denormal rounds up"), SpoutHdrPacking::FloatToUFloat(Smallest * 0.5f, 6), 1u);
+
+	// a mantissa carry bumps the exponent
+	TestEqual(TEXT("Rounding up to the next power of two"), SpoutHdrPacking::UFloatToFloat(SpoutHdrPacking::FloatToUFloat(1.999f, 6), 6), 2.f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutHdrPackingImageTest, "Spout2.HdrPacking.Image", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutHdrPackingImageTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(1234);
+
+	TArray<FLinearColor> Pixels;
+	for (int32 Index = 0; Index < 1024; ++Index)
+		Pixels.Add(FLinearColor(Random.FRandRange(0.f, 100.f), Random.FRandRange(0.f, 1.f), Random.FRandRange(0.f, 10.f), Random.FRand()));
+
+	TArray<uint32> Packed;
+	Packed.SetNumUninitialized(Pixels.Num());
+
+	const ESpoutHdrTransport Transports[] = { ESpoutHdrTransport::PQ10, ESpoutHdrTransport::Log10, ESpoutHdrTransport::Float11 };
+	for (ESpoutHdrTransport Transport : Transports)
+	{
+		SpoutHdrPacking::PackImage(Pixels.GetData(), Packed.GetData(), Pixels.Num(), Transport);
+
+		// the vectorized PQ path may round a code differently than the scalar one, never by more than one
+		bool bAgrees = true;
+		for (int32 Index = 0; Index < Pixels.Num(); ++Index)
+		{
+			const uint32 Expected = SpoutHdrPacking::PackTexel(Pixels[Index], Transport);
+			if (Transport != ESpoutHdrTransport::PQ10)
+			{
+				bAgrees &= Packed[Index] == Expected;
+				continue;
+			}
+
+			for (int32 Shift = 0; Shift < 30; Shift += 10)
+				bAgrees &= FMath::Abs((int32)((Packed[Index] >> Shift) & 1023) - (int32)((Expected >> Shift) & 1023)) <= 1;
+
+			bAgrees &= (Packed[Index] >> 30) == (Expected >> 30);
+		}
+
+		TestTrue(FString::Printf(TEXT("Transport %d, image and texel packing agree"), (int32)Transport), bAgrees);
+
+		TArray<FLinearColor> Unpacked;
+		Unpacked.SetNumUninitialized(Pixels.Num());
+		SpoutHdrPacking::UnpackImage(Packed.GetData(), Unpacked.GetData(), Packed.Num(), Transport);
+
+		// the vectorized curves may differ from the scalar ones in the last bits, Float11 is exact
+		const float Tolerance = Transport == ESpoutHdrTransport::Float11 ? 0.f : 1e-4f;
+
+		bool bMatches = true;
+		for (int32 Index = 0; Index < Pixels.Num(); ++Index)
+		{
+			const FLinearColor Expected = SpoutHdrPacking::UnpackTexel(Packed[Index], Transport);
+			for (int32 Channel = 0; Channel < 4; ++Channel)
+				bMatches &= FMath::Abs(Unpacked[Index].Component(Channel) - Expected.Component(Channel)) <= Tolerance * FMath::Max(Expected.Component(Channel), 1.f);
+		}
+
+		TestTrue(FString::Printf(TEXT("Transport %d, image and texel unpacking agree"), (int32)Transport), bMatches);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutHdrPackingThroughputTest, "Spout2.HdrPacking.Throughput", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutHdrPackingThroughputTest::RunTest(const FString& Parameters)
+{
+	const int32 NumPixels = 1920 * 1080;
+	const int32 NumFrames = 4;
+
+	FRandomStream Random(1234);
+
+	TArray<FLinearColor> Pixels, Unpacked;
+	Pixels.SetNumUninitialized(NumPixels);
+	Unpacked.SetNumUninitialized(NumPixels);
+
+	for (FLinearColor& Pixel : Pixels)
+		Pixel = FLinearColor(Random.FRandRange(0.f, 100.f), Random.FRandRange(0.f, 1.f), Random.FRandRange(0.f, 10.f), Random.FRand());
+
+	TArray<uint32> Packed;
+	Packed.SetNumUninitialized(NumPixels);
+
+	const ESpoutHdrTransport Transports[] = { ESpoutHdrTransport::PQ10, ESpoutHdrTransport::Log10, ESpoutHdrTransport::Float11 };
+	for (ESpoutHdrTransport Transport : Transports)
+	{
+		SpoutHdrPacking::PackImage(Pixels.GetData(), Packed.GetData(), NumPixels, Transport);
+
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			for (int32 Index = 0; Index < NumPixels; ++Index)
+				Unpacked[Index] = SpoutHdrPacking::UnpackTexel(Packed[Index], Transport);
+		}
+		const double TexelMegapixelsPerSecond = (double)NumPixels * NumFrames / (FPlatformTime::Seconds() - StartTime) / 1e6;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			SpoutHdrPacking::UnpackImage(Packed.GetData(), Unpacked.GetData(), NumPixels, Transport);
+		const double ImageMegapixelsPerSecond = (double)NumPixels * NumFrames / (FPlatformTime::Seconds() - StartTime) / 1e6;
+
+		AddInfo(FString::Printf(TEXT("Transport %d: %.0f Mpixel/s unpacked per image, %.0f per texel"), (int32)Transport, ImageMegapixelsPerSecond, TexelMegapixelsPerSecond));
+
+		// several times the texel loop in optimized builds; slower than it means the image path stopped vectorizing
+		TestTrue(FString::Printf(TEXT("Transport %d, the image path keeps up with the texel loop"), (int32)Transport), ImageMegapixelsPerSecond >= TexelMegapixelsPerSecond * 0.75);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutHdrPackingUsageTagTest, "Spout2.HdrPacking.UsageTag", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutHdrPackingUsageTagTest::RunTest(const FString& Parameters)
+{
+	const ESpoutHdrTransport Transports[] = { ESpoutHdrTransport::None, ESpoutHdrTransport::PQ10, ESpoutHdrTransport::Log10, ESpoutHdrTransport::Float11 };
+	for (ESpoutHdrTransport Transport : Transports)
+		TestTrue(FString::Printf(TEXT("Transport %d survives its tag"), (int32)Transport), SpoutHdrPacking::FromUsageTag(SpoutHdrPacking::GetUsageTag(Transport)) == Transport);
+
+	TestEqual(TEXT("Plain senders have no tag"), SpoutHdrPacking::GetUsageTag(ESpoutHdrTransport::None), 0u);
+	TestTrue(TEXT("Foreign usage flags are no transport"), SpoutHdrPacking::FromUsageTag(0x00000008) == ESpoutHdrTransport::None);
+	TestTrue(TEXT("Unknown transports are none"), SpoutHdrPacking::FromUsageTag(SpoutHdrPacking::GetUsageTag(ESpoutHdrTransport::Float11) + 1) == ESpoutHdrTransport::None);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,272 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "SpoutImageScaler.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutImageScalerTest
+{
+	static TArray<FLinearColor> MakeNoise(int32 Width, int32 Height, int32 Seed)
+	{
+		FRandomStream Random(Seed);
+
+		TArray<FLinearColor> Image;
+		for (int32 Index = 0; Index < Width * Height; ++Index)
+			Image.Add(FLinearColor(Random.FRand(), Random.FRand(), Random.FRand(), Random.FRand()));
+
+		return Image;
+	}
+
+	static float MaxDifference(const TArray<FLinearColor>& A, const TArray<FLinearColor>& B)
+	{
+		float Max = 0.f;
+		for (int32 Index = 0; Index < A.Num(); ++Index)
+		{
+			for (int32 Channel = 0; Channel < 4; ++Channel)
+				Max = FMath::Max(Max, FMath::Abs(A[Index].Component(Channel) - B[Index].Component(Channel)));
+		}
+
+		return Max;
+	}
+
+	/** SampleSource of SpoutReceiverCopyShader.usf as written: a 2D loop over the taps, lerps for bilinear. */
+	static FLinearColor SampleLikeShader(const TArray<FLinearColor>& Src, int32 Width, int32 Height, float U, float V, const FVector2D& FilterScale, ESpoutScaleFilter Filter)
+	{
+		auto LoadClamped = [&](int32 x, int32 y) {
+			return Src[FMath::Clamp(y, 0, Height - 1) * Width + FMath::Clamp(x, 0, Width - 1)];
+		};
+
+		const float PositionX = U * Width;
+		const float PositionY = V * Height;
+
+		if (Filter == ESpoutScaleFilter::Point)
+			return LoadClamped(FMath::FloorToInt(PositionX), FMath::FloorToInt(PositionY));
+
+		if (Filter == ESpoutScaleFilter::Bilinear)
+		{
+			const float TX = PositionX - 0.5f, TY = PositionY - 0.5f;
+			const int32 IX = FMath::FloorToInt(TX), IY = FMath::FloorToInt(TY);
+			const float FX = TX - IX, FY = TY - IY;
+
+			return FMath::Lerp(
+				FMath::Lerp(LoadClamped(IX, IY), LoadClamped(IX + 1, IY), FX),
+				FMath::Lerp(LoadClamped(IX, IY + 1), LoadClamped(IX + 1, IY + 1), FX),
+				FY);
+		}
+
+		const bool bBox = Filter == ESpoutScaleFilter::Box;
+		const float ScaleX = bBox ? FMath::Clamp((float)FilterScale.X, 1.f, 31.f) : FMath::Clamp((float)FilterScale.X, 1.f, 31.f / 4.f);
+		const float ScaleY = bBox ? FMath::Clamp((float)FilterScale.Y, 1.f, 31.f) : FMath::Clamp((float)FilterScale.Y, 1.f, 31.f / 4.f);
+		const float RadiusX = (bBox ? 0.5f : 2.f) * ScaleX;
+		const float RadiusY = (bBox ? 0.5f : 2.f) * ScaleY;
+
+		const int32 FirstX = FMath::FloorToInt(PositionX - RadiusX), FirstY = FMath::FloorToInt(PositionY - RadiusY);
+		const int32 LastX = FMath::Min(FMath::CeilToInt(PositionX + RadiusX) - 1, FirstX + 31);
+		const int32 LastY = FMath::Min(FMath::CeilToInt(PositionY + RadiusY) - 1, FirstY + 31);
+
+		FLinearColor Sum(0.f, 0.f, 0.f, 0.f);
+		float WeightSum = 0.f;
+
+		for (int32 y = FirstY; y <= LastY; ++y)
+		{
+			const float WeightY = SpoutImageScaler::AxisWeight(Filter, y, PositionY, ScaleY);
+
+			for (int32 x = FirstX; x <= LastX; ++x)
+			{
+				const float Weight = SpoutImageScaler::AxisWeight(Filter, x, PositionX, ScaleX) * WeightY;
+				Sum += LoadClamped(x, y) * Weight;
+				WeightSum += Weight;
+			}
+		}
+
+		return WeightSum != 0.f ? Sum / WeightSum : FLinearColor(0.f, 0.f, 0.f, 0.f);
+	}
+
+	/** The shader's pixel loop over a whole destination. */
+	static TArray<FLinearColor> ScaleLikeShader(const TArray<FLinearColor>& Src, int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, ESpoutScaleFilter Filter, ESpoutScaleMode Mode)
+	{
+		const FVector4 UVScaleBias = SpoutImageScaler::ComputeUVScaleBias(SrcWidth, SrcHeight, DstWidth, DstHeight, Mode);
+		const FVector2D FilterScale = SpoutImageScaler::ComputeFilterScale(SrcWidth, SrcHeight, DstWidth, DstHeight, UVScaleBias);
+
+		TArray<FLinearColor> Dst;
+		for (int32 y = 0; y < DstHeight; ++y)
+		{
+			for (int32 x = 0; x < DstWidth; ++x)
+			{
+				const float U = ((x + 0.5f) / DstWidth) * (float)UVScaleBias.X + (float)UVScaleBias.Z;
+				const float V = ((y + 0.5f) / DstHeight) * (float)UVScaleBias.Y + (float)UVScaleBias.W;
+
+				const bool bOutside = U < 0.f || U > 1.f || V < 0.f || V > 1.f;
+				Dst.Add(bOutside ? FLinearColor(0.f, 0.f, 0.f, 0.f) : SampleLikeShader(Src, SrcWidth, SrcHeight, U, V, FilterScale, Filter));
+			}
+		}
+
+		return Dst;
+	}
+
+	static TArray<FLinearColor> Scale(const TArray<FLinearColor>& Src, int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, ESpoutScaleFilter Filter, ESpoutScaleMode Mode = ESpoutScaleMode::Stretch)
+	{
+		TArray<FLinearColor> Dst;
+		Dst.SetNumUninitialized(DstWidth * DstHeight);
+		SpoutImageScaler::ScaleImage(Src.GetData(), SrcWidth, SrcHeight, Dst.GetData(), DstWidth, DstHeight, Filter, Mode);
+		return Dst;
+	}
+
+	static const ESpoutScaleFilter Filters[] = { ESpoutScaleFilter::Point, ESpoutScaleFilter::Bilinear, ESpoutScaleFilter::Box, ESpoutScaleFilter::Lanczos };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutImageScalerScaleBiasTest, "Spout2.ImageScaler.ScaleBias", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutImageScalerScaleBiasTest::RunTest(const FString& Parameters)
+{
+	const FVector4 Identity(1.f, 1.f, 0.f, 0.f);
+
+	TestEqual(TEXT("Stretch maps UVs unchanged"), SpoutImageScaler::ComputeUVScaleBias(200, 100, 100, 100, ESpoutScaleMode::Stretch), Identity);
+	TestEqual(TEXT("Same aspect maps UVs unchanged"), SpoutImageScaler::ComputeUVScaleBias(1920, 1080, 1280, 720, ESpoutScaleMode::Fit), Identity);
+	TestEqual(TEXT("Empty sizes map UVs unchanged"), SpoutImageScaler::ComputeUVScaleBias(0, 100, 100, 100, ESpoutScaleMode::Fill), Identity);
+
+	// a wide source in a square: letterboxed into the middle half of the rows
+	const FVector4 WideFit = SpoutImageScaler::ComputeUVScaleBias(200, 100, 100, 100, ESpoutScaleMode::Fit);
+	TestEqual(TEXT("Fit, wide source"), WideFit, FVector4(1.f, 2.f, 0.f, -0.5f));
+	TestEqual(TEXT("Fit, first source row at a quarter"), 0.25f * WideFit.Y + WideFit.W, 0.f);
+	TestEqual(TEXT("Fit, last source row at three quarters"), 0.75f * WideFit.Y + WideFit.W, 1.f);
+
+	const FVector4 TallFit = SpoutImageScaler::ComputeUVScaleBias(100, 200, 100, 100, ESpoutScaleMode::Fit);
+	TestEqual(TEXT("Fit, tall source"), TallFit, FVector4(2.f, 1.f, -0.5f, 0.f));
+
+	// a wide source in a square: the middle half of the columns fills it
+	TestEqual(TEXT("Fill, wide source"), SpoutImageScaler::ComputeUVScaleBias(200, 100, 100, 100, ESpoutScaleMode::Fill), FVector4(0.5f, 1.f, 0.25f, 0.f));
+	TestEqual(TEXT("Fill, tall source"), SpoutImageScaler::ComputeUVScaleBias(100, 200, 100, 100, ESpoutScaleMode::Fill), FVector4(1.f, 0.5f, 0.f, 0.25f));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutImageScalerFilterScaleTest, "Spout2.ImageScaler.FilterScale", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutImageScalerFilterScaleTest::RunTest(const FString& Parameters)
+{
+	const FVector4 Identity(1.f, 1.f, 0.f, 0.f);
+
+	TestEqual(TEXT("Quarter size downscale"), SpoutImageScaler::ComputeFilterScale(400, 200, 100, 50, Identity), FVector2D(4.f, 4.f));
+	TestEqual(TEXT("Upscale"), SpoutImageScaler::ComputeFilterScale(100, 100, 400, 200, Identity), FVector2D(0.25f, 0.5f));
+
+	// only the cropped part of the source is spread over the output
+	const FVector4 Fill = SpoutImageScaler::ComputeUVScaleBias(400, 100, 100, 100, ESpoutScaleMode::Fill);
+	TestEqual(TEXT("Fill crops before scaling"), SpoutImageScaler::ComputeFilterScale(400, 100, 100, 100, Fill), FVector2D(1.f, 1.f));
+
+	TestEqual(TEXT("Empty output"), SpoutImageScaler::ComputeFilterScale(400, 100, 0, 0, Identity), FVector2D(1.f, 1.f));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutImageScalerKernelsTest, "Spout2.ImageScaler.Kernels", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutImageScalerKernelsTest::RunTest(const FString& Parameters)
+{
+	// the lerp weights of the shader's bilinear tap
+	TestTrue(TEXT("Bilinear, nearer texel"), FMath::IsNearlyEqual(SpoutImageScaler::AxisWeight(ESpoutScaleFilter::Bilinear, 2, 2.75f, 1.f), 0.75f, 1e-6f));
+	TestTrue(TEXT("Bilinear, farther texel"), FMath::IsNearlyEqual(SpoutImageScaler::AxisWeight(ESpoutScaleFilter::Bilinear, 3, 2.75f, 1.f), 0.25f, 1e-6f));
+	TestEqual(TEXT("Bilinear, out of reach"), SpoutImageScaler::AxisWeight(ESpoutScaleFilter::Bilinear, 4, 2.75f, 1.f), 0.f);
+
+	// box weights are the overlap of the texel with the footprint
+	TestTrue(TEXT("Box, covered texel"), FMath::IsNearlyEqual(SpoutImageScaler::AxisWeight(ESpoutScaleFilter::Box, 5, 6.f, 4.f), 1.f, 1e-6f));
+	TestTrue(TEXT("Box, partly covered texel"), FMath::IsNearlyEqual(SpoutImageScaler::AxisWeight(ESpoutScaleFilter::Box, 3, 6.5f, 4.f), 0.5f, 1e-6f));
+
+	TestTrue(TEXT("Lanczos, centre"), FMath::IsNearlyEqual(SpoutImageScaler::AxisWeight(ESpoutScaleFilter::Lanczos, 4, 4.5f, 1.f), 1.f, 1e-6f));
+	TestTrue(TEXT("Lanczos, zero crossing"), FMath::Abs(SpoutImageScaler::AxisWeight(ESpoutScaleFilter::Lanczos, 5, 4.5f, 1.f)) < 1e-6f);
+	TestTrue(TEXT("Lanczos, negative lobe"), SpoutImageScaler::AxisWeight(ESpoutScaleFilter::Lanczos, 6, 4.f, 1.f) < 0.f);
+	TestTrue(TEXT("Lanczos, symmetric"), FMath::IsNearlyEqual(SpoutImageScaler::AxisWeight(ESpoutScaleFilter::Lanczos, 2, 4.f, 1.5f), SpoutImageScaler::AxisWeight(ESpoutScaleFilter::Lanczos, 5, 4.f, 1.5f), 1e-6f));
+
+	// the shader's clamps keep every kernel within its taps
+	float Scale, Radius;
+	SpoutImageScaler::GetKernelExtent(ESpoutScaleFilter::Box, 100.f, Scale, Radius);
+	TestTrue(TEXT("Box radius fits the taps"), 2.f * Radius <= SpoutImageScaler::MaxTaps - 1);
+	SpoutImageScaler::GetKernelExtent(ESpoutScaleFilter::Lanczos, 100.f, Scale, Radius);
+	TestTrue(TEXT("Lanczos radius fits the taps"), 2.f * Radius <= SpoutImageScaler::MaxTaps - 1);
+	SpoutImageScaler::GetKernelExtent(ESpoutScaleFilter::Lanczos, 0.25f, Scale, Radius);
+	TestEqual(TEXT("Upscales filter at the source resolution"), Scale, 1.f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutImageScalerAccuracyTest, "Spout2.ImageScaler.Accuracy", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutImageScalerAccuracyTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutImageScalerTest;
+
+	const TArray<FLinearColor> Noise = MakeNoise(37, 23, 7);
+
+	// the separable, vectorized scaler against the shader's own loop, down, up and across aspect ratios
+	const FIntPoint Sizes[] = { FIntPoint(37, 23), FIntPoint(12, 7), FIntPoint(5, 19), FIntPoint(90, 61) };
+	const ESpoutScaleMode Modes[] = { ESpoutScaleMode::Stretch, ESpoutScaleMode::Fit, ESpoutScaleMode::Fill };
+
+	for (ESpoutScaleFilter Filter : Filters)
+	{
+		for (ESpoutScaleMode Mode : Modes)
+		{
+			for (const FIntPoint& Size : Sizes)
+			{
+				const float Difference = MaxDifference(
+					Scale(Noise, 37, 23, Size.X, Size.Y, Filter, Mode),
+					ScaleLikeShader(Noise, 37, 23, Size.X, Size.Y, Filter, Mode));
+
+				TestTrue(FString::Printf(TEXT("Filter %d, mode %d, %dx%d, as the shader"), (int32)Filter, (int32)Mode, Size.X, Size.Y), Difference < 1e-5f);
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutImageScalerImagesTest, "Spout2.ImageScaler.Images", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutImageScalerImagesTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutImageScalerTest;
+
+	const TArray<FLinearColor> Noise = MakeNoise(32, 16, 11);
+
+	// normalized kernels keep a flat image flat, Lanczos lobes included
+	TArray<FLinearColor> Flat;
+	Flat.Init(FLinearColor(0.25f, 0.5f, 0.75f, 1.f), 32 * 16);
+
+	for (ESpoutScaleFilter Filter : Filters)
+	{
+		TArray<FLinearColor> Expected;
+		Expected.Init(Flat[0], 8 * 4);
+		TestTrue(FString::Printf(TEXT("Filter %d, flat downscale"), (int32)Filter), MaxDifference(Scale(Flat, 32, 16, 8, 4, Filter), Expected) < 1e-5f);
+
+		Expected.Init(Flat[0], 75 * 41);
+		TestTrue(FString::Printf(TEXT("Filter %d, flat upscale"), (int32)Filter), MaxDifference(Scale(Flat, 32, 16, 75, 41, Filter), Expected) < 1e-5f);
+
+		// the same size is a copy, Lanczos up to the float error of its zero crossings
+		TestTrue(FString::Printf(TEXT("Filter %d, same size"), (int32)Filter), MaxDifference(Scale(Noise, 32, 16, 32, 16, Filter), Noise) < 1e-5f);
+	}
+
+	// a box downscale by two averages each 2x2 block
+	const TArray<FLinearColor> Half = Scale(Noise, 32, 16, 16, 8, ESpoutScaleFilter::Box);
+	float Worst = 0.f;
+	for (int32 y = 0; y < 8; ++y)
+	{
+		for (int32 x = 0; x < 16; ++x)
+		{
+			const FLinearColor Average = (Noise[(2 * y) * 32 + 2 * x] + Noise[(2 * y) * 32 + 2 * x + 1] + Noise[(2 * y + 1) * 32 + 2 * x] + Noise[(2 * y + 1) * 32 + 2 * x + 1]) * 0.25f;
+			for (int32 Channel = 0; Channel < 4; ++Channel)
+				Worst = FMath::Max(Worst, FMath::Abs(Half[y * 16 + x].Component(Channel) - Average.Component(Channel)));
+		}
+	}
+	TestTrue(TEXT("Box, 2x2 averages"), Worst < 1e-5f);
+
+	// a wide source fit into a square leaves transparent bars above and below
+	const TArray<FLinearColor> Fit = Scale(Flat, 32, 16, 16, 16, ESpoutScaleFilter::Lanczos, ESpoutScaleMode::Fit);
+	TestTrue(TEXT("Fit, bar above"), Fit[0] == FLinearColor(0.f, 0.f, 0.f, 0.f) && Fit[3 * 16 + 8] == FLinearColor(0.f, 0.f, 0.f, 0.f));
+	TestTrue(TEXT("Fit, source in the middle"), FMath::IsNearlyEqual(Fit[8 * 16 + 8].G, 0.5f, 1e-5f));
+	TestTrue(TEXT("Fit, bar below"), Fit[15 * 16 + 15] == FLinearColor(0.f, 0.f, 0.f, 0.f));
+
+	return true;
+}
+
+#endif
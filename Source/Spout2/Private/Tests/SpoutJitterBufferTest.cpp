@@ -0,0 +1,194 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "SpoutJitterBuffer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutJitterBufferTest
+{
+	// frame id and publish time
+	typedef TArray<TPair<int64, double>> FTrace;
+
+	struct FResult
+	{
+		int32 Ticks = 0;
+		int32 Repeats = 0;
+		int32 Skips = 0;
+
+		// once the buffer filled
+		double MinLatency = MAX_dbl;
+		double MaxLatency = 0.0;
+	};
+
+	static FTrace MakeSteadyTrace(double FrameRate, int32 NumFrames)
+	{
+		FTrace Trace;
+		for (int64 FrameId = 1; FrameId <= NumFrames; ++FrameId)
+			Trace.Emplace(FrameId, FrameId / FrameRate);
+
+		return Trace;
+	}
+
+	/** A receiver ticking at DisplayRate, a quarter tick after the sender's cadence, sees every frame published by then. */
+	static FResult Simulate(const FTrace& Trace, ESpoutJitterPolicy Policy, double DisplayRate = 60.0, int32 Capacity = 3)
+	{
+		static constexpr int32 WarmUpTicks = 10;
+
+		FSpoutJitterBuffer Buffer;
+		Buffer.Reset(Capacity);
+
+		FResult Result;
+		int64 PreviousFrameId = 0;
+		int32 NextFrame = 0;
+
+		for (int32 Tick = 0;; ++Tick)
+		{
+			const double Now = Trace[0].Value + (Tick + 0.25) / DisplayRate;
+			if (Now > Trace.Last().Value)
+				break;
+
+			for (; NextFrame < Trace.Num() && Trace[NextFrame].Value <= Now; ++NextFrame)
+				Buffer.Push(Trace[NextFrame].Key, Trace[NextFrame].Value);
+
+			if (Buffer.Select(Policy, Now) == INDEX_NONE)
+				continue;
+
+			if (++Result.Ticks > WarmUpTicks)
+			{
+				Result.MinLatency = FMath::Min(Result.MinLatency, Buffer.GetLatency());
+				Result.MaxLatency = FMath::Max(Result.MaxLatency, Buffer.GetLatency());
+			}
+
+			const int64 FrameId = Buffer.GetSelectedFrameId();
+
+			if (FrameId == PreviousFrameId)
+				++Result.Repeats;
+			else if (PreviousFrameId != 0)
+				Result.Skips += (int32)(FrameId - PreviousFrameId - 1);
+
+			PreviousFrameId = FrameId;
+		}
+
+		return Result;
+	}
+
+	static bool IsBetween(double Value, double Min, double Max)
+	{
+		return Value >= Min - 1e-6 && Value <= Max + 1e-6;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutJitterBufferPushTest, "Spout2.JitterBuffer.Push", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutJitterBufferPushTest::RunTest(const FString& Parameters)
+{
+	FSpoutJitterBuffer Buffer;
+	TestEqual(TEXT("No slots, nothing buffered"), Buffer.Push(1, 0.0), (int32)INDEX_NONE);
+
+	Buffer.Reset(3);
+	TestEqual(TEXT("First frame"), Buffer.Push(1, 0.0), 0);
+	TestEqual(TEXT("Second frame"), Buffer.Push(2, 1.0 / 60.0), 1);
+	TestEqual(TEXT("A repeated frame"), Buffer.Push(2, 1.0 / 60.0), (int32)INDEX_NONE);
+	TestEqual(TEXT("An older frame"), Buffer.Push(1, 0.0), (int32)INDEX_NONE);
+	TestEqual(TEXT("Third frame"), Buffer.Push(3, 2.0 / 60.0), 2);
+	TestEqual(TEXT("Full, over the oldest"), Buffer.Push(4, 3.0 / 60.0), 0);
+	TestTrue(TEXT("Interval"), FMath::IsNearlyEqual(Buffer.GetFrameInterval(), 1.0 / 60.0, 1e-9));
+
+	// a frame the receiver missed does not stretch the interval
+	TestEqual(TEXT("Then over the next oldest"), Buffer.Push(6, 5.0 / 60.0), 1);
+	TestTrue(TEXT("Interval per frame id"), FMath::IsNearlyEqual(Buffer.GetFrameInterval(), 1.0 / 60.0, 1e-9));
+	TestTrue(TEXT("One interval per slot but the newest"), FMath::IsNearlyEqual(Buffer.GetTargetDelay(), 2.0 / 60.0, 1e-9));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutJitterBufferSelectTest, "Spout2.JitterBuffer.Select", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutJitterBufferSelectTest::RunTest(const FString& Parameters)
+{
+	FSpoutJitterBuffer Buffer;
+	Buffer.Reset(3);
+	TestEqual(TEXT("Nothing while empty"), Buffer.Select(ESpoutJitterPolicy::LowestLatency, 0.0), (int32)INDEX_NONE);
+
+	for (int64 FrameId = 1; FrameId <= 3; ++FrameId)
+		Buffer.Push(FrameId, (FrameId - 1) / 60.0);
+
+	// two intervals behind the newest
+	TestEqual(TEXT("Smooth cadence holds back"), Buffer.Select(ESpoutJitterPolicy::SmoothCadence, 2.0 / 60.0), 0);
+	TestEqual(TEXT("The oldest frame"), (int64)Buffer.GetSelectedFrameId(), (int64)1);
+	TestEqual(TEXT("Two newer frames buffered"), Buffer.GetOccupancy(), 2);
+	TestTrue(TEXT("Latency"), FMath::IsNearlyEqual(Buffer.GetLatency(), 2.0 / 60.0, 1e-9));
+
+	TestEqual(TEXT("Lowest latency takes the newest"), Buffer.Select(ESpoutJitterPolicy::LowestLatency, 2.0 / 60.0), 2);
+	TestEqual(TEXT("Nothing newer"), Buffer.GetOccupancy(), 0);
+	TestTrue(TEXT("No latency"), FMath::IsNearlyEqual(Buffer.GetLatency(), 0.0, 1e-9));
+
+	Buffer.Select(ESpoutJitterPolicy::SmoothCadence, 2.0 / 60.0);
+	TestEqual(TEXT("Never back to an older frame"), (int64)Buffer.GetSelectedFrameId(), (int64)3);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutJitterBufferPoliciesTest, "Spout2.JitterBuffer.Policies", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutJitterBufferPoliciesTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutJitterBufferTest;
+
+	const double Tick = 1.0 / 60.0;
+
+	// sender and display at 60: the buffered policies repeat their first frame while the other two slots fill
+	{
+		const FTrace Trace = MakeSteadyTrace(60.0, 60);
+
+		const FResult Lowest = Simulate(Trace, ESpoutJitterPolicy::LowestLatency);
+		TestTrue(TEXT("60 fps, lowest latency: every frame once"), Lowest.Repeats == 0 && Lowest.Skips == 0);
+		TestTrue(TEXT("60 fps, lowest latency: a quarter tick behind"), IsBetween(Lowest.MinLatency, Tick / 4, Tick / 4) && IsBetween(Lowest.MaxLatency, Tick / 4, Tick / 4));
+
+		for (ESpoutJitterPolicy Policy : { ESpoutJitterPolicy::SmoothCadence, ESpoutJitterPolicy::NearestTimestamp })
+		{
+			const FResult Result = Simulate(Trace, Policy);
+			TestTrue(TEXT("60 fps, buffered: repeats while filling, no skips"), Result.Repeats == 2 && Result.Skips == 0);
+			TestTrue(TEXT("60 fps, buffered: two intervals more"), IsBetween(Result.MinLatency, 2 * Tick + Tick / 4, 2 * Tick + Tick / 4) && IsBetween(Result.MaxLatency, 2 * Tick + Tick / 4, 2 * Tick + Tick / 4));
+		}
+	}
+
+	// a 30 fps sender on a 60 Hz display: each frame shows twice, the delay is two sender intervals
+	{
+		const FTrace Trace = MakeSteadyTrace(30.0, 60);
+		const double Interval = 1.0 / 30.0;
+
+		const FResult Lowest = Simulate(Trace, ESpoutJitterPolicy::LowestLatency);
+		TestTrue(TEXT("30 fps, lowest latency: no skips"), Lowest.Skips == 0);
+		TestEqual(TEXT("30 fps, lowest latency: every frame twice"), Lowest.Repeats, Lowest.Ticks - 59);
+		TestTrue(TEXT("30 fps, lowest latency: within an interval"), IsBetween(Lowest.MinLatency, 0.0, Interval) && IsBetween(Lowest.MaxLatency, 0.0, Interval));
+
+		const FResult Smooth = Simulate(Trace, ESpoutJitterPolicy::SmoothCadence);
+		TestTrue(TEXT("30 fps, smooth cadence: no skips"), Smooth.Skips == 0);
+		TestTrue(TEXT("30 fps, smooth cadence: at least the delay, less than an interval more"), IsBetween(Smooth.MinLatency, 2 * Interval, 3 * Interval) && IsBetween(Smooth.MaxLatency, 2 * Interval, 3 * Interval));
+
+		const FResult Nearest = Simulate(Trace, ESpoutJitterPolicy::NearestTimestamp);
+		TestTrue(TEXT("30 fps, nearest timestamp: no skips"), Nearest.Skips == 0);
+		TestTrue(TEXT("30 fps, nearest timestamp: within half an interval of the delay"), IsBetween(Nearest.MinLatency, 1.5 * Interval, 2.5 * Interval) && IsBetween(Nearest.MaxLatency, 1.5 * Interval, 2.5 * Interval));
+	}
+
+	// one publish 12 ms late: shown at once it costs a repeat and a skip, the buffered policies absorb it
+	{
+		FTrace Trace = MakeSteadyTrace(60.0, 60);
+		Trace[29].Value += 0.012;
+
+		const FResult Lowest = Simulate(Trace, ESpoutJitterPolicy::LowestLatency);
+		TestTrue(TEXT("Late publish, lowest latency: one repeat, one skip"), Lowest.Repeats == 1 && Lowest.Skips == 1);
+
+		for (ESpoutJitterPolicy Policy : { ESpoutJitterPolicy::SmoothCadence, ESpoutJitterPolicy::NearestTimestamp })
+		{
+			const FResult Result = Simulate(Trace, Policy);
+			TestTrue(TEXT("Late publish, buffered: no repeats past filling, no skips"), Result.Repeats == 2 && Result.Skips == 0);
+		}
+	}
+
+	return true;
+}
+
+#endif
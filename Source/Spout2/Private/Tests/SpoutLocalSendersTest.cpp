@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "RenderUtils.h"
+#include "SpoutLocalSenders.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutLocalSendersTest
+{
+	// stand-ins for share handles, only compared
+	static void* const HandleA = (void*)(UPTRINT)0x1000;
+	static void* const HandleB = (void*)(UPTRINT)0x2000;
+
+	/** Any two distinct engine textures; null without an RHI. */
+	static bool GetTextures(FRHITexture2D*& OutFirst, FRHITexture2D*& OutSecond)
+	{
+		OutFirst = GWhiteTexture && GWhiteTexture->TextureRHI ? GWhiteTexture->TextureRHI->GetTexture2D() : nullptr;
+		OutSecond = GBlackTexture && GBlackTexture->TextureRHI ? GBlackTexture->TextureRHI->GetTexture2D() : nullptr;
+		return OutFirst && OutSecond && OutFirst != OutSecond;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutLocalSendersBypassTest, "Spout2.LocalSenders.Bypass", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutLocalSendersBypassTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutLocalSendersTest;
+
+	FRHITexture2D* TextureA = nullptr;
+	FRHITexture2D* TextureB = nullptr;
+	if (!TestTrue(TEXT("Engine textures"), GetTextures(TextureA, TextureB)))
+		return false;
+
+	// the process-wide instance serves running senders, the test keeps its own
+	FSpoutLocalSenders Senders;
+
+	TestFalse(TEXT("Nothing published"), Senders.Find(TEXT("Sender"), HandleA).IsValid());
+
+	Senders.Register(TEXT("Sender"), HandleA, TextureA);
+	TestTrue(TEXT("Drawn directly when the handle matches"), Senders.Find(TEXT("Sender"), HandleA) == TextureA);
+
+	// the registry's entry of that name belongs to another process
+	TestFalse(TEXT("Not for another handle"), Senders.Find(TEXT("Sender"), HandleB).IsValid());
+	TestFalse(TEXT("Nor another name"), Senders.Find(TEXT("Other"), HandleA).IsValid());
+	TestFalse(TEXT("Nor without a handle"), Senders.Find(TEXT("Sender"), nullptr).IsValid());
+
+	Senders.Register(TEXT("Nothing"), nullptr, TextureA);
+	Senders.Register(TEXT("Nothing"), HandleA, nullptr);
+	TestEqual(TEXT("Incomplete senders are not registered"), Senders.Num(), 1);
+
+	// the sender recreated its shared texture
+	Senders.Register(TEXT("Sender"), HandleB, TextureB);
+	TestTrue(TEXT("The new handle finds the new texture"), Senders.Find(TEXT("Sender"), HandleB) == TextureB);
+	TestFalse(TEXT("The old handle nothing"), Senders.Find(TEXT("Sender"), HandleA).IsValid());
+
+	// the old context is torn down after the new one registered
+	Senders.Unregister(TEXT("Sender"), HandleA);
+	TestTrue(TEXT("A stale unregister leaves the entry"), Senders.Find(TEXT("Sender"), HandleB) == TextureB);
+
+	Senders.Unregister(TEXT("Sender"), HandleB);
+	TestFalse(TEXT("Gone once its owner unregistered"), Senders.Find(TEXT("Sender"), HandleB).IsValid());
+	TestEqual(TEXT("Empty"), Senders.Num(), 0);
+
+	return true;
+}
+
+#endif
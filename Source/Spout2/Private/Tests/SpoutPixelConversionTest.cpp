@@ -0,0 +1,250 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "SpoutHdrPacking.h"
+#include "SpoutPixelConversion.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutPixelConversionTest
+{
+	static FSpoutConversionOptions MakeOptions(bool bSwizzle, ESpoutAlphaConversion Alpha, ESpoutColorConversion Color, bool bFlip = false)
+	{
+		FSpoutConversionOptions Options;
+		Options.bSwizzleRedBlue = bSwizzle;
+		Options.Alpha = Alpha;
+		Options.Color = Color;
+		Options.bFlipVertical = bFlip;
+		return Options;
+	}
+
+	static bool IsNear(const FLinearColor& A, const FLinearColor& B, float Tolerance = 1e-5f)
+	{
+		return FMath::IsNearlyEqual(A.R, B.R, Tolerance) && FMath::IsNearlyEqual(A.G, B.G, Tolerance)
+			&& FMath::IsNearlyEqual(A.B, B.B, Tolerance) && FMath::IsNearlyEqual(A.A, B.A, Tolerance);
+	}
+
+	/** A bilinear tap halfway between two texels, as the shader filters them. */
+	static FLinearColor FilterHalfway(const FLinearColor& A, const FLinearColor& B, const FSpoutConversionOptions& Options)
+	{
+		const FLinearColor DecodedA = SpoutPixelConversion::DecodeTexel(A, Options, ESpoutScaleFilter::Bilinear);
+		const FLinearColor DecodedB = SpoutPixelConversion::DecodeTexel(B, Options, ESpoutScaleFilter::Bilinear);
+
+		return SpoutPixelConversion::EncodeOutput((DecodedA + DecodedB) * 0.5f, Options, ESpoutScaleFilter::Bilinear);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutPixelConversionTransferTest, "Spout2.PixelConversion.TransferFunctions", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutPixelConversionTransferTest::RunTest(const FString& Parameters)
+{
+	TestTrue(TEXT("sRGB mid grey"), FMath::IsNearlyEqual(SpoutPixelConversion::SRGBToLinear(0.5f), 0.214041f, 1e-5f));
+	TestTrue(TEXT("Linear segment"), FMath::IsNearlyEqual(SpoutPixelConversion::SRGBToLinear(0.04f), 0.04f / 12.92f, 1e-7f));
+	TestEqual(TEXT("Black"), SpoutPixelConversion::LinearToSRGB(0.f), 0.f);
+	TestTrue(TEXT("White"), FMath::IsNearlyEqual(SpoutPixelConversion::LinearToSRGB(1.f), 1.f, 1e-6f));
+
+	// every 8-bit code survives a decode and encode, the conversion is exact at the output format
+	int32 Mismatches = 0;
+	for (int32 Code = 0; Code < 256; ++Code)
+	{
+		const float Linear = SpoutPixelConversion::SRGBToLinear(Code / 255.f);
+		Mismatches += SpoutPixelConversion::QuantizeUNorm8(SpoutPixelConversion::LinearToSRGB(Linear)) != Code ? 1 : 0;
+	}
+	TestEqual(TEXT("8-bit sRGB round trip"), Mismatches, 0);
+
+	TestEqual(TEXT("Quantize rounds to nearest"), (int32)SpoutPixelConversion::QuantizeUNorm8(127.6f / 255.f), 128);
+	TestEqual(TEXT("Quantize just below"), (int32)SpoutPixelConversion::QuantizeUNorm8(127.4f / 255.f), 127);
+	TestEqual(TEXT("Quantize clamps below"), (int32)SpoutPixelConversion::QuantizeUNorm8(-0.5f), 0);
+	TestEqual(TEXT("Quantize clamps above"), (int32)SpoutPixelConversion::QuantizeUNorm8(2.f), 255);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutPixelConversionPermutationsTest, "Spout2.PixelConversion.Permutations", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutPixelConversionPermutationsTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutPixelConversionTest;
+
+	const FLinearColor Texel(0.8f, 0.4f, 0.2f, 0.5f);
+
+	TestTrue(TEXT("Nothing"), IsNear(SpoutPixelConversion::ConvertTexel(Texel, MakeOptions(false, ESpoutAlphaConversion::None, ESpoutColorConversion::None)), Texel));
+	TestTrue(TEXT("Swizzle"), IsNear(SpoutPixelConversion::ConvertTexel(Texel, MakeOptions(true, ESpoutAlphaConversion::None, ESpoutColorConversion::None)), FLinearColor(0.2f, 0.4f, 0.8f, 0.5f)));
+	TestTrue(TEXT("Premultiply"), IsNear(SpoutPixelConversion::ConvertTexel(Texel, MakeOptions(false, ESpoutAlphaConversion::Premultiply, ESpoutColorConversion::None)), FLinearColor(0.4f, 0.2f, 0.1f, 0.5f)));
+	TestTrue(TEXT("Unpremultiply"), IsNear(SpoutPixelConversion::ConvertTexel(FLinearColor(0.4f, 0.2f, 0.1f, 0.5f), MakeOptions(false, ESpoutAlphaConversion::Unpremultiply, ESpoutColorConversion::None)), Texel));
+	TestTrue(TEXT("Unpremultiply transparent"), IsNear(SpoutPixelConversion::ConvertTexel(FLinearColor(0.4f, 0.2f, 0.1f, 0.f), MakeOptions(false, ESpoutAlphaConversion::Unpremultiply, ESpoutColorConversion::None)), FLinearColor(0.f, 0.f, 0.f, 0.f)));
+
+	// alpha is never color converted
+	const FLinearColor Decoded = SpoutPixelConversion::ConvertTexel(Texel, MakeOptions(false, ESpoutAlphaConversion::None, ESpoutColorConversion::SRGBToLinear));
+	TestTrue(TEXT("sRGB to linear"), IsNear(Decoded, FLinearColor(SpoutPixelConversion::SRGBToLinear(0.8f), SpoutPixelConversion::SRGBToLinear(0.4f), SpoutPixelConversion::SRGBToLinear(0.2f), 0.5f)));
+	TestTrue(TEXT("Linear to sRGB"), IsNear(SpoutPixelConversion::ConvertTexel(Decoded, MakeOptions(false, ESpoutAlphaConversion::None, ESpoutColorConversion::LinearToSRGB)), Texel));
+
+	// swizzle, decode, then premultiply the linear value, as the shader orders them
+	const FLinearColor All = SpoutPixelConversion::ConvertTexel(Texel, MakeOptions(true, ESpoutAlphaConversion::Premultiply, ESpoutColorConversion::SRGBToLinear));
+	TestTrue(TEXT("Swizzle, sRGB decode, premultiply"), IsNear(All, FLinearColor(SpoutPixelConversion::SRGBToLinear(0.2f) * 0.5f, SpoutPixelConversion::SRGBToLinear(0.4f) * 0.5f, SpoutPixelConversion::SRGBToLinear(0.8f) * 0.5f, 0.5f)));
+
+	// unpremultiply before encoding, the encode sees straight linear color
+	const FLinearColor Encoded = SpoutPixelConversion::ConvertTexel(FLinearColor(0.1f, 0.2f, 0.3f, 0.5f), MakeOptions(false, ESpoutAlphaConversion::Unpremultiply, ESpoutColorConversion::LinearToSRGB));
+	TestTrue(TEXT("Unpremultiply, sRGB encode"), IsNear(Encoded, FLinearColor(SpoutPixelConversion::LinearToSRGB(0.2f), SpoutPixelConversion::LinearToSRGB(0.4f), SpoutPixelConversion::LinearToSRGB(0.6f), 0.5f)));
+	TestTrue(TEXT("Negative values encode as black"), SpoutPixelConversion::ConvertTexel(FLinearColor(-1.f, 0.f, 0.f, 1.f), MakeOptions(false, ESpoutAlphaConversion::None, ESpoutColorConversion::LinearToSRGB)).R == 0.f);
+
+	// HDR transports decode before everything else and are already linear
+	const FLinearColor PQ(SpoutHdrPacking::EncodePQ(2.f), SpoutHdrPacking::EncodePQ(0.5f), SpoutHdrPacking::EncodePQ(10.f), 1.f);
+	const FLinearColor FromPQ = SpoutPixelConversion::ConvertTexel(PQ, MakeOptions(true, ESpoutAlphaConversion::None, ESpoutColorConversion::SRGBToLinear), ESpoutHdrTransport::PQ10);
+	TestTrue(TEXT("PQ decoded, swizzled, not sRGB decoded"), IsNear(FromPQ, FLinearColor(10.f, 0.5f, 2.f, 1.f), 1e-3f));
+
+	const FLinearColor Log(SpoutHdrPacking::EncodeLog(4.f), SpoutHdrPacking::EncodeLog(0.25f), 0.f, 0.25f);
+	const FLinearColor FromLog = SpoutPixelConversion::ConvertTexel(Log, MakeOptions(false, ESpoutAlphaConversion::Premultiply, ESpoutColorConversion::None), ESpoutHdrTransport::Log10);
+	TestTrue(TEXT("Log decoded, then premultiplied"), IsNear(FromLog, FLinearColor(1.f, 0.0625f, 0.f, 0.25f), 1e-4f));
+
+	// every permutation leaves opaque alpha alone and is exact on 8-bit black and white
+	for (int32 Swizzle = 0; Swizzle < 2; ++Swizzle)
+	{
+		for (int32 Alpha = 0; Alpha < 3; ++Alpha)
+		{
+			for (int32 Color = 0; Color < 3; ++Color)
+			{
+				const FSpoutConversionOptions Options = MakeOptions(Swizzle != 0, (ESpoutAlphaConversion)Alpha, (ESpoutColorConversion)Color);
+				const FString What = FString::Printf(TEXT("Swizzle %d, alpha %d, color %d"), Swizzle, Alpha, Color);
+
+				FColor Pixels[2] = { FColor(0, 0, 0, 255), FColor(255, 255, 255, 255) };
+				SpoutPixelConversion::ConvertImage(Pixels, Pixels, 2, 1, Options);
+
+				TestTrue(What + TEXT(", black"), Pixels[0] == FColor(0, 0, 0, 255));
+				TestTrue(What + TEXT(", white"), Pixels[1] == FColor(255, 255, 255, 255));
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutPixelConversionImageTest, "Spout2.PixelConversion.Image", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutPixelConversionImageTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutPixelConversionTest;
+
+	// 2x3, each row its own color
+	const FColor Src[6] = {
+		FColor(10, 20, 30, 255), FColor(10, 20, 30, 255),
+		FColor(40, 50, 60, 128), FColor(40, 50, 60, 128),
+		FColor(70, 80, 90, 0), FColor(70, 80, 90, 0) };
+	FColor Dst[6];
+
+	SpoutPixelConversion::ConvertImage(Src, Dst, 2, 3, MakeOptions(false, ESpoutAlphaConversion::None, ESpoutColorConversion::None, true));
+	TestTrue(TEXT("Flip, first row from the last"), Dst[0] == Src[4] && Dst[1] == Src[5]);
+	TestTrue(TEXT("Flip, middle row stays"), Dst[2] == Src[2] && Dst[3] == Src[3]);
+	TestTrue(TEXT("Flip, last row from the first"), Dst[4] == Src[0] && Dst[5] == Src[1]);
+
+	SpoutPixelConversion::ConvertImage(Src, Dst, 2, 3, MakeOptions(true, ESpoutAlphaConversion::Premultiply, ESpoutColorConversion::None, true));
+	TestTrue(TEXT("Flip and swizzle, transparent row premultiplied to black"), Dst[0] == FColor(0, 0, 0, 0));
+	TestTrue(TEXT("Flip and swizzle, half alpha"), Dst[2] == FColor(SpoutPixelConversion::QuantizeUNorm8((60 / 255.f) * (128 / 255.f)), SpoutPixelConversion::QuantizeUNorm8((50 / 255.f) * (128 / 255.f)), SpoutPixelConversion::QuantizeUNorm8((40 / 255.f) * (128 / 255.f)), 128));
+	TestTrue(TEXT("Flip and swizzle, opaque row"), Dst[4] == FColor(30, 20, 10, 255));
+
+	// in place without flipping
+	FColor InPlace[6];
+	FMemory::Memcpy(InPlace, Src, sizeof(Src));
+	SpoutPixelConversion::ConvertImage(InPlace, InPlace, 2, 3, MakeOptions(true, ESpoutAlphaConversion::None, ESpoutColorConversion::None));
+	TestTrue(TEXT("In place swizzle"), InPlace[2] == FColor(60, 50, 40, 128));
+
+	// the float variant agrees with the 8-bit one once quantized
+	FLinearColor LinearSrc[6], LinearDst[6];
+	for (int32 Index = 0; Index < 6; ++Index)
+		LinearSrc[Index] = FLinearColor(Src[Index].R / 255.f, Src[Index].G / 255.f, Src[Index].B / 255.f, Src[Index].A / 255.f);
+
+	const FSpoutConversionOptions Options = MakeOptions(true, ESpoutAlphaConversion::Premultiply, ESpoutColorConversion::SRGBToLinear, true);
+	SpoutPixelConversion::ConvertImage(LinearSrc, LinearDst, 2, 3, Options);
+	SpoutPixelConversion::ConvertImage(Src, Dst, 2, 3, Options);
+
+	int32 Mismatches = 0;
+	for (int32 Index = 0; Index < 6; ++Index)
+	{
+		const FColor Quantized(SpoutPixelConversion::QuantizeUNorm8(LinearDst[Index].R), SpoutPixelConversion::QuantizeUNorm8(LinearDst[Index].G), SpoutPixelConversion::QuantizeUNorm8(LinearDst[Index].B), SpoutPixelConversion::QuantizeUNorm8(LinearDst[Index].A));
+		Mismatches += Quantized != Dst[Index] ? 1 : 0;
+	}
+	TestEqual(TEXT("Float and 8-bit agree"), Mismatches, 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutPixelConversionFilteredAlphaTest, "Spout2.PixelConversion.FilteredAlpha", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutPixelConversionFilteredAlphaTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutPixelConversionTest;
+
+	const FLinearColor OpaqueRed(1.f, 0.f, 0.f, 1.f);
+	const FLinearColor TransparentGreen(0.f, 1.f, 0.f, 0.f);
+
+	// straight alpha in and out: the edge stays red, the invisible green does not bleed in
+	const FSpoutConversionOptions Straight = MakeOptions(false, ESpoutAlphaConversion::None, ESpoutColorConversion::None);
+	TestTrue(TEXT("Filtered taps are premultiplied"), SpoutPixelConversion::PremultipliesTaps(Straight, ESpoutScaleFilter::Bilinear));
+	TestFalse(TEXT("Point copies are left alone"), SpoutPixelConversion::PremultipliesTaps(Straight, ESpoutScaleFilter::Point) || SpoutPixelConversion::UnpremultipliesOutput(Straight, ESpoutScaleFilter::Point));
+	TestTrue(TEXT("Straight edge, no bleed"), IsNear(FilterHalfway(OpaqueRed, TransparentGreen, Straight), FLinearColor(1.f, 0.f, 0.f, 0.5f)));
+
+	// straight in, premultiplied out
+	const FSpoutConversionOptions Premultiply = MakeOptions(false, ESpoutAlphaConversion::Premultiply, ESpoutColorConversion::None);
+	TestTrue(TEXT("Premultiplied edge"), IsNear(FilterHalfway(OpaqueRed, TransparentGreen, Premultiply), FLinearColor(0.5f, 0.f, 0.f, 0.5f)));
+
+	// premultiplied in, straight out: the source already carries no invisible color
+	const FSpoutConversionOptions Unpremultiply = MakeOptions(false, ESpoutAlphaConversion::Unpremultiply, ESpoutColorConversion::None);
+	TestFalse(TEXT("Premultiplied taps are not premultiplied again"), SpoutPixelConversion::PremultipliesTaps(Unpremultiply, ESpoutScaleFilter::Lanczos));
+	TestTrue(TEXT("Unpremultiplied edge"), IsNear(FilterHalfway(OpaqueRed, FLinearColor(0.f, 0.f, 0.f, 0.f), Unpremultiply), FLinearColor(1.f, 0.f, 0.f, 0.5f)));
+
+	// sRGB edges are averaged in linear and encoded once
+	const FSpoutConversionOptions Srgb = MakeOptions(false, ESpoutAlphaConversion::None, ESpoutColorConversion::SRGBToLinear);
+	const FLinearColor Grey = FilterHalfway(FLinearColor(1.f, 1.f, 1.f, 1.f), FLinearColor(0.f, 0.f, 0.f, 1.f), Srgb);
+	TestTrue(TEXT("Linear average of sRGB white and black"), FMath::IsNearlyEqual(Grey.G, 0.5f, 1e-5f));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutPixelConversionScaledImageTest, "Spout2.PixelConversion.ScaledImage", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutPixelConversionScaledImageTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutPixelConversionTest;
+
+	// unscaled and point sampled, the whole draw is the texel conversion
+	FRandomStream Random(3);
+	TArray<FColor> Src;
+	for (int32 Index = 0; Index < 16 * 8; ++Index)
+		Src.Add(FColor(Random.RandRange(0, 255), Random.RandRange(0, 255), Random.RandRange(0, 255), Random.RandRange(0, 255)));
+
+	const FSpoutConversionOptions Options = MakeOptions(true, ESpoutAlphaConversion::Premultiply, ESpoutColorConversion::SRGBToLinear, true);
+
+	TArray<FColor> Expected;
+	Expected.SetNumUninitialized(Src.Num());
+	SpoutPixelConversion::ConvertImage(Src.GetData(), Expected.GetData(), 16, 8, Options);
+
+	TArray<FLinearColor> Converted;
+	Converted.SetNumUninitialized(Src.Num());
+	SpoutPixelConversion::ConvertScaledImage(Src.GetData(), 16, 8, Converted.GetData(), 16, 8, Options, ESpoutScaleFilter::Point, ESpoutScaleMode::Stretch);
+
+	int32 Mismatches = 0;
+	for (int32 Index = 0; Index < Src.Num(); ++Index)
+	{
+		const FColor Quantized(SpoutPixelConversion::QuantizeUNorm8(Converted[Index].R), SpoutPixelConversion::QuantizeUNorm8(Converted[Index].G), SpoutPixelConversion::QuantizeUNorm8(Converted[Index].B), SpoutPixelConversion::QuantizeUNorm8(Converted[Index].A));
+		Mismatches += Quantized != Expected[Index] ? 1 : 0;
+	}
+	TestEqual(TEXT("Point copy, swizzled, decoded, premultiplied and flipped"), Mismatches, 0);
+
+	// an opaque red row over a transparent green one, boxed down to one straight alpha pixel
+	const FColor Edge[4] = { FColor(255, 0, 0, 255), FColor(255, 0, 0, 255), FColor(0, 255, 0, 0), FColor(0, 255, 0, 0) };
+	FLinearColor Boxed;
+	SpoutPixelConversion::ConvertScaledImage(Edge, 2, 2, &Boxed, 1, 1, MakeOptions(false, ESpoutAlphaConversion::None, ESpoutColorConversion::None), ESpoutScaleFilter::Box, ESpoutScaleMode::Stretch);
+	TestTrue(TEXT("Box, straight alpha edge stays red"), IsNear(Boxed, FLinearColor(1.f, 0.f, 0.f, 0.5f)));
+
+	// the flip applies to the output, after scaling
+	const FColor Column[2] = { FColor(255, 0, 0, 255), FColor(0, 0, 255, 255) };
+	FLinearColor Flipped[4];
+	SpoutPixelConversion::ConvertScaledImage(Column, 1, 2, Flipped, 1, 4, MakeOptions(false, ESpoutAlphaConversion::None, ESpoutColorConversion::None, true), ESpoutScaleFilter::Point, ESpoutScaleMode::Stretch);
+	TestTrue(TEXT("Flipped, the bottom row on top"), IsNear(Flipped[0], FLinearColor(0.f, 0.f, 1.f, 1.f)) && IsNear(Flipped[1], FLinearColor(0.f, 0.f, 1.f, 1.f)));
+	TestTrue(TEXT("Flipped, the top row at the bottom"), IsNear(Flipped[3], FLinearColor(1.f, 0.f, 0.f, 1.f)));
+
+	return true;
+}
+
+#endif
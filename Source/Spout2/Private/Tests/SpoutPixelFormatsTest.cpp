@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "SpoutPixelFormats.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutPixelFormatsLookupTest, "Spout2.PixelFormats.Lookup", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutPixelFormatsLookupTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutPixelFormats;
+
+	for (const FInfo& Info : Table)
+	{
+		const FString What = FString::Printf(TEXT("DXGI format %u"), Info.DxgiFormat);
+
+		TestTrue(What + TEXT(" is found"), Find(Info.DxgiFormat) == &Info);
+		TestTrue(What + TEXT(" is receivable"), ToPixelFormat(Info.DxgiFormat) == Info.PixelFormat && Info.PixelFormat != PF_Unknown);
+		TestTrue(What + TEXT(" has its cost"), GetConversionCost(Info.DxgiFormat) == Info.Cost);
+		TestEqual(What + TEXT(" bytes per pixel"), (int32)GetBytesPerPixel(Info.DxgiFormat), (int32)Info.BytesPerPixel);
+
+		// shared textures are never created typeless
+		const uint32 Shareable = ToShareableFormat(Info.DxgiFormat);
+		TestTrue(What + TEXT(" shares as a typed member of its group"), Find(Shareable) && Find(Shareable)->TypedFormat == Shareable);
+		TestTrue(What + TEXT(" shares within its group"), AreCopyCompatible(Info.DxgiFormat, Shareable));
+
+		// the engine creates every receivable format as a direct copy row
+		const uint32 EngineFormat = FromPixelFormat(Info.PixelFormat);
+		TestTrue(What + TEXT(" engine format is a direct copy"), EngineFormat != DXGI_Unknown && Find(EngineFormat)->bDirectCopy);
+		TestTrue(What + TEXT(" copies directly into the engine format exactly when its cost is none"), AreCopyCompatible(Info.DxgiFormat, EngineFormat) == (Info.Cost == EConversionCost::None));
+	}
+
+	TestTrue(TEXT("Unknown formats"), Find(DXGI_Unknown) == nullptr && Find(1000) == nullptr);
+	TestTrue(TEXT("Are not receivable"), ToPixelFormat(1000) == PF_Unknown && GetConversionCost(1000) == EConversionCost::Unsupported);
+	TestEqual(TEXT("Are not shareable"), (int32)ToShareableFormat(1000), (int32)DXGI_Unknown);
+	TestEqual(TEXT("Have no size"), (int32)GetBytesPerPixel(1000), 0);
+	TestEqual(TEXT("No engine format"), (int32)FromPixelFormat(PF_DXT1), (int32)DXGI_Unknown);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutPixelFormatsCopyTest, "Spout2.PixelFormats.Copy", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutPixelFormatsCopyTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutPixelFormats;
+
+	TestTrue(TEXT("Typeless and typed members copy"), AreCopyCompatible(DXGI_B8G8R8A8_Typeless, DXGI_B8G8R8A8_UNorm));
+	TestTrue(TEXT("Linear and sRGB members copy"), AreCopyCompatible(DXGI_R8G8B8A8_UNorm_SRGB, DXGI_R8G8B8A8_UNorm));
+	TestFalse(TEXT("Swizzled formats do not"), AreCopyCompatible(DXGI_R8G8B8A8_UNorm, DXGI_B8G8R8A8_UNorm));
+	TestFalse(TEXT("Nor X8 into A8"), AreCopyCompatible(DXGI_B8G8R8X8_UNorm, DXGI_B8G8R8A8_UNorm));
+	TestFalse(TEXT("Nor unknown formats"), AreCopyCompatible(1000, 1000));
+
+	for (const FInfo& Info : Table)
+	{
+		if (Info.SRGBPairFormat == DXGI_Unknown)
+			continue;
+
+		const FInfo* Pair = Find(Info.SRGBPairFormat);
+		const FString What = FString::Printf(TEXT("DXGI format %u"), Info.DxgiFormat);
+
+		TestTrue(What + TEXT(" sRGB pair points back"), Pair && Pair->SRGBPairFormat == Info.DxgiFormat);
+		TestTrue(What + TEXT(" sRGB pair differs in sRGB-ness"), Pair && Pair->bSRGB != Info.bSRGB);
+		TestTrue(What + TEXT(" sRGB pair copies"), AreCopyCompatible(Info.DxgiFormat, Info.SRGBPairFormat));
+	}
+
+	// X8 senders land in the engine's BGRA8 texture through a readback
+	for (uint32 Format : { (uint32)DXGI_B8G8R8X8_UNorm, (uint32)DXGI_B8G8R8X8_Typeless, (uint32)DXGI_B8G8R8X8_UNorm_SRGB })
+	{
+		const FString What = FString::Printf(TEXT("DXGI format %u"), Format);
+
+		TestTrue(What + TEXT(" is read back"), GetConversionCost(Format) == EConversionCost::Readback);
+		TestTrue(What + TEXT(" into BGRA8"), ToPixelFormat(Format) == PF_B8G8R8A8 && FromPixelFormat(PF_B8G8R8A8) == DXGI_B8G8R8A8_UNorm);
+		TestTrue(What + TEXT(" staged in its own group"), AreCopyCompatible(Format, ToShareableFormat(Format)));
+	}
+
+	return true;
+}
+
+#endif
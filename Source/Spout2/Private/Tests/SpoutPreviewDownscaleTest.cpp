@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "SpoutPreviewDownscale.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutPreviewDownscaleTest
+{
+	static TArray<FColor> MakeRandomImage(FRandomStream& Random, int32 Width, int32 Height)
+	{
+		TArray<FColor> Pixels;
+		Pixels.SetNumUninitialized(Width * Height);
+
+		for (FColor& Pixel : Pixels)
+			Pixel = FColor(Random.RandHelper(256), Random.RandHelper(256), Random.RandHelper(256), Random.RandHelper(256));
+
+		return Pixels;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutPreviewDownscaleSizeTest, "Spout2.PreviewDownscale.Size", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutPreviewDownscaleSizeTest::RunTest(const FString& Parameters)
+{
+	TestEqual(TEXT("Disabled"), SpoutPreviewDownscale::GetFactor(ESpoutPreviewScale::Disabled), 1);
+	TestEqual(TEXT("Quarter"), SpoutPreviewDownscale::GetFactor(ESpoutPreviewScale::Quarter), 4);
+	TestEqual(TEXT("Eighth"), SpoutPreviewDownscale::GetFactor(ESpoutPreviewScale::Eighth), 8);
+
+	TestEqual(TEXT("1080p, quarter"), SpoutPreviewDownscale::GetScaledSize(FIntPoint(1920, 1080), 4), FIntPoint(480, 270));
+	TestEqual(TEXT("1080p, eighth rounds up"), SpoutPreviewDownscale::GetScaledSize(FIntPoint(1920, 1080), 8), FIntPoint(240, 135));
+	TestEqual(TEXT("Odd sizes round up"), SpoutPreviewDownscale::GetScaledSize(FIntPoint(1921, 1081), 8), FIntPoint(241, 136));
+	TestEqual(TEXT("Never empty"), SpoutPreviewDownscale::GetScaledSize(FIntPoint(3, 1), 8), FIntPoint(1, 1));
+
+	TestEqual(TEXT("Preview name"), SpoutPreviewDownscale::MakePreviewName(TEXT("Stage")), FString(TEXT("Stage_Preview")));
+
+	// the halvings of the memory-share path land on the size of the GPU preview
+	FRandomStream Random(0x5350);
+
+	for (int32 Iteration = 0; Iteration < 32; ++Iteration)
+	{
+		const int32 Width = Random.RandRange(1, 67);
+		const int32 Height = Random.RandRange(1, 67);
+		const TArray<FColor> Pixels = SpoutPreviewDownscaleTest::MakeRandomImage(Random, Width, Height);
+
+		for (int32 Factor : { 1, 2, 4, 8 })
+		{
+			TArray<FColor> Out;
+			FIntPoint OutSize;
+			SpoutPreviewDownscale::Downscale(Pixels.GetData(), Width, Height, Factor, Out, OutSize);
+
+			const FIntPoint Expected = Factor > 1 ? SpoutPreviewDownscale::GetScaledSize(FIntPoint(Width, Height), Factor) : FIntPoint(Width, Height);
+			TestTrue(FString::Printf(TEXT("%dx%d by %d"), Width, Height, Factor), OutSize == Expected && Out.Num() == Expected.X * Expected.Y);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutPreviewDownscaleAverageTest, "Spout2.PreviewDownscale.Average", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutPreviewDownscaleAverageTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutPreviewDownscaleTest;
+
+	// rounded to nearest, odd edges repeat their last column
+	const FColor Row[] = { FColor(10, 0, 0, 255), FColor(21, 0, 0, 255), FColor(30, 0, 0, 255) };
+	FColor Half[2];
+	SpoutPreviewDownscale::HalveScalar(Row, 3, 1, Half);
+	TestEqual(TEXT("Pair"), (int32)Half[0].R, 16);
+	TestEqual(TEXT("Last column alone"), (int32)Half[1].R, 30);
+
+	// each halving rounds: a quarter averages 4x4 blocks in two steps
+	TArray<FColor> Block;
+	for (int32 Index = 0; Index < 16; ++Index)
+		Block.Add(FColor((uint8)(Index * 16), 0, 0, (uint8)(Index == 0 ? 1 : 0)));
+
+	TArray<FColor> Out;
+	FIntPoint OutSize;
+	SpoutPreviewDownscale::Downscale(Block.GetData(), 4, 4, 4, Out, OutSize);
+	TestEqual(TEXT("One texel"), OutSize, FIntPoint(1, 1));
+	TestEqual(TEXT("Block mean"), (int32)Out[0].R, 120);
+	TestEqual(TEXT("A single low bit rounds away"), (int32)Out[0].A, 0);
+
+	// the SIMD kernel matches the reference, including odd widths and the scalar tail
+	FRandomStream Random(0x5351);
+
+	for (int32 Iteration = 0; Iteration < 32; ++Iteration)
+	{
+		const int32 Width = Random.RandRange(1, 77);
+		const int32 Height = Random.RandRange(1, 9);
+		const TArray<FColor> Pixels = MakeRandomImage(Random, Width, Height);
+
+		const int32 HalfSize = ((Width + 1) / 2) * ((Height + 1) / 2);
+		TArray<FColor> Scalar, Simd;
+		Scalar.SetNumUninitialized(HalfSize);
+		Simd.SetNumUninitialized(HalfSize);
+
+		SpoutPreviewDownscale::HalveScalar(Pixels.GetData(), Width, Height, Scalar.GetData());
+		SpoutPreviewDownscale::Halve(Pixels.GetData(), Width, Height, Simd.GetData());
+
+		TestTrue(FString::Printf(TEXT("%dx%d halved"), Width, Height), Scalar == Simd);
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,129 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "SpoutResizePolicy.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutResizePolicyTest
+{
+	static constexpr int32 Format = 2;
+	static constexpr double Cooldown = 1.0;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutResizePolicyBucketTest, "Spout2.ResizePolicy.Bucket", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutResizePolicyBucketTest::RunTest(const FString& Parameters)
+{
+	TestEqual(TEXT("Nothing"), FSpoutResizePolicy::GetBucket(0), 0);
+	TestEqual(TEXT("Negative"), FSpoutResizePolicy::GetBucket(-5), 0);
+	TestEqual(TEXT("At least a step"), FSpoutResizePolicy::GetBucket(1), 64);
+	TestEqual(TEXT("A step exactly"), FSpoutResizePolicy::GetBucket(64), 64);
+	TestEqual(TEXT("Just over"), FSpoutResizePolicy::GetBucket(65), 128);
+	TestEqual(TEXT("Small sizes step by 64"), FSpoutResizePolicy::GetBucket(300), 320);
+	TestEqual(TEXT("An eighth of 1024"), FSpoutResizePolicy::GetBucket(700), 768);
+	TestEqual(TEXT("An eighth of 2048"), FSpoutResizePolicy::GetBucket(1080), 1280);
+	TestEqual(TEXT("A power of two"), FSpoutResizePolicy::GetBucket(2048), 2048);
+
+	// never under the value, never more than an eighth of the next power of two over it
+	for (int32 Value = 1; Value <= 8192; ++Value)
+	{
+		const int32 Bucket = FSpoutResizePolicy::GetBucket(Value);
+		const int32 Slack = FMath::Max<int32>(FSpoutResizePolicy::MinBucketStep, FMath::RoundUpToPowerOfTwo(Value) / 8);
+
+		if (!TestTrue(FString::Printf(TEXT("Bucket of %d"), Value), Bucket >= Value && Bucket - Value < Slack))
+			break;
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutResizePolicyGrowTest, "Spout2.ResizePolicy.Grow", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutResizePolicyGrowTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutResizePolicyTest;
+
+	FSpoutResizePolicy Policy;
+
+	TestTrue(TEXT("The first frame allocates"), Policy.Update(700, 300, Format, 0.0, Cooldown));
+	TestTrue(TEXT("In buckets"), Policy.GetAllocationSize() == FIntPoint(768, 320));
+
+	TestFalse(TEXT("A frame within the buckets"), Policy.Update(710, 290, Format, 0.1, Cooldown));
+
+	TestTrue(TEXT("Taller content grows at once"), Policy.Update(300, 1000, Format, 0.2, Cooldown));
+	TestTrue(TEXT("Keeping the wider axis"), Policy.GetAllocationSize() == FIntPoint(768, 1024));
+
+	TestTrue(TEXT("Another format reallocates"), Policy.Update(300, 1000, Format + 1, 0.3, Cooldown));
+	TestTrue(TEXT("From the content alone"), Policy.GetAllocationSize() == FIntPoint(320, 1024));
+
+	Policy.Reset();
+	TestTrue(TEXT("Reset forgets the allocation"), Policy.GetAllocationSize() == FIntPoint::ZeroValue);
+	TestTrue(TEXT("The next frame allocates"), Policy.Update(300, 1000, Format + 1, 0.4, Cooldown));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutResizePolicyShrinkTest, "Spout2.ResizePolicy.Shrink", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutResizePolicyShrinkTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutResizePolicyTest;
+
+	// smaller frames of several sizes: after the cooldown, the largest bucket each axis saw
+	{
+		FSpoutResizePolicy Policy;
+		Policy.Update(1000, 1000, Format, 0.0, Cooldown);
+
+		TestFalse(TEXT("Smaller, cooling down"), Policy.Update(500, 500, Format, 0.5, Cooldown));
+		TestFalse(TEXT("Wider, still cooling down"), Policy.Update(700, 300, Format, 0.9, Cooldown));
+		TestTrue(TEXT("Shrinks after the cooldown"), Policy.Update(300, 300, Format, 1.0, Cooldown));
+		TestTrue(TEXT("To the largest bucket per axis since the last full use"), Policy.GetAllocationSize() == FIntPoint(768, 512));
+
+		// the window restarts with the shrink
+		TestFalse(TEXT("Then cools down again"), Policy.Update(300, 300, Format, 1.5, Cooldown));
+		TestTrue(TEXT("And shrinks to what followed"), Policy.Update(300, 300, Format, 2.0, Cooldown));
+		TestTrue(TEXT("The small frames"), Policy.GetAllocationSize() == FIntPoint(320, 320));
+	}
+
+	// a frame using the whole allocation restarts the cooldown
+	{
+		FSpoutResizePolicy Policy;
+		Policy.Update(1000, 1000, Format, 0.0, Cooldown);
+
+		Policy.Update(500, 500, Format, 0.8, Cooldown);
+		TestFalse(TEXT("Full use"), Policy.Update(1000, 1000, Format, 0.9, Cooldown));
+		TestFalse(TEXT("Not a cooldown since the full use"), Policy.Update(500, 500, Format, 1.5, Cooldown));
+		TestTrue(TEXT("A cooldown since the full use"), Policy.Update(500, 500, Format, 2.0, Cooldown));
+		TestTrue(TEXT("Shrunk"), Policy.GetAllocationSize() == FIntPoint(512, 512));
+	}
+
+	// wide and tall frames in turn use each axis in full between them
+	{
+		FSpoutResizePolicy Policy;
+		Policy.Update(1000, 1000, Format, 0.0, Cooldown);
+
+		int32 Reallocations = 0;
+		for (int32 Frame = 1; Frame <= 180; ++Frame)
+		{
+			const bool bWide = Frame % 2 == 0;
+			Reallocations += Policy.Update(bWide ? 1000 : 300, bWide ? 300 : 1000, Format, Frame / 60.0, Cooldown) ? 1 : 0;
+		}
+
+		TestEqual(TEXT("Alternating sizes never reallocate"), Reallocations, 0);
+		TestTrue(TEXT("Keeping both axes"), Policy.GetAllocationSize() == FIntPoint(1024, 1024));
+	}
+
+	// no cooldown: the next smaller frame shrinks to itself
+	{
+		FSpoutResizePolicy Policy;
+		Policy.Update(1000, 1000, Format, 0.0, 0.0);
+
+		TestTrue(TEXT("No cooldown"), Policy.Update(500, 300, Format, 0.0, 0.0));
+		TestTrue(TEXT("Shrunk at once"), Policy.GetAllocationSize() == FIntPoint(512, 320));
+	}
+
+	return true;
+}
+
+#endif
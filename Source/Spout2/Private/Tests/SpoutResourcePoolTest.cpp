@@ -0,0 +1,150 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "SpoutResourcePool.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutResourcePoolTest
+{
+	// keys are sizes, values name the resource
+	typedef TSpoutResourcePool<int32, int32> FPool;
+
+	/** Creates a resource the way an owner does after a miss. */
+	static int32 AcquireOrCreate(FPool& Pool, int32 Key, int32& NextValue, uint64 Bytes)
+	{
+		int32 Value = 0;
+		if (!Pool.Acquire(Key, Value))
+		{
+			Value = NextValue++;
+			Pool.OnCreated(Bytes);
+		}
+
+		return Value;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutResourcePoolOrderTest, "Spout2.ResourcePool.Order", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutResourcePoolOrderTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutResourcePoolTest;
+
+	FPool Pool;
+	int32 NextValue = 1;
+
+	const int32 A = AcquireOrCreate(Pool, 1, NextValue, 100);
+	const int32 B = AcquireOrCreate(Pool, 1, NextValue, 100);
+	const int32 C = AcquireOrCreate(Pool, 1, NextValue, 100);
+
+	Pool.Release(1, A, 100);
+	Pool.Release(1, B, 100);
+	Pool.Release(1, C, 100);
+	TestEqual(TEXT("All idle"), Pool.NumIdle(1), 3);
+
+	// reuse takes the most recently released, the one most likely still warm
+	int32 Value = 0;
+	TestTrue(TEXT("Hit"), Pool.Acquire(1, Value));
+	TestEqual(TEXT("Most recently released first"), Value, C);
+	TestFalse(TEXT("Other keys miss"), Pool.Acquire(2, Value));
+
+	// eviction takes the least recently released
+	TArray<int32> Evicted = Pool.SetBudget(300);
+	TestEqual(TEXT("Everything fits"), Evicted.Num(), 0);
+
+	Evicted = Pool.SetBudget(200);
+	TestEqual(TEXT("One evicted"), Evicted.Num(), 1);
+	TestTrue(TEXT("Least recently released evicted"), Evicted.Num() == 1 && Evicted[0] == A);
+
+	Pool.Release(1, C, 100);
+	Evicted = Pool.SetBudget(100);
+	TestTrue(TEXT("Then the next oldest"), Evicted.Num() == 1 && Evicted[0] == B);
+	TestEqual(TEXT("The newest stays"), Pool.NumIdle(1), 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutResourcePoolBudgetTest, "Spout2.ResourcePool.Budget", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutResourcePoolBudgetTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutResourcePoolTest;
+
+	FPool Pool(250);
+	int32 NextValue = 1;
+
+	const int32 A = AcquireOrCreate(Pool, 1, NextValue, 100);
+	const int32 B = AcquireOrCreate(Pool, 2, NextValue, 100);
+	const int32 C = AcquireOrCreate(Pool, 3, NextValue, 100);
+
+	// in-use resources are never evicted, the budget is exceeded until something is idle
+	TestEqual(TEXT("Over budget while in use"), (int64)Pool.GetStats().BytesInUse, (int64)300);
+	TestEqual(TEXT("Nothing to trim while in use"), Pool.Trim().Num(), 0);
+
+	TArray<int32> Evicted = Pool.Release(1, A, 100);
+	TestTrue(TEXT("The released resource is what no longer fits"), Evicted.Num() == 1 && Evicted[0] == A);
+
+	Evicted = Pool.Release(2, B, 100);
+	TestEqual(TEXT("Back in budget"), Evicted.Num(), 0);
+	TestEqual(TEXT("Idle bytes"), (int64)Pool.GetStats().BytesIdle, (int64)100);
+	TestEqual(TEXT("In-use bytes"), (int64)Pool.GetStats().BytesInUse, (int64)100);
+
+	// 0 disables the budget
+	Pool.SetBudget(0);
+	Evicted = Pool.Release(3, C, 100);
+	TestEqual(TEXT("Unlimited"), Evicted.Num(), 0);
+	TestEqual(TEXT("Everything idle"), Pool.GetStats().NumIdle, 2);
+
+	Evicted = Pool.SetBudget(100);
+	TestEqual(TEXT("Trimmed to the new budget"), Evicted.Num(), 1);
+	TestTrue(TEXT("Within budget"), Pool.GetStats().BytesInUse + Pool.GetStats().BytesIdle <= 100);
+
+	Evicted = Pool.Empty();
+	TestEqual(TEXT("Empty hands back the rest"), Evicted.Num(), 1);
+	TestEqual(TEXT("No idle bytes left"), (int64)Pool.GetStats().BytesIdle, (int64)0);
+
+	// a resource dropped while in use is not counted against the budget any more
+	AcquireOrCreate(Pool, 1, NextValue, 100);
+	Pool.OnDestroyedInUse(100);
+	TestEqual(TEXT("Dropped in use"), (int64)Pool.GetStats().BytesInUse, (int64)0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutResourcePoolStatsTest, "Spout2.ResourcePool.Stats", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutResourcePoolStatsTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutResourcePoolTest;
+
+	FPool Pool(200);
+	int32 NextValue = 1;
+
+	TestEqual(TEXT("No requests, no hit rate"), Pool.GetStats().GetHitRate(), 0.0);
+
+	// a sender resized between two sizes every frame: after the first round everything is reused
+	for (int32 Frame = 0; Frame < 10; ++Frame)
+	{
+		const int32 Key = 1 + Frame % 2;
+		const int32 Value = AcquireOrCreate(Pool, Key, NextValue, 100);
+		Pool.Release(Key, Value, 100);
+	}
+
+	const FPool::FStats& Stats = Pool.GetStats();
+	TestEqual(TEXT("Misses"), (int64)Stats.Misses, (int64)2);
+	TestEqual(TEXT("Hits"), (int64)Stats.Hits, (int64)8);
+	TestEqual(TEXT("Hit rate"), Stats.GetHitRate(), 0.8);
+	TestEqual(TEXT("Created twice"), NextValue, 3);
+	TestEqual(TEXT("No evictions in budget"), (int64)Stats.Evictions, (int64)0);
+
+	// a third size no longer fits beside the other two
+	const int32 Value = AcquireOrCreate(Pool, 3, NextValue, 100);
+	Pool.Release(3, Value, 100);
+	TestEqual(TEXT("Evicted to make room"), (int64)Stats.Evictions, (int64)1);
+	TestEqual(TEXT("Misses include the new size"), (int64)Stats.Misses, (int64)3);
+	TestEqual(TEXT("Idle count"), Stats.NumIdle, 2);
+
+	return true;
+}
+
+#endif
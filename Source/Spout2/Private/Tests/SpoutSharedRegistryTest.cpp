@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Async/Async.h"
+#include "Misc/AutomationTest.h"
+#include "SpoutSharedRegistry.h"
+
+#include <atomic>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutSharedRegistryTest
+{
+	/** Counts its instances, so teardown is observable without any RHI. */
+	struct FValue
+	{
+		int32 Key;
+		std::atomic<int32>& Live;
+
+		FValue(int32 InKey, std::atomic<int32>& InLive)
+			: Key(InKey)
+			, Live(InLive)
+		{
+			++Live;
+		}
+
+		~FValue()
+		{
+			--Live;
+		}
+	};
+
+	typedef TSpoutSharedRegistry<int32, FValue> FRegistry;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutSharedRegistryRefCountTest, "Spout2.SharedRegistry.RefCount", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutSharedRegistryRefCountTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutSharedRegistryTest;
+
+	std::atomic<int32> Live{ 0 };
+	int32 Created = 0;
+
+	FRegistry Registry;
+	auto Factory = [&Live, &Created](int32 Key) {
+		return [&Live, &Created, Key]() {
+			++Created;
+			return MakeShared<FValue, ESPMode::ThreadSafe>(Key, Live);
+		};
+	};
+
+	TestFalse(TEXT("Nothing registered"), Registry.Find(1).IsValid());
+	TestEqual(TEXT("Empty"), Registry.Num(), 0);
+
+	TSharedPtr<FValue, ESPMode::ThreadSafe> First = Registry.Acquire(1, Factory(1));
+	TSharedPtr<FValue, ESPMode::ThreadSafe> Second = Registry.Acquire(1, Factory(1));
+	TestTrue(TEXT("One value per key"), First == Second && First->Key == 1);
+	TestEqual(TEXT("Made once"), Created, 1);
+
+	TSharedPtr<FValue, ESPMode::ThreadSafe> Other = Registry.Acquire(2, Factory(2));
+	TestTrue(TEXT("Another key, another value"), Other != First && Other->Key == 2);
+	TestEqual(TEXT("Two keys"), Registry.Num(), 2);
+	TestTrue(TEXT("Found without creating"), Registry.Find(2) == Other && Created == 2);
+
+	First.Reset();
+	TestEqual(TEXT("Alive while referenced"), Live.load(), 2);
+	TestTrue(TEXT("And still found"), Registry.Find(1) == Second);
+
+	Second.Reset();
+	TestEqual(TEXT("Destroyed with its last reference"), Live.load(), 1);
+	TestFalse(TEXT("Not found after"), Registry.Find(1).IsValid());
+	TestEqual(TEXT("Not counted"), Registry.Num(), 1);
+
+	// the registry holds nothing itself, a key released and acquired again gets a fresh value
+	TSharedPtr<FValue, ESPMode::ThreadSafe> Again = Registry.Acquire(1, Factory(1));
+	TestEqual(TEXT("Made again"), Created, 3);
+	TestEqual(TEXT("Two alive"), Live.load(), 2);
+
+	Again.Reset();
+	Other.Reset();
+	TestEqual(TEXT("All destroyed"), Live.load(), 0);
+	TestEqual(TEXT("Nothing referenced"), Registry.Num(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutSharedRegistryTeardownTest, "Spout2.SharedRegistry.Teardown", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutSharedRegistryTeardownTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutSharedRegistryTest;
+
+	std::atomic<int32> Live{ 0 };
+
+	// values outliving the registry are torn down by whoever holds them last
+	TSharedPtr<FValue, ESPMode::ThreadSafe> Survivor;
+	{
+		FRegistry Registry;
+		Survivor = Registry.Acquire(1, [&Live]() { return MakeShared<FValue, ESPMode::ThreadSafe>(1, Live); });
+		Registry.Acquire(2, [&Live]() { return MakeShared<FValue, ESPMode::ThreadSafe>(2, Live); });
+		TestEqual(TEXT("An unreferenced value is gone at once"), Live.load(), 1);
+	}
+
+	TestEqual(TEXT("The held one survives the registry"), Live.load(), 1);
+	Survivor.Reset();
+	TestEqual(TEXT("Until released"), Live.load(), 0);
+
+	// components on several threads acquiring and releasing the same few keys
+	const int32 NumThreads = 4;
+	const int32 NumIterations = 20000;
+	const int32 NumKeys = 3;
+
+	FRegistry Registry;
+	std::atomic<int32> Mismatches{ 0 };
+
+	TArray<TFuture<void>> Threads;
+	for (int32 Thread = 0; Thread < NumThreads; ++Thread)
+	{
+		Threads.Add(Async(EAsyncExecution::Thread, [&Registry, &Live, &Mismatches, Thread, NumIterations, NumKeys]() {
+			for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+			{
+				const int32 Key = (Thread + Iteration) % NumKeys;
+				TSharedPtr<FValue, ESPMode::ThreadSafe> Held = Registry.Acquire(Key, [&Live, Key]() { return MakeShared<FValue, ESPMode::ThreadSafe>(Key, Live); });
+
+				// while held, everyone acquiring the key shares it
+				bool bMadeAnother = false;
+				TSharedPtr<FValue, ESPMode::ThreadSafe> Shared = Registry.Acquire(Key, [&Live, &bMadeAnother, Key]() {
+					bMadeAnother = true;
+					return MakeShared<FValue, ESPMode::ThreadSafe>(Key, Live);
+				});
+
+				if (Held->Key != Key || Registry.Find(Key) != Held || Shared != Held || bMadeAnother)
+					++Mismatches;
+			}
+		}));
+	}
+
+	for (TFuture<void>& Thread : Threads)
+		Thread.Wait();
+
+	TestEqual(TEXT("A held key's value is never replaced"), Mismatches.load(), 0);
+	TestEqual(TEXT("Every value destroyed"), Live.load(), 0);
+	TestEqual(TEXT("Nothing referenced"), Registry.Num(), 0);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,207 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Async/Async.h"
+#include "HAL/PlatformProcess.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "SpoutSnapshotRing.h"
+#include "SpoutSpscQueue.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutSnapshotRingTest
+{
+	/** Signalled by whoever plays the GPU. */
+	struct FFence
+	{
+		std::atomic<bool> bSignalled{ false };
+
+		bool Poll() const { return bSignalled.load(std::memory_order_acquire); }
+		void Signal() { bSignalled.store(true, std::memory_order_release); }
+	};
+
+	typedef TSharedPtr<FFence, ESPMode::ThreadSafe> FFenceRef;
+	typedef TSpoutSnapshotRing<FFenceRef, 3> FRing;
+
+	/** A copy into a slot with the fence behind it, as the GPU runs it and as the worker receives it. */
+	struct FCopy
+	{
+		int32 Slot = INDEX_NONE;
+		int64 FrameId = 0;
+		FFenceRef Fence;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutSnapshotRingClaimTest, "Spout2.SnapshotRing.Claim", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutSnapshotRingClaimTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutSnapshotRingTest;
+
+	FRing Ring;
+	FFenceRef Fences[FRing::Num];
+
+	for (int32 Index = 0; Index < FRing::Num; ++Index)
+	{
+		TestEqual(TEXT("Slots are claimed in order"), Ring.Claim(), Index);
+
+		Fences[Index] = MakeShared<FFence, ESPMode::ThreadSafe>();
+		Ring.Submit(Index, Fences[Index]);
+	}
+
+	TestEqual(TEXT("All submitted"), Ring.NumSubmitted(), FRing::Num);
+	TestEqual(TEXT("Nothing while the oldest is read"), Ring.Claim(), (int32)INDEX_NONE);
+
+	// a newer slot coming back first does not let a frame overtake the oldest
+	Fences[1]->Signal();
+	Ring.Release(1);
+	TestEqual(TEXT("Not out of order"), Ring.Claim(), (int32)INDEX_NONE);
+
+	// a reader that gave up on the fence releases the slot before the GPU wrote it
+	Ring.Release(0);
+	TestEqual(TEXT("Not before its fence signalled"), Ring.Claim(), (int32)INDEX_NONE);
+
+	Fences[0]->Signal();
+	TestEqual(TEXT("Released and signalled"), Ring.Claim(), 0);
+	Ring.Submit(0, MakeShared<FFence, ESPMode::ThreadSafe>());
+
+	// the frame claiming slot 1 is dropped before its copy, the slot is never submitted
+	TestEqual(TEXT("Then the next one"), Ring.Claim(), 1);
+	TestEqual(TEXT("A claimed slot is not submitted"), Ring.NumSubmitted(), 2);
+
+	TestEqual(TEXT("The last one is still read"), Ring.Claim(), (int32)INDEX_NONE);
+	Fences[2]->Signal();
+	Ring.Release(2);
+	TestEqual(TEXT("Until released"), Ring.Claim(), 2);
+
+	// around again to the slot submitted last, its fence has not signalled
+	TestEqual(TEXT("Wraps around to a busy slot"), Ring.Claim(), (int32)INDEX_NONE);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutSnapshotRingOrderingTest, "Spout2.SnapshotRing.Ordering", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutSnapshotRingOrderingTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutSnapshotRingTest;
+
+	// the render thread claims and submits, a GPU thread writes the slots late, a worker reads them in job order
+	const int64 NumFrames = 3000;
+
+	FRing Ring;
+	std::atomic<int64> SlotFrames[FRing::Num];
+	for (std::atomic<int64>& SlotFrame : SlotFrames)
+		SlotFrame.store(0);
+
+	TSpoutSpscQueue<FCopy> GpuQueue(64);
+	TSpoutSpscQueue<FCopy> Jobs(64);
+	std::atomic<bool> bSubmitting{ true };
+
+	int64 Dropped = 0;
+
+	TFuture<void> Gpu = Async(EAsyncExecution::Thread, [&]() {
+		FRandomStream Random(7);
+		FCopy Copy;
+
+		while (bSubmitting.load() || !GpuQueue.IsEmpty())
+		{
+			if (!GpuQueue.Pop(Copy))
+			{
+				FPlatformProcess::Yield();
+				continue;
+			}
+
+			if (Random.FRand() < 0.1f)
+				FPlatformProcess::Sleep(0.0002f);
+
+			SlotFrames[Copy.Slot].store(Copy.FrameId);
+			Copy.Fence->Signal();
+		}
+	});
+
+	struct FReaderResult
+	{
+		int64 Read = 0;
+		int64 GivenUp = 0;
+		int64 Wrong = 0;
+		int64 OutOfOrder = 0;
+	};
+
+	TFuture<FReaderResult> Worker = Async(EAsyncExecution::Thread, [&]() {
+		FRandomStream Random(11);
+		FReaderResult Result;
+		int64 LastFrameId = 0;
+		FCopy Job;
+
+		while (bSubmitting.load() || !Jobs.IsEmpty())
+		{
+			if (!Jobs.Pop(Job))
+			{
+				FPlatformProcess::Yield();
+				continue;
+			}
+
+			// a fence timeout, the slot goes back before the GPU may have written it
+			if (Random.FRand() < 0.05f)
+			{
+				++Result.GivenUp;
+				Ring.Release(Job.Slot);
+				continue;
+			}
+
+			while (!Job.Fence->Poll())
+				FPlatformProcess::Yield();
+
+			// the slot must hold the job's frame for as long as the read takes
+			const int64 Before = SlotFrames[Job.Slot].load();
+			if (Random.FRand() < 0.2f)
+				FPlatformProcess::Sleep(0.0002f);
+			const int64 After = SlotFrames[Job.Slot].load();
+
+			Result.Wrong += Before != Job.FrameId || After != Job.FrameId ? 1 : 0;
+			Result.OutOfOrder += Job.FrameId <= LastFrameId ? 1 : 0;
+			LastFrameId = Job.FrameId;
+			++Result.Read;
+
+			Ring.Release(Job.Slot);
+		}
+
+		return Result;
+	});
+
+	for (int64 FrameId = 1; FrameId <= NumFrames; ++FrameId)
+	{
+		const int32 Slot = Ring.Claim();
+		if (Slot == INDEX_NONE)
+		{
+			++Dropped;
+			FPlatformProcess::Yield();
+			continue;
+		}
+
+		FFenceRef Fence = MakeShared<FFence, ESPMode::ThreadSafe>();
+		Ring.Submit(Slot, Fence);
+
+		// the ring holds at most three copies, the queues never fill
+		FCopy GpuCopy{ Slot, FrameId, Fence };
+		FCopy Job{ Slot, FrameId, Fence };
+		verify(GpuQueue.Push(MoveTemp(GpuCopy)));
+		verify(Jobs.Push(MoveTemp(Job)));
+	}
+
+	bSubmitting.store(false);
+	Gpu.Wait();
+
+	const FReaderResult& Result = Worker.Get();
+
+	TestEqual(TEXT("Every frame read, given up or dropped"), Result.Read + Result.GivenUp + Dropped, NumFrames);
+	TestTrue(TEXT("Frames were read"), Result.Read > 0);
+	TestEqual(TEXT("Never a slot written while it was read"), Result.Wrong, (int64)0);
+	TestEqual(TEXT("Never out of order"), Result.OutOfOrder, (int64)0);
+	TestEqual(TEXT("Every slot released"), Ring.NumSubmitted(), 0);
+
+	return true;
+}
+
+#endif
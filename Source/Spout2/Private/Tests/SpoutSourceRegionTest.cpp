@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "SpoutSourceRegion.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutSourceRegionResolveTest, "Spout2.SourceRegion.Resolve", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutSourceRegionResolveTest::RunTest(const FString& Parameters)
+{
+	const FIntRect Canvas(0, 0, 7680, 1080);
+
+	TestEqual(TEXT("Empty region selects everything"), SpoutSourceRegion::Resolve(Canvas, FIntRect()), Canvas);
+	TestEqual(TEXT("Inverted region selects everything"), SpoutSourceRegion::Resolve(Canvas, FIntRect(100, 100, 50, 50)), Canvas);
+	TestEqual(TEXT("Inside is kept"), SpoutSourceRegion::Resolve(Canvas, FIntRect(1920, 0, 3840, 1080)), FIntRect(1920, 0, 3840, 1080));
+
+	// clamped into the sender
+	TestEqual(TEXT("Past the right edge"), SpoutSourceRegion::Resolve(Canvas, FIntRect(7000, 500, 8000, 1500)), FIntRect(7000, 500, 7680, 1080));
+	TestEqual(TEXT("Before the origin"), SpoutSourceRegion::Resolve(Canvas, FIntRect(-100, -50, 100, 50)), FIntRect(0, 0, 100, 50));
+	TestEqual(TEXT("Larger than the sender"), SpoutSourceRegion::Resolve(Canvas, FIntRect(-1, -1, 9000, 9000)), Canvas);
+
+	// nothing left to copy
+	TestEqual(TEXT("Outside"), SpoutSourceRegion::Resolve(Canvas, FIntRect(8000, 0, 9000, 100)), FIntRect());
+	TestEqual(TEXT("Touching the edge"), SpoutSourceRegion::Resolve(Canvas, FIntRect(7680, 0, 7700, 100)), FIntRect());
+	TestEqual(TEXT("Left of the origin"), SpoutSourceRegion::Resolve(Canvas, FIntRect(-200, 0, -100, 100)), FIntRect());
+
+	// a sender in an atlas: the region is relative to its rectangle and stays inside it
+	const FIntRect AtlasEntry(256, 128, 512, 256);
+	TestEqual(TEXT("Atlas entry, whole"), SpoutSourceRegion::Resolve(AtlasEntry, FIntRect()), AtlasEntry);
+	TestEqual(TEXT("Atlas entry, offset to its origin"), SpoutSourceRegion::Resolve(AtlasEntry, FIntRect(10, 20, 110, 120)), FIntRect(266, 148, 366, 248));
+	TestEqual(TEXT("Atlas entry, clamped to it rather than the atlas"), SpoutSourceRegion::Resolve(AtlasEntry, FIntRect(200, 100, 400, 300)), FIntRect(456, 228, 512, 256));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutSourceRegionCopyTest, "Spout2.SourceRegion.Copy", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutSourceRegionCopyTest::RunTest(const FString& Parameters)
+{
+	const int32 Width = 37;
+	const int32 Height = 23;
+
+	// every pixel names its position
+	TArray<FColor> Image;
+	for (int32 y = 0; y < Height; ++y)
+	{
+		for (int32 x = 0; x < Width; ++x)
+			Image.Add(FColor((uint8)x, (uint8)y, 0, 255));
+	}
+
+	const FIntRect Regions[] = {
+		SpoutSourceRegion::Resolve(FIntRect(0, 0, Width, Height), FIntRect()),
+		SpoutSourceRegion::Resolve(FIntRect(0, 0, Width, Height), FIntRect(5, 3, 17, 11)),
+		SpoutSourceRegion::Resolve(FIntRect(0, 0, Width, Height), FIntRect(30, 20, 50, 50)),
+		FIntRect(0, 7, Width, 8),
+	};
+
+	for (const FIntRect& Region : Regions)
+	{
+		TArray<FColor> Crop;
+		Crop.Init(FColor::Transparent, Region.Area());
+		SpoutSourceRegion::CopyRegion(Image.GetData(), Width, Region, Crop.GetData());
+
+		bool bMatches = true;
+		for (int32 y = 0; y < Region.Height(); ++y)
+		{
+			for (int32 x = 0; x < Region.Width(); ++x)
+				bMatches &= Crop[y * Region.Width() + x] == FColor((uint8)(Region.Min.X + x), (uint8)(Region.Min.Y + y), 0, 255);
+		}
+
+		TestTrue(FString::Printf(TEXT("%dx%d at %d,%d"), Region.Width(), Region.Height(), Region.Min.X, Region.Min.Y), bMatches);
+	}
+
+	// padded rows on both sides, the padding stays untouched
+	const uint8 Src[] = { 1, 2, 3, 0xAA, 4, 5, 6, 0xAA };
+	uint8 Dst[] = { 0, 0, 0, 0xBB, 0xBB, 0, 0, 0, 0xBB, 0xBB };
+	SpoutSourceRegion::CopyRows(Src, 4, Dst, 5, 3, 2);
+
+	const uint8 Expected[] = { 1, 2, 3, 0xBB, 0xBB, 4, 5, 6, 0xBB, 0xBB };
+	TestTrue(TEXT("Pitched rows"), FMemory::Memcmp(Dst, Expected, sizeof(Expected)) == 0);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Async/Async.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/AutomationTest.h"
+#include "SpoutSpscQueue.h"
+#include "Templates/UniquePtr.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutSpscQueueBoundsTest, "Spout2.SpscQueue.Bounds", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutSpscQueueBoundsTest::RunTest(const FString& Parameters)
+{
+	TestEqual(TEXT("Rounded up to a power of two"), (int32)TSpoutSpscQueue<int32>(5).GetCapacity(), 8);
+	TestEqual(TEXT("At least two slots"), (int32)TSpoutSpscQueue<int32>(0).GetCapacity(), 2);
+
+	TSpoutSpscQueue<TUniquePtr<int32>> Queue(4);
+
+	TUniquePtr<int32> Popped;
+	TestTrue(TEXT("Empty"), Queue.IsEmpty() && !Queue.Pop(Popped));
+
+	for (int32 Value = 0; Value < 4; ++Value)
+		TestTrue(FString::Printf(TEXT("Push %d"), Value), Queue.Push(MakeUnique<int32>(Value)));
+
+	TUniquePtr<int32> Refused = MakeUnique<int32>(4);
+	TestFalse(TEXT("Full"), Queue.Push(MoveTemp(Refused)));
+	TestTrue(TEXT("A refused element is left to the caller"), Refused.IsValid() && *Refused == 4);
+	TestEqual(TEXT("Four queued"), (int32)Queue.Num(), 4);
+
+	// the counters run past the capacity many times over
+	for (int32 Value = 0; Value < 100; ++Value)
+	{
+		if (!TestTrue(TEXT("Pop in order"), Queue.Pop(Popped) && Popped.IsValid() && *Popped == Value))
+			break;
+
+		TestTrue(TEXT("Room again"), Queue.Push(MakeUnique<int32>(Value + 4)));
+	}
+
+	TestEqual(TEXT("Still four queued"), (int32)Queue.Num(), 4);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutSpscQueueThreadsTest, "Spout2.SpscQueue.Threads", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutSpscQueueThreadsTest::RunTest(const FString& Parameters)
+{
+	const int64 NumElements = 200000;
+
+	TSpoutSpscQueue<int64> Queue(16);
+
+	// the producer spins on a full ring, the consumer on an empty one
+	TFuture<void> Producer = Async(EAsyncExecution::Thread, [&Queue, NumElements]() {
+		for (int64 Value = 1; Value <= NumElements; ++Value)
+		{
+			int64 Element = Value;
+			while (!Queue.Push(MoveTemp(Element)))
+				FPlatformProcess::Yield();
+		}
+	});
+
+	TFuture<int64> Consumer = Async(EAsyncExecution::Thread, [&Queue, NumElements]() {
+		int64 Expected = 1;
+		int64 OutOfOrder = 0;
+
+		while (Expected <= NumElements)
+		{
+			int64 Element = 0;
+			if (!Queue.Pop(Element))
+			{
+				FPlatformProcess::Yield();
+				continue;
+			}
+
+			OutOfOrder += Element != Expected ? 1 : 0;
+			Expected = Element + 1;
+		}
+
+		return OutOfOrder;
+	});
+
+	Producer.Wait();
+
+	TestEqual(TEXT("Every element once, in order"), Consumer.Get(), (int64)0);
+	TestTrue(TEXT("Drained"), Queue.IsEmpty());
+
+	return true;
+}
+
+#endif
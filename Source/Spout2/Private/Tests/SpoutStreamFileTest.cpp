@@ -0,0 +1,341 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "SpoutMemoryShare.h"
+#include "SpoutStreamFile.h"
+#include "SpoutStreamRecording.h"
+#include "SpoutYuvConversion.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutStreamFileTest
+{
+	static constexpr int32 Width = 64;
+	static constexpr int32 Height = 32;
+	static constexpr int32 NumFrames = 6;
+
+	static FString MakeName()
+	{
+		return FString::Printf(TEXT("SpoutStreamFileTest_%s"), *FGuid::NewGuid().ToString());
+	}
+
+	static FString MakePath()
+	{
+		return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Automation"), MakeName() + TEXT(".spoutrec"));
+	}
+
+	static FSpoutMemoryFrameInfo MakeInfo(int32 Frame)
+	{
+		FSpoutMemoryFrameInfo Info;
+		Info.Format = ESpoutMemoryShareFormat::BGRA;
+		Info.Width = Width;
+		Info.Height = Height;
+		Info.FrameId = 100 + Frame;
+		return Info;
+	}
+
+	/** A gradient LZ4 shrinks, or noise it does not. */
+	static TArray<uint8> MakePayload(int32 Frame, bool bNoise)
+	{
+		TArray<uint8> Payload;
+		Payload.SetNumUninitialized(SpoutYuvConversion::GetFrameSize(ESpoutMemoryShareFormat::BGRA, Width, Height));
+
+		FRandomStream Random(Frame + 1);
+		for (int32 Byte = 0; Byte < Payload.Num(); ++Byte)
+			Payload[Byte] = bNoise ? (uint8)Random.RandHelper(256) : (uint8)((Byte / 4 + Frame) & 0xff);
+
+		return Payload;
+	}
+
+	static int64 MakeTimestampUs(int32 Frame)
+	{
+		return Frame * 16667;
+	}
+
+	/** Writes NumFrames frames; OutBytesBeforeClose is where the index starts. */
+	static bool WriteRecording(const FString& Path, bool bCompress, bool bNoise, uint64& OutBytesBeforeClose)
+	{
+		FSpoutStreamWriter Writer;
+		if (!Writer.Open(Path, bCompress))
+			return false;
+
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const TArray<uint8> Payload = MakePayload(Frame, bNoise);
+			if (!Writer.Append(MakeInfo(Frame), Payload.GetData(), Payload.Num(), MakeTimestampUs(Frame)))
+				return false;
+		}
+
+		OutBytesBeforeClose = Writer.GetBytesWritten();
+		return Writer.Close();
+	}
+
+	/** Frames read back as written, up to NumExpected of them. */
+	static bool ReadsBack(FAutomationTestBase& Test, FSpoutStreamReader& Reader, int32 NumExpected, bool bNoise)
+	{
+		if (!Test.TestEqual(TEXT("Frames"), Reader.GetNumFrames(), NumExpected))
+			return false;
+
+		for (int32 Frame = 0; Frame < NumExpected; ++Frame)
+		{
+			FSpoutMemoryFrameInfo Info;
+			const uint8* Payload = nullptr;
+			SIZE_T PayloadSize = 0;
+
+			if (!Test.TestTrue(FString::Printf(TEXT("Frame %d reads"), Frame), Reader.ReadFrame(Frame, Info, Payload, PayloadSize)))
+				return false;
+
+			const TArray<uint8> Expected = MakePayload(Frame, bNoise);
+			const FSpoutMemoryFrameInfo ExpectedInfo = MakeInfo(Frame);
+
+			Test.TestTrue(FString::Printf(TEXT("Frame %d layout"), Frame), Info.Format == ExpectedInfo.Format && Info.Width == Width && Info.Height == Height);
+			Test.TestEqual(FString::Printf(TEXT("Frame %d id"), Frame), Info.FrameId, ExpectedInfo.FrameId);
+			Test.TestEqual(FString::Printf(TEXT("Frame %d timestamp"), Frame), Reader.GetTimestampUs(Frame), MakeTimestampUs(Frame));
+			Test.TestTrue(FString::Printf(TEXT("Frame %d payload"), Frame),
+				PayloadSize == (SIZE_T)Expected.Num() && FMemory::Memcmp(Payload, Expected.GetData(), PayloadSize) == 0);
+		}
+
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutStreamFileRoundTripTest, "Spout2.StreamFile.RoundTrip", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutStreamFileRoundTripTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutStreamFileTest;
+
+	const FString Path = MakePath();
+
+	uint64 BytesBeforeClose = 0;
+	if (!TestTrue(TEXT("Written"), WriteRecording(Path, false, false, BytesBeforeClose)))
+		return false;
+
+	{
+		FSpoutStreamReader Reader;
+		if (TestTrue(TEXT("Opened"), Reader.Open(Path)))
+		{
+			ReadsBack(*this, Reader, NumFrames, false);
+
+			FSpoutMemoryFrameInfo Info;
+			const uint8* Payload = nullptr;
+			SIZE_T PayloadSize = 0;
+			TestFalse(TEXT("Past the last frame"), Reader.ReadFrame(NumFrames, Info, Payload, PayloadSize));
+		}
+	}
+
+	IFileManager::Get().Delete(*Path);
+
+	FSpoutStreamReader Missing;
+	TestFalse(TEXT("A missing file"), Missing.Open(Path));
+
+	// anything that is not a recording
+	TArray<uint8> Garbage = MakePayload(0, true);
+	FFileHelper::SaveArrayToFile(Garbage, *Path);
+
+	FSpoutStreamReader Foreign;
+	TestFalse(TEXT("Another file"), Foreign.Open(Path));
+	Foreign.Close();
+
+	IFileManager::Get().Delete(*Path);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutStreamFileCompressionTest, "Spout2.StreamFile.Compression", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutStreamFileCompressionTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutStreamFileTest;
+
+	const FString RawPath = MakePath();
+	const FString CompressedPath = MakePath();
+
+	uint64 RawBytes = 0;
+	uint64 CompressedBytes = 0;
+	TestTrue(TEXT("Raw written"), WriteRecording(RawPath, false, false, RawBytes));
+	TestTrue(TEXT("Compressed written"), WriteRecording(CompressedPath, true, false, CompressedBytes));
+	TestTrue(TEXT("LZ4 shrinks a gradient"), CompressedBytes < RawBytes / 2);
+
+	{
+		FSpoutStreamReader Reader;
+		if (TestTrue(TEXT("Opened"), Reader.Open(CompressedPath)))
+			ReadsBack(*this, Reader, NumFrames, false);
+	}
+
+	// noise does not shrink, it is stored as it is rather than grown
+	const FString NoisePath = MakePath();
+	uint64 NoiseBytes = 0;
+	TestTrue(TEXT("Noise written"), WriteRecording(NoisePath, true, true, NoiseBytes));
+	TestEqual(TEXT("Incompressible frames are stored raw"), (int64)NoiseBytes, (int64)RawBytes);
+
+	{
+		FSpoutStreamReader Reader;
+		if (TestTrue(TEXT("Opened"), Reader.Open(NoisePath)))
+			ReadsBack(*this, Reader, NumFrames, true);
+	}
+
+	IFileManager::Get().Delete(*RawPath);
+	IFileManager::Get().Delete(*CompressedPath);
+	IFileManager::Get().Delete(*NoisePath);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutStreamFileRecoveryTest, "Spout2.StreamFile.Recovery", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutStreamFileRecoveryTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutStreamFileTest;
+
+	const FString Path = MakePath();
+
+	uint64 BytesBeforeClose = 0;
+	if (!TestTrue(TEXT("Written"), WriteRecording(Path, true, false, BytesBeforeClose)))
+		return false;
+
+	TArray<uint8> Closed;
+	if (!TestTrue(TEXT("Loaded"), FFileHelper::LoadFileToArray(Closed, *Path)))
+		return false;
+
+	// the recorder died after its last frame, before writing the index
+	TArray<uint8> Unclosed(Closed.GetData(), (int32)BytesBeforeClose);
+	FFileHelper::SaveArrayToFile(Unclosed, *Path);
+
+	{
+		FSpoutStreamReader Reader;
+		if (TestTrue(TEXT("An unclosed recording opens"), Reader.Open(Path)))
+			ReadsBack(*this, Reader, NumFrames, false);
+	}
+
+	// and in the middle of writing its last frame
+	TArray<uint8> Torn(Closed.GetData(), (int32)BytesBeforeClose - 10);
+	FFileHelper::SaveArrayToFile(Torn, *Path);
+
+	{
+		FSpoutStreamReader Reader;
+		if (TestTrue(TEXT("A torn recording opens"), Reader.Open(Path)))
+			ReadsBack(*this, Reader, NumFrames - 1, false);
+	}
+
+	IFileManager::Get().Delete(*Path);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutStreamRecordingTest, "Spout2.StreamFile.Recording", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutStreamRecordingTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutStreamFileTest;
+
+	const FString SenderName = MakeName();
+	const FString Path = MakePath();
+
+	TArray<FColor> Pixels;
+	Pixels.Init(FColor::Red, Width * Height);
+
+	FSpoutMemorySender Sender(SenderName);
+	FSpoutStreamRecorder Recorder(SenderName);
+	if (!TestTrue(TEXT("Started"), Recorder.Start(Path, false)))
+		return false;
+
+	TestFalse(TEXT("Nothing published"), Recorder.Poll());
+
+	Sender.Publish(Pixels.GetData(), Width, Height, ESpoutMemoryShareFormat::BGRA, ESpoutYuvMatrix::BT709);
+	TestTrue(TEXT("Recorded"), Recorder.Poll());
+	TestFalse(TEXT("Once"), Recorder.Poll());
+
+	// two publishes between polls, the first is overwritten before anyone sees it
+	Sender.Publish(Pixels.GetData(), Width, Height, ESpoutMemoryShareFormat::BGRA, ESpoutYuvMatrix::BT709);
+	FPlatformProcess::Sleep(0.02f);
+	Sender.Publish(Pixels.GetData(), Width, Height, ESpoutMemoryShareFormat::BGRA, ESpoutYuvMatrix::BT709);
+	TestTrue(TEXT("The newest is recorded"), Recorder.Poll());
+
+	TestEqual(TEXT("One frame missed"), Recorder.GetNumMissedFrames(), (int64)1);
+	TestEqual(TEXT("In one gap"), Recorder.GetNumGaps(), 1);
+
+	// polled late, the timestamp is still when the sender published
+	FPlatformProcess::Sleep(0.05f);
+	Sender.Publish(Pixels.GetData(), Width, Height, ESpoutMemoryShareFormat::BGRA, ESpoutYuvMatrix::BT709);
+	FPlatformProcess::Sleep(0.05f);
+	TestTrue(TEXT("Recorded late"), Recorder.Poll());
+
+	TestTrue(TEXT("Stopped"), Recorder.Stop());
+
+	{
+		FSpoutStreamReader Reader;
+		if (TestTrue(TEXT("Opened"), Reader.Open(Path)) && TestEqual(TEXT("Three frames"), Reader.GetNumFrames(), 3))
+		{
+			TestEqual(TEXT("From the first frame"), Reader.GetTimestampUs(0), (int64)0);
+			TestTrue(TEXT("The gap took its time"), Reader.GetTimestampUs(1) >= 20000);
+
+			// the last publish came 50 ms after the second recorded frame and was polled 50 ms later still
+			const int64 Spacing = Reader.GetTimestampUs(2) - Reader.GetTimestampUs(1);
+			TestTrue(TEXT("On the sender's clock, not the poll's"), Spacing >= 45000 && Spacing < 95000);
+		}
+	}
+
+	IFileManager::Get().Delete(*Path);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutStreamReplayTest, "Spout2.StreamFile.Replay", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutStreamReplayTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutStreamFileTest;
+
+	const FString Path = MakePath();
+
+	uint64 BytesBeforeClose = 0;
+	if (!TestTrue(TEXT("Written"), WriteRecording(Path, false, false, BytesBeforeClose)))
+		return false;
+
+	const FString SenderName = MakeName();
+	FSpoutStreamReplayer Replayer(SenderName);
+	FSpoutMemoryReceiver Receiver(SenderName);
+
+	if (!TestTrue(TEXT("Opened"), Replayer.Open(Path)))
+		return false;
+
+	TArray<uint8> Received;
+	FSpoutMemoryFrameInfo Info;
+
+	const double Start = 1000.0;
+
+	TestTrue(TEXT("The first frame at once"), Replayer.Tick(Start, ESpoutReplayTiming::Original));
+	TestTrue(TEXT("Published"), Receiver.ReceiveEncoded(Received, Info) && Received == MakePayload(0, false));
+
+	TestTrue(TEXT("Before the next is due"), Replayer.Tick(Start + 0.010, ESpoutReplayTiming::Original));
+	TestEqual(TEXT("Nothing"), Replayer.GetNumPublished(), 1);
+	TestTrue(TEXT("Waits for it"), FMath::IsNearlyEqual(Replayer.GetTimeUntilNextFrame(Start + 0.010), 0.006667, 0.0001));
+
+	// a late tick with three frames due publishes one, every frame reaches the share on its own
+	for (int32 Frame = 1; Frame < NumFrames; ++Frame)
+	{
+		Replayer.Tick(Start + 1.0, ESpoutReplayTiming::Original);
+
+		TestEqual(TEXT("One publish per tick"), Replayer.GetNumPublished(), Frame + 1);
+		TestTrue(FString::Printf(TEXT("Frame %d is received"), Frame), Receiver.ReceiveEncoded(Received, Info) && Received == MakePayload(Frame, false));
+	}
+
+	TestFalse(TEXT("Over"), Replayer.Tick(Start + 1.0, ESpoutReplayTiming::Original));
+
+	Replayer.Rewind();
+	TestTrue(TEXT("As fast as possible, one at a time too"), Replayer.Tick(Start, ESpoutReplayTiming::AsFastAsPossible));
+	TestEqual(TEXT("Published again"), Replayer.GetNumPublished(), NumFrames + 1);
+
+	IFileManager::Get().Delete(*Path);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,269 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "SpoutTransferScheduler.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutTransferSchedulerTest
+{
+	static constexpr double FrameTime = 1.0 / 60.0;
+
+	/** A stream of the simulated cost model: its submit cost, and whether it asks in a given frame. */
+	struct FSimStream
+	{
+		FSpoutTransferScheduler::FStreamId StreamId;
+		double CostMs;
+		TFunction<bool(uint64)> Asks;
+		TArray<uint64> RunFrames;
+	};
+
+	/** Runs NumFrames frames, asking in the order of the array, and returns the highest cost admitted in one frame. */
+	static double Simulate(FSpoutTransferScheduler& Scheduler, TArray<FSimStream>& SimStreams, uint64 FirstFrame, int32 NumFrames, double BudgetMs)
+	{
+		double MaxFrameCost = 0.0;
+
+		for (uint64 Frame = FirstFrame; Frame < FirstFrame + NumFrames; ++Frame)
+		{
+			const double Time = Frame * FrameTime;
+			double FrameCost = 0.0;
+
+			for (FSimStream& SimStream : SimStreams)
+			{
+				if (SimStream.Asks && !SimStream.Asks(Frame))
+					continue;
+
+				if (!Scheduler.ShouldTransfer(SimStream.StreamId, Frame, Time, BudgetMs))
+					continue;
+
+				SimStream.RunFrames.Add(Frame);
+				Scheduler.ReportSubmitCost(SimStream.StreamId, SimStream.CostMs);
+				FrameCost += SimStream.CostMs;
+			}
+
+			MaxFrameCost = FMath::Max(MaxFrameCost, FrameCost);
+		}
+
+		return MaxFrameCost;
+	}
+
+	static uint64 GetLongestWait(const FSimStream& SimStream)
+	{
+		uint64 Longest = 0;
+		for (int32 Index = 1; Index < SimStream.RunFrames.Num(); ++Index)
+			Longest = FMath::Max(Longest, SimStream.RunFrames[Index] - SimStream.RunFrames[Index - 1]);
+
+		return Longest;
+	}
+
+	static FSimStream& AddStream(FSpoutTransferScheduler& Scheduler, TArray<FSimStream>& SimStreams, int32 Priority, double CostMs)
+	{
+		FSimStream& SimStream = SimStreams.AddDefaulted_GetRef();
+		SimStream.StreamId = Scheduler.RegisterStream(1);
+		SimStream.CostMs = CostMs;
+		Scheduler.UpdateStream(SimStream.StreamId, Priority, 0.f);
+		return SimStream;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutTransferSchedulerBudgetTest, "Spout2.TransferScheduler.Budget", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutTransferSchedulerBudgetTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutTransferSchedulerTest;
+
+	FSpoutTransferScheduler Scheduler;
+	TArray<FSimStream> SimStreams;
+
+	for (int32 Index = 0; Index < 6; ++Index)
+		AddStream(Scheduler, SimStreams, Index % 3, 2.0);
+
+	// the first frame has no cost samples yet, everything runs once
+	Simulate(Scheduler, SimStreams, 1, 1, 5.0);
+	const double MaxFrameCost = Simulate(Scheduler, SimStreams, 2, 240, 5.0);
+
+	TestTrue(TEXT("Admitted cost stays within the budget"), MaxFrameCost <= 5.0);
+
+	for (const FSimStream& SimStream : SimStreams)
+	{
+		// two of six fit a frame, so every stream runs about every third frame
+		TestTrue(FString::Printf(TEXT("Stream %d gets its share"), SimStream.StreamId), SimStream.RunFrames.Num() >= 60);
+		TestTrue(FString::Printf(TEXT("Stream %d is never starved for long"), SimStream.StreamId), GetLongestWait(SimStream) <= 6);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutTransferSchedulerOverBudgetTest, "Spout2.TransferScheduler.OverBudget", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutTransferSchedulerOverBudgetTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutTransferSchedulerTest;
+
+	FSpoutTransferScheduler Scheduler;
+	TArray<FSimStream> SimStreams;
+
+	AddStream(Scheduler, SimStreams, 0, 10.0);
+	AddStream(Scheduler, SimStreams, 0, 10.0);
+
+	Simulate(Scheduler, SimStreams, 1, 100, 4.0);
+
+	// each stream alone is over the budget, one still runs every frame and they take turns
+	TestEqual(TEXT("One copy per frame"), SimStreams[0].RunFrames.Num() + SimStreams[1].RunFrames.Num(), 101);
+	TestTrue(TEXT("Both streams make progress"), SimStreams[0].RunFrames.Num() >= 40 && SimStreams[1].RunFrames.Num() >= 40);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutTransferSchedulerTargetRateTest, "Spout2.TransferScheduler.TargetRate", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutTransferSchedulerTargetRateTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutTransferSchedulerTest;
+
+	FSpoutTransferScheduler Scheduler;
+	TArray<FSimStream> SimStreams;
+
+	FSimStream& Slow = AddStream(Scheduler, SimStreams, 0, 1.0);
+	Scheduler.UpdateStream(Slow.StreamId, 0, 10.f);
+
+	// six seconds at 60 frames per second
+	Simulate(Scheduler, SimStreams, 1, 360, 0.0);
+
+	TestTrue(TEXT("Runs at its target rate"), FMath::Abs(SimStreams[0].RunFrames.Num() - 60) <= 1);
+	TestTrue(TEXT("Never bursts"), GetLongestWait(SimStreams[0]) >= 5);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutTransferSchedulerPreviewTest, "Spout2.TransferScheduler.MainAndPreview", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutTransferSchedulerPreviewTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutTransferSchedulerTest;
+
+	FSpoutTransferScheduler Scheduler;
+	TArray<FSimStream> SimStreams;
+
+	// a sender at 30 per second and its preview at 5, a budget that holds one of them per frame
+	FSimStream& Main = AddStream(Scheduler, SimStreams, 0, 2.0);
+	Scheduler.UpdateStream(Main.StreamId, 0, 30.f);
+
+	FSimStream& Preview = AddStream(Scheduler, SimStreams, -1, 1.0);
+	Scheduler.UpdateStream(Preview.StreamId, -1, 5.f);
+
+	Simulate(Scheduler, SimStreams, 1, 1, 2.5);
+	Main.RunFrames.Reset();
+	Preview.RunFrames.Reset();
+
+	const double MaxFrameCost = Simulate(Scheduler, SimStreams, 2, 360, 2.5);
+
+	TestTrue(TEXT("Within the budget"), MaxFrameCost <= 2.5);
+	TestTrue(TEXT("Main at its rate"), FMath::Abs(Main.RunFrames.Num() - 180) <= 2);
+	TestTrue(TEXT("Preview at its rate"), FMath::Abs(Preview.RunFrames.Num() - 30) <= 1);
+
+	// the preview takes the frames the main stream is not due in, rather than waiting on its admission
+	bool bSharedFrame = false;
+	for (uint64 Frame : Preview.RunFrames)
+		bSharedFrame |= Main.RunFrames.Contains(Frame);
+
+	TestFalse(TEXT("Preview runs in frames without a main copy"), bSharedFrame);
+	TestTrue(TEXT("Preview keeps its interval"), GetLongestWait(Preview) <= 13);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutTransferSchedulerQueryOrderTest, "Spout2.TransferScheduler.QueryOrder", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutTransferSchedulerQueryOrderTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutTransferSchedulerTest;
+
+	FSpoutTransferScheduler Scheduler;
+	TArray<FSimStream> SimStreams;
+
+	// the first stream builds every plan, the others only ask some frames, like gated streams
+	AddStream(Scheduler, SimStreams, 0, 1.0);
+
+	FSimStream& EveryOther = AddStream(Scheduler, SimStreams, 0, 1.0);
+	EveryOther.Asks = [](uint64 Frame) { return Frame % 2 == 0; };
+
+	FSimStream& Rare = AddStream(Scheduler, SimStreams, 0, 1.0);
+	Rare.Asks = [](uint64 Frame) { return Frame % 20 == 0; };
+
+	Simulate(Scheduler, SimStreams, 1, 100, 0.0);
+
+	TestEqual(TEXT("Runs every frame"), SimStreams[0].RunFrames.Num(), 100);
+	TestEqual(TEXT("Runs every frame it asks in"), SimStreams[1].RunFrames.Num(), 50);
+	TestEqual(TEXT("Runs the first frame it asks in after being idle"), SimStreams[2].RunFrames.Num(), 5);
+
+	// with budget left, a stream idle at plan time takes it; without, it waits
+	const FSpoutTransferScheduler::FStreamId Late = Scheduler.RegisterStream(1);
+	Scheduler.ReportSubmitCost(Late, 1.0);
+
+	const uint64 Frame = 200;
+	TestTrue(TEXT("Plan builder runs"), Scheduler.ShouldTransfer(SimStreams[0].StreamId, Frame, Frame * FrameTime, 2.5));
+	TestTrue(TEXT("Late stream fits the rest of the budget"), Scheduler.ShouldTransfer(Late, Frame, Frame * FrameTime, 2.5));
+	TestFalse(TEXT("Second late stream does not"), Scheduler.ShouldTransfer(SimStreams[2].StreamId, Frame, Frame * FrameTime, 2.5));
+	TestFalse(TEXT("A stream runs once per frame"), Scheduler.ShouldTransfer(Late, Frame, Frame * FrameTime, 2.5));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutTransferSchedulerWithdrawTest, "Spout2.TransferScheduler.Withdraw", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutTransferSchedulerWithdrawTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutTransferSchedulerTest;
+
+	FSpoutTransferScheduler Scheduler;
+
+	// a keep-alive at 10 per second whose owner turns the copy down, and a stream idle when the plan is built
+	const FSpoutTransferScheduler::FStreamId Gated = Scheduler.RegisterStream(1);
+	Scheduler.UpdateStream(Gated, 1, 10.f);
+	Scheduler.ReportSubmitCost(Gated, 1.0);
+
+	const FSpoutTransferScheduler::FStreamId Late = Scheduler.RegisterStream(1);
+	Scheduler.ReportSubmitCost(Late, 1.0);
+
+	uint64 Frame = 100;
+	TestTrue(TEXT("Admitted"), Scheduler.ShouldTransfer(Gated, Frame, Frame * FrameTime, 1.5));
+
+	Scheduler.Withdraw(Gated, Frame);
+	TestEqual(TEXT("Its budget is handed back"), Scheduler.GetPlannedCost(), 0.0);
+	TestTrue(TEXT("A later stream takes it"), Scheduler.ShouldTransfer(Late, Frame, Frame * FrameTime, 1.5));
+
+	// without the withdrawal the next slot would be 6 frames away
+	++Frame;
+	TestTrue(TEXT("Still due the next frame"), Scheduler.ShouldTransfer(Gated, Frame, Frame * FrameTime, 1.5));
+	TestFalse(TEXT("No budget beside it"), Scheduler.ShouldTransfer(Late, Frame, Frame * FrameTime, 1.5));
+
+	Scheduler.Withdraw(Late, Frame);
+	TestEqual(TEXT("Withdrawing a copy that was not admitted changes nothing"), Scheduler.GetPlannedCost(), 1.0);
+
+	++Frame;
+	TestFalse(TEXT("Ran, so back on its rate"), Scheduler.ShouldTransfer(Gated, Frame, Frame * FrameTime, 1.5));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutTransferSchedulerCostTest, "Spout2.TransferScheduler.CostEstimate", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutTransferSchedulerCostTest::RunTest(const FString& Parameters)
+{
+	FSpoutTransferScheduler Scheduler;
+	const FSpoutTransferScheduler::FStreamId StreamId = Scheduler.RegisterStream(1);
+
+	Scheduler.ReportSubmitCost(StreamId, 4.0);
+	TestEqual(TEXT("The first sample is taken as is"), Scheduler.GetEstimatedCost(StreamId), 4.0);
+
+	Scheduler.ReportSubmitCost(StreamId, 14.0);
+	TestEqual(TEXT("Later samples are smoothed"), Scheduler.GetEstimatedCost(StreamId), 4.0 + 10.0 * FSpoutTransferScheduler::CostSmoothing);
+
+	Scheduler.UnregisterStream(StreamId);
+	TestFalse(TEXT("Unregistered streams never run"), Scheduler.ShouldTransfer(StreamId, 2, 2 * SpoutTransferSchedulerTest::FrameTime, 0.0));
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,260 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "SpoutYuvConversion.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SpoutYuvConversionTest
+{
+	/** Smooth ramps and a low frequency wave inside the video range, what 4:2:x is meant for. */
+	static void MakeTestImage(int32 Width, int32 Height, TArray<FColor>& OutPixels)
+	{
+		OutPixels.SetNumUninitialized(Width * Height);
+
+		for (int32 y = 0; y < Height; ++y)
+		{
+			for (int32 x = 0; x < Width; ++x)
+			{
+				OutPixels[y * Width + x] = FColor(
+					(uint8)(16 + x * 219 / FMath::Max(Width - 1, 1)),
+					(uint8)(16 + y * 219 / FMath::Max(Height - 1, 1)),
+					(uint8)(128 + 100 * FMath::Sin(x * 0.01f + y * 0.013f)),
+					255);
+			}
+		}
+	}
+
+	static double GetPSNR(const TArray<FColor>& A, const TArray<FColor>& B)
+	{
+		double SquaredError = 0.0;
+		for (int32 Index = 0; Index < A.Num(); ++Index)
+		{
+			SquaredError += FMath::Square((double)A[Index].R - B[Index].R);
+			SquaredError += FMath::Square((double)A[Index].G - B[Index].G);
+			SquaredError += FMath::Square((double)A[Index].B - B[Index].B);
+		}
+
+		const double MeanSquaredError = SquaredError / (A.Num() * 3.0);
+		return MeanSquaredError > 0.0 ? 10.0 * FMath::LogX(10.0, 255.0 * 255.0 / MeanSquaredError) : MAX_dbl;
+	}
+
+	static void RoundTrip(ESpoutMemoryShareFormat Format, ESpoutYuvMatrix Matrix, const TArray<FColor>& Pixels, int32 Width, int32 Height, TArray<uint8>& Payload, TArray<FColor>& OutPixels)
+	{
+		Payload.SetNumUninitialized(SpoutYuvConversion::GetFrameSize(Format, Width, Height));
+		OutPixels.SetNumUninitialized(Width * Height);
+
+		SpoutYuvConversion::Encode(Format, Pixels.GetData(), Width, Height, Payload.GetData(), Matrix);
+		SpoutYuvConversion::Decode(Format, Payload.GetData(), Width, Height, OutPixels.GetData(), Matrix);
+	}
+
+	/** The bytes of the two texel wide column strip Strip of an even width frame, as a frame of its own. */
+	static void ExtractStrip(ESpoutMemoryShareFormat Format, const TArray<uint8>& Payload, int32 Width, int32 Height, int32 Strip, TArray<uint8>& OutStrip)
+	{
+		OutStrip.SetNumUninitialized(SpoutYuvConversion::GetFrameSize(Format, 2, Height));
+
+		if (Format == ESpoutMemoryShareFormat::NV12)
+		{
+			for (int32 y = 0; y < Height; ++y)
+				FMemory::Memcpy(&OutStrip[y * 2], &Payload[y * Width + Strip * 2], 2);
+
+			for (int32 cy = 0; cy < (Height + 1) / 2; ++cy)
+				FMemory::Memcpy(&OutStrip[Height * 2 + cy * 2], &Payload[Width * Height + cy * Width + Strip * 2], 2);
+		}
+		else
+		{
+			for (int32 y = 0; y < Height; ++y)
+				FMemory::Memcpy(&OutStrip[y * 4], &Payload[y * Width * 2 + Strip * 4], 4);
+		}
+	}
+
+	static const ESpoutMemoryShareFormat YuvFormats[] = { ESpoutMemoryShareFormat::NV12, ESpoutMemoryShareFormat::YUY2 };
+	static const ESpoutYuvMatrix Matrices[] = { ESpoutYuvMatrix::BT709, ESpoutYuvMatrix::BT2020 };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutYuvConversionFrameSizeTest, "Spout2.YuvConversion.FrameSize", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutYuvConversionFrameSizeTest::RunTest(const FString& Parameters)
+{
+	TestEqual(TEXT("BGRA"), (int64)SpoutYuvConversion::GetFrameSize(ESpoutMemoryShareFormat::BGRA, 1920, 1080), (int64)1920 * 1080 * 4);
+	TestEqual(TEXT("NV12"), (int64)SpoutYuvConversion::GetFrameSize(ESpoutMemoryShareFormat::NV12, 1920, 1080), (int64)1920 * 1080 * 3 / 2);
+	TestEqual(TEXT("YUY2"), (int64)SpoutYuvConversion::GetFrameSize(ESpoutMemoryShareFormat::YUY2, 1920, 1080), (int64)1920 * 1080 * 2);
+
+	// odd sizes round chroma up
+	TestEqual(TEXT("NV12, odd size"), (int64)SpoutYuvConversion::GetFrameSize(ESpoutMemoryShareFormat::NV12, 3, 3), (int64)(9 + 2 * 2 * 2));
+	TestEqual(TEXT("YUY2, odd size"), (int64)SpoutYuvConversion::GetFrameSize(ESpoutMemoryShareFormat::YUY2, 3, 3), (int64)(2 * 4 * 3));
+	TestEqual(TEXT("Disabled"), (int64)SpoutYuvConversion::GetFrameSize(ESpoutMemoryShareFormat::Disabled, 16, 16), (int64)0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutYuvConversionPSNRTest, "Spout2.YuvConversion.PSNR", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutYuvConversionPSNRTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutYuvConversionTest;
+
+	const FIntPoint Sizes[] = { FIntPoint(1920, 1080), FIntPoint(333, 187) };
+
+	TArray<FColor> Pixels, Decoded;
+	TArray<uint8> Payload;
+
+	for (const FIntPoint& Size : Sizes)
+	{
+		MakeTestImage(Size.X, Size.Y, Pixels);
+
+		for (ESpoutMemoryShareFormat Format : YuvFormats)
+		{
+			for (ESpoutYuvMatrix Matrix : Matrices)
+			{
+				RoundTrip(Format, Matrix, Pixels, Size.X, Size.Y, Payload, Decoded);
+
+				const double PSNR = GetPSNR(Pixels, Decoded);
+				TestTrue(FString::Printf(TEXT("%dx%d, format %d, matrix %d: %.1f dB"), Size.X, Size.Y, (int32)Format, (int32)Matrix, PSNR), PSNR >= 45.0);
+			}
+		}
+	}
+
+	// BGRA is a plain copy
+	MakeTestImage(64, 64, Pixels);
+	RoundTrip(ESpoutMemoryShareFormat::BGRA, ESpoutYuvMatrix::BT709, Pixels, 64, 64, Payload, Decoded);
+	TestTrue(TEXT("BGRA is lossless"), Decoded == Pixels);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutYuvConversionGrayTest, "Spout2.YuvConversion.Gray", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutYuvConversionGrayTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutYuvConversionTest;
+
+	TArray<FColor> Pixels, Decoded;
+	TArray<uint8> Payload;
+
+	for (int32 Value = 0; Value < 256; ++Value)
+		Pixels.Add(FColor((uint8)Value, (uint8)Value, (uint8)Value, 255));
+
+	for (ESpoutMemoryShareFormat Format : YuvFormats)
+	{
+		for (ESpoutYuvMatrix Matrix : Matrices)
+		{
+			RoundTrip(Format, Matrix, Pixels, 16, 16, Payload, Decoded);
+
+			int32 WorstError = 0;
+			for (int32 Index = 0; Index < Pixels.Num(); ++Index)
+			{
+				WorstError = FMath::Max(WorstError, FMath::Abs(Decoded[Index].R - Pixels[Index].R));
+				WorstError = FMath::Max(WorstError, FMath::Abs(Decoded[Index].G - Pixels[Index].G));
+				WorstError = FMath::Max(WorstError, FMath::Abs(Decoded[Index].B - Pixels[Index].B));
+			}
+
+			// neutral colors carry no chroma, subsampling loses nothing
+			TestTrue(FString::Printf(TEXT("Format %d, matrix %d: grays within one step"), (int32)Format, (int32)Matrix), WorstError <= 1);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutYuvConversionVectorizedTest, "Spout2.YuvConversion.Vectorized", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutYuvConversionVectorizedTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutYuvConversionTest;
+
+	// frames this wide run the SIMD kernels, two texel strips only their scalar tails; both give the same bytes
+	const int32 Width = 24;
+	const int32 Height = 7;
+
+	FRandomStream Random(1234);
+
+	TArray<FColor> Pixels;
+	for (int32 Index = 0; Index < Width * Height; ++Index)
+		Pixels.Add(FColor(Random.RandHelper(256), Random.RandHelper(256), Random.RandHelper(256), 255));
+
+	TArray<uint8> Payload, Noise, StripPayload, Extracted;
+	TArray<FColor> StripPixels, Decoded, StripDecoded;
+
+	for (ESpoutMemoryShareFormat Format : YuvFormats)
+	{
+		for (ESpoutYuvMatrix Matrix : Matrices)
+		{
+			const FString What = FString::Printf(TEXT("Format %d, matrix %d"), (int32)Format, (int32)Matrix);
+
+			Payload.SetNumUninitialized(SpoutYuvConversion::GetFrameSize(Format, Width, Height));
+			SpoutYuvConversion::Encode(Format, Pixels.GetData(), Width, Height, Payload.GetData(), Matrix);
+
+			// every code, including those outside the video range, decodes alike
+			Noise.SetNumUninitialized(Payload.Num());
+			for (uint8& Byte : Noise)
+				Byte = (uint8)Random.RandHelper(256);
+
+			Decoded.SetNumUninitialized(Width * Height);
+			SpoutYuvConversion::Decode(Format, Noise.GetData(), Width, Height, Decoded.GetData(), Matrix);
+
+			bool bEncodesAlike = true, bDecodesAlike = true;
+			for (int32 Strip = 0; Strip < Width / 2; ++Strip)
+			{
+				StripPixels.Reset();
+				for (int32 y = 0; y < Height; ++y)
+					StripPixels.Append(&Pixels[y * Width + Strip * 2], 2);
+
+				StripPayload.SetNumUninitialized(SpoutYuvConversion::GetFrameSize(Format, 2, Height));
+				SpoutYuvConversion::Encode(Format, StripPixels.GetData(), 2, Height, StripPayload.GetData(), Matrix);
+
+				ExtractStrip(Format, Payload, Width, Height, Strip, Extracted);
+				bEncodesAlike &= Extracted == StripPayload;
+
+				ExtractStrip(Format, Noise, Width, Height, Strip, Extracted);
+				StripDecoded.SetNumUninitialized(2 * Height);
+				SpoutYuvConversion::Decode(Format, Extracted.GetData(), 2, Height, StripDecoded.GetData(), Matrix);
+
+				for (int32 y = 0; y < Height; ++y)
+				{
+					bDecodesAlike &= StripDecoded[y * 2] == Decoded[y * Width + Strip * 2];
+					bDecodesAlike &= StripDecoded[y * 2 + 1] == Decoded[y * Width + Strip * 2 + 1];
+				}
+			}
+
+			TestTrue(What + TEXT(": vector and scalar encodes agree"), bEncodesAlike);
+			TestTrue(What + TEXT(": vector and scalar decodes agree"), bDecodesAlike);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpoutYuvConversionThroughputTest, "Spout2.YuvConversion.Throughput", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpoutYuvConversionThroughputTest::RunTest(const FString& Parameters)
+{
+	using namespace SpoutYuvConversionTest;
+
+	const int32 Width = 1920;
+	const int32 Height = 1080;
+	const int32 NumFrames = 10;
+
+	TArray<FColor> Pixels, Decoded;
+	TArray<uint8> Payload;
+	MakeTestImage(Width, Height, Pixels);
+
+	for (ESpoutMemoryShareFormat Format : YuvFormats)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			RoundTrip(Format, ESpoutYuvMatrix::BT709, Pixels, Width, Height, Payload, Decoded);
+
+		const double MegapixelsPerSecond = (double)Width * Height * NumFrames / (FPlatformTime::Seconds() - StartTime) / 1e6;
+		AddInfo(FString::Printf(TEXT("Format %d: %.0f Mpixel/s encoded and decoded"), (int32)Format, MegapixelsPerSecond));
+
+		// roughly 100 in optimized builds; far below means the kernels stopped vectorizing or allocate per pixel
+		TestTrue(FString::Printf(TEXT("Format %d keeps up with 1080p at a few frames per second even unoptimized"), (int32)Format), MegapixelsPerSecond >= 5.0);
+	}
+
+	return true;
+}
+
+#endif
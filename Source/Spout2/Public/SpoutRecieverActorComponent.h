@@ -1,42 +1,160 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "Engine.h"
-#include "Components/ActorComponent.h"
-
-#include "SpoutRecieverActorComponent.generated.h"
-
-UCLASS( ClassGroup=(Custom), DisplayName = "Spout Reciever", meta=(BlueprintSpawnableComponent) )
-class SPOUT2_API USpoutRecieverActorComponent : public UActorComponent
-{
-	GENERATED_BODY()
-
-	struct SpoutRecieverContext;
-	TSharedPtr<SpoutRecieverContext> context;
-
-	UPROPERTY()
-	UTexture2D* IntermediateTexture2D = nullptr;
-
-	void Tick_RenderThread(FRHICommandListImmediate& RHICmdList, void* hSharehandle, FTextureRenderTargetResource* OutputRenderTargetResource);
-
-public:	
-	
-	USpoutRecieverActorComponent();
-
-protected:
-	
-	virtual void BeginPlay() override;
-	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
-
-public:	
-	
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
-	FName SubscribeName = "";
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
-	UTextureRenderTarget2D* OutputRenderTarget = nullptr;
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine.h"
+#include "Components/ActorComponent.h"
+#include "Async/Future.h"
+#include "SpoutTypes.h"
+
+#include "SpoutRecieverActorComponent.generated.h"
+
+class FSpoutAtlasTableReader;
+class FSpoutFrameNotifier;
+class FSpoutLateLatch;
+class FSpoutMetadataReader;
+class FSpoutPublishedFrames;
+class FSpoutSubscription;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FSpoutFrameReceivedSignature, int64, FrameId, float, Timestamp);
+
+UCLASS( ClassGroup=(Custom), DisplayName = "Spout Reciever", meta=(BlueprintSpawnableComponent) )
+class SPOUT2_API USpoutRecieverActorComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+	struct SpoutRecieverContext;
+	struct FSharedReception;
+	struct FDrawSettings;
+	struct FJitterState;
+	struct FMemoryOutput;
+
+	// opened, copied and sized once per sender and process, every receiver of the sender draws from it
+	TSharedPtr<FSharedReception, ESPMode::ThreadSafe> Reception;
+
+	int32 TransferStreamId = INDEX_NONE;
+
+	TSharedPtr<FSpoutLateLatch> LateLatch;
+	TSharedPtr<FSpoutSubscription> Subscription;
+	TSharedPtr<FSpoutAtlasTableReader> AtlasReader;
+	TSharedPtr<FJitterState> Jitter;
+	TSharedPtr<FMemoryOutput> MemoryOutput;
+
+	// fed by the render thread after each draw, drained by the tick into OnFrameReceived
+	TSharedPtr<FSpoutFrameNotifier, ESPMode::ThreadSafe> FrameNotifier;
+
+	// frame ids of a sender of this process, read when its texture is drawn directly
+	TSharedPtr<FSpoutPublishedFrames> LocalFrames;
+
+	// render thread, numbers the draws of senders that publish no frame ids
+	int64 UncountedDraws = 0;
+
+	// render thread, the sender's per-frame metadata and the frame last drawn
+	TSharedPtr<FSpoutMetadataReader> MetadataReader;
+	int64 NotifiedFrameId = 0;
+
+	// game thread, the frame last broadcast by OnFrameReceived
+	FSpoutReceivedFrame DispatchedFrame;
+
+	bool ScheduleTransfer();
+	FDrawSettings MakeDrawSettings() const;
+	FIntRect GetSourceRegion() const;
+	FSharedReception& AcquireReception(const FString& SenderName, bool bFromMemory, const FIntRect& Region);
+	void ReleaseReception();
+	void UpdateJitterState(const FSharedReception& Shared);
+	void ReleaseJitterState();
+	void UpdateMemoryOutput(FIntPoint Size);
+	void ReleaseMemoryOutput();
+	void TickMemoryShare();
+	// MetadataSender: whose metadata ring FrameId indexes, empty for ids of another counter
+	void NotifyFrameDrawn_RenderThread(int64 FrameId, double PublishTime, const FString& MetadataSender);
+
+	// FrameTime: the engine frame time the drawn frame is selected for, see JitterPolicy
+	void Receive_RenderThread(FRHICommandListImmediate& RHICmdList, FSharedReception& Shared, void* hSharehandle, FIntRect SourceRect, uint32 DxgiFormat, const FDrawSettings& DrawSettings, double FrameTime);
+
+	static void DrawSpoutTexture_RenderThread(FRHICommandListImmediate& RHICmdList, FRHITexture* SourceTexture, FIntPoint SourceSize, FTextureRenderTargetResource* OutputRenderTargetResource, const FDrawSettings& DrawSettings);
+
+public:	
+	
+	USpoutRecieverActorComponent();
+
+protected:
+	
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void OnUnregister() override;
+
+public:	
+	
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// The next frame drawn into OutputRenderTarget, invalid when the component goes away first.
+	// Fulfilled on the render thread right after the draw: continuations touching UObjects go back to the game thread,
+	// and the game thread must not wait for it, since its tick enqueues the draw.
+	TFuture<FSpoutReceivedFrame> AcquireNextFrame();
+
+	// Completes once the next frame was drawn into OutputRenderTarget, or after Timeout seconds when Timeout is above 0
+	UFUNCTION(BlueprintCallable, Category = "Spout2", meta = (Latent, LatentInfo = "LatentInfo", DisplayName = "Wait For Next Spout Frame"))
+	void WaitForNextFrame(float Timeout, bool& bReceived, FSpoutReceivedFrame& Frame, FLatentActionInfo LatentInfo);
+
+	// Broadcast from the tick after a new frame was drawn into OutputRenderTarget; frames drawn within one tick coalesce to the newest
+	UPROPERTY(BlueprintAssignable, Category = "Spout2")
+	FSpoutFrameReceivedSignature OnFrameReceived;
+
+	// Metadata the sender attached to the frame last broadcast by OnFrameReceived, false when it had none
+	UFUNCTION(BlueprintCallable, Category = "Spout2")
+	bool GetFrameMetadata(TArray<uint8>& Metadata) const;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	FName SubscribeName = "";
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	UTextureRenderTarget2D* OutputRenderTarget = nullptr;
+
+	// Read the sender's CPU memory-share stream (any ESpoutMemoryShareFormat) instead of its shared texture; its frames are converted and scaled on the CPU
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	bool bReceiveFromMemory = false;
+
+	// Copy the newest sender frame on the render thread right before the scene renders, instead of when the component ticks
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	bool bLateLatch = false;
+
+	// Acknowledge every frame copied from the shared texture once the GPU finished the copy, a sender with bLossless waits for it before publishing the next one
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	bool bLossless = false;
+
+	// Sender frames held back against jitter, 0 or 1 draws each frame as it arrives; shared textures of Spout2 senders only
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2", meta = (ClampMin = "0", ClampMax = "8"))
+	int32 JitterBufferFrames = 0;
+
+	// Which buffered frame is drawn, against the sender's publish times and the engine frame time
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	ESpoutJitterPolicy JitterPolicy = ESpoutJitterPolicy::SmoothCadence;
+
+	// Receive only the SourceRegionSize pixels at SourceRegionOffset of the sender, a zero size receives all of it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	FIntPoint SourceRegionOffset = FIntPoint::ZeroValue;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2", meta = (ClampMin = "0"))
+	FIntPoint SourceRegionSize = FIntPoint::ZeroValue;
+
+	// Conversions applied by the copy draw itself, without an extra material pass
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	FSpoutConversionOptions Conversion;
+
+	// Filter used when OutputRenderTarget differs in size from the sender
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	ESpoutScaleFilter ScaleFilter = ESpoutScaleFilter::Point;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	ESpoutScaleMode ScaleMode = ESpoutScaleMode::Stretch;
+
+	// Higher priority copies are scheduled first when Spout2.SubmitBudgetMs is exceeded
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	int32 TransferPriority = 0;
+
+	// Receive rate in frames per second, 0 receives every frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2", meta = (ClampMin = "0"))
+	float TargetFrameRate = 0.f;
+};
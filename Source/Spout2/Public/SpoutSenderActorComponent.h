@@ -1,36 +1,174 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "Engine.h"
-#include "Components/ActorComponent.h"
-#include "SpoutSenderActorComponent.generated.h"
-
-UCLASS( ClassGroup=(Custom), DisplayName="Spout Sender", meta=(BlueprintSpawnableComponent) )
-class SPOUT2_API USpoutSenderActorComponent : public UActorComponent
-{
-	GENERATED_BODY()
-
-	struct SpoutSenderContext;
-	TSharedPtr<SpoutSenderContext> context;
-
-public:	
-	// Sets default values for this component's properties
-	USpoutSenderActorComponent();
-
-protected:
-	// Called when the game starts
-	virtual void BeginPlay() override;
-	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
-
-public:	
-	// Called every frame
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
-	FName PublishName;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
-	UTexture* OutputTexture;
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine.h"
+#include "Components/ActorComponent.h"
+#include "SpoutTypes.h"
+#include "SpoutSenderActorComponent.generated.h"
+
+class FSpoutMemorySender;
+class FSpoutSubscriberMonitor;
+struct FSpoutSourceVersionKey;
+
+UCLASS( ClassGroup=(Custom), DisplayName="Spout Sender", meta=(BlueprintSpawnableComponent) )
+class SPOUT2_API USpoutSenderActorComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+	struct SpoutSenderContext;
+	TSharedPtr<SpoutSenderContext, ESPMode::ThreadSafe> context;
+
+	struct FContextCreator;
+	TSharedPtr<FContextCreator> ContextCreator;
+
+	void ResetContext();
+
+	// Slot a SceneView or BackBuffer source is captured into during rendering
+	UPROPERTY(Transient)
+	UTextureRenderTarget2D* CaptureRenderTarget = nullptr;
+
+	struct FViewCapture;
+	TSharedPtr<FViewCapture> ViewCapture;
+
+	void TickViewCapture();
+	void ResetViewCapture();
+
+	int32 TransferStreamId = INDEX_NONE;
+
+	// HdrTransport target the source is packed into before sharing
+	UPROPERTY(Transient)
+	UTextureRenderTarget2D* PackedRenderTarget = nullptr;
+
+	bool UpdatePackedRenderTarget();
+
+	TSharedPtr<FSpoutMemorySender, ESPMode::ThreadSafe> MemorySender;
+
+	// GPU copies of the memory-share stream, published once the GPU finished them
+	struct FMemoryReadback;
+	TSharedPtr<FMemoryReadback, ESPMode::ThreadSafe> MemoryReadback;
+
+	void PublishMemoryShare();
+	void PublishFinishedReadbacks();
+
+	// PreviewScale target the source is downscaled into before it is shared
+	UPROPERTY(Transient)
+	UTextureRenderTarget2D* PreviewRenderTarget = nullptr;
+
+	struct FPreviewStream;
+	TSharedPtr<FPreviewStream> Preview;
+
+	void TickPreview(const FSpoutSourceVersionKey& SourceKey);
+	void ResetPreview();
+
+	TSharedPtr<FSpoutSubscriberMonitor> SubscriberMonitor;
+	double LastKeepAliveTime = 0.0;
+
+	bool ShouldPublishForSubscribers(const FString& SenderName, TSharedPtr<FSpoutSubscriberMonitor>& Monitor, double& InOutLastKeepAliveTime) const;
+
+	struct FAtlasPublisher;
+	TSharedPtr<FAtlasPublisher> AtlasPublisher;
+
+	// a texture the atlas refused is published on its own until the atlas accepts it again
+	bool bAtlasRefused = false;
+
+	bool TickAtlas();
+	bool RefuseAtlas(FRHITexture2D* Texture2D);
+	void LeaveAtlas();
+
+	struct FSourceVersion;
+	TSharedPtr<FSourceVersion> SourceVersion;
+	uint64 DirtyCount = 0;
+
+	// set by SetFrameMetadata, handed to the context with the next copy
+	TArray<uint8> PendingMetadata;
+	bool bMetadataPending = false;
+
+	void AttachPendingMetadata();
+
+	// while bLossless, the copy waits for every actor's tick and the game thread for the copy
+	struct FLosslessPacing;
+	TSharedPtr<FLosslessPacing> LosslessPacing;
+
+public:	
+	// Sets default values for this component's properties
+	USpoutSenderActorComponent();
+
+protected:
+	// Called when the game starts
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void OnUnregister() override;
+
+public:	
+	// Called every frame
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	FName PublishName;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	UTexture* OutputTexture;
+
+	// Where the published image comes from; SceneView and BackBuffer need no OutputTexture or scene capture
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	ESpoutSenderSource Source = ESpoutSenderSource::Texture;
+
+	// Post-processing stage a SceneView source is captured after
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	ESpoutCaptureStage CaptureStage = ESpoutCaptureStage::AfterTonemap;
+
+	// Skip copies while no Spout2 receiver subscribes, apart from Spout2.IdleKeepAliveRate; receivers of other Spout applications never subscribe
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	bool bOnlyWhileSubscribed = false;
+
+	// Offline rendering: the game thread waits until Spout2 receivers with bLossless, of any process, consumed a frame before the next one overwrites it,
+	// and until that one was published; each wait up to Spout2.BackpressureTimeout. No frame is skipped, the game runs at the pace of its slowest receiver
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	bool bLossless = false;
+
+	// Share one atlas texture with every other sender of this name instead of an own shared texture; plugin receivers read their rectangle transparently
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	FName AtlasName = NAME_None;
+
+	// When a texture source is copied again; MarkDirty and GpuHash skip frames whose content did not change
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	ESpoutChangeDetection ChangeDetection = ESpoutChangeDetection::Always;
+
+	// Publish the texture source again with ChangeDetection MarkDirty or GpuHash, call after redrawing it
+	UFUNCTION(BlueprintCallable, Category = "Spout2")
+	void MarkDirty();
+
+	// Attach up to 4 KB, such as timecode or camera and lens data, to the next frame this sender publishes; plugin receivers get it with exactly that frame
+	UFUNCTION(BlueprintCallable, Category = "Spout2")
+	void SetFrameMetadata(const TArray<uint8>& Metadata);
+
+	// Higher priority copies are scheduled first when Spout2.SubmitBudgetMs is exceeded
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	int32 TransferPriority = 0;
+
+	// Publish rate in frames per second, 0 publishes every frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2", meta = (ClampMin = "0"))
+	float TargetFrameRate = 0.f;
+
+	// Pack HDR sources into a 32 bit format before sharing, halving bandwidth against FloatRGBA
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	ESpoutHdrTransport HdrTransport = ESpoutHdrTransport::None;
+
+	// Also publish a CPU copy in shared memory; NV12 needs 1.5 bytes per pixel against 4 for BGRA
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	ESpoutMemoryShareFormat MemoryShareFormat = ESpoutMemoryShareFormat::Disabled;
+
+	// Matrix used for the YUV memory-share formats
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	ESpoutYuvMatrix YuvMatrix = ESpoutYuvMatrix::BT709;
+
+	// Also publish a downscaled copy as "<PublishName>_Preview" for thumbnails, in shared texture and, when enabled, memory-share form; texture sources only
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	ESpoutPreviewScale PreviewScale = ESpoutPreviewScale::Disabled;
+
+	// Preview publish rate in frames per second, scheduled apart from the sender; 0 publishes it every frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2", meta = (ClampMin = "0"))
+	float PreviewFrameRate = 5.f;
+};
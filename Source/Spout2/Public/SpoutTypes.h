@@ -0,0 +1,176 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "SpoutTypes.generated.h"
+
+UENUM(BlueprintType)
+enum class ESpoutAlphaConversion : uint8
+{
+	None,
+	// Straight alpha in, premultiplied alpha out
+	Premultiply,
+	// Premultiplied alpha in, straight alpha out
+	Unpremultiply,
+};
+
+UENUM(BlueprintType)
+enum class ESpoutColorConversion : uint8
+{
+	None,
+	SRGBToLinear,
+	LinearToSRGB,
+};
+
+UENUM(BlueprintType)
+enum class ESpoutScaleFilter : uint8
+{
+	// Nearest texel, exact when sender and output sizes match
+	Point,
+	Bilinear,
+	// Area average, for large downscales
+	Box,
+	// Lanczos-2, sharper than Box for downscales
+	Lanczos,
+};
+
+UENUM(BlueprintType)
+enum class ESpoutScaleMode : uint8
+{
+	// Fill the output, ignoring aspect ratio
+	Stretch,
+	// Show the whole source, letterboxed with transparent black
+	Fit,
+	// Fill the output, cropping the source to its aspect ratio
+	Fill,
+};
+
+UENUM(BlueprintType)
+enum class ESpoutHdrTransport : uint8
+{
+	// Share the source format unchanged
+	None,
+	// R10G10B10A2 with SMPTE ST 2084 (PQ) encoding, linear 1.0 = 100 nits
+	PQ10,
+	// R10G10B10A2 with log2 encoding over 20 stops
+	Log10,
+	// R11G11B10_FLOAT, alpha is dropped
+	Float11,
+};
+
+UENUM(BlueprintType)
+enum class ESpoutMemoryShareFormat : uint8
+{
+	// No memory-share stream
+	Disabled,
+	// 4 bytes per pixel
+	BGRA,
+	// 4:2:0, full resolution luma plane plus interleaved half resolution chroma, 1.5 bytes per pixel
+	NV12,
+	// 4:2:2 packed as YUY2, 2 bytes per pixel
+	YUY2,
+};
+
+UENUM(BlueprintType)
+enum class ESpoutYuvMatrix : uint8
+{
+	BT709,
+	BT2020,
+};
+
+UENUM(BlueprintType)
+enum class ESpoutSenderSource : uint8
+{
+	// Publish OutputTexture
+	Texture,
+	// Capture the game viewport's scene view at CaptureStage while it renders
+	SceneView,
+	// Capture the game window's back buffer just before it is presented
+	BackBuffer,
+};
+
+UENUM(BlueprintType)
+enum class ESpoutChangeDetection : uint8
+{
+	// Copy every transfer
+	Always,
+	// Copy when MarkDirty was called or the source texture was reallocated, resized or replaced
+	MarkDirty,
+	// MarkDirty, plus a GPU hash of the source; redraws are picked up once the hash is read back a few frames later
+	GpuHash,
+};
+
+// Post-processing stages in pipeline order; a disabled stage falls back to the nearest earlier enabled one
+UENUM(BlueprintType)
+enum class ESpoutCaptureStage : uint8
+{
+	AfterMotionBlur,
+	AfterTonemap,
+	AfterFXAA,
+};
+
+UENUM(BlueprintType)
+enum class ESpoutPreviewScale : uint8
+{
+	// No preview stream
+	Disabled,
+	// A quarter of the width and height
+	Quarter,
+	// An eighth of the width and height
+	Eighth,
+};
+
+// Which buffered frame a receiver with a jitter buffer shows each engine frame
+UENUM(BlueprintType)
+enum class ESpoutJitterPolicy : uint8
+{
+	// The newest frame, as without a buffer
+	LowestLatency,
+	// The newest frame published at least the buffer's delay ago; repeats and skips follow the rate mismatch, not the jitter
+	SmoothCadence,
+	// The frame whose publish time plus the buffer's delay is nearest to the engine frame time
+	NearestTimestamp,
+};
+
+// Conversions fused into the receiver's copy draw. Order: flip, swizzle, sRGB decode, alpha, sRGB encode.
+USTRUCT(BlueprintType)
+struct SPOUT2_API FSpoutConversionOptions
+{
+	GENERATED_BODY()
+
+	// Exchange the red and blue channels (BGRA <-> RGBA)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	bool bSwizzleRedBlue = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	bool bFlipVertical = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	ESpoutAlphaConversion Alpha = ESpoutAlphaConversion::None;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spout2")
+	ESpoutColorConversion Color = ESpoutColorConversion::None;
+};
+
+// A frame a receiver drew into its OutputRenderTarget
+USTRUCT(BlueprintType)
+struct SPOUT2_API FSpoutReceivedFrame
+{
+	GENERATED_BODY()
+
+	// The sender's frame id; receivers of senders outside the plugin count their draws instead. 0 when no frame came
+	UPROPERTY(BlueprintReadOnly, Category = "Spout2")
+	int64 FrameId = 0;
+
+	// Seconds since the engine started, at which the sender published the frame or, without a publish time, the receiver drew it
+	UPROPERTY(BlueprintReadOnly, Category = "Spout2")
+	float Timestamp = 0.f;
+
+	// What the sender attached to the frame with SetFrameMetadata, empty when it attached nothing
+	UPROPERTY(BlueprintReadOnly, Category = "Spout2")
+	TArray<uint8> Metadata;
+
+	bool IsValid() const { return FrameId != 0; }
+};
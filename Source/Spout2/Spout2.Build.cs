@@ -85,6 +85,7 @@ public class Spout2 : ModuleRules
 				"Slate",
 				"SlateCore",
 				"RenderCore",
+				"Renderer",
 				"RHI",
 				"Projects",
 				"D3D11RHI",